@@ -0,0 +1,130 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <iostream>
+
+namespace medley {
+namespace bench {
+
+namespace {
+    double ticksToNanoseconds(int64 ticks) {
+        return (double)ticks * 1.0e9 / (double)Time::getHighResolutionTicksPerSecond();
+    }
+
+    double percentile(const std::vector<double>& sorted, double p) {
+        if (sorted.empty()) {
+            return 0.0;
+        }
+
+        auto index = jlimit<size_t>(0, sorted.size() - 1, (size_t)std::ceil(p * (double)sorted.size()) - 1);
+        return sorted[index];
+    }
+}
+
+var Result::toVar() const
+{
+    auto obj = new DynamicObject();
+    obj->setProperty("name", name);
+    obj->setProperty("variant", variant);
+    obj->setProperty("blockSize", blockSize);
+    obj->setProperty("channels", numChannels);
+    obj->setProperty("sampleRate", sampleRate);
+    obj->setProperty("iterations", iterations);
+    obj->setProperty("meanNs", meanNs);
+    obj->setProperty("medianNs", medianNs);
+    obj->setProperty("p99Ns", p99Ns);
+    obj->setProperty("minNs", minNs);
+    obj->setProperty("maxNs", maxNs);
+    obj->setProperty("framesPerSecond", framesPerSecond);
+    obj->setProperty("realtimeFactor", realtimeFactor);
+    return var(obj);
+}
+
+Runner::Runner(const Options& options)
+    : options(options)
+{
+
+}
+
+bool Runner::shouldRun(const juce::String& name) const
+{
+    return options.filter.isEmpty() || name.containsIgnoreCase(options.filter);
+}
+
+void Runner::run(const juce::String& name, const juce::String& variant, int blockSize, int numChannels, double sampleRate, Body body, Body prepare)
+{
+    if (!shouldRun(name)) {
+        return;
+    }
+
+    for (int i = 0; i < options.warmupIterations; i++) {
+        if (prepare) prepare();
+        body();
+    }
+
+    std::vector<double> samples;
+    samples.reserve((size_t)options.minIterations * 4);
+
+    const auto minTicks = (int64)(options.minTimeMs / 1000.0 * (double)Time::getHighResolutionTicksPerSecond());
+    int64 elapsed = 0;
+
+    while ((int)samples.size() < options.minIterations || elapsed < minTicks) {
+        if (prepare) prepare();
+
+        auto start = Time::getHighResolutionTicks();
+        body();
+        auto ticks = Time::getHighResolutionTicks() - start;
+
+        elapsed += ticks;
+        samples.push_back(ticksToNanoseconds(ticks));
+    }
+
+    Result result;
+    result.name = name;
+    result.variant = variant;
+    result.blockSize = blockSize;
+    result.numChannels = numChannels;
+    result.sampleRate = sampleRate;
+    result.iterations = (int)samples.size();
+
+    double total = 0.0;
+    for (auto s : samples) {
+        total += s;
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    result.meanNs = total / (double)samples.size();
+    result.medianNs = percentile(samples, 0.5);
+    result.p99Ns = percentile(samples, 0.99);
+    result.minNs = samples.front();
+    result.maxNs = samples.back();
+
+    if (result.meanNs > 0.0) {
+        result.framesPerSecond = (double)blockSize / (result.meanNs / 1.0e9);
+
+        if (sampleRate > 0.0) {
+            result.realtimeFactor = result.framesPerSecond / sampleRate;
+        }
+    }
+
+    results.push_back(result);
+
+    std::cerr << name << " [" << variant << "] block=" << blockSize << " ch=" << numChannels
+        << " mean=" << String(result.meanNs / 1000.0, 3) << "us"
+        << " p99=" << String(result.p99Ns / 1000.0, 3) << "us"
+        << " x" << String(result.realtimeFactor, 1) << " realtime" << std::endl;
+}
+
+var Runner::toVar() const
+{
+    Array<var> list;
+
+    for (const auto& result : results) {
+        list.add(result.toVar());
+    }
+
+    return var(list);
+}
+
+}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <vector>
+
+using namespace juce;
+
+namespace medley {
+namespace bench {
+
+struct Result {
+    juce::String name;
+    juce::String variant;
+    int blockSize = 0;
+    int numChannels = 0;
+    double sampleRate = 0.0;
+    int iterations = 0;
+
+    double meanNs = 0.0;
+    double medianNs = 0.0;
+    double p99Ns = 0.0;
+    double minNs = 0.0;
+    double maxNs = 0.0;
+
+    /**
+     * Frames processed per second of wall-clock time
+     */
+    double framesPerSecond = 0.0;
+
+    /**
+     * How many times faster than realtime, based on the mean iteration time
+     */
+    double realtimeFactor = 0.0;
+
+    var toVar() const;
+};
+
+class Runner {
+public:
+    struct Options {
+        juce::String filter;
+        double minTimeMs = 500.0;
+        int minIterations = 50;
+        int warmupIterations = 10;
+    };
+
+    typedef std::function<void()> Body;
+
+    explicit Runner(const Options& options);
+
+    bool shouldRun(const juce::String& name) const;
+
+    /**
+     * Time `body` repeatedly, `prepare` (if any) runs before each iteration and is not timed
+     */
+    void run(const juce::String& name, const juce::String& variant, int blockSize, int numChannels, double sampleRate, Body body, Body prepare = nullptr);
+
+    const std::vector<Result>& getResults() const { return results; }
+
+    var toVar() const;
+
+private:
+    Options options;
+    std::vector<Result> results;
+};
+
+}
+}
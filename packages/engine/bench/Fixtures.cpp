@@ -0,0 +1,123 @@
+#include "Fixtures.h"
+#include <iostream>
+
+namespace medley {
+namespace bench {
+
+Fixtures::Fixtures(AudioFormatManager& formatMgr, const File& sourceDirectory, const StringArray& codecs)
+    : formatMgr(formatMgr),
+    tempDir(File::getSpecialLocation(File::tempDirectory).getNonexistentChildFile("medley-bench", ""))
+{
+    tempDir.createDirectory();
+
+    FlacAudioFormat flac;
+    OggVorbisAudioFormat vorbis;
+
+    for (int numChannels = 1; numChannels <= 2; numChannels++) {
+        if (codecs.contains("flac")) {
+            generate(flac, "flac", numChannels, 16, 5);
+        }
+
+        if (codecs.contains("vorbis")) {
+            generate(vorbis, "vorbis", numChannels, 16, 5);
+        }
+    }
+
+    // There is no MP3/Opus encoder available, use the bundled test files instead
+    struct {
+        const char* codec;
+        const char* fileName;
+    } const bundled[] = {
+        { "mp3", "middlec.mp3" },
+        { "opus", "middlec.opus" }
+    };
+
+    for (const auto& b : bundled) {
+        if (!codecs.contains(b.codec)) {
+            continue;
+        }
+
+        auto file = sourceDirectory.getChildFile(b.fileName);
+
+        if (!file.existsAsFile()) {
+            std::cerr << "Fixture not found: " << file.getFullPathName() << std::endl;
+            continue;
+        }
+
+        std::unique_ptr<AudioFormatReader> reader(formatMgr.createReaderFor(file));
+        if (reader == nullptr) {
+            continue;
+        }
+
+        entries.add({ b.codec, file, (int)reader->numChannels });
+    }
+}
+
+Fixtures::~Fixtures()
+{
+    tempDir.deleteRecursively();
+}
+
+void Fixtures::synthesize(AudioBuffer<float>& buffer, double sampleRate, uint32 seed)
+{
+    static constexpr double frequencies[] = { 55.0, 220.0, 261.63, 1244.5, 4186.0, 9000.0 };
+    static constexpr float amplitudes[] = { 0.2f, 0.15f, 0.12f, 0.08f, 0.05f, 0.03f };
+
+    Random random((int64)seed);
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ch++) {
+        auto data = buffer.getWritePointer(ch);
+        auto detune = 1.0 + ch * 0.003;
+
+        for (int i = 0; i < buffer.getNumSamples(); i++) {
+            auto t = (double)i / sampleRate;
+            double s = 0.0;
+
+            for (size_t k = 0; k < std::size(frequencies); k++) {
+                s += amplitudes[k] * std::sin(MathConstants<double>::twoPi * frequencies[k] * detune * t);
+            }
+
+            // Slow amplitude envelope so the dynamics processors have something to do
+            auto envelope = 0.6 + 0.4 * std::sin(MathConstants<double>::twoPi * 0.25 * t);
+            auto noise = (random.nextFloat() * 2.0f - 1.0f) * 0.02f;
+
+            data[i] = (float)(s * envelope) + noise;
+        }
+    }
+}
+
+bool Fixtures::generate(AudioFormat& format, const juce::String& codec, int numChannels, int bitsPerSample, int quality)
+{
+    auto file = tempDir.getChildFile(codec + "-" + String(numChannels) + "ch" + format.getFileExtensions()[0]);
+    auto stream = file.createOutputStream();
+
+    if (stream == nullptr) {
+        return false;
+    }
+
+    auto qualityIndex = jlimit(0, jmax(0, format.getQualityOptions().size() - 1), quality);
+
+    auto rawStream = stream.release();
+    std::unique_ptr<AudioFormatWriter> writer(format.createWriterFor(rawStream, kSampleRate, (unsigned int)numChannels, bitsPerSample, {}, qualityIndex));
+
+    if (writer == nullptr) {
+        delete rawStream;
+        std::cerr << "Could not create " << codec << " writer" << std::endl;
+        return false;
+    }
+
+    AudioBuffer<float> buffer(numChannels, (int)(kSampleRate * kDurationSeconds));
+    synthesize(buffer, kSampleRate);
+
+    if (!writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples())) {
+        return false;
+    }
+
+    writer.reset();
+
+    entries.add({ codec, file, numChannels });
+    return true;
+}
+
+}
+}
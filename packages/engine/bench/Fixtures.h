@@ -0,0 +1,53 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+using namespace juce;
+
+namespace medley {
+namespace bench {
+
+/**
+ * Generated (or located) audio files used by the decoder benchmarks
+ */
+class Fixtures {
+public:
+    struct Entry {
+        juce::String codec;
+        File file;
+        int numChannels = 0;
+    };
+
+    /**
+     * @param sourceDirectory A directory containing fixtures that cannot be generated (MP3/Opus have no writers)
+     * @param codecs Only these codecs are generated or located, see getCodecs()
+     */
+    Fixtures(AudioFormatManager& formatMgr, const File& sourceDirectory, const StringArray& codecs);
+
+    ~Fixtures();
+
+    const Array<Entry>& getEntries() const { return entries; }
+
+    /**
+     * Every codec a fixture can be provided for
+     */
+    static StringArray getCodecs() { return { "flac", "vorbis", "mp3", "opus" }; }
+
+    /**
+     * Fill the buffer with a deterministic multi-sine + noise program-like signal
+     */
+    static void synthesize(AudioBuffer<float>& buffer, double sampleRate, uint32 seed = 0x6d65646c);
+
+    static constexpr double kSampleRate = 44100.0;
+    static constexpr double kDurationSeconds = 30.0;
+
+private:
+    bool generate(AudioFormat& format, const juce::String& codec, int numChannels, int bitsPerSample, int quality);
+
+    AudioFormatManager& formatMgr;
+    File tempDir;
+    Array<Entry> entries;
+};
+
+}
+}
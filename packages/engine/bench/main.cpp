@@ -0,0 +1,338 @@
+#include <JuceHeader.h>
+#include <iostream>
+
+#include "Benchmark.h"
+#include "Fixtures.h"
+
+#include "PostProcessor.h"
+#include "LookAheadLimiter.h"
+#include "DeFXKaraoke.h"
+#include "MultibandProcessor.h"
+#include "LevelTracker.h"
+#include "LoudnessMeter.h"
+#include "RingBuffer.h"
+#include "MiniMP3AudioFormat.h"
+#include "OpusAudioFormat.h"
+#include "SecretRabbitCode.h"
+
+using namespace juce;
+using namespace medley::bench;
+
+namespace {
+    const int kBlockSizes[] = { 64, 128, 256, 480, 512, 1024, 2048 };
+    const int kChannels[] = { 1, 2 };
+    constexpr double kSampleRate = 48000.0;
+
+    void printUsage() {
+        std::cerr
+            << "Usage: medley-bench [options]" << std::endl
+            << "  --filter <text>      Only run benchmarks whose name contains <text>" << std::endl
+            << "  --min-time <ms>      Minimum measuring time per case (default 500)" << std::endl
+            << "  --min-iterations <n> Minimum iterations per case (default 50)" << std::endl
+            << "  --fixtures <dir>     Directory containing middlec.mp3 and middlec.opus (default test)" << std::endl
+            << "  --output <file>      Write JSON results to <file> instead of stdout" << std::endl;
+    }
+
+    /**
+     * A source buffer larger than any block so each iteration processes fresh, non-repeating material
+     */
+    class Program {
+    public:
+        Program(int numChannels, double sampleRate)
+            : source(numChannels, (int)sampleRate * 4)
+        {
+            Fixtures::synthesize(source, sampleRate);
+        }
+
+        void next(AudioBuffer<float>& dest, int numSamples) {
+            if (position + numSamples > source.getNumSamples()) {
+                position = 0;
+            }
+
+            for (int ch = 0; ch < dest.getNumChannels(); ch++) {
+                dest.copyFrom(ch, 0, source, ch % source.getNumChannels(), position, numSamples);
+            }
+
+            position += numSamples;
+        }
+
+    private:
+        AudioBuffer<float> source;
+        int position = 0;
+    };
+
+    void benchPostProcessor(Runner& runner, bool karaoke) {
+        auto variant = karaoke ? "karaoke" : "default";
+
+        for (auto numChannels : kChannels) {
+            for (auto blockSize : kBlockSizes) {
+                PostProcessor processor;
+                processor.prepare({ kSampleRate, (uint32)blockSize, (uint32)numChannels }, 0);
+
+                if (karaoke) {
+                    processor.setKaraokeEnabled(true, true);
+                }
+
+                AudioBuffer<float> buffer(numChannels, blockSize);
+                Program program(numChannels, kSampleRate);
+                double timestamp = 0.0;
+
+                runner.run("PostProcessor::process", variant, blockSize, numChannels, kSampleRate,
+                    [&] {
+                        processor.process(AudioSourceChannelInfo(&buffer, 0, blockSize), timestamp);
+                    },
+                    [&] {
+                        program.next(buffer, blockSize);
+                        timestamp += blockSize * 1000.0 / kSampleRate;
+                    }
+                );
+            }
+        }
+    }
+
+    template <typename Processor>
+    void benchProcessor(Runner& runner, const juce::String& name, std::function<void(Processor&)> setup = nullptr) {
+        for (auto numChannels : kChannels) {
+            for (auto blockSize : kBlockSizes) {
+                Processor processor;
+                processor.prepare({ kSampleRate, (uint32)blockSize, (uint32)numChannels });
+
+                if (setup) {
+                    setup(processor);
+                }
+
+                AudioBuffer<float> buffer(numChannels, blockSize);
+                Program program(numChannels, kSampleRate);
+
+                runner.run(name, "default", blockSize, numChannels, kSampleRate,
+                    [&] {
+                        AudioBlock<float> block(buffer);
+                        processor.process(ProcessContextReplacing<float>(block));
+                    },
+                    [&] { program.next(buffer, blockSize); }
+                );
+            }
+        }
+    }
+
+    void benchLevelTracker(Runner& runner) {
+        for (auto numChannels : kChannels) {
+            for (auto blockSize : kBlockSizes) {
+                LevelTracker tracker;
+                tracker.prepare(numChannels, (int)kSampleRate, 0);
+
+                AudioBuffer<float> buffer(numChannels, blockSize);
+                Program program(numChannels, kSampleRate);
+
+                runner.run("LevelTracker::process", "default", blockSize, numChannels, kSampleRate,
+                    [&] { tracker.process(AudioSourceChannelInfo(&buffer, 0, blockSize)); },
+                    [&] { program.next(buffer, blockSize); }
+                );
+            }
+        }
+    }
+
+    void benchLoudnessMeter(Runner& runner) {
+        for (auto numChannels : kChannels) {
+            for (auto blockSize : kBlockSizes) {
+                LoudnessMeter meter;
+                meter.prepare(numChannels, kSampleRate, blockSize);
+
+                AudioBuffer<float> buffer(numChannels, blockSize);
+                Program program(numChannels, kSampleRate);
+
+                runner.run("LoudnessMeter::process", "default", blockSize, numChannels, kSampleRate,
+                    [&] { meter.process(AudioSourceChannelInfo(&buffer, 0, blockSize)); },
+                    [&] {
+                        program.next(buffer, blockSize);
+                        // Keep the FIFO drained like the visualization thread does
+                        meter.update();
+                    }
+                );
+            }
+        }
+    }
+
+    void benchRingBuffer(Runner& runner) {
+        for (auto numChannels : kChannels) {
+            for (auto blockSize : kBlockSizes) {
+                // Same sizing as AudioRequest: a few blocks worth of capacity
+                RingBuffer<float> ring(numChannels, blockSize * 4 + 1);
+
+                AudioBuffer<float> in(numChannels, blockSize);
+                AudioBuffer<float> out(numChannels, blockSize);
+                Fixtures::synthesize(in, kSampleRate);
+
+                runner.run("RingBuffer::write+read", "default", blockSize, numChannels, kSampleRate,
+                    [&] {
+                        ring.write(in, 0, blockSize);
+                        ring.read(out, blockSize);
+                    }
+                );
+            }
+        }
+    }
+
+    void benchResampler(Runner& runner) {
+        struct {
+            const char* name;
+            SecretRabbitCode::Quality quality;
+        } const qualities[] = {
+            { "best", SecretRabbitCode::Quality::Best },
+            { "medium", SecretRabbitCode::Quality::Medium },
+            { "fastest", SecretRabbitCode::Quality::Fastest },
+            { "zoh", SecretRabbitCode::Quality::ZeroOrderHold },
+            { "linear", SecretRabbitCode::Quality::Linear }
+        };
+
+        constexpr int kInRate = 44100;
+        constexpr int kOutRate = 48000;
+
+        for (const auto& q : qualities) {
+            for (auto numChannels : kChannels) {
+                for (auto blockSize : kBlockSizes) {
+                    // SecretRabbitCode is mono, one instance per channel just like AudioRequest
+                    std::vector<std::unique_ptr<SecretRabbitCode>> resamplers;
+                    for (int ch = 0; ch < numChannels; ch++) {
+                        resamplers.push_back(std::make_unique<SecretRabbitCode>(kInRate, kOutRate, q.quality));
+                    }
+
+                    auto outSize = (int)std::ceil(blockSize * (double)kOutRate / kInRate) + 16;
+
+                    AudioBuffer<float> in(numChannels, blockSize);
+                    AudioBuffer<float> out(numChannels, outSize);
+                    Program program(numChannels, kInRate);
+
+                    runner.run("SecretRabbitCode::process", q.name, blockSize, numChannels, kInRate,
+                        [&] {
+                            for (int ch = 0; ch < numChannels; ch++) {
+                                long used = 0;
+                                resamplers[ch]->process(in.getReadPointer(ch), blockSize, out.getWritePointer(ch), outSize, used);
+                            }
+                        },
+                        [&] { program.next(in, blockSize); }
+                    );
+                }
+            }
+        }
+    }
+
+    void benchDecoders(Runner& runner, AudioFormatManager& formatMgr, const Fixtures& fixtures) {
+        for (const auto& entry : fixtures.getEntries()) {
+            std::unique_ptr<AudioFormatReader> reader(formatMgr.createReaderFor(entry.file));
+
+            if (reader == nullptr) {
+                std::cerr << "Could not open fixture: " << entry.file.getFullPathName() << std::endl;
+                continue;
+            }
+
+            auto name = "Decode::" + entry.codec;
+            auto numChannels = (int)reader->numChannels;
+            auto length = reader->lengthInSamples;
+
+            for (auto blockSize : kBlockSizes) {
+                AudioBuffer<float> buffer(numChannels, blockSize);
+                int64 position = 0;
+
+                runner.run(name, reader->getFormatName(), blockSize, numChannels, reader->sampleRate,
+                    [&] {
+                        reader->read(&buffer, 0, blockSize, position, true, true);
+                        position += blockSize;
+                    },
+                    [&] {
+                        // Wrap around, the seek is not part of the measurement
+                        if (position + blockSize > length) {
+                            position = 0;
+                            reader->read(&buffer, 0, 1, 0, true, true);
+                            position = 1;
+                        }
+                    }
+                );
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Runner::Options options;
+    File fixturesDir = File::getCurrentWorkingDirectory().getChildFile("test");
+    File outputFile;
+
+    for (int i = 1; i < argc; i++) {
+        String arg(argv[i]);
+        auto hasValue = i + 1 < argc;
+
+        if (arg == "--filter" && hasValue) {
+            options.filter = argv[++i];
+        }
+        else if (arg == "--min-time" && hasValue) {
+            options.minTimeMs = String(argv[++i]).getDoubleValue();
+        }
+        else if (arg == "--min-iterations" && hasValue) {
+            options.minIterations = jmax(1, String(argv[++i]).getIntValue());
+        }
+        else if (arg == "--fixtures" && hasValue) {
+            fixturesDir = File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        }
+        else if (arg == "--output" && hasValue) {
+            outputFile = File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        }
+        else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    AudioFormatManager formatMgr;
+    formatMgr.registerFormat(new MiniMP3AudioFormat(), true);
+    formatMgr.registerFormat(new FlacAudioFormat(), false);
+    formatMgr.registerFormat(new OggVorbisAudioFormat(), false);
+    formatMgr.registerFormat(new OpusAudioFormat(), false);
+
+    Runner runner(options);
+
+    benchPostProcessor(runner, false);
+    benchPostProcessor(runner, true);
+    benchProcessor<LookAheadLimiter>(runner, "LookAheadLimiter::process");
+    benchProcessor<DeFXKaraoke>(runner, "DeFXKaraoke::process", [](DeFXKaraoke& fx) { fx.setEnabled(true); });
+    benchProcessor<MultibandProcessor>(runner, "MultibandProcessor::process", [](MultibandProcessor& fx) { fx.setEnabled(true); });
+    benchLevelTracker(runner);
+    benchLoudnessMeter(runner);
+    benchRingBuffer(runner);
+    benchResampler(runner);
+
+    // Fixtures take a while to generate, only for the codecs that are benchmarked
+    StringArray codecs;
+
+    for (const auto& codec : Fixtures::getCodecs()) {
+        if (runner.shouldRun("Decode::" + codec)) {
+            codecs.add(codec);
+        }
+    }
+
+    if (!codecs.isEmpty()) {
+        Fixtures fixtures(formatMgr, fixturesDir, codecs);
+        benchDecoders(runner, formatMgr, fixtures);
+    }
+
+    auto report = new DynamicObject();
+    report->setProperty("juce", SystemStats::getJUCEVersion());
+    report->setProperty("os", SystemStats::getOperatingSystemName());
+    report->setProperty("cpu", SystemStats::getCpuModel());
+    report->setProperty("results", runner.toVar());
+
+    auto json = JSON::toString(var(report));
+
+    if (outputFile != File()) {
+        if (!outputFile.replaceWithText(json)) {
+            std::cerr << "Could not write " << outputFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else {
+        std::cout << json << std::endl;
+    }
+
+    return 0;
+}
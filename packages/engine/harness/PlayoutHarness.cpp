@@ -0,0 +1,457 @@
+#include "PlayoutHarness.h"
+#include <iostream>
+
+namespace medley {
+namespace harness {
+
+namespace {
+    // A tone is considered audible above -40dBFS
+    constexpr float kOnsetLevel = 0.01f;
+
+    // A block is considered silent below -60dBFS
+    constexpr float kSilenceLevel = 0.001f;
+
+    constexpr float kFadeEpsilon = 1e-3f;
+
+    // The next deck is started this much earlier to make up for the playhead timer
+    constexpr double kEarlyStart = 0.05;
+
+    /**
+     * Where the transition out of a track should start, its cue-out when it has one.
+     * Otherwise it is wherever the fade out is detected, somewhere between the start and the end of the fade
+     */
+    Range<double> getExpectedCueOut(const TrackSpec& spec) {
+        if (spec.cueOut >= 0.0) {
+            return { spec.cueOut, spec.cueOut };
+        }
+
+        if (spec.taggedCueOut >= 0.0) {
+            return { spec.taggedCueOut, spec.taggedCueOut };
+        }
+
+        auto fadeStart = spec.leadingSilence + spec.fadeIn + spec.body;
+        return { fadeStart, fadeStart + spec.fadeOut };
+    }
+
+    /**
+     * How long before the cue-out of the previous track a track should be started.
+     * A cue-in leaves no lead-in, otherwise the lead-in is detected somewhere within the fade in
+     */
+    Range<double> getExpectedLeadIn(const TrackSpec& spec) {
+        if (spec.cueIn >= 0.0 || spec.taggedCueIn >= 0.0) {
+            return {};
+        }
+
+        return { 0.0, spec.fadeIn };
+    }
+
+    float goertzel(const float* data, int numSamples, double frequency, double sampleRate) {
+        const auto coeff = (float)(2.0 * std::cos(MathConstants<double>::twoPi * frequency / sampleRate));
+
+        float s1 = 0.0f;
+        float s2 = 0.0f;
+
+        for (int i = 0; i < numSamples; i++) {
+            auto s0 = data[i] + coeff * s1 - s2;
+            s2 = s1;
+            s1 = s0;
+        }
+
+        auto power = jmax(0.0f, s1 * s1 + s2 * s2 - coeff * s1 * s2);
+        return 2.0f * std::sqrt(power) / (float)numSamples;
+    }
+
+    var curveToVar(const std::vector<std::pair<double, float>>& curve) {
+        Array<var> list;
+
+        for (const auto& [position, volume] : curve) {
+            list.add(Array<var>{ position, volume });
+        }
+
+        return list;
+    }
+}
+
+PlayoutHarness::PlayoutHarness(const ReferenceCountedArray<TestTrack>& tracks, const Options& options)
+    : tracks(tracks),
+    options(options),
+    onsets((size_t)tracks.size(), -1)
+{
+    if (tracks.size() > 0) {
+        queue.add(tracks[0].get());
+        nextToEnqueue = 1;
+    }
+
+    medley = std::make_unique<Medley>(*this, this, true);
+    medley->addListener(this);
+    medley->setAudioCallback(this);
+}
+
+PlayoutHarness::~PlayoutHarness()
+{
+    medley->setAudioCallback(nullptr);
+    medley->removeListener(this);
+    medley.reset();
+}
+
+bool PlayoutHarness::run()
+{
+    double totalDuration = 0.0;
+    for (auto track : tracks) {
+        totalDuration += track->getSpec().getDuration();
+    }
+
+    auto timeout = options.timeout > 0.0 ? options.timeout : totalDuration + 30.0;
+    auto startTime = Time::getMillisecondCounterHiRes();
+
+    medley->play(false);
+
+    while (!done.wait(100)) {
+        elapsed = (Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+
+        if (elapsed >= timeout) {
+            timedOut = true;
+            break;
+        }
+    }
+
+    elapsed = (Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+
+    // Let the interceptor drain the remaining output
+    Thread::sleep(500);
+
+    medley->stop(false);
+
+    evaluate();
+
+    return failures.isEmpty();
+}
+
+size_t PlayoutHarness::count() const
+{
+    ScopedLock sl(lock);
+    return (size_t)queue.size();
+}
+
+ITrack::Ptr PlayoutHarness::fetchNextTrack()
+{
+    ScopedLock sl(lock);
+    return queue.size() > 0 ? queue.removeAndReturn(0) : nullptr;
+}
+
+ITrack::Ptr PlayoutHarness::peek(size_t index) const
+{
+    ScopedLock sl(lock);
+    return queue[(int)index];
+}
+
+void PlayoutHarness::enqueueNext(EnqueueNextDone doneCallback)
+{
+    bool enqueued = false;
+
+    {
+        ScopedLock sl(lock);
+
+        if (nextToEnqueue < tracks.size()) {
+            queue.add(tracks[nextToEnqueue++].get());
+            enqueued = true;
+        }
+    }
+
+    if (enqueued) {
+        medley->queueChanged();
+    }
+
+    doneCallback(enqueued);
+}
+
+int PlayoutHarness::indexOf(Deck& deck) const
+{
+    if (auto track = dynamic_cast<TestTrack*>(deck.getTrack().get())) {
+        return track->getSpec().index;
+    }
+
+    return -1;
+}
+
+double PlayoutHarness::getLateness(const Transition& t)
+{
+    if (t.actualStart < t.expectedStart.getStart()) {
+        return t.actualStart - t.expectedStart.getStart();
+    }
+
+    if (t.actualStart > t.expectedStart.getEnd()) {
+        return t.actualStart - t.expectedStart.getEnd();
+    }
+
+    return 0.0;
+}
+
+PlayoutHarness::Transition* PlayoutHarness::findTransitionFrom(int trackIndex)
+{
+    for (auto& t : transitions) {
+        if (t.from == trackIndex && !t.fromFinished) {
+            return &t;
+        }
+    }
+
+    return nullptr;
+}
+
+void PlayoutHarness::deckStarted(Deck& sender, TrackPlay& track)
+{
+    auto index = indexOf(sender);
+
+    Deck* from = nullptr;
+    for (int i = 0; i < Medley::numDecks; i++) {
+        auto deck = medley->getDeck(i);
+
+        if (deck != &sender && deck->isMain() && deck->isTrackLoaded()) {
+            from = deck;
+            break;
+        }
+    }
+
+    ScopedLock sl(lock);
+    startOrder.push_back(index);
+
+    if (from == nullptr) {
+        return;
+    }
+
+    Transition t;
+    t.from = indexOf(*from);
+    t.to = index;
+    t.actualStart = from->getPosition();
+    t.leadingDuration = sender.getLeadingDuration();
+
+    // Derived from the shapes of the tracks rather than from what the decks have detected
+    if (t.from >= 0 && t.to >= 0) {
+        auto cueOut = getExpectedCueOut(tracks[t.from]->getSpec());
+        auto leadIn = getExpectedLeadIn(tracks[t.to]->getSpec());
+
+        t.expectedStart = { cueOut.getStart() - leadIn.getEnd() - kEarlyStart, cueOut.getEnd() - leadIn.getStart() - kEarlyStart };
+    }
+
+    transitions.push_back(t);
+}
+
+void PlayoutHarness::deckPosition(Deck& sender, double position)
+{
+    auto index = indexOf(sender);
+    auto next = medley->getNextDeck(&sender);
+
+    ScopedLock sl(lock);
+
+    if (auto t = findTransitionFrom(index)) {
+        t->fadeOut.emplace_back(position, sender.getVolume());
+
+        if (next != nullptr && indexOf(*next) == t->to) {
+            t->fadeIn.emplace_back(position, next->getVolume());
+        }
+    }
+}
+
+void PlayoutHarness::deckFinished(Deck& sender, TrackPlay& track)
+{
+    auto index = indexOf(sender);
+
+    ScopedLock sl(lock);
+
+    if (auto t = findTransitionFrom(index)) {
+        t->fromFinished = true;
+        t->finalVolume = sender.getVolume();
+    }
+
+    if (index == tracks.size() - 1) {
+        done.signal();
+    }
+}
+
+void PlayoutHarness::deckUnloaded(Deck& sender, TrackPlay& track)
+{
+    if (indexOf(sender) == tracks.size() - 1) {
+        done.signal();
+    }
+}
+
+void PlayoutHarness::audioDeviceUpdate(juce::AudioIODevice* device, const AudioDeviceConfig& config)
+{
+    outputSampleRate = config.sampleRate;
+}
+
+void PlayoutHarness::audioData(const AudioSourceChannelInfo& info, double timestamp)
+{
+    if (info.numSamples <= 0 || info.buffer->getNumChannels() <= 0) {
+        return;
+    }
+
+    auto cpu = medley != nullptr ? medley->getCpuUsage() : 0.0;
+
+    ScopedLock sl(lock);
+
+    cpuTotal += cpu;
+    cpuMax = jmax(cpuMax, cpu);
+    cpuCount++;
+
+    const auto data = info.buffer->getReadPointer(0, info.startSample);
+
+    for (int i = 0; i < tracks.size(); i++) {
+        if (onsets[i] < 0 && goertzel(data, info.numSamples, tracks[i]->getSpec().frequency, outputSampleRate) >= kOnsetLevel) {
+            onsets[i] = framesOutput;
+        }
+    }
+
+    // Only gaps between the first and the last track matter, the ends are silent by design
+    auto transiting = onsets.front() >= 0 && onsets.back() < 0;
+    auto silent = info.buffer->getMagnitude(info.startSample, info.numSamples) < kSilenceLevel;
+
+    if (silent && transiting) {
+        if (silenceStart < 0) {
+            silenceStart = framesOutput;
+        }
+    }
+    else if (silenceStart >= 0) {
+        if ((framesOutput - silenceStart) / outputSampleRate > options.maxGap) {
+            gaps.emplace_back(silenceStart, framesOutput);
+        }
+
+        silenceStart = -1;
+    }
+
+    framesOutput += info.numSamples;
+}
+
+void PlayoutHarness::log(medley::LogLevel level, juce::String& name, juce::String& msg) const
+{
+    if (options.verbose || level >= LogLevel::Warn) {
+        std::cerr << "[" << name << "] " << msg << std::endl;
+    }
+}
+
+void PlayoutHarness::evaluate()
+{
+    ScopedLock sl(lock);
+
+    failures.clear();
+
+    if (timedOut) {
+        failures.add("Timed out after " + String(elapsed, 1) + "s, " + String((int)startOrder.size()) + " of " + String(tracks.size()) + " tracks started");
+    }
+
+    for (int i = 0; i < (int)startOrder.size(); i++) {
+        if (startOrder[i] != i) {
+            failures.add("Track " + String(startOrder[i]) + " was started out of order at #" + String(i));
+            break;
+        }
+    }
+
+    for (int i = 0; i < tracks.size(); i++) {
+        if (onsets[i] < 0) {
+            failures.add("Track " + String(i) + " was never heard");
+        }
+    }
+
+    for (const auto& t : transitions) {
+        auto name = "Transition " + String(t.from) + " -> " + String(t.to);
+
+        // A negative start means the next deck was started as soon as possible, nothing to compare against
+        if (t.expectedStart.getEnd() >= 0.0) {
+            auto lateness = getLateness(t);
+
+            if (std::abs(lateness) > options.startTolerance) {
+                failures.add(name + " started " + String(lateness * 1000.0, 1) + "ms off the cue points");
+            }
+        }
+
+        for (size_t i = 1; i < t.fadeOut.size(); i++) {
+            if (t.fadeOut[i].second > t.fadeOut[i - 1].second + kFadeEpsilon) {
+                failures.add(name + " fade out is not monotonic at " + String(t.fadeOut[i].first, 3) + "s");
+                break;
+            }
+        }
+
+        for (size_t i = 1; i < t.fadeIn.size(); i++) {
+            if (t.fadeIn[i].second + kFadeEpsilon < t.fadeIn[i - 1].second) {
+                failures.add(name + " fade in is not monotonic at " + String(t.fadeIn[i].first, 3) + "s");
+                break;
+            }
+        }
+    }
+
+    for (const auto& [start, end] : gaps) {
+        failures.add("Output gap of " + String((end - start) * 1000.0 / outputSampleRate, 1) + "ms at " + String(start / outputSampleRate, 3) + "s");
+    }
+
+    if (options.maxCpu > 0.0 && cpuMax > options.maxCpu) {
+        failures.add("CPU usage peaked at " + String(cpuMax * 100.0, 1) + "%");
+    }
+}
+
+var PlayoutHarness::toVar() const
+{
+    ScopedLock sl(lock);
+
+    auto report = new DynamicObject();
+
+    Array<var> trackList;
+    for (auto track : tracks) {
+        trackList.add(track->getSpec().toVar());
+    }
+
+    Array<var> transitionList;
+    for (const auto& t : transitions) {
+        auto obj = new DynamicObject();
+        obj->setProperty("from", t.from);
+        obj->setProperty("to", t.to);
+        obj->setProperty("expectedStart", Array<var>{ t.expectedStart.getStart(), t.expectedStart.getEnd() });
+        obj->setProperty("actualStart", t.actualStart);
+        obj->setProperty("lateness", t.expectedStart.getEnd() >= 0.0 ? var(getLateness(t)) : var());
+        obj->setProperty("leadingDuration", t.leadingDuration);
+        obj->setProperty("finalVolume", t.finalVolume);
+        obj->setProperty("fadeOut", curveToVar(t.fadeOut));
+        obj->setProperty("fadeIn", curveToVar(t.fadeIn));
+
+        if (t.to >= 0 && t.from >= 0 && onsets[t.to] >= 0 && onsets[t.from] >= 0) {
+            obj->setProperty("onsetDelta", (onsets[t.to] - onsets[t.from]) / outputSampleRate);
+        }
+
+        transitionList.add(var(obj));
+    }
+
+    Array<var> onsetList;
+    for (auto frame : onsets) {
+        onsetList.add(frame);
+    }
+
+    Array<var> gapList;
+    for (const auto& [start, end] : gaps) {
+        gapList.add(Array<var>{ (int64)start, (int64)end });
+    }
+
+    auto cpu = new DynamicObject();
+    cpu->setProperty("mean", cpuCount > 0 ? cpuTotal / cpuCount : 0.0);
+    cpu->setProperty("max", cpuMax);
+
+    report->setProperty("passed", failures.isEmpty());
+    report->setProperty("elapsed", elapsed);
+    report->setProperty("sampleRate", outputSampleRate);
+    report->setProperty("framesOutput", (int64)framesOutput);
+    report->setProperty("tracks", trackList);
+    report->setProperty("onsets", onsetList);
+    report->setProperty("transitions", transitionList);
+    report->setProperty("gaps", gapList);
+    report->setProperty("cpu", var(cpu));
+
+    Array<var> failureList;
+    for (const auto& f : failures) {
+        failureList.add(f);
+    }
+
+    report->setProperty("failures", failureList);
+
+    return var(report);
+}
+
+}
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+#include "Medley.h"
+#include "TestTracks.h"
+
+using namespace juce;
+
+namespace medley {
+namespace harness {
+
+/**
+ * Plays a list of test tracks through Medley on the Null device and records how the transitions actually happened
+ */
+class PlayoutHarness : public Medley::Callback, public Medley::AudioCallback, public IQueue, private ILoggerWriter {
+public:
+    struct Options {
+        /**
+         * Allowed difference between the expected and the actual start of the next deck, in seconds
+         */
+        double startTolerance = 0.05;
+
+        /**
+         * Longest silence allowed in the output while transiting, in seconds
+         */
+        double maxGap = 0.1;
+
+        /**
+         * Fail when the device CPU usage goes above this value (0.0 - 1.0), disabled when <= 0
+         */
+        double maxCpu = 0.0;
+
+        double timeout = 0.0;
+
+        bool verbose = false;
+    };
+
+    PlayoutHarness(const ReferenceCountedArray<TestTrack>& tracks, const Options& options);
+
+    ~PlayoutHarness();
+
+    /**
+     * Blocks until all tracks have been played or the timeout is reached
+     *
+     * @return true if all tracks were played and every assertion passed
+     */
+    bool run();
+
+    const StringArray& getFailures() const { return failures; }
+
+    var toVar() const;
+
+    // IQueue
+    size_t count() const override;
+
+    ITrack::Ptr fetchNextTrack() override;
+
+    ITrack::Ptr peek(size_t index) const override;
+
+private:
+    struct Transition {
+        int from = -1;
+        int to = -1;
+        /**
+         * Where the next deck should be started, a single position when pinned by cue points.
+         * Otherwise it spans the positions the fade out and the fade in could be detected at
+         */
+        Range<double> expectedStart{ -1.0, -1.0 };
+        double actualStart = 0.0;
+        double leadingDuration = 0.0;
+        bool fromFinished = false;
+        double finalVolume = 1.0;
+        std::vector<std::pair<double, float>> fadeOut;
+        std::vector<std::pair<double, float>> fadeIn;
+    };
+
+    // Medley::Callback
+    void deckTrackScanning(Deck& sender) override {}
+
+    void deckTrackScanned(Deck& sender) override {}
+
+    void deckPosition(Deck& sender, double position) override;
+
+    void deckStarted(Deck& sender, TrackPlay& track) override;
+
+    void deckFinished(Deck& sender, TrackPlay& track) override;
+
+    void deckLoaded(Deck& sender, TrackPlay& track) override {}
+
+    void deckUnloaded(Deck& sender, TrackPlay& track) override;
+
+    void audioDeviceChanged() override {}
+
+    void enqueueNext(EnqueueNextDone done) override;
+
+    void mainDeckChanged(Deck& sender, TrackPlay& track) override {}
+
+    // The queue is locked and its tracks are engine objects, refreshed right away
+    void trackFetched() override { medley->queueChanged(); }
+
+    // Medley::AudioCallback
+    void audioDeviceUpdate(juce::AudioIODevice* device, const AudioDeviceConfig& config) override;
+
+    void audioData(const AudioSourceChannelInfo& info, double timestamp) override;
+
+    // ILoggerWriter
+    void log(medley::LogLevel level, juce::String& name, juce::String& msg) const override;
+
+    int indexOf(Deck& deck) const;
+
+    Transition* findTransitionFrom(int trackIndex);
+
+    /**
+     * How far the actual start is outside of the expected range, negative when too early
+     */
+    static double getLateness(const Transition& t);
+
+    void evaluate();
+
+    ReferenceCountedArray<TestTrack> tracks;
+    Options options;
+
+    CriticalSection lock;
+
+    ReferenceCountedArray<ITrack> queue;
+    int nextToEnqueue = 0;
+
+    std::unique_ptr<Medley> medley;
+
+    std::vector<Transition> transitions;
+    std::vector<int> startOrder;
+    WaitableEvent done;
+
+    double outputSampleRate = 48000.0;
+    int64 framesOutput = 0;
+    std::vector<int64> onsets;
+
+    int64 silenceStart = -1;
+    std::vector<std::pair<int64, int64>> gaps;
+
+    double cpuTotal = 0.0;
+    double cpuMax = 0.0;
+    int cpuCount = 0;
+
+    double elapsed = 0.0;
+    bool timedOut = false;
+
+    StringArray failures;
+};
+
+}
+}
@@ -0,0 +1,212 @@
+#include "TestTracks.h"
+#include <taglib/flacfile.h>
+#include <taglib/xiphcomment.h>
+
+namespace medley {
+namespace harness {
+
+namespace {
+    constexpr float kAmplitude = 0.5f;
+
+    juce::String formatSeconds(double seconds) {
+        return String(seconds, 3);
+    }
+}
+
+var TrackSpec::toVar() const
+{
+    auto obj = new DynamicObject();
+    obj->setProperty("index", index);
+    obj->setProperty("frequency", frequency);
+    obj->setProperty("leadingSilence", leadingSilence);
+    obj->setProperty("fadeIn", fadeIn);
+    obj->setProperty("body", body);
+    obj->setProperty("fadeOut", fadeOut);
+    obj->setProperty("tail", tail);
+    obj->setProperty("cueIn", cueIn);
+    obj->setProperty("cueOut", cueOut);
+    obj->setProperty("taggedCueIn", taggedCueIn);
+    obj->setProperty("taggedCueOut", taggedCueOut);
+    return var(obj);
+}
+
+TestTracks::TestTracks(const File& directory)
+    : directory(directory)
+{
+
+}
+
+TestTracks::~TestTracks()
+{
+    tracks.clear();
+    directory.deleteRecursively();
+}
+
+TrackSpec TestTracks::makeSpec(int index)
+{
+    TrackSpec spec;
+    spec.index = index;
+    // Multiples of 100Hz land exactly on a bin for 480 samples blocks at 48kHz
+    spec.frequency = 300.0 + 200.0 * index;
+
+    switch (index % 4) {
+    case 0:
+        // Hard start, long fade out and a silence tail
+        spec.body = 6.0;
+        spec.fadeOut = 3.0;
+        spec.tail = 2.0;
+        break;
+
+    case 1:
+        // Leading silence, long lead-in, cue-in tag inside the fade in
+        spec.leadingSilence = 0.5;
+        spec.fadeIn = 3.0;
+        spec.body = 5.0;
+        spec.fadeOut = 2.0;
+        spec.tail = 1.0;
+        spec.taggedCueIn = 1.0;
+        break;
+
+    case 2:
+        // Hard end followed by a long silence, cue-out provided by the track
+        spec.fadeIn = 0.05;
+        spec.body = 7.0;
+        spec.tail = 3.0;
+        spec.cueOut = spec.fadeIn + spec.body - 1.0;
+        break;
+
+    default:
+        // Short lead-in, very long fade out cut by a cue-out tag
+        spec.leadingSilence = 0.2;
+        spec.fadeIn = 1.0;
+        spec.body = 6.0;
+        spec.fadeOut = 4.0;
+        spec.tail = 0.5;
+        spec.taggedCueOut = spec.leadingSilence + spec.fadeIn + spec.body + spec.fadeOut - 1.5;
+        break;
+    }
+
+    return spec;
+}
+
+bool TestTracks::generate(int count, juce::String& error)
+{
+    if (!directory.createDirectory()) {
+        error = "Could not create " + directory.getFullPathName();
+        return false;
+    }
+
+    for (int i = 0; i < count; i++) {
+        auto spec = makeSpec(i);
+        auto tagged = spec.taggedCueIn >= 0.0 || spec.taggedCueOut >= 0.0;
+
+        auto file = render(spec, tagged);
+        if (file == File()) {
+            error = "Could not render track " + String(i);
+            return false;
+        }
+
+        if (tagged && !writeCueTags(file, spec)) {
+            error = "Could not write cue tags to " + file.getFullPathName();
+            return false;
+        }
+
+        tracks.add(new TestTrack(spec, file));
+    }
+
+    return true;
+}
+
+File TestTracks::render(const TrackSpec& spec, bool flac)
+{
+    std::unique_ptr<AudioFormat> format;
+
+    if (flac) {
+        format = std::make_unique<FlacAudioFormat>();
+    }
+    else {
+        format = std::make_unique<WavAudioFormat>();
+    }
+
+    auto file = directory.getChildFile("track-" + String(spec.index).paddedLeft('0', 2) + format->getFileExtensions()[0]);
+    auto stream = file.createOutputStream();
+
+    if (stream == nullptr) {
+        return {};
+    }
+
+    auto rawStream = stream.release();
+    std::unique_ptr<AudioFormatWriter> writer(format->createWriterFor(rawStream, kSampleRate, 2, 16, {}, 0));
+
+    if (writer == nullptr) {
+        delete rawStream;
+        return {};
+    }
+
+    auto toSamples = [](double seconds) { return (int)std::round(seconds * kSampleRate); };
+
+    const auto leading = toSamples(spec.leadingSilence);
+    const auto fadeIn = toSamples(spec.fadeIn);
+    const auto body = toSamples(spec.body);
+    const auto fadeOut = toSamples(spec.fadeOut);
+    const auto total = toSamples(spec.getDuration());
+
+    AudioBuffer<float> buffer(2, total);
+    buffer.clear();
+
+    const auto delta = MathConstants<double>::twoPi * spec.frequency / kSampleRate;
+    const auto toneStart = leading;
+    const auto toneEnd = leading + fadeIn + body + fadeOut;
+
+    for (int i = toneStart; i < toneEnd; i++) {
+        auto n = i - toneStart;
+        auto gain = 1.0f;
+
+        if (n < fadeIn) {
+            gain = (float)n / (float)fadeIn;
+        }
+        else if (n >= fadeIn + body) {
+            gain = 1.0f - (float)(n - fadeIn - body) / (float)jmax(1, fadeOut);
+        }
+
+        auto s = kAmplitude * gain * (float)std::sin(delta * n);
+        buffer.setSample(0, i, s);
+        buffer.setSample(1, i, s);
+    }
+
+    if (!writer->writeFromAudioSampleBuffer(buffer, 0, total)) {
+        return {};
+    }
+
+    return file;
+}
+
+bool TestTracks::writeCueTags(const File& file, const TrackSpec& spec)
+{
+#ifdef _WIN32
+    TagLib::FileName fileName((const wchar_t*)file.getFullPathName().toWideCharPointer());
+#else
+    TagLib::FileName fileName(file.getFullPathName().toRawUTF8());
+#endif
+
+    TagLib::FLAC::File flacFile(fileName, false);
+
+    if (!flacFile.isValid()) {
+        return false;
+    }
+
+    auto comment = flacFile.xiphComment(true);
+
+    if (spec.taggedCueIn >= 0.0) {
+        comment->addField("CUE-IN", formatSeconds(spec.taggedCueIn).toRawUTF8());
+    }
+
+    if (spec.taggedCueOut >= 0.0) {
+        comment->addField("CUE-OUT", formatSeconds(spec.taggedCueOut).toRawUTF8());
+    }
+
+    return flacFile.save();
+}
+
+}
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "ITrack.h"
+
+using namespace juce;
+
+namespace medley {
+namespace harness {
+
+/**
+ * Shape of a generated test track, all durations are in seconds
+ */
+struct TrackSpec {
+    int index = 0;
+    double frequency = 1000.0;
+
+    double leadingSilence = 0.0;
+    double fadeIn = 0.0;
+    double body = 0.0;
+    double fadeOut = 0.0;
+    double tail = 0.0;
+
+    /**
+     * Cue points provided by the track itself (ITrack), -1 when not provided
+     */
+    double cueIn = -1.0;
+    double cueOut = -1.0;
+
+    /**
+     * Cue points written into the file as CUE-IN/CUE-OUT tags, -1 when not written
+     */
+    double taggedCueIn = -1.0;
+    double taggedCueOut = -1.0;
+
+    double getDuration() const { return leadingSilence + fadeIn + body + fadeOut + tail; }
+
+    var toVar() const;
+};
+
+class TestTrack : public ITrack {
+public:
+    using Ptr = ReferenceCountedObjectPtr<TestTrack>;
+
+    TestTrack(const TrackSpec& spec, const File& file)
+        : spec(spec), file(file)
+    {
+
+    }
+
+    File getFile() override { return file; }
+
+    double getCueInPosition() override { return spec.cueIn; }
+
+    double getCueOutPosition() override { return spec.cueOut; }
+
+    const TrackSpec& getSpec() const { return spec; }
+
+private:
+    TrackSpec spec;
+    File file;
+};
+
+/**
+ * Deterministically generate tones with known fades, silence tails and cue points
+ */
+class TestTracks {
+public:
+    static constexpr double kSampleRate = 44100.0;
+
+    explicit TestTracks(const File& directory);
+
+    ~TestTracks();
+
+    /**
+     * Generate `count` tracks cycling through a fixed set of shapes
+     */
+    bool generate(int count, juce::String& error);
+
+    const ReferenceCountedArray<TestTrack>& getTracks() const { return tracks; }
+
+    static TrackSpec makeSpec(int index);
+
+private:
+    File render(const TrackSpec& spec, bool flac);
+
+    bool writeCueTags(const File& file, const TrackSpec& spec);
+
+    File directory;
+    ReferenceCountedArray<TestTrack> tracks;
+};
+
+}
+}
@@ -0,0 +1,115 @@
+#include <JuceHeader.h>
+#include <iostream>
+
+#include "PlayoutHarness.h"
+#include "TestTracks.h"
+#include "Trace.h"
+
+using namespace juce;
+using namespace medley::harness;
+
+namespace {
+    void printUsage() {
+        std::cerr
+            << "Usage: medley-playout-harness [options]" << std::endl
+            << "  --tracks <n>          Number of generated tracks to play (default 6)" << std::endl
+            << "  --start-tolerance <ms> Allowed transition start error (default 50)" << std::endl
+            << "  --max-gap <ms>        Longest allowed silence while transiting (default 100)" << std::endl
+            << "  --max-cpu <percent>   Fail if the device CPU usage goes above this value" << std::endl
+            << "  --timeout <s>         Give up after this many seconds (default total duration + 30)" << std::endl
+            << "  --output <file>       Write JSON report to <file> instead of stdout" << std::endl
+            << "  --trace <file>        Write a Chrome trace-event timeline to <file>" << std::endl
+            << "  --verbose             Print engine logs" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    PlayoutHarness::Options options;
+    int numTracks = 6;
+    File outputFile;
+    File traceFile;
+
+    for (int i = 1; i < argc; i++) {
+        String arg(argv[i]);
+        auto hasValue = i + 1 < argc;
+
+        if (arg == "--tracks" && hasValue) {
+            numTracks = jmax(2, String(argv[++i]).getIntValue());
+        }
+        else if (arg == "--start-tolerance" && hasValue) {
+            options.startTolerance = String(argv[++i]).getDoubleValue() / 1000.0;
+        }
+        else if (arg == "--max-gap" && hasValue) {
+            options.maxGap = String(argv[++i]).getDoubleValue() / 1000.0;
+        }
+        else if (arg == "--max-cpu" && hasValue) {
+            options.maxCpu = String(argv[++i]).getDoubleValue() / 100.0;
+        }
+        else if (arg == "--timeout" && hasValue) {
+            options.timeout = String(argv[++i]).getDoubleValue();
+        }
+        else if (arg == "--output" && hasValue) {
+            outputFile = File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        }
+        else if (arg == "--trace" && hasValue) {
+            traceFile = File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        }
+        else if (arg == "--verbose") {
+            options.verbose = true;
+        }
+        else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    TestTracks testTracks(File::getSpecialLocation(File::tempDirectory).getNonexistentChildFile("medley-harness", ""));
+
+    String error;
+    if (!testTracks.generate(numTracks, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    var report;
+    bool passed = false;
+
+    if (traceFile != File()) {
+        medley::Trace::setEnabled(true);
+    }
+
+    {
+        PlayoutHarness harness(testTracks.getTracks(), options);
+        passed = harness.run();
+        report = harness.toVar();
+
+        for (const auto& failure : harness.getFailures()) {
+            std::cerr << "FAIL: " << failure << std::endl;
+        }
+    }
+
+    if (traceFile != File()) {
+        medley::Trace::setEnabled(false);
+
+        if (!traceFile.replaceWithText(medley::Trace::toJSON())) {
+            std::cerr << "Could not write " << traceFile.getFullPathName() << std::endl;
+        }
+    }
+
+    auto json = JSON::toString(report);
+
+    if (outputFile != File()) {
+        if (!outputFile.replaceWithText(json)) {
+            std::cerr << "Could not write " << outputFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else {
+        std::cout << json << std::endl;
+    }
+
+    std::cerr << (passed ? "PASSED" : "FAILED") << std::endl;
+
+    return passed ? 0 : 1;
+}
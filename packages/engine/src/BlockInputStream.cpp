@@ -0,0 +1,209 @@
+#include "BlockInputStream.h"
+#include "Trace.h"
+
+namespace medley {
+
+namespace {
+    constexpr int kNumIoThreads = 4;
+
+    // Waiting is done in steps, the event is shared by reads ahead and reads being waited on
+    constexpr int kWaitInterval = 100;
+}
+
+BlockInputStream::BlockInputStream(const File& file)
+{
+    auto source = std::make_unique<FileInputStream>(file);
+
+    if (source->failedToOpen()) {
+        return;
+    }
+
+    length = source->getTotalLength();
+
+    shared = std::make_shared<Shared>();
+    shared->source = std::move(source);
+}
+
+BlockInputStream::~BlockInputStream()
+{
+    if (shared == nullptr) {
+        return;
+    }
+
+    // A block being read is dropped along with the shared state, once read
+    ScopedLock sl(shared->lock);
+    shared->closed = true;
+    shared->pending.clear();
+}
+
+int BlockInputStream::read(void* destBuffer, int maxBytesToRead)
+{
+    if (shared == nullptr || maxBytesToRead <= 0) {
+        return 0;
+    }
+
+    auto sequential = position == lastReadEnd;
+    auto remaining = jmin((int64)maxBytesToRead, length - position);
+    auto dest = static_cast<char*>(destBuffer);
+    int numRead = 0;
+
+    while (remaining > 0) {
+        auto index = position / blockSize;
+        auto offset = (int)(position % blockSize);
+
+        schedule(index, sequential);
+
+        auto block = waitForBlock(index);
+
+        if (block == nullptr || block->size <= offset) {
+            break;
+        }
+
+        auto numBytes = (int)jmin(remaining, (int64)(block->size - offset));
+        memcpy(dest + numRead, block->data + offset, (size_t)numBytes);
+
+        numRead += numBytes;
+        position += numBytes;
+        remaining -= numBytes;
+
+        // Crossing into the next block
+        sequential = true;
+    }
+
+    lastReadEnd = position;
+    return numRead;
+}
+
+bool BlockInputStream::setPosition(int64 newPosition)
+{
+    position = jlimit((int64)0, length, newPosition);
+    return true;
+}
+
+void BlockInputStream::schedule(int64 index, bool sequential)
+{
+    const auto lastIndex = (length - 1) / blockSize;
+    const auto windowEnd = jmin(lastIndex, index + (sequential ? windowSize : 1) - 1);
+
+    ScopedLock sl(shared->lock);
+
+    auto& blocks = shared->blocks;
+    auto& pending = shared->pending;
+
+    // The previous block is kept, decoders often step back a little
+    for (auto it = blocks.begin(); it != blocks.end();) {
+        it = (it->first < index - 1 || it->first >= index + windowSize) ? blocks.erase(it) : std::next(it);
+    }
+
+    pending.erase(std::remove_if(pending.begin(), pending.end(), [&](int64 i) { return blocks.find(i) == blocks.end(); }), pending.end());
+
+    for (auto i = index; i <= windowEnd; i++) {
+        if (blocks.find(i) == blocks.end()) {
+            blocks[i];
+            pending.push_back(i);
+        }
+    }
+
+    // The block needed right now goes first
+    auto it = std::find(pending.begin(), pending.end(), index);
+
+    if (it != pending.begin() && it != pending.end()) {
+        pending.erase(it);
+        pending.push_front(index);
+    }
+
+    if (!shared->fetching && !pending.empty()) {
+        shared->fetching = true;
+        getPool().addJob([s = shared] { fetch(s); });
+    }
+}
+
+const BlockInputStream::Block* BlockInputStream::waitForBlock(int64 index)
+{
+    std::unique_ptr<Trace::ScopedSpan> span;
+
+    for (;;) {
+        {
+            ScopedLock sl(shared->lock);
+
+            auto it = shared->blocks.find(index);
+
+            // Dropped because it could not be read, it will be read again by the next call to read()
+            if (it == shared->blocks.end()) {
+                return nullptr;
+            }
+
+            if (it->second.ready) {
+                return &it->second;
+            }
+        }
+
+        if (span == nullptr) {
+            span = std::make_unique<Trace::ScopedSpan>("waitForBlock", "io");
+        }
+
+        shared->blockReady.wait(kWaitInterval);
+    }
+}
+
+void BlockInputStream::fetch(std::shared_ptr<Shared> shared)
+{
+    for (;;) {
+        int64 index;
+
+        {
+            ScopedLock sl(shared->lock);
+
+            if (shared->closed || shared->pending.empty()) {
+                shared->fetching = false;
+                return;
+            }
+
+            index = shared->pending.front();
+            shared->pending.pop_front();
+
+            // Scheduled again after going out of the window while it was being read, it is already there
+            auto it = shared->blocks.find(index);
+
+            if (it == shared->blocks.end() || it->second.ready) {
+                continue;
+            }
+        }
+
+        HeapBlock<char> data(blockSize);
+        int size = 0;
+
+        if (shared->source->setPosition(index * blockSize)) {
+            size = shared->source->read(data, blockSize);
+        }
+
+        {
+            ScopedLock sl(shared->lock);
+
+            // Otherwise it went out of the window while being read
+            auto it = shared->blocks.find(index);
+
+            // A ready block may be being copied from by the reader, it is never touched again
+            if (it != shared->blocks.end() && !it->second.ready) {
+                if (size > 0) {
+                    it->second.data = std::move(data);
+                    it->second.size = size;
+                    it->second.ready = true;
+                }
+                else {
+                    shared->blocks.erase(it);
+                }
+            }
+        }
+
+        shared->blockReady.signal();
+    }
+}
+
+ThreadPool& BlockInputStream::getPool()
+{
+    static ThreadPool pool(kNumIoThreads);
+    return pool;
+}
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <deque>
+#include <map>
+
+namespace medley {
+
+/**
+ * A file input stream for decoders, reads are served from large blocks aligned on the block size
+ *
+ * Blocks are read by a small pool of I/O threads shared by every stream of the process, while reading sequentially the blocks following
+ * the current position are read ahead, up to a window. Each stream has at most one read in flight, a file stalling on slow or network storage
+ * holds up a single I/O thread and the thread reading that stream, other streams keep being served.
+ *
+ * Like FileInputStream, a stream must only be read from one thread at a time.
+ */
+class BlockInputStream : public InputStream {
+public:
+    static constexpr int blockSize = 256 * 1024;
+
+    /**
+     * Number of blocks read ahead while reading sequentially, including the current one
+     */
+    static constexpr int windowSize = 8;
+
+    explicit BlockInputStream(const File& file);
+
+    ~BlockInputStream() override;
+
+    bool failedToOpen() const { return shared == nullptr; }
+
+    int64 getTotalLength() override { return length; }
+
+    bool isExhausted() override { return position >= length; }
+
+    int read(void* destBuffer, int maxBytesToRead) override;
+
+    int64 getPosition() override { return position; }
+
+    bool setPosition(int64 newPosition) override;
+
+private:
+    struct Block {
+        HeapBlock<char> data;
+        int size = 0;
+        bool ready = false;
+    };
+
+    /**
+     * Outlives the stream while a block is being read
+     */
+    struct Shared {
+        std::unique_ptr<FileInputStream> source;
+
+        CriticalSection lock;
+        std::map<int64, Block> blocks;
+        std::deque<int64> pending;
+        bool fetching = false;
+        bool closed = false;
+
+        WaitableEvent blockReady;
+    };
+
+    /**
+     * Runs on the I/O pool until no block is pending
+     */
+    static void fetch(std::shared_ptr<Shared> shared);
+
+    static ThreadPool& getPool();
+
+    /**
+     * Request the block at index and the window following it if reading sequentially, blocks out of the window are dropped
+     */
+    void schedule(int64 index, bool sequential);
+
+    /**
+     * Block until the block at index has been read, nullptr if it could not be read
+     */
+    const Block* waitForBlock(int64 index);
+
+    std::shared_ptr<Shared> shared;
+
+    int64 length = 0;
+    int64 position = 0;
+    int64 lastReadEnd = 0;
+};
+
+}
@@ -0,0 +1,123 @@
+#include "CoverArt.h"
+#include "Trace.h"
+
+namespace {
+
+constexpr uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+
+inline uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+}
+
+juce::String medley::CoverArt::getHash(const TagLib::ByteVector& data)
+{
+    const auto bytes = (const uint8_t*)data.data();
+    const auto size = (size_t)data.size();
+
+    if (size == 0) {
+        return {};
+    }
+
+    // Not xxHash64, only its primes and its final avalanche are borrowed: a single lane of multiply-rotate rounds
+    // over 64-bit words, the tail is taken byte by byte. Hashes are only ever compared with hashes from this same function
+    uint64_t hash = prime1 ^ (uint64_t)size;
+    size_t i = 0;
+
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof(word));
+        hash = rotl(hash + word * prime2, 31) * prime1;
+    }
+
+    for (; i < size; i++) {
+        hash = rotl(hash ^ (bytes[i] * prime1), 11) * prime2;
+    }
+
+    // Avalanche of xxHash64, every input bit affects every output bit
+    hash ^= hash >> 33;
+    hash *= prime2;
+    hash ^= hash >> 29;
+    hash *= prime1;
+    hash ^= hash >> 32;
+
+    return String::toHexString((int64)hash).paddedLeft('0', 16);
+}
+
+std::shared_ptr<const medley::CoverArt::Thumbnail> medley::CoverArt::getThumbnail(const Metadata::Cover& cover, const juce::String& hash, int size)
+{
+    if (hash.isEmpty() || size <= 0) {
+        return nullptr;
+    }
+
+    auto& cache = getCache();
+    auto key = (hash + "|" + String(size)).toStdString();
+
+    std::shared_ptr<const Thumbnail> thumbnail;
+
+    // Pictures failing to decode are cached as well
+    if (cache.find(key, thumbnail)) {
+        return thumbnail;
+    }
+
+    thumbnail = createThumbnail(cover.getData(), size);
+    cache.set(key, thumbnail);
+
+    return thumbnail;
+}
+
+std::shared_ptr<const medley::CoverArt::Thumbnail> medley::CoverArt::createThumbnail(const TagLib::ByteVector& data, int size)
+{
+    medley::Trace::ScopedSpan span("createThumbnail", "io");
+
+    auto image = ImageFileFormat::loadFrom(data.data(), (size_t)data.size());
+
+    if (!image.isValid()) {
+        return nullptr;
+    }
+
+    auto scale = jmin(1.0, (double)size / jmax(image.getWidth(), image.getHeight()));
+
+    if (scale < 1.0) {
+        image = image.rescaled(
+            jmax(1, roundToInt(image.getWidth() * scale)),
+            jmax(1, roundToInt(image.getHeight() * scale)),
+            Graphics::highResamplingQuality
+        );
+    }
+
+    auto thumbnail = std::make_shared<Thumbnail>();
+    thumbnail->width = image.getWidth();
+    thumbnail->height = image.getHeight();
+
+    bool written;
+
+    {
+        MemoryOutputStream stream(thumbnail->data, false);
+
+        if (image.hasAlphaChannel()) {
+            PNGImageFormat png;
+            written = png.writeImageToStream(image, stream);
+            thumbnail->mimeType = "image/png";
+        }
+        else {
+            JPEGImageFormat jpeg;
+            jpeg.setQuality(0.85f);
+            written = jpeg.writeImageToStream(image, stream);
+            thumbnail->mimeType = "image/jpeg";
+        }
+    }
+
+    return written ? thumbnail : nullptr;
+}
+
+void medley::CoverArt::clearCache()
+{
+    getCache().clear();
+}
+
+medley::LruCache<std::shared_ptr<const medley::CoverArt::Thumbnail>>& medley::CoverArt::getCache()
+{
+    static LruCache<std::shared_ptr<const Thumbnail>> cache(capacity);
+    return cache;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "Metadata.h"
+#include "LruCache.h"
+
+namespace medley {
+
+/**
+ * Content hashes and thumbnails of cover art
+ *
+ * Thumbnails are cached by the hash of the picture they are made from, a cover shared by every track of an album is decoded and resized only once.
+ */
+class CoverArt {
+public:
+    class Thumbnail
+    {
+    public:
+        const MemoryBlock& getData() const { return data; }
+
+        const juce::String& getMimeType() const { return mimeType; }
+
+        int getWidth() const { return width; }
+
+        int getHeight() const { return height; }
+
+    private:
+        friend class CoverArt;
+
+        MemoryBlock data;
+        juce::String mimeType;
+        int width = 0;
+        int height = 0;
+    };
+
+    static constexpr size_t capacity = 256;
+
+    /**
+     * 16 hex digits, not a cryptographic hash. Empty for empty data
+     */
+    static juce::String getHash(const TagLib::ByteVector& data);
+
+    /**
+     * The cover scaled down to fit in size x size pixels, never scaled up.
+     * Encoded as JPEG, or as PNG if the picture has transparency. nullptr if the picture could not be decoded
+     */
+    static std::shared_ptr<const Thumbnail> getThumbnail(const Metadata::Cover& cover, const juce::String& hash, int size);
+
+    static void clearCache();
+
+private:
+    static std::shared_ptr<const Thumbnail> createThumbnail(const TagLib::ByteVector& data, int size);
+
+    static LruCache<std::shared_ptr<const Thumbnail>>& getCache();
+};
+
+}
@@ -1,38 +1,73 @@
 #include "DeFXKaraoke.h"
+#include "Simd.h"
 
 using namespace juce;
 using namespace dsp;
+using namespace medley;
 
-DeFXKaraoke::DeFXKaraoke()
-{
-    lastLowpassCutOff = lowpassCutOff;
-    lastLowpassQ = lowpassQ;
+namespace {
+    // Filter coefficients are recomputed this often while being ramped
+    constexpr int kFilterRampInterval = 32;
 
-    lastHighpassCutOff = highpassCutOff;
-    lastHighpassQ = highpassQ;
+    constexpr float kLaneOffsets[4] = { 1.0f, 2.0f, 3.0f, 4.0f };
+
+    // In the order of DeFXKaraoke::Param
+    constexpr float kDefaults[DeFXKaraoke::numParams] = { 0.8f, 0.65f, 125.0f, 3.5f, 7000.0f, 2.0f };
+}
 
-    lowPassFilter = std::make_unique<IIR::Filter<double>>();
-    highPassFilter = std::make_unique<IIR::Filter<double>>();
+DeFXKaraoke::DeFXKaraoke()
+{
+    for (int i = 0; i < numParams; i++) {
+        values[i].store(kDefaults[i], std::memory_order_relaxed);
+    }
 
-    reset();
+    loadValues();
 }
 
 void DeFXKaraoke::prepare(const ProcessSpec& spec)
 {
+    const ScopedLock sl(processLock);
+
     sampleRate = spec.sampleRate;
 
-    lowPassFilter->prepare(spec);
-    highPassFilter->prepare(spec);
+    monoSize = jmax(1, (int)spec.maximumBlockSize);
+    mono.allocate(monoSize, true);
 
-    updateFilter(true);
+    loadValues();
 
-    lowPassFilter->reset();
-    highPassFilter->reset();
+    filters.reset();
+}
+
+void DeFXKaraoke::loadValues()
+{
+    // The queue is only ever popped by the audio thread, what is still queued ends up with these same values
+    for (int i = 0; i < numParams; i++) {
+        targets[i] = values[i].load(std::memory_order_relaxed);
+    }
+
+    current = targets;
+    lastFade = fade;
+
+    updateFilters(1.0f);
 }
 
 void DeFXKaraoke::process(const ProcessContextReplacing<float>& context)
 {
-    if (!enabled || (mix <= 0.0f)) {
+    const ScopedTryLock sl(processLock);
+
+    if (!sl.isLocked()) {
+        return;
+    }
+
+    applyChanges();
+
+    const auto mixFrom = at(current, Param::Mix) * lastFade;
+    const auto mixTo = at(targets, Param::Mix) * fade;
+
+    if (!enabled.load(std::memory_order_relaxed) || (mixFrom <= 0.0f && mixTo <= 0.0f)) {
+        // Nothing audible to ramp from, take the latest values as they are
+        settle();
+        bypassed = true;
         return;
     }
 
@@ -41,12 +76,15 @@ void DeFXKaraoke::process(const ProcessContextReplacing<float>& context)
 
     auto totalNumInputChannels = jmin(input.getNumChannels(), (size_t)2);
 
-    if (totalNumInputChannels < 2) {
+    if (totalNumInputChannels < 2 || monoSize <= 0) {
         // Cannot process mono channel input
+        settle();
         return;
     }
 
-    const auto numSamples = input.getNumSamples();
+    ScopedNoDenormals noDenormals;
+
+    const auto numSamples = (int)input.getNumSamples();
 
     auto in_left = input.getChannelPointer(0);
     auto in_right = input.getChannelPointer(1);
@@ -54,79 +92,256 @@ void DeFXKaraoke::process(const ProcessContextReplacing<float>& context)
     auto out_left = output.getChannelPointer(0);
     auto out_right = output.getNumChannels() > 1 ? output.getChannelPointer(1) : nullptr;
 
-    updateFilter(false);
+    if (bypassed) {
+        // Whatever left in the filters is from before being bypassed
+        filters.reset();
+        bypassed = false;
+    }
+
+    for (int start = 0; start < numSamples; start += monoSize) {
+        auto count = jmin(monoSize, numSamples - start);
 
-    for (int i = 0; i < (int)numSamples; ++i) {
-        auto l = in_left[i];
-        auto r = in_right[i];
+        processChunk(
+            in_left + start, in_right + start,
+            out_left + start, out_right != nullptr ? out_right + start : nullptr,
+            start, count, numSamples
+        );
+    }
 
-        auto mono = (l * 0.25) + (r * 0.25);
-        auto mono_filtered = (float)(lowPassFilter->processSample(mono) + highPassFilter->processSample(mono));
+    settle();
+    filters.snapToZero();
+}
+
+void DeFXKaraoke::applyChanges()
+{
+    changes.popAll([this](const ParamChange& change) {
+        at(targets, change.param) = change.value;
+    });
+
+    if (resync.exchange(false, std::memory_order_acquire)) {
+        for (int i = 0; i < numParams; i++) {
+            targets[i] = values[i].load(std::memory_order_relaxed);
+        }
+    }
+}
 
-        // Snap
-        lowPassFilter->snapToZero();
-        highPassFilter->snapToZero();
+void DeFXKaraoke::settle()
+{
+    const auto filterChanging = isFilterChanging();
 
-        auto bg = mono_filtered * 1.25f * originalBgLevel;
-        auto bgMix = bg * mix;
+    current = targets;
+    lastFade = fade;
 
-        out_left[i] = l - (r * mix) + bgMix;
+    if (filterChanging) {
+        updateFilters(1.0f);
+    }
+}
 
-        if (out_right != nullptr) {
-            out_right[i] = r - (l * mix) + bgMix;
+bool DeFXKaraoke::isFilterChanging() const
+{
+    for (auto param : { Param::LowPassCutOff, Param::LowPassQ, Param::HighPassCutOff, Param::HighPassQ }) {
+        if (at(current, param) != at(targets, param)) {
+            return true;
         }
     }
+
+    return false;
 }
 
-void DeFXKaraoke::reset()
+void DeFXKaraoke::updateFilters(float position)
 {
-    mix = 0.8f;
-    originalBgLevel = 0.65f;
+    // Cut-off frequencies are ramped on a log scale
+    auto ramp = [&](Param param, bool logarithmic) {
+        const auto from = at(current, param);
+        const auto to = at(targets, param);
 
-    lowpassCutOff = 125.0f;
-    lowpassQ = 3.5f;
+        if (position >= 1.0f || from == to) {
+            return (double)to;
+        }
 
-    highpassCutOff = 7000.0f;
-    highpassQ = 2.0f;
+        return logarithmic
+            ? from * std::pow((double)to / from, (double)position)
+            : from + ((double)to - from) * position;
+    };
 
-    updateFilter(true);
+    filters.setLowPass(kLowPass, sampleRate, ramp(Param::LowPassCutOff, true), ramp(Param::LowPassQ, false));
+    filters.setHighPass(kHighPass, sampleRate, ramp(Param::HighPassCutOff, true), ramp(Param::HighPassQ, false));
 }
 
-bool DeFXKaraoke::isEnabled() const
+void DeFXKaraoke::processChunk(const float* inLeft, const float* inRight, float* outLeft, float* outRight, int offset, int numSamples, int blockSize)
 {
-    return enabled;
+    using simd::Float4;
+
+    auto signal = mono.get();
+
+    {
+        const auto quarter = Float4::broadcast(0.25f);
+        int i = 0;
+
+        for (; i + 4 <= numSamples; i += 4) {
+            ((Float4::load(inLeft + i) + Float4::load(inRight + i)) * quarter).store(signal + i);
+        }
+
+        for (; i < numSamples; i++) {
+            signal[i] = (inLeft[i] + inRight[i]) * 0.25f;
+        }
+    }
+
+    if (isFilterChanging()) {
+        for (int i = 0; i < numSamples; i += kFilterRampInterval) {
+            auto count = jmin(kFilterRampInterval, numSamples - i);
+
+            updateFilters((float)(offset + i + count) / (float)blockSize);
+            filters.process(signal + i, count);
+        }
+    }
+    else {
+        filters.process(signal, numSamples);
+    }
+
+    // Mix and background level ramp linearly across the whole block
+    const auto mixFrom = at(current, Param::Mix) * lastFade;
+    const auto mixStep = (at(targets, Param::Mix) * fade - mixFrom) / (float)blockSize;
+
+    const auto bgFrom = 1.25f * at(current, Param::OriginalBgLevel) * mixFrom;
+    const auto bgStep = (1.25f * at(targets, Param::OriginalBgLevel) * at(targets, Param::Mix) * fade - bgFrom) / (float)blockSize;
+
+    const auto offsets = Float4::load(kLaneOffsets);
+    const auto four = Float4::broadcast(4.0f);
+
+    auto position = Float4::broadcast((float)offset) + offsets;
+
+    int i = 0;
+
+    // Input and output may share the same memory, both channels are read before writing
+    for (; i + 4 <= numSamples; i += 4) {
+        auto mixes = Float4::broadcast(mixFrom) + Float4::broadcast(mixStep) * position;
+        auto bgGains = Float4::broadcast(bgFrom) + Float4::broadcast(bgStep) * position;
+
+        auto l = Float4::load(inLeft + i);
+        auto r = Float4::load(inRight + i);
+        auto bgMix = Float4::load(signal + i) * bgGains;
+
+        (l - (r * mixes) + bgMix).store(outLeft + i);
+
+        if (outRight != nullptr) {
+            (r - (l * mixes) + bgMix).store(outRight + i);
+        }
+
+        position = position + four;
+    }
+
+    for (; i < numSamples; i++) {
+        const auto n = (float)(offset + i + 1);
+        const auto mix = mixFrom + mixStep * n;
+        const auto bgGain = bgFrom + bgStep * n;
+
+        auto l = inLeft[i];
+        auto r = inRight[i];
+        auto bgMix = signal[i] * bgGain;
+
+        outLeft[i] = l - (r * mix) + bgMix;
+
+        if (outRight != nullptr) {
+            outRight[i] = r - (l * mix) + bgMix;
+        }
+    }
 }
 
-void DeFXKaraoke::setEnabled(bool value)
+void DeFXKaraoke::FilterPair::setLowPass(int lane, double sampleRate, double frequency, double q)
 {
-    enabled = value;
+    const auto n = 1.0 / std::tan(MathConstants<double>::pi * frequency / sampleRate);
+    const auto nSquared = n * n;
+    const auto invQ = 1.0 / q;
+    const auto c1 = 1.0 / (1.0 + invQ * n + nSquared);
+
+    b0[lane] = c1;
+    b1[lane] = c1 * 2.0;
+    b2[lane] = c1;
+    a1[lane] = c1 * 2.0 * (1.0 - nSquared);
+    a2[lane] = c1 * (1.0 - invQ * n + nSquared);
 }
 
-float DeFXKaraoke::getParam(Param index) const
+void DeFXKaraoke::FilterPair::setHighPass(int lane, double sampleRate, double frequency, double q)
 {
-    switch (index)
-    {
-    case DeFXKaraoke::Param::Mix:
-        return mix;
+    const auto n = std::tan(MathConstants<double>::pi * frequency / sampleRate);
+    const auto nSquared = n * n;
+    const auto invQ = 1.0 / q;
+    const auto c1 = 1.0 / (1.0 + invQ * n + nSquared);
+
+    b0[lane] = c1;
+    b1[lane] = c1 * -2.0;
+    b2[lane] = c1;
+    a1[lane] = c1 * 2.0 * (nSquared - 1.0);
+    a2[lane] = c1 * (1.0 - invQ * n + nSquared);
+}
 
-    case DeFXKaraoke::Param::OriginalBgLevel:
-        return originalBgLevel;
+void DeFXKaraoke::FilterPair::process(float* samples, int numSamples)
+{
+    using simd::Double2;
 
-    case DeFXKaraoke::Param::LowPassCutOff:
-        return lowpassCutOff;
+    const auto cb0 = Double2::set(b0[0], b0[1]);
+    const auto cb1 = Double2::set(b1[0], b1[1]);
+    const auto cb2 = Double2::set(b2[0], b2[1]);
+    const auto ca1 = Double2::set(a1[0], a1[1]);
+    const auto ca2 = Double2::set(a2[0], a2[1]);
 
-    case DeFXKaraoke::Param::LowPassQ:
-        return lowpassQ;
+    auto s1 = Double2::set(z1[0], z1[1]);
+    auto s2 = Double2::set(z2[0], z2[1]);
 
-    case DeFXKaraoke::Param::HighPassCutOff:
-        return highpassCutOff;
+    for (int i = 0; i < numSamples; i++) {
+        const auto in = Double2::broadcast(samples[i]);
+        const auto out = cb0 * in + s1;
 
-    case DeFXKaraoke::Param::HighPassQ:
-        return highpassQ;
+        s1 = cb1 * in - ca1 * out + s2;
+        s2 = cb2 * in - ca2 * out;
 
-    default:
+        samples[i] = (float)out.sum();
+    }
+
+    s1.store(z1);
+    s2.store(z2);
+}
+
+void DeFXKaraoke::FilterPair::snapToZero()
+{
+    for (int lane = 0; lane < 2; lane++) {
+        JUCE_SNAP_TO_ZERO(z1[lane]);
+        JUCE_SNAP_TO_ZERO(z2[lane]);
+    }
+}
+
+void DeFXKaraoke::FilterPair::reset()
+{
+    for (int lane = 0; lane < 2; lane++) {
+        z1[lane] = z2[lane] = 0.0;
+    }
+}
+
+void DeFXKaraoke::reset()
+{
+    for (int i = 0; i < numParams; i++) {
+        setParam((Param)i, kDefaults[i]);
+    }
+}
+
+bool DeFXKaraoke::isEnabled() const
+{
+    return enabled;
+}
+
+void DeFXKaraoke::setEnabled(bool value)
+{
+    enabled = value;
+}
+
+float DeFXKaraoke::getParam(Param index) const
+{
+    if ((int)index >= numParams) {
         return 0.0f;
     }
+
+    return values[(int)index].load(std::memory_order_relaxed);
 }
 
 float DeFXKaraoke::setParam(Param index, float newValue)
@@ -134,41 +349,30 @@ float DeFXKaraoke::setParam(Param index, float newValue)
     switch (index)
     {
     case DeFXKaraoke::Param::Mix:
-        return mix = jlimit(0.0f, 1.0f, newValue);
-
     case DeFXKaraoke::Param::OriginalBgLevel:
-        return originalBgLevel = jlimit(0.0f, 1.0f, newValue);
+        newValue = jlimit(0.0f, 1.0f, newValue);
+        break;
 
     case DeFXKaraoke::Param::LowPassCutOff:
-        return lowpassCutOff = jlimit(10.0f, 20000.0f, newValue);
-
-    case DeFXKaraoke::Param::LowPassQ:
-        return lowpassQ = jlimit(0.01f, 10.0f, newValue);
-
     case DeFXKaraoke::Param::HighPassCutOff:
-        return highpassCutOff = jlimit(10.0f, 20000.0f, newValue);
+        newValue = jlimit(10.0f, 20000.0f, newValue);
+        break;
 
+    case DeFXKaraoke::Param::LowPassQ:
     case DeFXKaraoke::Param::HighPassQ:
-        return highpassQ = jlimit(0.01f, 10.0f, newValue);
+        newValue = jlimit(0.01f, 10.0f, newValue);
+        break;
 
     default:
         return 0.0f;
     }
-}
 
-void DeFXKaraoke::updateFilter(bool force)
-{
-    if (force || (lowpassCutOff != lastLowpassCutOff) || (lowpassQ != lastLowpassQ)) {
-        lowPassFilter->coefficients = dsp::IIR::Coefficients<double>::makeLowPass(sampleRate, lowpassCutOff, lowpassQ);
+    values[(int)index].store(newValue, std::memory_order_relaxed);
 
-        lastLowpassCutOff = lowpassCutOff;
-        lastLowpassQ = lowpassQ;
+    if (!changes.push({ index, newValue })) {
+        // Too many changes in between two blocks, the audio thread catches up with the latest values instead
+        resync.store(true, std::memory_order_release);
     }
 
-    if (force || (highpassCutOff != lastHighpassCutOff) || (highpassQ != lastHighpassQ)) {
-        highPassFilter->coefficients = dsp::IIR::Coefficients<double>::makeHighPass(sampleRate, highpassCutOff, highpassQ);
-
-        lastHighpassCutOff = highpassCutOff;
-        lastHighpassQ = highpassQ;
-    }
+    return newValue;
 }
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include "MessageQueue.h"
 
 using namespace juce;
 using namespace dsp;
@@ -17,6 +20,8 @@ public:
         HighPassQ
     };
 
+    static constexpr int numParams = 6;
+
     DeFXKaraoke();
 
     void prepare(const ProcessSpec& spec) override;
@@ -31,30 +36,107 @@ public:
 
     float getParam(Param index) const;
 
+    /**
+     * Can be called from any thread, the change reaches the audio thread through a queue and is applied at the start of the next block,
+     * ramping from the previous value across that block. The clamped value is returned.
+     */
     float setParam(Param index, float newValue);
+
+    /**
+     * Audio thread, scales the mix without touching the Mix parameter, for fading the effect in and out
+     */
+    void setFade(float value) { fade = value; }
 private:
-    void updateFilter(bool force);
+    static constexpr int kLowPass = 0;
+    static constexpr int kHighPass = 1;
+
+    /**
+     * The low-pass and the high-pass filters are fed with the same signal,
+     * they run side by side in the two lanes of one transposed direct form II biquad
+     */
+    struct FilterPair {
+        double b0[2]{ 1.0, 1.0 }, b1[2]{}, b2[2]{}, a1[2]{}, a2[2]{};
+        double z1[2]{}, z2[2]{};
+
+        /**
+         * Same coefficients as IIR::Coefficients::makeLowPass(), without allocating
+         */
+        void setLowPass(int lane, double sampleRate, double frequency, double q);
+
+        /**
+         * Same coefficients as IIR::Coefficients::makeHighPass(), without allocating
+         */
+        void setHighPass(int lane, double sampleRate, double frequency, double q);
+
+        /**
+         * Filter in place, each sample is replaced with the sum of both lanes
+         */
+        void process(float* samples, int numSamples);
+
+        void snapToZero();
+
+        void reset();
+    };
+
+    struct ParamChange {
+        Param param;
+        float value;
+    };
+
+    using Params = std::array<float, numParams>;
+
+    static float& at(Params& params, Param index) { return params[(size_t)index]; }
+
+    static float at(const Params& params, Param index) { return params[(size_t)index]; }
+
+    /**
+     * Not on the audio thread, start from the latest requested values without ramping and without touching the queue
+     */
+    void loadValues();
+
+    /**
+     * Audio thread, pick up pending changes into targets
+     */
+    void applyChanges();
+
+    /**
+     * Audio thread, jump to the targets without ramping
+     */
+    void settle();
+
+    /**
+     * Set the filters to the parameters at the given position of the ramp from current to targets, 0 to 1
+     */
+    void updateFilters(float position);
+
+    bool isFilterChanging() const;
+
+    void processChunk(const float* inLeft, const float* inRight, float* outLeft, float* outRight, int offset, int numSamples, int blockSize);
 
-    std::unique_ptr<IIR::Filter<double>> lowPassFilter;
-    std::unique_ptr<IIR::Filter<double>> highPassFilter;
+    FilterPair filters;
+    HeapBlock<float> mono;
+    int monoSize = 0;
 
     double sampleRate = 44100.0;
 
-    bool enabled = false;
+    std::atomic<bool> enabled{ false };
+    bool bypassed = true;
 
-    float mix = 1.0f;
-    float originalBgLevel = 0.4f;
+    // Latest values requested by setParam(), any thread
+    std::atomic<float> values[numParams];
 
-    float lowpassCutOff = 100.0f;
-    float lowpassQ = 2.0f;
+    MessageQueue<ParamChange> changes;
 
-    float highpassCutOff = 7000.0f;
-    float highpassQ = 2.0f;
+    // Set when a change could not be queued, the audio thread then reloads everything from values
+    std::atomic<bool> resync{ false };
 
-    float lastLowpassCutOff;
-    float lastLowpassQ;
+    // Audio thread
+    Params current{};
+    Params targets{};
+    float fade = 1.0f;
+    float lastFade = 1.0f;
 
-    float lastHighpassCutOff;
-    float lastHighpassQ;
+    // Guards prepare() against process(), process() only tries to lock and passes the audio through while being prepared
+    CriticalSection processLock;
 };
 
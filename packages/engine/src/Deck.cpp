@@ -1,5 +1,7 @@
 #include "Deck.h"
 #include "utils.h"
+#include "TrackInfoCache.h"
+#include "Trace.h"
 #include <cinttypes>
 #include <cstddef>
 
@@ -13,32 +15,123 @@ namespace {
     constexpr float kLastSoundDuration = 1.25f;
     constexpr auto kLeadingScanningDuration = 25.0;
     constexpr float kLastSoundScanningDurartion = 20.0f;
+    constexpr double kReadAheadDuration = 4.0;
+
+    /**
+     * Records the read-ahead chunks being filled in the trace timeline.
+     *
+     * After each chunk, the range of samples ready from the play position is published,
+     * the audio thread tells underruns from it and never has to take the buffer's lock.
+     */
+    class TracedBufferingAudioSource : public BufferingAudioSource {
+    public:
+        TracedBufferingAudioSource(std::atomic<int64>& readyStart, std::atomic<int64>& readyEnd, PositionableAudioSource* source, TimeSliceThread& thread, int bufferSize)
+            : BufferingAudioSource(source, thread, false, bufferSize, 2),
+            readyStart(readyStart),
+            readyEnd(readyEnd),
+            bufferSize(bufferSize)
+        {
+
+        }
+
+        int useTimeSlice() override {
+            auto start = Time::getHighResolutionTicks();
+            auto result = BufferingAudioSource::useTimeSlice();
+
+            // BufferingAudioSource asks to be called again sooner only when a chunk was read
+            if (result < 100) {
+                publishReadyRange();
+
+                if (medley::Trace::isEnabled()) {
+                    medley::Trace::complete("readAhead", "deck", start);
+                }
+            }
+
+            return result;
+        }
+
+    private:
+        void publishReadyRange() {
+            auto position = getNextReadPosition();
+
+            // BufferingAudioSource does not expose its valid range, search for the largest block that is ready
+            int lo = 0;
+            int hi = bufferSize;
+
+            for (int i = 0; i < 12 && lo < hi; i++) {
+                auto mid = (lo + hi + 1) / 2;
+                AudioSourceChannelInfo probe(nullptr, 0, mid);
+
+                if (waitForNextAudioBlockReady(probe, 0)) {
+                    lo = mid;
+                }
+                else {
+                    hi = mid - 1;
+                }
+            }
+
+            readyStart.store(position, std::memory_order_relaxed);
+            readyEnd.store(position + lo, std::memory_order_relaxed);
+        }
+
+        std::atomic<int64>& readyStart;
+        std::atomic<int64>& readyEnd;
+        int bufferSize;
+    };
+
+    /**
+     * Marks the audio thread as being inside Deck::getNextAudioBlock
+     */
+    class ScopedCallbackEpoch {
+    public:
+        explicit ScopedCallbackEpoch(std::atomic<juce::uint64>& epoch)
+            : epoch(epoch)
+        {
+            epoch.fetch_add(1);
+        }
+
+        ~ScopedCallbackEpoch() {
+            epoch.fetch_add(1);
+        }
+
+    private:
+        std::atomic<juce::uint64>& epoch;
+    };
 }
 
 namespace medley {
 
 using namespace medley::utils;
 
-Deck::Deck(uint8_t index, const String& name, ILoggerWriter* logWriter, AudioFormatManager& formatMgr, TimeSliceThread& loadingThread, TimeSliceThread& readAheadThread)
+Deck::Deck(uint8_t index, const String& name, ILoggerWriter* logWriter, AudioFormatManager& formatMgr, Prefetcher& prefetcher, TimeSliceThread& loadingThread, TimeSliceThread& reclamationThread, ThreadPool& tagWritingPool)
     :
     formatMgr(formatMgr),
+    prefetcher(prefetcher),
     loadingThread(loadingThread),
-    readAheadThread(readAheadThread),
+    reclamationThread(reclamationThread),
+    tagWritingPool(tagWritingPool),
+    readAheadThread(name + " read-ahead"),
     index(index),
     name(name),
     loader(*this),
     scanner(*this),
-    playhead(*this)
+    playhead(*this),
+    reclaimer(*this)
 {
     logger = std::make_unique<medley::Logger>(name, logWriter);
 
-    readAheadThread.setPriority(8);
     readAheadThread.addTimeSliceClient(&playhead);
+    readAheadThread.startThread(9);
+    reclamationThread.addTimeSliceClient(&reclaimer);
 }
 
 Deck::~Deck() {
     releaseChainedResources();
     unloadTrackInternal();
+
+    reclamationThread.removeTimeSliceClient(&reclaimer);
+    loadingThread.removeTimeSliceClient(&analyzer);
+    readAheadThread.removeTimeSliceClient(&playhead);
 }
 
 void Deck::log(medley::LogLevel level, const String& s) {
@@ -79,14 +172,25 @@ void Deck::loadTrack(const ITrack::Ptr track, OnLoadingDone doneCallback)
 
 void Deck::unloadTrack()
 {
-    setSource(nullptr);
     unloadTrackInternal();
 }
 
 bool Deck::loadTrackInternal(const ITrack::Ptr track)
 {
     logger->debug("Loading: " + track->getFile().getFullPathName());
-    auto newReader = utils::createAudioReaderFor(formatMgr, track);
+
+    // A reader opened ahead by the prefetcher spares opening the file at all, the tags are then served by the cache
+    auto prefetchedReader = prefetcher.takeReader(track);
+
+    // Otherwise the tags and the decoder come from a single open of the file, the tags are only parsed if they are not cached
+    uint32_t fields = TrackProbe::Tags | TrackProbe::Gain;
+
+    if (prefetchedReader == nullptr) {
+        fields |= TrackProbe::Reader;
+    }
+
+    auto probe = TrackInfoCache::probe(formatMgr, track->getFile(), fields);
+    auto newReader = prefetchedReader ? prefetchedReader.release() : probe->takeReader().release();
 
     if (!newReader) {
         logger->warn("Could not create format reader");
@@ -100,11 +204,13 @@ bool Deck::loadTrackInternal(const ITrack::Ptr track)
 
     auto reader = newReader;
 
-    try {
-        m_metadata.readFromTrack(track);
-    }
-    catch (std::exception& e) {
-        logger->error(("Error reading metadata: " + track->getFile().getFullPathName() + " " + e.what()).toStdString());
+    // The previous track is no longer of interest, the loader and the analyzer share the same thread
+    analyzer.cancel();
+
+    m_metadata = probe->getMetadata();
+
+    if (probe->getError().isNotEmpty()) {
+        logger->error(("Error reading metadata: " + probe->getError()).toStdString());
     }
 
     auto mid = reader->lengthInSamples / 2;
@@ -197,17 +303,23 @@ bool Deck::loadTrackInternal(const ITrack::Ptr track)
         }
     }
 
-    setSource(new AudioFormatReaderSource(reader, false));
+    setSource(reader);
 
     scanner.scan(track);
     loadingThread.addTimeSliceClient(&scanner);
 
     logger->debug(String::formatted("Loaded - leading@%.2f duration=%.2f", leadingSamplePosition / reader->sampleRate, leadingDuration));
 
-    setReplayGain(m_metadata.getTrackGain());
-    logger->debug(String::formatted("Gain correction: %.2fdB", Decibels::gainToDecibels(gainCorrection)));
+    auto trackGain = m_metadata.getTrackGain();
+    auto cachedLoudness = 0.0;
 
-    this->reader = reader;
+    if (trackGain <= 0.0f && loudnessCorrection && LoudnessAnalyzer::findCached(track->getFile(), cachedLoudness)) {
+        trackGain = LoudnessAnalyzer::toGain(cachedLoudness);
+        logger->debug(String::formatted("Integrated loudness (cached): %.2f LUFS", cachedLoudness));
+    }
+
+    setReplayGain(trackGain);
+    logger->debug(String::formatted("Gain correction: %.2fdB", Decibels::gainToDecibels(gainCorrection)));
 
     this->track = track;
     _isTrackLoading = false;
@@ -230,33 +342,13 @@ void Deck::unloadTrackInternal()
     stopped = true;
     fadingOut = false;
 
+    // This can be called from the audio thread, the chain is deleted later by the reclaimer
     bool deckUnloaded = false;
-    {
-        const ScopedLock sl(sourceLock);
-
-        if (resamplerSource) {
-            delete resamplerSource;
-            resamplerSource = nullptr;
-            deckUnloaded = true;
-        }
 
-        if (bufferingSource) {
-            delete bufferingSource;
-            bufferingSource = nullptr;
-            deckUnloaded = true;
-        }
-
-        if (source) {
-            delete source;
-            source = nullptr;
-            deckUnloaded = true;
-        }
-
-        if (reader) {
-            delete reader;
-            reader = nullptr;
-            deckUnloaded = true;
-        }
+    if (auto oldChain = chain.exchange(nullptr)) {
+        totalSourceLength = 0;
+        retire(oldChain);
+        deckUnloaded = true;
     }
 
     if (deckUnloaded) {
@@ -463,6 +555,24 @@ void Deck::scanTrackInternal(const ITrack::Ptr trackToScan)
 
     disableNextTrackLeadIn = trackToScan->getDisableNextTrackLeadIn();
 
+    // Hints given by the track itself are not the result of the analysis, a CUE-IN would also prevent the leading fade-in from being detected
+    analysisTags = TagWriter::Values();
+
+    if (trackToScan->getCueInPosition() < 0 && leadingSamplePosition < 0) {
+        analysisTags.cueIn = firstAudibleSamplePosition / scanningReader->sampleRate;
+    }
+
+    if (trackToScan->getCueOutPosition() < 0 && trailingSamplePosition > -1) {
+        analysisTags.cueOut = trailingSamplePosition / scanningReader->sampleRate;
+    }
+
+    analysisTags.lastAudible = lastAudibleSamplePosition / scanningReader->sampleRate;
+
+    // Loudness measured on a previous load is not measured again, it is written from the cache
+    if (m_metadata.getTrackGain() <= 0.0f && replayGain > 0.0f) {
+        analysisTags.trackGain = replayGain;
+    }
+
     if (trailingDuration > 0) {
         logger->debug(String::formatted(
             "Scanned - trailing@%.2f/%.2f duration=%.2f",
@@ -478,7 +588,19 @@ void Deck::scanTrackInternal(const ITrack::Ptr trackToScan)
         cb.deckTrackScanned(*this);
     });
 
+    // No ReplayGain, continue decoding the whole track with the same reader to measure its loudness
+    if (loudnessCorrection && replayGain <= 0.0f) {
+        analyzer.analyze(trackToScan, scanningReader, [this](const ITrack::Ptr analyzedTrack, double integratedLoudness) {
+            applyMeasuredLoudness(analyzedTrack, integratedLoudness);
+        });
+
+        loadingThread.addTimeSliceClient(&analyzer);
+        return;
+    }
+
     delete scanningReader;
+
+    writeAnalysisTags(trackToScan);
 }
 
 void Deck::calculateTransition()
@@ -546,18 +668,43 @@ void Deck::setPositionFractional(double fraction) {
 
 void Deck::getNextAudioBlock(const AudioSourceChannelInfo& info)
 {
-    const ScopedLock sl(sourceLock);
+    ScopedCallbackEpoch epoch(callbackEpoch);
+
+    auto c = chain.load();
+
+    if (c != nullptr && c->flushPending.exchange(false)) {
+        c->resamplerSource->flushBuffers();
+    }
 
     if (internallyPaused) {
         info.clearActiveBufferRegion();
+        levelTracker.process(info);
         return;
     }
 
     bool wasPlaying = !stopped;
 
-    if (resamplerSource != nullptr && !stopped)
+    if (c != nullptr && !stopped)
     {
-        resamplerSource->getNextAudioBlock(info);
+        auto chainSampleRate = c->reader->sampleRate;
+
+        if (started && sampleRate > 0 && chainSampleRate > 0) {
+            auto numSourceSamples = (int)std::ceil(info.numSamples * chainSampleRate / sampleRate);
+
+            auto position = c->bufferingSource->getNextReadPosition();
+
+            if (position + numSourceSamples < totalSourceSamplesToPlay) {
+                // Right after a seek, the range is still the old one until the first chunk is read, which is an underrun as well
+                auto ready = position >= c->readyStart.load(std::memory_order_relaxed)
+                    && position + numSourceSamples <= c->readyEnd.load(std::memory_order_relaxed);
+
+                if (!ready) {
+                    stats.underruns.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        c->resamplerSource->getNextAudioBlock(info);
 
         if (!started)
         {
@@ -572,9 +719,9 @@ void Deck::getNextAudioBlock(const AudioSourceChannelInfo& info)
         }
 
         auto samplesToPlay = totalSourceSamplesToPlay;
-        nextReadPosition = bufferingSource->getNextReadPosition();
+        nextReadPosition = c->bufferingSource->getNextReadPosition();
 
-        if (nextReadPosition > samplesToPlay + 1 && !bufferingSource->isLooping())
+        if (nextReadPosition > samplesToPlay + 1 && !c->bufferingSource->isLooping())
         {
             started = false;
             inputStreamEOF = true;
@@ -595,25 +742,47 @@ void Deck::getNextAudioBlock(const AudioSourceChannelInfo& info)
 
     lastGain = gain;
 
+    levelTracker.process(info);
+
     if (wasPlaying && stopped) {
         fireFinishedCallback();
     }
 }
 
+void Deck::updateBufferStats()
+{
+    // Called from the read-ahead thread, which must not wait for a chain being built
+    const ScopedTryLock sl(chainLock);
+
+    if (!sl.isLocked()) {
+        return;
+    }
+
+    auto c = chain.load();
+
+    if (c == nullptr || sourceSampleRate <= 0) {
+        stats.bufferedSeconds = 0.0f;
+        return;
+    }
+
+    auto ready = c->readyEnd.load(std::memory_order_relaxed) - c->bufferingSource->getNextReadPosition();
+    stats.bufferedSeconds = (float)(jmax((int64)0, ready) / sourceSampleRate);
+}
+
 void Deck::setNextReadPosition(int64 newPosition)
 {
-    const ScopedLock sl(sourceLock);
+    const ScopedLock sl(chainLock);
 
-    if (bufferingSource != nullptr)
+    if (auto c = chain.load())
     {
         if (sampleRate > 0 && sourceSampleRate > 0)
             newPosition = (int64)((double)newPosition * sourceSampleRate / sampleRate);
 
         nextReadPosition = newPosition;
-        bufferingSource->setNextReadPosition(newPosition);
+        c->bufferingSource->setNextReadPosition(newPosition);
 
-        if (resamplerSource != nullptr)
-            resamplerSource->flushBuffers();
+        // The resampler is only touched by the audio thread
+        c->flushPending = true;
 
         inputStreamEOF = false;
     }
@@ -621,7 +790,7 @@ void Deck::setNextReadPosition(int64 newPosition)
 
 int64 Deck::getNextReadPosition() const
 {
-    if (bufferingSource != nullptr)
+    if (isTrackLoaded())
     {
         const double ratio = (sampleRate > 0 && sourceSampleRate > 0) ? sampleRate / sourceSampleRate : 1.0;
         return (int64)((double)nextReadPosition * ratio);
@@ -632,26 +801,26 @@ int64 Deck::getNextReadPosition() const
 
 int64 Deck::getTotalLength() const
 {
-    const ScopedLock sl(sourceLock);
-
-    if (bufferingSource != nullptr)
+    if (auto length = totalSourceLength.load(); length > 0)
     {
         const double ratio = (sampleRate > 0 && sourceSampleRate > 0) ? sampleRate / sourceSampleRate : 1.0;
-        return (int64)((double)bufferingSource->getTotalLength() * ratio);
+        return (int64)((double)length * ratio);
     }
     return 0;
 }
 
 bool Deck::isLooping() const
 {
-    const ScopedLock sl(sourceLock);
-    return bufferingSource != nullptr && bufferingSource->isLooping();
+    const ScopedLock sl(chainLock);
+
+    auto c = chain.load();
+    return c != nullptr && c->bufferingSource->isLooping();
 }
 
 bool Deck::start()
 {
     logger->debug("Try to start playing");
-    if ((!started || internallyPaused) && resamplerSource != nullptr)
+    if ((!started || internallyPaused) && isTrackLoaded())
     {
         if (!internallyPaused) {
             listeners.call([this](Callback& cb) {
@@ -696,6 +865,44 @@ void Deck::fireFinishedCallback()
     unloadTrackInternal();
 }
 
+void Deck::applyMeasuredLoudness(const ITrack::Ptr analyzedTrack, double integratedLoudness)
+{
+    if (analyzedTrack != track) {
+        return;
+    }
+
+    logger->debug(String::formatted("Integrated loudness: %.2f LUFS", integratedLoudness));
+
+    analysisTags.trackGain = LoudnessAnalyzer::toGain(integratedLoudness);
+    writeAnalysisTags(analyzedTrack);
+
+    // Changing the gain in the middle of a track would be audible, the result is still cached for the next time
+    if (started) {
+        return;
+    }
+
+    setReplayGain(LoudnessAnalyzer::toGain(integratedLoudness));
+    logger->debug(String::formatted("Gain correction: %.2fdB", Decibels::gainToDecibels(gainCorrection)));
+}
+
+void Deck::writeAnalysisTags(const ITrack::Ptr analyzedTrack)
+{
+    if (!analysisTagWriting) {
+        return;
+    }
+
+    tagWritingPool.addJob([this, file = analyzedTrack->getFile(), values = analysisTags] {
+        try {
+            if (TagWriter::write(file, values)) {
+                logger->debug("Analysis written to tags");
+            }
+        }
+        catch (std::exception& e) {
+            logger->warn(("Could not write analysis to tags: " + String(e.what())).toStdString());
+        }
+    });
+}
+
 void Deck::setReplayGain(float rg)
 {
     replayGain = rg;
@@ -751,19 +958,33 @@ void Deck::removeListener(Callback* cb)
     listeners.remove(cb);
 }
 
+void Deck::setOutputLatency(int latencyInSamples)
+{
+    const ScopedLock sl(chainLock);
+
+    if (outputLatency != latencyInSamples) {
+        outputLatency = latencyInSamples;
+        levelTracker.prepare(2, (int)sampleRate, outputLatency);
+    }
+}
+
 void Deck::prepareToPlay(int samplesPerBlockExpected, double newSampleRate)
 {
-    const ScopedLock sl(sourceLock);
+    const ScopedLock sl(chainLock);
 
     sampleRate = newSampleRate;
     blockSize = samplesPerBlockExpected;
 
-    if (resamplerSource != nullptr) {
-        resamplerSource->prepareToPlay(samplesPerBlockExpected, sampleRate);
+    levelTracker.prepare(2, (int)sampleRate, outputLatency);
+
+    auto c = chain.load();
+
+    if (c != nullptr) {
+        c->resamplerSource->prepareToPlay(samplesPerBlockExpected, sampleRate);
     }
 
-    if (resamplerSource != nullptr && sourceSampleRate > 0) {
-        resamplerSource->setResamplingRatio(sourceSampleRate / sampleRate);
+    if (c != nullptr && sourceSampleRate > 0) {
+        c->resamplerSource->setResamplingRatio(sourceSampleRate / sampleRate);
     }
 
     inputStreamEOF = false;
@@ -777,62 +998,72 @@ void Deck::releaseResources()
 
 
 
-void Deck::setSource(AudioFormatReaderSource* newSource)
+Deck::SourceChain::SourceChain(AudioFormatReader* newReader, TimeSliceThread& readAheadThread, int bufferSize)
+    :
+    reader(newReader),
+    source(std::make_unique<AudioFormatReaderSource>(newReader, false)),
+    bufferingSource(std::make_unique<TracedBufferingAudioSource>(readyStart, readyEnd, source.get(), readAheadThread, bufferSize)),
+    resamplerSource(std::make_unique<ResamplingAudioSource>(bufferingSource.get(), false, 2))
 {
-    const ScopedLock sl(sourceLock);
-
-    if (source == newSource) {
-        if (newSource == nullptr) {
-            return;
-        }
-
-        setSource(nullptr);
-    }
-
-    BufferingAudioSource* newBufferingSource = nullptr;
-    ResamplingAudioSource* newResamplerSource = nullptr;
 
-    std::unique_ptr<BufferingAudioSource> oldBufferingSource(bufferingSource);
-    std::unique_ptr<ResamplingAudioSource> oldResamplerSource(resamplerSource);
+}
 
-    if (newSource != nullptr) {
-        sourceSampleRate = newSource->getAudioFormatReader()->sampleRate;
+void Deck::setSource(AudioFormatReader* newReader)
+{
+    SourceChain* newChain = nullptr;
 
-        newBufferingSource = new BufferingAudioSource(newSource, readAheadThread, false, (int)(sourceSampleRate * 4), 2);
-        newBufferingSource->setNextReadPosition(firstAudibleSamplePosition);
+    // Built without holding chainLock, preparing waits for the read-ahead thread to prefill the buffer
+    if (newReader != nullptr) {
+        sourceSampleRate = newReader->sampleRate;
 
-        newResamplerSource = new ResamplingAudioSource(newBufferingSource, false, 2);
+        newChain = new SourceChain(newReader, readAheadThread, (int)(sourceSampleRate * kReadAheadDuration));
+        newChain->bufferingSource->setNextReadPosition(firstAudibleSamplePosition);
 
         if (isPrepared)
         {
-            newResamplerSource->setResamplingRatio(sourceSampleRate / sampleRate);
-            newResamplerSource->prepareToPlay(blockSize, sampleRate);
+            newChain->resamplerSource->setResamplingRatio(sourceSampleRate / sampleRate);
+            newChain->resamplerSource->prepareToPlay(blockSize, sampleRate);
         }
     }
 
-    source = newSource;
-    bufferingSource = newBufferingSource;
-    resamplerSource = newResamplerSource;
+    const ScopedLock sl(chainLock);
+
+    if (newChain != nullptr && isPrepared) {
+        // In case the device was reconfigured while preparing
+        newChain->resamplerSource->setResamplingRatio(sourceSampleRate / sampleRate);
+    }
 
     nextReadPosition = 0;
     inputStreamEOF = false;
     started = false;
 
-    if (oldResamplerSource != nullptr) {
-        oldResamplerSource->releaseResources();
-    }
+    totalSourceLength = newReader != nullptr ? newReader->lengthInSamples : 0;
 
-    if (newSource != nullptr) {
+    // Publish the fully built chain, the audio thread picks it up at the next block
+    retire(chain.exchange(newChain));
+
+    if (newChain != nullptr) {
         calculateTransition();
     }
 }
 
+void Deck::retire(SourceChain* oldChain)
+{
+    if (oldChain == nullptr) {
+        return;
+    }
+
+    // Lock-free push, this can be called from the audio thread
+    oldChain->nextRetired = retiredChains.load(std::memory_order_relaxed);
+    while (!retiredChains.compare_exchange_weak(oldChain->nextRetired, oldChain, std::memory_order_release, std::memory_order_relaxed)) {}
+}
+
 void Deck::releaseChainedResources()
 {
-    const ScopedLock sl(sourceLock);
+    const ScopedLock sl(chainLock);
 
-    if (resamplerSource != nullptr) {
-        resamplerSource->releaseResources();
+    if (auto c = chain.load()) {
+        c->resamplerSource->releaseResources();
     }
 
     isPrepared = false;
@@ -849,7 +1080,14 @@ int Deck::Loader::useTimeSlice()
 
     if (track != nullptr) {
         try {
-            auto ret = deck.loadTrackInternal(track);
+            bool ret;
+
+            {
+                Histogram::ScopedTimer timer(deck.stats.loadTime);
+                Trace::ScopedSpan span("loadTrack", "deck");
+                ret = deck.loadTrackInternal(track);
+            }
+
             track = nullptr;
             callback(ret);
         }
@@ -872,6 +1110,8 @@ void Deck::Loader::load(const ITrack::Ptr track, OnLoadingDone callback)
 int Deck::Scanner::useTimeSlice()
 {
     if (track) {
+        Histogram::ScopedTimer timer(deck.stats.scanTime);
+        Trace::ScopedSpan span("scanTrack", "deck");
         deck.scanTrackInternal(track);
         track = nullptr;
     }
@@ -884,12 +1124,96 @@ void Deck::Scanner::scan(const ITrack::Ptr track)
     this->track = track;
 }
 
+Deck::Reclaimer::~Reclaimer()
+{
+    // The audio thread has stopped calling the deck by now
+    auto c = deck.retiredChains.exchange(nullptr);
+
+    while (c != nullptr) {
+        auto next = c->nextRetired;
+        delete c;
+        c = next;
+    }
+
+    while (pending != nullptr) {
+        auto next = pending->nextRetired;
+        delete pending;
+        pending = next;
+    }
+}
+
+int Deck::Reclaimer::useTimeSlice()
+{
+    auto retired = deck.retiredChains.exchange(nullptr, std::memory_order_acquire);
+
+    // Read after the chains were unpublished, if odd the audio thread might still be holding one of them
+    auto epoch = deck.callbackEpoch.load();
+
+    while (retired != nullptr) {
+        auto next = retired->nextRetired;
+        retired->retiredEpoch = epoch;
+        retired->nextRetired = pending;
+        pending = retired;
+        retired = next;
+    }
+
+    if (pending == nullptr) {
+        return 100;
+    }
+
+    collect();
+
+    return pending != nullptr ? 5 : 100;
+}
+
+void Deck::Reclaimer::collect()
+{
+    auto epoch = deck.callbackEpoch.load();
+
+    SourceChain* expired = nullptr;
+    auto link = &pending;
+
+    while (*link != nullptr) {
+        auto c = *link;
+
+        // Either the audio thread was not inside the callback when the chain was retired, or it has left that callback since
+        if ((c->retiredEpoch & 1) == 0 || epoch != c->retiredEpoch) {
+            *link = c->nextRetired;
+            c->nextRetired = expired;
+            expired = c;
+        }
+        else {
+            link = &c->nextRetired;
+        }
+    }
+
+    if (expired == nullptr) {
+        return;
+    }
+
+    {
+        // Wait for non-realtime threads which might have loaded the chain before it was unpublished
+        const ScopedLock sl(deck.chainLock);
+    }
+
+    while (expired != nullptr) {
+        auto next = expired->nextRetired;
+        delete expired;
+        expired = next;
+    }
+}
+
 int Deck::PlayHead::useTimeSlice()
 {
     if (!deck.isTrackLoaded()) {
         return 250;
     }
 
+    if (++ticks >= 10) {
+        ticks = 0;
+        deck.updateBufferStats();
+    }
+
     auto pos = deck.getPosition();
     if (lastPosition != pos) {
         deck.doPositionChange(pos);
@@ -4,6 +4,11 @@
 #include "ITrack.h"
 #include "Metadata.h"
 #include "ILogger.h"
+#include "Stats.h"
+#include "LevelTracker.h"
+#include "LoudnessAnalyzer.h"
+#include "TagWriter.h"
+#include "Prefetcher.h"
 
 using namespace juce;
 
@@ -30,7 +35,20 @@ public:
 
     typedef std::function<void(bool)> OnLoadingDone;
 
-    Deck(uint8_t index, const juce::String& name, ILoggerWriter* logWriter, AudioFormatManager& formatMgr, TimeSliceThread& loadingThread, TimeSliceThread& readAheadThread);
+    struct Stats {
+        Histogram loadTime{ Histogram::Unit::Milliseconds };
+        Histogram scanTime{ Histogram::Unit::Milliseconds };
+        /**
+         * Amount of audio ready in the read-ahead buffer, sampled periodically
+         */
+        std::atomic<float> bufferedSeconds{ 0.0f };
+        /**
+         * Number of blocks requested while the read-ahead buffer was not ready
+         */
+        std::atomic<uint32> underruns{ 0 };
+    };
+
+    Deck(uint8_t index, const juce::String& name, ILoggerWriter* logWriter, AudioFormatManager& formatMgr, Prefetcher& prefetcher, TimeSliceThread& loadingThread, TimeSliceThread& reclamationThread, ThreadPool& tagWritingPool);
 
     ~Deck() override;
 
@@ -48,7 +66,7 @@ public:
 
     bool isTrackLoading() const { return _isTrackLoading; }
 
-    bool isTrackLoaded() const { return source != nullptr; }
+    bool isTrackLoaded() const { return chain.load() != nullptr; }
 
     void setPosition(double time);
 
@@ -93,6 +111,21 @@ public:
 
     inline float getReplayGainBoost() const { return replayGainBoost; }
 
+    /**
+     * Measure the loudness of tracks without ReplayGain metadata and use it as gain correction
+     */
+    void setLoudnessCorrectionEnabled(bool enabled) { loudnessCorrection = enabled; }
+
+    inline bool isLoudnessCorrectionEnabled() const { return loudnessCorrection; }
+
+    /**
+     * Store the cue points and the measured loudness found while scanning into the file's tags, if they are missing.
+     * Tags are written from the loading thread once the analysis of a track completes
+     */
+    void setAnalysisTagWritingEnabled(bool enabled) { analysisTagWriting = enabled; }
+
+    inline bool isAnalysisTagWritingEnabled() const { return analysisTagWriting; }
+
     double getSampleRate() const { return sampleRate; }
 
     double getSourceSampleRate() const { return sourceSampleRate; }
@@ -131,6 +164,20 @@ public:
         return m_metadata;
     }
 
+    const Stats& getStats() const { return stats; }
+
+    /**
+     * Output level of this deck, after its volume has been applied
+     */
+    const LevelTracker& getLevelTracker() const { return levelTracker; }
+
+    void updateLevelTracker() { levelTracker.update(); }
+
+    /**
+     * Samples between this deck and the listener, for the level tracker to line up with what is being heard
+     */
+    void setOutputLatency(int latencyInSamples);
+
 private:
     friend class Medley;
 
@@ -166,6 +213,49 @@ private:
     private:
         Deck& deck;
         double lastPosition = 0;
+        int ticks = 0;
+    };
+
+    /**
+     * Everything needed to play a loaded track, published to the audio thread as a whole through an atomic pointer
+     */
+    struct SourceChain {
+        SourceChain(AudioFormatReader* reader, TimeSliceThread& readAheadThread, int bufferSize);
+
+        std::unique_ptr<AudioFormatReader> reader;
+        std::unique_ptr<AudioFormatReaderSource> source;
+
+        /**
+         * Source samples ready in the read-ahead buffer as of the last chunk read, set by the read-ahead thread
+         */
+        std::atomic<int64> readyStart{ 0 };
+        std::atomic<int64> readyEnd{ 0 };
+
+        std::unique_ptr<BufferingAudioSource> bufferingSource;
+        std::unique_ptr<ResamplingAudioSource> resamplerSource;
+
+        /**
+         * Set by seeking, the resampler is flushed by the audio thread at the next block
+         */
+        std::atomic<bool> flushPending{ false };
+
+        SourceChain* nextRetired = nullptr;
+        uint64 retiredEpoch = 0;
+    };
+
+    /**
+     * Deletes retired source chains once the audio thread can no longer be using them
+     */
+    class Reclaimer : public TimeSliceClient {
+    public:
+        Reclaimer(Deck& deck) : deck(deck) {}
+        ~Reclaimer() override;
+        int useTimeSlice() override;
+    private:
+        void collect();
+
+        Deck& deck;
+        SourceChain* pending = nullptr;
     };
 
     void setVolume(float newVolume) {
@@ -175,7 +265,13 @@ private:
 
     void setReplayGain(float rg);
 
-    void setSource(AudioFormatReaderSource* newSource);
+    void applyMeasuredLoudness(const ITrack::Ptr analyzedTrack, double integratedLoudness);
+
+    void writeAnalysisTags(const ITrack::Ptr analyzedTrack);
+
+    void setSource(AudioFormatReader* newReader);
+
+    void retire(SourceChain* oldChain);
 
     void releaseChainedResources();
 
@@ -191,6 +287,8 @@ private:
 
     void fireFinishedCallback();
 
+    void updateBufferStats();
+
     inline double getSampleInSeconds(int64 sample) {
         if (sampleRate > 0.0)
             return (double)sample / sampleRate;
@@ -230,24 +328,45 @@ private:
     float gainCorrection = 1.0f;
     float volume = 1.0f;
     float replayGainBoost = 9.0;
+    std::atomic<bool> loudnessCorrection{ true };
+    std::atomic<bool> analysisTagWriting{ false };
+    TagWriter::Values analysisTags;
     //
     float gain = 1.0f;
     float lastGain = 1.0f;
 
     AudioFormatManager& formatMgr;
+    Prefetcher& prefetcher;
     TimeSliceThread& loadingThread;
-    TimeSliceThread& readAheadThread;
+    TimeSliceThread& reclamationThread;
+
+    /**
+     * Writing tags copies the whole file, it does not hold up loading
+     */
+    ThreadPool& tagWritingPool;
 
-    AudioFormatReader* reader = nullptr;
-    AudioFormatReaderSource* source = nullptr;
-    ResamplingAudioSource* resamplerSource = nullptr;
-    BufferingAudioSource* bufferingSource = nullptr;
+    /**
+     * One per deck, a read stalling on slow storage does not hold up the read-ahead of the other decks
+     */
+    TimeSliceThread readAheadThread;
+
+    std::atomic<SourceChain*> chain{ nullptr };
+    std::atomic<int64> totalSourceLength{ 0 };
+    std::atomic<SourceChain*> retiredChains{ nullptr };
+
+    /**
+     * Incremented when the audio thread enters and leaves getNextAudioBlock, odd while inside
+     */
+    std::atomic<uint64> callbackEpoch{ 0 };
 
     int blockSize = 128;
     bool isPrepared = false;
     bool inputStreamEOF = false;
 
-    CriticalSection sourceLock;
+    /**
+     * Held by non-realtime threads while using the current chain, never taken by the audio thread
+     */
+    CriticalSection chainLock;
     //
     ListenerList<Callback> listeners;
     //
@@ -256,7 +375,9 @@ private:
     Loader loader;
 
     Scanner scanner;
+    LoudnessAnalyzer analyzer;
     PlayHead playhead;
+    Reclaimer reclaimer;
 
     int64 firstAudibleSamplePosition = 0;
     int64 lastAudibleSamplePosition = 0;
@@ -283,6 +404,11 @@ private:
 
     Metadata m_metadata;
 
+    Stats stats;
+
+    LevelTracker levelTracker;
+    int outputLatency = 0;
+
     std::unique_ptr<Logger> logger;
 };
 
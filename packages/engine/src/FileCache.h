@@ -0,0 +1,56 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "LruCache.h"
+
+using namespace juce;
+
+namespace medley {
+
+/**
+ * Bounded least recently used cache of values derived from files, thread safe
+ *
+ * Entries are keyed by path, modification time and size, a changed file gets a new key so stale entries are never served, they just age out.
+ */
+template <typename Value>
+class FileCache
+{
+public:
+    explicit FileCache(size_t capacity)
+        : cache(capacity)
+    {
+
+    }
+
+    bool find(const File& file, Value& value)
+    {
+        return cache.find(getKey(file), value);
+    }
+
+    void set(const File& file, const Value& value)
+    {
+        cache.set(getKey(file), value);
+    }
+
+    void clear()
+    {
+        cache.clear();
+    }
+
+    size_t size() const
+    {
+        return cache.size();
+    }
+
+    static std::string getKey(const File& file)
+    {
+        return (file.getFullPathName()
+            + "|" + String(file.getLastModificationTime().toMilliseconds())
+            + "|" + String(file.getSize())).toStdString();
+    }
+
+private:
+    LruCache<Value> cache;
+};
+
+}
@@ -1,4 +1,5 @@
 #include "LevelTracker.h"
+#include "Simd.h"
 
 LevelTracker::LevelTracker()
     :
@@ -18,60 +19,128 @@ LevelTracker::LevelTracker(const LevelTracker& other)
 
 void LevelTracker::process(const AudioSourceChannelInfo& info)
 {
-    const auto buffer = *info.buffer;
-    const auto numChannels = buffer.getNumChannels();
-    const auto numSamples = info.numSamples;
+    const ScopedTryLock sl(processLock);
 
-    const auto numBlocks = jmax(1, (int)(numSamples / samplesPerBlock));
+    if (!sl.isLocked()) {
+        return;
+    }
+
+    const auto& buffer = *info.buffer;
+    const auto channels = jmin(buffer.getNumChannels(), numChannels);
+    const auto end = info.startSample + info.numSamples;
+
+    auto start = info.startSample;
+
+    // Blocks may span across callbacks, a level is only emitted once a whole block has been seen
+    while (start < end) {
+        auto numSamplesThisTime = jmin(end - start, samplesPerBlock - samplesInBlock);
+
+        for (int channel = 0; channel < channels; channel++) {
+            auto src = buffer.getReadPointer(channel, start);
+            auto& p = pending[channel];
+
+            p.peak = jmax(p.peak, medley::simd::findPeak(src, numSamplesThisTime));
+            p.sumOfSquares += medley::simd::sumOfSquares(src, numSamplesThisTime);
+        }
+
+        start += numSamplesThisTime;
+        samplesInBlock += numSamplesThisTime;
+
+        if (samplesInBlock < samplesPerBlock) {
+            break;
+        }
+
+        Time time = Time((int64)((double)samplesProcessed.load(std::memory_order_relaxed) / sampleRate * 1000));
+
+        for (int channel = 0; channel < channels; channel++) {
+            auto& p = pending[channel];
+
+            levels[channel]->addLevel(time, p.peak, holdDuration);
 
-    for (int channel = 0; channel < std::min(numChannels, int(levels.size())); channel++) {
-        for (int block = 0; block < numBlocks; block++) {
-            Time time = Time((int64)((double)samplesProcessed / sampleRate * 1000));
+            p.rmsBlocks[rmsBlockIndex] = p.sumOfSquares;
 
-            auto start = info.startSample + block * numBlocks;
-            auto numSamplesThisTime = jmin(numSamples - start, samplesPerBlock);
+            auto total = 0.0;
+            for (auto sum : p.rmsBlocks) {
+                total += sum;
+            }
 
-            levels[channel]->addLevel(time, buffer.getMagnitude(channel, start, numSamplesThisTime), holdDuration);
+            published[channel].rms.store(std::sqrt(total / ((double)samplesPerBlock * kRMSBlocks)), std::memory_order_relaxed);
 
-            samplesProcessed += numSamplesThisTime;
+            p.peak = 0.0f;
+            p.sumOfSquares = 0.0;
         }
+
+        rmsBlockIndex = (rmsBlockIndex + 1) % kRMSBlocks;
+        samplesProcessed.fetch_add(samplesInBlock, std::memory_order_relaxed);
+        samplesInBlock = 0;
     }
 }
 
 void LevelTracker::prepare(const int channels, const int sampleRate, const int latencyInSamples)
 {
+    const ScopedLock sl(lock);
+    const ScopedLock psl(processLock);
+
     this->sampleRate = sampleRate;
-    samplesPerBlock = (int)(sampleRate * 0.1 / 10.0);
+    samplesPerBlock = jmax(1, (int)(sampleRate * 0.1 / 10.0));
 
     latency = RelativeTime((double)latencyInSamples / sampleRate);
 
+    numChannels = jmin(channels, maxChannels);
+    samplesInBlock = 0;
+    rmsBlockIndex = 0;
+
+    for (auto& p : pending) {
+        p = Pending();
+    }
+
+    for (auto& p : published) {
+        p.level.store(0.0, std::memory_order_relaxed);
+        p.peak.store(0.0, std::memory_order_relaxed);
+        p.rms.store(0.0, std::memory_order_relaxed);
+        p.clip.store(false, std::memory_order_relaxed);
+    }
+
     levels.clear();
-    levels.resize(channels);
-    for (auto i = 0; i < channels; i++) {
+    levels.resize(numChannels);
+    for (auto i = 0; i < numChannels; i++) {
         levels[i] = std::shared_ptr<LevelSmoother>(new LevelSmoother(sampleRate));
     }
 }
 
 double LevelTracker::getLevel(int channel) const
 {
-    return channel < (int)levels.size() ? levels[channel]->get().level : 0.0;
+    return isPositiveAndBelow(channel, maxChannels) ? published[channel].level.load(std::memory_order_relaxed) : 0.0;
 }
 
 double LevelTracker::getPeak(int channel) const
 {
-    return channel < (int)levels.size() ? levels[channel]->get().peak : 0.0;
+    return isPositiveAndBelow(channel, maxChannels) ? published[channel].peak.load(std::memory_order_relaxed) : 0.0;
+}
+
+double LevelTracker::getRMS(int channel) const
+{
+    return isPositiveAndBelow(channel, maxChannels) ? published[channel].rms.load(std::memory_order_relaxed) : 0.0;
 }
 
 bool LevelTracker::isClipping(int channel) const
 {
-    return channel < (int)levels.size() ? levels[channel]->get().clip : false;
+    return isPositiveAndBelow(channel, maxChannels) ? published[channel].clip.load(std::memory_order_relaxed) : false;
 }
 
 void LevelTracker::update()
 {
-    auto time = Time((int64)((double)samplesProcessed / sampleRate * 1000)) - latency;
+    const ScopedLock sl(lock);
+
+    auto time = Time((int64)((double)samplesProcessed.load(std::memory_order_relaxed) / sampleRate * 1000)) - latency;
 
-    for (auto& lv : levels) {
+    for (int channel = 0; channel < (int)levels.size(); channel++) {
+        auto& lv = levels[channel];
         lv->update(time);
+
+        const auto& result = lv->get();
+        published[channel].level.store(result.level, std::memory_order_relaxed);
+        published[channel].peak.store(result.peak, std::memory_order_relaxed);
+        published[channel].clip.store(result.clip, std::memory_order_relaxed);
     }
 }
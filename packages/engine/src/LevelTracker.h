@@ -5,9 +5,17 @@
 
 using namespace juce;
 
+/**
+ * Peak program and RMS meter
+ *
+ * process() is realtime safe and never locks, update() is meant to be called periodically from a single consumer thread,
+ * the getters can be called from any thread.
+ */
 class LevelTracker
 {
 public:
+    static constexpr int maxChannels = 2;
+
     LevelTracker();
 
     LevelTracker(const LevelTracker& other);
@@ -20,18 +28,49 @@ public:
 
     double getPeak(int channel) const;
 
+    /**
+     * RMS level over the last 300ms
+     */
+    double getRMS(int channel) const;
+
     bool isClipping(int channel) const;
 
     void update();
 
 private:
+    static constexpr int kRMSBlocks = 30;
+
+    struct Published {
+        std::atomic<double> level{ 0.0 };
+        std::atomic<double> peak{ 0.0 };
+        std::atomic<double> rms{ 0.0 };
+        std::atomic<bool> clip{ false };
+    };
+
+    struct Pending {
+        float peak = 0.0f;
+        double sumOfSquares = 0.0;
+        double rmsBlocks[kRMSBlocks]{};
+    };
+
     int sampleRate = 44100;
     int samplesPerBlock = 441;
-    int64 samplesProcessed = 0;
+    std::atomic<int64> samplesProcessed{ 0 };
 
+    int numChannels = 0;
+    int samplesInBlock = 0;
+    int rmsBlockIndex = 0;
+    Pending pending[maxChannels];
+
+    // Guards prepare() against update()
+    CriticalSection lock;
+
+    // Guards prepare() against process(), process() only tries to lock and skips metering while being prepared
+    CriticalSection processLock;
     std::vector<std::shared_ptr<LevelSmoother>> levels;
 
+    Published published[maxChannels];
+
     RelativeTime holdDuration{ 0.5 };
     RelativeTime latency{ 0 };
 };
-
@@ -1,8 +1,10 @@
 #include "LookAheadLimiter.h"
+#include "Simd.h"
 
 // Adapted from https://github.com/DanielRudrich/SimpleCompressor
 
 using namespace juce;
+using namespace medley;
 
 LookAheadLimiter::LookAheadLimiter()
 {
@@ -18,6 +20,8 @@ LookAheadLimiter::LookAheadLimiter()
     else
         gainReductionCalculator.setRatio(ratio);
 
+    // Sample peaks are delayed to line up with the true-peaks in both modes, so switching modes never changes the latency
+    delay.alignmentInSamples = TruePeakDetector::latencyInSamples;
     delay.setDelayTime(0.005f);
     lookAheadFadeIn.setDelayTime(0.005f);
 }
@@ -30,6 +34,9 @@ void LookAheadLimiter::prepare(const ProcessSpec& spec)
     delay.prepare({ spec.sampleRate, static_cast<uint32> (spec.maximumBlockSize), 2 });
 
     sideChainBuffer.setSize(2, spec.maximumBlockSize);
+
+    samplePeaks.allocate(spec.maximumBlockSize + TruePeakDetector::latencyInSamples, true);
+    truePeakDetector.prepare(spec.maximumBlockSize);
 }
 
 void LookAheadLimiter::process(const ProcessContextReplacing<float>& context)
@@ -49,14 +56,38 @@ void LookAheadLimiter::process(const ProcessContextReplacing<float>& context)
         output.getSingleChannelBlock(i).clear();
 
     /** STEP 1: compute sidechain-signal */
-    // copy the absolute values from the first input channel to the sideChainBuffer
-    FloatVectorOperations::abs(sideChainBuffer.getWritePointer(0), input.getChannelPointer(0), numSamples);
+    constexpr int alignment = TruePeakDetector::latencyInSamples;
+    const auto peaks = samplePeaks.get() + alignment;
+
+    // copy the absolute values from the first input channel, right after the tail of the previous block
+    FloatVectorOperations::abs(peaks, input.getChannelPointer(0), numSamples);
 
-    // copy all other channels to the second channel of the sideChainBuffer and write the maximum of both channels to the first one
+    // write the maximum of all channels
     for (unsigned long ch = 1; ch < totalNumInputChannels; ++ch)
     {
         FloatVectorOperations::abs(sideChainBuffer.getWritePointer(1), input.getChannelPointer(ch), numSamples);
-        FloatVectorOperations::max(sideChainBuffer.getWritePointer(0), sideChainBuffer.getReadPointer(0), sideChainBuffer.getReadPointer(1), numSamples);
+        FloatVectorOperations::max(peaks, peaks, sideChainBuffer.getReadPointer(1), numSamples);
+    }
+
+    // delayed sample peaks go to the first channel of the sideChainBuffer, the tail is kept for the next block
+    FloatVectorOperations::copy(sideChainBuffer.getWritePointer(0), samplePeaks.get(), numSamples);
+    std::memmove(samplePeaks.get(), samplePeaks.get() + numSamples, alignment * sizeof(float));
+
+    if (truePeakEnabled.load(std::memory_order_relaxed))
+    {
+        if (!truePeakActive)
+        {
+            // Whatever left in the interpolator is from before the mode was switched
+            truePeakDetector.reset();
+            truePeakActive = true;
+        }
+
+        for (unsigned long ch = 0; ch < jmin(totalNumInputChannels, (size_t)TruePeakDetector::maxChannels); ++ch)
+            truePeakDetector.accumulatePeaks((int)ch, input.getChannelPointer(ch), sideChainBuffer.getWritePointer(0), (int)numSamples);
+    }
+    else
+    {
+        truePeakActive = false;
     }
 
     /** STEP 2: calculate gain reduction, which one depends on lookAhead */
@@ -74,22 +105,32 @@ void LookAheadLimiter::process(const ProcessContextReplacing<float>& context)
     lookAheadFadeIn.process();
     lookAheadFadeIn.readSamples(sideChainBuffer.getWritePointer(1), (int)numSamples);
 
-    // add make-up and convert to linear gain
     const float makeUpGainInDecibels = gainReductionCalculator.getMakeUpGain();
-    for (int i = 0; i < (int)numSamples; ++i)
-        sideChainBuffer.setSample(1, i, Decibels::decibelsToGain(sideChainBuffer.getSample(1, i) + makeUpGainInDecibels));
+    const auto gainReduction = sideChainBuffer.getWritePointer(1);
 
+    // Nothing to reduce in this block, only the make-up gain applies
+    if (FloatVectorOperations::findMinimum(gainReduction, (int)numSamples) >= 0.0f) {
+        reduction.store(makeUpGainInDecibels, std::memory_order_relaxed);
 
-    /** STEP 4: apply gain-reduction to all channels */
-    auto reduction = 0.0f;
+        if (makeUpGainInDecibels != 0.0f) {
+            const auto makeUpGain = Decibels::decibelsToGain(makeUpGainInDecibels);
+
+            for (unsigned long ch = 0; ch < totalNumInputChannels; ++ch)
+                FloatVectorOperations::multiply(output.getChannelPointer(ch), makeUpGain, numSamples);
+        }
 
-    for (int i = 0; i < (int)numSamples; ++i)
-        reduction += sideChainBuffer.getSample(1, i);
+        return;
+    }
+
+    // add make-up and convert to linear gain
+    simd::decibelsToGain(gainReduction, gainReduction, makeUpGainInDecibels, (int)numSamples);
 
-    this->reduction = Decibels::gainToDecibels(reduction / numSamples);
+    /** STEP 4: apply gain-reduction to all channels */
+    const auto average = simd::sum(gainReduction, (int)numSamples) / numSamples;
+    reduction.store(Decibels::gainToDecibels((float)average), std::memory_order_relaxed);
 
     for (unsigned long ch = 0; ch < totalNumInputChannels; ++ch)
-        FloatVectorOperations::multiply(output.getChannelPointer(ch), sideChainBuffer.getReadPointer(1), numSamples);
+        FloatVectorOperations::multiply(output.getChannelPointer(ch), gainReduction, numSamples);
 }
 
 void LookAheadLimiter::reset()
@@ -101,7 +142,7 @@ void LookAheadLimiter::Delay::prepare(const ProcessSpec& spec)
 {
     this->spec = spec;
 
-    delayInSamples = static_cast<int> (delayPeriod * spec.sampleRate);
+    delayInSamples = static_cast<int> (delayPeriod * spec.sampleRate) + alignmentInSamples;
 
     buffer.setSize(spec.numChannels, spec.maximumBlockSize + delayInSamples);
     buffer.clear();
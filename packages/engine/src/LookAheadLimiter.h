@@ -5,6 +5,7 @@
 #include <JuceHeader.h>
 #include "ReductionCalculator.h"
 #include "LookAheadReduction.h"
+#include "TruePeakDetector.h"
 
 using namespace juce;
 using namespace dsp;
@@ -23,7 +24,19 @@ public:
     /**
      * Reduction in dB
      */
-    float getReduction() const { return reduction; }
+    float getReduction() const { return reduction.load(std::memory_order_relaxed); }
+
+    /**
+     * Detect peaks on the 4x oversampled signal instead of the sample values, so inter-sample peaks are limited as well
+     */
+    void setTruePeakEnabled(bool enabled) { truePeakEnabled = enabled; }
+
+    bool isTruePeakEnabled() const { return truePeakEnabled; }
+
+    /**
+     * Delay added to the signal, the look-ahead plus the true-peak detector alignment, it does not depend on the mode
+     */
+    int getLatencyInSamples() const { return delay.delayInSamples; }
 
 private:
     class Delay {
@@ -41,12 +54,20 @@ private:
         ProcessSpec spec = { -1, 0, 0 };
         float delayPeriod = 0.0f;
         int delayInSamples = 0;
+        int alignmentInSamples = 0;
         bool bypassed = false;
         int writePosition = 0;
         juce::AudioBuffer<float> buffer;
     };
 
-    float reduction = 0.0f;
+    std::atomic<float> reduction{ 0.0f };
+
+    std::atomic<bool> truePeakEnabled{ false };
+    bool truePeakActive = false;
+    TruePeakDetector truePeakDetector;
+
+    // Sample peaks of the latest block, preceded by TruePeakDetector::latencyInSamples peaks of the previous one
+    HeapBlock<float> samplePeaks;
 
     Delay delay;
     ReductionCalculator gainReductionCalculator;
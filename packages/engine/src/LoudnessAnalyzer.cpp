@@ -0,0 +1,105 @@
+#include "LoudnessAnalyzer.h"
+#include "Trace.h"
+
+namespace medley {
+
+namespace {
+    constexpr double kChunkDuration = 1.0;
+    constexpr int kMaxCachedEntries = 8192;
+
+    constexpr double kMinGainDecibels = -24.0;
+    constexpr double kMaxGainDecibels = 12.0;
+
+    FileCache<double>& getCache() {
+        static FileCache<double> cache(kMaxCachedEntries);
+        return cache;
+    }
+}
+
+LoudnessAnalyzer::~LoudnessAnalyzer()
+{
+    cancel();
+}
+
+void LoudnessAnalyzer::analyze(const ITrack::Ptr track, AudioFormatReader* reader, OnDone callback)
+{
+    this->track = track;
+    this->reader.reset(reader);
+    this->callback = callback;
+
+    auto numChannels = jmin((int)reader->numChannels, LoudnessMeter::maxChannels);
+    auto chunkSize = jmax(1, (int)(reader->sampleRate * kChunkDuration));
+
+    buffer.setSize(numChannels, chunkSize, false, false, true);
+
+    meter.setTruePeakEnabled(false);
+    meter.prepare(numChannels, reader->sampleRate, chunkSize);
+
+    position = 0;
+}
+
+void LoudnessAnalyzer::cancel()
+{
+    reader = nullptr;
+    track = nullptr;
+    callback = nullptr;
+}
+
+int LoudnessAnalyzer::useTimeSlice()
+{
+    if (reader == nullptr) {
+        return -1;
+    }
+
+    Trace::ScopedSpan span("analyzeLoudness", "deck");
+
+    auto numSamples = (int)jmin((int64)buffer.getNumSamples(), reader->lengthInSamples - position);
+
+    if (numSamples > 0 && reader->read(&buffer, 0, numSamples, position, true, true)) {
+        meter.process(AudioSourceChannelInfo(&buffer, 0, numSamples));
+        meter.update();
+
+        position += numSamples;
+        return 0;
+    }
+
+    meter.update();
+
+    auto integrated = meter.getReadings().integrated;
+    auto file = track->getFile();
+    auto done = callback;
+    auto analyzedTrack = track;
+
+    cancel();
+
+    if (std::isfinite(integrated)) {
+        addToCache(file, integrated);
+    }
+
+    if (done) {
+        done(analyzedTrack, integrated);
+    }
+
+    return -1;
+}
+
+float LoudnessAnalyzer::toGain(double integratedLoudness)
+{
+    if (!std::isfinite(integratedLoudness)) {
+        return 0.0f;
+    }
+
+    return Decibels::decibelsToGain((float)jlimit(kMinGainDecibels, kMaxGainDecibels, referenceLoudness - integratedLoudness));
+}
+
+bool LoudnessAnalyzer::findCached(const File& file, double& integratedLoudness)
+{
+    return getCache().find(file, integratedLoudness);
+}
+
+void LoudnessAnalyzer::addToCache(const File& file, double integratedLoudness)
+{
+    getCache().set(file, integratedLoudness);
+}
+
+}
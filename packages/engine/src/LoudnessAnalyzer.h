@@ -0,0 +1,60 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "ITrack.h"
+#include "FileCache.h"
+#include "LoudnessMeter.h"
+
+namespace medley {
+
+/**
+ * Measures the integrated loudness of a whole track in the background
+ *
+ * The track is decoded a chunk at a time, one chunk per time slice, so other clients sharing the same thread are not held back.
+ * All methods must be called from the thread running this client.
+ */
+class LoudnessAnalyzer : public TimeSliceClient {
+public:
+    using OnDone = std::function<void(const ITrack::Ptr track, double integratedLoudness)>;
+
+    /**
+     * ReplayGain 2.0 reference level in LUFS
+     */
+    static constexpr double referenceLoudness = -18.0;
+
+    ~LoudnessAnalyzer() override;
+
+    /**
+     * Start measuring, takes ownership of the reader
+     */
+    void analyze(const ITrack::Ptr track, AudioFormatReader* reader, OnDone callback);
+
+    void cancel();
+
+    bool isAnalyzing() const { return reader != nullptr; }
+
+    int useTimeSlice() override;
+
+    /**
+     * Gain to bring a track measured at integratedLoudness to referenceLoudness
+     */
+    static float toGain(double integratedLoudness);
+
+    /**
+     * Results are cached by path, modification time and size, the least recently used are evicted
+     */
+    static bool findCached(const File& file, double& integratedLoudness);
+
+private:
+    static void addToCache(const File& file, double integratedLoudness);
+
+    ITrack::Ptr track;
+    std::unique_ptr<AudioFormatReader> reader;
+    OnDone callback;
+
+    LoudnessMeter meter;
+    AudioBuffer<float> buffer;
+    int64 position = 0;
+};
+
+}
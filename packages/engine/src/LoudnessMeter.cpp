@@ -0,0 +1,350 @@
+#include "LoudnessMeter.h"
+#include "Simd.h"
+
+namespace {
+    constexpr auto kAbsoluteGate = -70.0;
+    constexpr auto kRelativeGate = -10.0;
+}
+
+LoudnessMeter::LoudnessMeter()
+{
+    publish(Readings());
+}
+
+void LoudnessMeter::prepare(const int channels, const double sampleRate, const int maximumBlockSize)
+{
+    const ScopedLock sl(lock);
+    const ScopedLock psl(processLock);
+
+    numChannels = jmin(channels, maxChannels);
+    samplesPerRecord = jmax(1, roundToInt(sampleRate / kRecordsPerSecond));
+
+    scratchSize = jmax(1, maximumBlockSize);
+    weighted.allocate(scratchSize, true);
+    truePeakDetector.prepare(scratchSize);
+
+    // K-weighting, the BS.1770 48kHz filters re-derived for the actual sample rate
+    const auto pi = MathConstants<double>::pi;
+
+    Biquad shelf;
+    {
+        const auto f0 = 1681.974450955533;
+        const auto G = 3.999843853973347;
+        const auto Q = 0.7071752369554196;
+
+        const auto K = std::tan(pi * f0 / sampleRate);
+        const auto Vh = std::pow(10.0, G / 20.0);
+        const auto Vb = std::pow(Vh, 0.4996667741545416);
+        const auto a0 = 1.0 + K / Q + K * K;
+
+        shelf.b0 = (Vh + Vb * K / Q + K * K) / a0;
+        shelf.b1 = 2.0 * (K * K - Vh) / a0;
+        shelf.b2 = (Vh - Vb * K / Q + K * K) / a0;
+        shelf.a1 = 2.0 * (K * K - 1.0) / a0;
+        shelf.a2 = (1.0 - K / Q + K * K) / a0;
+    }
+
+    Biquad highpass;
+    {
+        const auto f0 = 38.13547087602444;
+        const auto Q = 0.5003270373238773;
+
+        const auto K = std::tan(pi * f0 / sampleRate);
+        const auto a0 = 1.0 + K / Q + K * K;
+
+        highpass.b0 = 1.0;
+        highpass.b1 = -2.0;
+        highpass.b2 = 1.0;
+        highpass.a1 = 2.0 * (K * K - 1.0) / a0;
+        highpass.a2 = (1.0 - K / Q + K * K) / a0;
+    }
+
+    for (int i = 0; i < maxChannels; i++) {
+        preFilter[i] = shelf;
+        rlbFilter[i] = highpass;
+    }
+
+    current = Record();
+    fifo.reset();
+
+    windowWrite = 0;
+    windowSize = 0;
+    clearIntegration();
+    resetPending = false;
+
+    publish(Readings());
+}
+
+void LoudnessMeter::process(const AudioSourceChannelInfo& info)
+{
+    const ScopedTryLock sl(processLock);
+
+    if (!sl.isLocked()) {
+        return;
+    }
+
+    const auto& buffer = *info.buffer;
+    const auto channels = jmin(buffer.getNumChannels(), numChannels);
+
+    if (channels <= 0) {
+        return;
+    }
+
+    ScopedNoDenormals noDenormals;
+
+    auto start = info.startSample;
+    const auto end = start + info.numSamples;
+
+    while (start < end) {
+        auto numSamples = jmin(end - start, samplesPerRecord - current.numSamples, scratchSize);
+
+        processChunk(buffer, channels, start, numSamples);
+
+        start += numSamples;
+        current.numSamples += numSamples;
+
+        if (current.numSamples >= samplesPerRecord) {
+            completeRecord();
+        }
+    }
+}
+
+void LoudnessMeter::processChunk(const AudioBuffer<float>& buffer, int channels, int start, int numSamples)
+{
+    auto dest = weighted.get();
+
+    for (int channel = 0; channel < channels; channel++) {
+        auto src = buffer.getReadPointer(channel, start);
+        auto& pre = preFilter[channel];
+        auto& rlb = rlbFilter[channel];
+
+        for (int i = 0; i < numSamples; i++) {
+            dest[i] = rlb.process(pre.process(src[i]));
+        }
+
+        current.sumOfSquares[channel] += medley::simd::sumOfSquares(dest, numSamples);
+
+        if (truePeakEnabled) {
+            current.truePeak[channel] = jmax(current.truePeak[channel], truePeakDetector.findPeak(channel, src, numSamples));
+        }
+    }
+
+    if (channels == 2) {
+        auto left = buffer.getReadPointer(0, start);
+        auto right = buffer.getReadPointer(1, start);
+
+        current.sumLR += medley::simd::sumOfProducts(left, right, numSamples);
+        current.sumLL += medley::simd::sumOfSquares(left, numSamples);
+        current.sumRR += medley::simd::sumOfSquares(right, numSamples);
+    }
+}
+
+void LoudnessMeter::completeRecord()
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    // When the consumer is not keeping up, the record is dropped
+    if (size1 > 0) {
+        records[start1] = current;
+        fifo.finishedWrite(1);
+    }
+
+    current = Record();
+}
+
+void LoudnessMeter::update()
+{
+    const ScopedLock sl(lock);
+
+    auto shouldPublish = false;
+
+    if (resetPending.exchange(false)) {
+        clearIntegration();
+        shouldPublish = true;
+    }
+
+    auto numReady = fifo.getNumReady();
+
+    if (numReady > 0) {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(numReady, start1, size1, start2, size2);
+
+        for (int i = 0; i < size1; i++) {
+            addRecord(records[start1 + i]);
+        }
+
+        for (int i = 0; i < size2; i++) {
+            addRecord(records[start2 + i]);
+        }
+
+        fifo.finishedRead(size1 + size2);
+        shouldPublish = true;
+    }
+
+    if (!shouldPublish) {
+        return;
+    }
+
+    Readings readings;
+
+    auto momentary = accumulate(kMomentaryRecords);
+    auto shortTerm = accumulate(kShortTermRecords);
+
+    auto meanSquare = [](const Record& r) {
+        auto sum = 0.0;
+        for (auto s : r.sumOfSquares) {
+            sum += s;
+        }
+
+        return r.numSamples > 0 ? sum / r.numSamples : 0.0;
+    };
+
+    readings.momentary = toLUFS(meanSquare(momentary));
+    readings.shortTerm = toLUFS(meanSquare(shortTerm));
+    readings.integrated = getIntegratedLoudness();
+
+    auto denominator = std::sqrt(momentary.sumLL * momentary.sumRR);
+    readings.correlation = denominator > 1.0e-12 ? jlimit(-1.0, 1.0, momentary.sumLR / denominator) : 0.0;
+
+    for (int i = 0; i < maxChannels; i++) {
+        readings.truePeak[i] = momentary.truePeak[i];
+        readings.maxTruePeak[i] = maxTruePeak[i];
+    }
+
+    publish(readings);
+}
+
+void LoudnessMeter::addRecord(const Record& record)
+{
+    window[windowWrite] = record;
+    windowWrite = (windowWrite + 1) % kShortTermRecords;
+    windowSize = jmin(windowSize + 1, kShortTermRecords);
+
+    for (int i = 0; i < maxChannels; i++) {
+        maxTruePeak[i] = jmax(maxTruePeak[i], (double)record.truePeak[i]);
+    }
+
+    if (windowSize < kMomentaryRecords) {
+        return;
+    }
+
+    // Gating blocks are 400ms long and overlap by 75%, a new one completes with every record
+    auto block = accumulate(kMomentaryRecords);
+
+    auto energy = 0.0;
+    for (auto s : block.sumOfSquares) {
+        energy += s;
+    }
+
+    energy /= jmax(1, block.numSamples);
+
+    auto loudness = toLUFS(energy);
+
+    if (loudness > kAbsoluteGate) {
+        auto bin = jlimit(0, kHistogramBins - 1, (int)((loudness - kHistogramMin) / kHistogramStep));
+
+        histogramCounts[bin]++;
+        histogramEnergy[bin] += energy;
+    }
+}
+
+LoudnessMeter::Record LoudnessMeter::accumulate(int count) const
+{
+    Record result;
+
+    count = jmin(count, windowSize);
+
+    for (int i = 1; i <= count; i++) {
+        const auto& r = window[(windowWrite - i + kShortTermRecords) % kShortTermRecords];
+
+        for (int ch = 0; ch < maxChannels; ch++) {
+            result.sumOfSquares[ch] += r.sumOfSquares[ch];
+            result.truePeak[ch] = jmax(result.truePeak[ch], r.truePeak[ch]);
+        }
+
+        result.sumLR += r.sumLR;
+        result.sumLL += r.sumLL;
+        result.sumRR += r.sumRR;
+        result.numSamples += r.numSamples;
+    }
+
+    return result;
+}
+
+double LoudnessMeter::getIntegratedLoudness() const
+{
+    uint64 count = 0;
+    auto energy = 0.0;
+
+    for (int i = 0; i < kHistogramBins; i++) {
+        count += histogramCounts[i];
+        energy += histogramEnergy[i];
+    }
+
+    if (count == 0) {
+        return -std::numeric_limits<double>::infinity();
+    }
+
+    auto relativeGate = toLUFS(energy / (double)count) + kRelativeGate;
+
+    // Only bins lying entirely above the relative gate are counted, the gate is thus accurate to kHistogramStep
+    auto firstBin = jlimit(0, kHistogramBins, (int)std::ceil((relativeGate - kHistogramMin) / kHistogramStep));
+
+    count = 0;
+    energy = 0.0;
+
+    for (int i = firstBin; i < kHistogramBins; i++) {
+        count += histogramCounts[i];
+        energy += histogramEnergy[i];
+    }
+
+    return count > 0 ? toLUFS(energy / (double)count) : -std::numeric_limits<double>::infinity();
+}
+
+void LoudnessMeter::clearIntegration()
+{
+    std::fill(std::begin(histogramCounts), std::end(histogramCounts), 0u);
+    std::fill(std::begin(histogramEnergy), std::end(histogramEnergy), 0.0);
+    std::fill(std::begin(maxTruePeak), std::end(maxTruePeak), 0.0);
+}
+
+void LoudnessMeter::resetIntegrated()
+{
+    resetPending = true;
+}
+
+void LoudnessMeter::publish(const Readings& readings)
+{
+    published.momentary.store(readings.momentary, std::memory_order_relaxed);
+    published.shortTerm.store(readings.shortTerm, std::memory_order_relaxed);
+    published.integrated.store(readings.integrated, std::memory_order_relaxed);
+    published.correlation.store(readings.correlation, std::memory_order_relaxed);
+
+    for (int i = 0; i < maxChannels; i++) {
+        published.truePeak[i].store(readings.truePeak[i], std::memory_order_relaxed);
+        published.maxTruePeak[i].store(readings.maxTruePeak[i], std::memory_order_relaxed);
+    }
+}
+
+LoudnessMeter::Readings LoudnessMeter::getReadings() const
+{
+    Readings readings;
+
+    readings.momentary = published.momentary.load(std::memory_order_relaxed);
+    readings.shortTerm = published.shortTerm.load(std::memory_order_relaxed);
+    readings.integrated = published.integrated.load(std::memory_order_relaxed);
+    readings.correlation = published.correlation.load(std::memory_order_relaxed);
+
+    for (int i = 0; i < maxChannels; i++) {
+        readings.truePeak[i] = published.truePeak[i].load(std::memory_order_relaxed);
+        readings.maxTruePeak[i] = published.maxTruePeak[i].load(std::memory_order_relaxed);
+    }
+
+    return readings;
+}
+
+double LoudnessMeter::toLUFS(double meanSquare)
+{
+    return meanSquare > 0.0 ? -0.691 + 10.0 * std::log10(meanSquare) : -std::numeric_limits<double>::infinity();
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include "TruePeakDetector.h"
+
+using namespace juce;
+
+/**
+ * EBU R128 / ITU-R BS.1770 loudness, true-peak and stereo correlation meter
+ *
+ * process() runs on the audio thread, it K-weights and oversamples the signal without allocating
+ * and hands over one record for every 100ms of audio through a lock-free FIFO.
+ *
+ * update() drains the FIFO, integrates the loudness and publishes the results, it must always be called from the same thread.
+ *
+ * The getters can be called from any thread.
+ */
+class LoudnessMeter
+{
+public:
+    static constexpr int maxChannels = 2;
+
+    struct Readings {
+        /**
+         * LUFS over the last 400ms
+         */
+        double momentary = -std::numeric_limits<double>::infinity();
+
+        /**
+         * LUFS over the last 3s
+         */
+        double shortTerm = -std::numeric_limits<double>::infinity();
+
+        /**
+         * Gated LUFS since the last reset
+         */
+        double integrated = -std::numeric_limits<double>::infinity();
+
+        /**
+         * Correlation between the left and right channels over the last 400ms, -1.0 - 1.0
+         */
+        double correlation = 0.0;
+
+        /**
+         * Highest 4x oversampled sample value over the last 400ms, in gain
+         */
+        double truePeak[maxChannels]{};
+
+        /**
+         * Highest true-peak since the last reset, in gain
+         */
+        double maxTruePeak[maxChannels]{};
+    };
+
+    LoudnessMeter();
+
+    void prepare(const int channels, const double sampleRate, const int maximumBlockSize);
+
+    void process(const AudioSourceChannelInfo& info);
+
+    void update();
+
+    Readings getReadings() const;
+
+    /**
+     * Restart the integrated loudness and the maximum true-peak, takes effect on the next update()
+     */
+    void resetIntegrated();
+
+    /**
+     * True-peak is the most expensive measurement, offline analysis only interested in loudness can skip it
+     */
+    void setTruePeakEnabled(bool enabled) { truePeakEnabled = enabled; }
+
+private:
+    static constexpr int kRecordsPerSecond = 10;
+    static constexpr int kMomentaryRecords = 4;
+    static constexpr int kShortTermRecords = 30;
+    static constexpr int kFifoSize = 64;
+
+    static constexpr double kHistogramMin = -70.0;
+    static constexpr double kHistogramMax = 10.0;
+    static constexpr double kHistogramStep = 0.1;
+    static constexpr int kHistogramBins = 800;
+
+    struct Biquad {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+        double z1 = 0.0, z2 = 0.0;
+
+        inline float process(float in) {
+            auto out = b0 * in + z1;
+            z1 = b1 * in - a1 * out + z2;
+            z2 = b2 * in - a2 * out;
+            return (float)out;
+        }
+
+        void reset() { z1 = z2 = 0.0; }
+    };
+
+    /**
+     * 100ms worth of measurement
+     */
+    struct Record {
+        double sumOfSquares[maxChannels]{};
+        double sumLR = 0.0;
+        double sumLL = 0.0;
+        double sumRR = 0.0;
+        float truePeak[maxChannels]{};
+        int numSamples = 0;
+    };
+
+    struct Published {
+        std::atomic<double> momentary{ 0.0 };
+        std::atomic<double> shortTerm{ 0.0 };
+        std::atomic<double> integrated{ 0.0 };
+        std::atomic<double> correlation{ 0.0 };
+        std::atomic<double> truePeak[maxChannels]{};
+        std::atomic<double> maxTruePeak[maxChannels]{};
+    };
+
+    void processChunk(const AudioBuffer<float>& buffer, int channels, int start, int numSamples);
+
+    void completeRecord();
+
+    void addRecord(const Record& record);
+
+    /**
+     * Combine the latest count records
+     */
+    Record accumulate(int count) const;
+
+    double getIntegratedLoudness() const;
+
+    void clearIntegration();
+
+    void publish(const Readings& readings);
+
+    static double toLUFS(double meanSquare);
+
+    // Audio thread
+    int numChannels = 0;
+    int samplesPerRecord = 4800;
+    Biquad preFilter[maxChannels];
+    Biquad rlbFilter[maxChannels];
+    HeapBlock<float> weighted;
+    int scratchSize = 0;
+    bool truePeakEnabled = true;
+    TruePeakDetector truePeakDetector;
+    Record current;
+
+    AbstractFifo fifo{ kFifoSize };
+    Record records[kFifoSize];
+
+    // Consumer thread
+    Record window[kShortTermRecords];
+    int windowWrite = 0;
+    int windowSize = 0;
+    uint32 histogramCounts[kHistogramBins]{};
+    double histogramEnergy[kHistogramBins]{};
+    double maxTruePeak[maxChannels]{};
+
+    std::atomic<bool> resetPending{ false };
+
+    // Guards prepare() against update()
+    CriticalSection lock;
+
+    // Guards prepare() against process(), process() only tries to lock and skips metering while being prepared
+    CriticalSection processLock;
+
+    Published published;
+};
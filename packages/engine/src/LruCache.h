@@ -0,0 +1,84 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+using namespace juce;
+
+namespace medley {
+
+/**
+ * Bounded least recently used cache, thread safe
+ */
+template <typename Value>
+class LruCache
+{
+public:
+    explicit LruCache(size_t capacity)
+        : capacity(capacity)
+    {
+
+    }
+
+    bool find(const std::string& key, Value& value)
+    {
+        const ScopedLock sl(lock);
+
+        auto it = index.find(key);
+
+        if (it == index.end()) {
+            return false;
+        }
+
+        // Most recently used first
+        items.splice(items.begin(), items, it->second);
+        value = it->second->second;
+        return true;
+    }
+
+    void set(const std::string& key, const Value& value)
+    {
+        const ScopedLock sl(lock);
+
+        auto it = index.find(key);
+
+        if (it != index.end()) {
+            it->second->second = value;
+            items.splice(items.begin(), items, it->second);
+            return;
+        }
+
+        items.emplace_front(key, value);
+        index[key] = items.begin();
+
+        while (items.size() > capacity) {
+            index.erase(items.back().first);
+            items.pop_back();
+        }
+    }
+
+    void clear()
+    {
+        const ScopedLock sl(lock);
+        items.clear();
+        index.clear();
+    }
+
+    size_t size() const
+    {
+        const ScopedLock sl(lock);
+        return items.size();
+    }
+
+private:
+    using Item = std::pair<std::string, Value>;
+
+    CriticalSection lock;
+    std::list<Item> items;
+    std::unordered_map<std::string, typename std::list<Item>::iterator> index;
+    size_t capacity;
+};
+
+}
@@ -3,6 +3,8 @@
 #include "OpusAudioFormat.h"
 #include "NullAudioDevice.h"
 #include "utils.h"
+#include "TrackInfoCache.h"
+#include "Trace.h"
 
 #if JUCE_WINDOWS
 #include <Windows.h>
@@ -12,14 +14,15 @@ namespace medley {
 
 Medley::Medley(IQueue& queue, ILoggerWriter* logWriter, bool skipDeviceScanning)
     :
+    prefetcher(formatMgr),
     audioInterceptor(*this),
     mixer(*this),
     watchdog(*this),
     queue(queue),
     loadingThread("Loading Thread"),
-    readAheadThread("Read-ahead-thread"),
     visualizationThread("Visualization Thread"),
-    audioInterceptionThread("Audio interception thread")
+    audioInterceptionThread("Audio interception thread"),
+    reclamationThread("Reclamation thread")
 {
 #if JUCE_WINDOWS
     static_cast<void>(::CoInitialize(nullptr));
@@ -46,15 +49,15 @@ Medley::Medley(IQueue& queue, ILoggerWriter* logWriter, bool skipDeviceScanning)
     deviceMgr.addChangeListener(&mixer);
 
     for (int i = 0; i < numDecks; i++) {
-        decks[i].reset(new Deck(i, "Deck " + String(i), logWriter, formatMgr, loadingThread, readAheadThread));
+        decks[i].reset(new Deck(i, "Deck " + String(i), logWriter, formatMgr, prefetcher, loadingThread, reclamationThread, tagWritingPool));
         decks[i]->addListener(this);
         mixer.addInputSource(decks[i].get(), false);
     }
 
     loadingThread.startThread(6);
-    readAheadThread.startThread(9);
     visualizationThread.startThread();
     audioInterceptionThread.startThread(9);
+    reclamationThread.startThread(3);
 
     loadingThread.addTimeSliceClient(&watchdog);
     visualizationThread.addTimeSliceClient(&mixer);
@@ -82,9 +85,12 @@ Medley::~Medley() {
     mainOut.setSource(nullptr);
 
     loadingThread.stopThread(100);
-    readAheadThread.stopThread(100);
     visualizationThread.stopThread(100);
     audioInterceptionThread.stopThread(100);
+    reclamationThread.stopThread(100);
+
+    // Pending writes are dropped, the one in progress still refers to its deck
+    tagWritingPool.removeAllJobs(false, -1);
 
     deviceMgr.closeAudioDevice();
 
@@ -93,6 +99,88 @@ Medley::~Medley() {
     }
 }
 
+static_assert(Medley::numDecks == EngineState::numDecks, "EngineState must hold every deck");
+
+void Medley::captureState(EngineState& state)
+{
+    auto mainDeck = getMainDeck();
+
+    state.playing = hasAnyDeckStarted() ? 1.0 : 0.0;
+    state.paused = isPaused() ? 1.0 : 0.0;
+    state.mainDeck = mainDeck != nullptr ? (double)mainDeck->index : -1.0;
+    state.volume = getVolume();
+    state.reduction = getReduction();
+
+    for (int i = 0; i < 2; i++) {
+        state.level[i] = getLevel(i);
+        state.peak[i] = getPeakLevel(i);
+        state.rms[i] = getRMSLevel(i);
+    }
+
+    auto loudness = getLoudness();
+
+    state.momentary = loudness.momentary;
+    state.shortTerm = loudness.shortTerm;
+    state.integrated = loudness.integrated;
+    state.correlation = loudness.correlation;
+
+    for (int i = 0; i < 2; i++) {
+        state.truePeak[i] = loudness.truePeak[i];
+        state.maxTruePeak[i] = loudness.maxTruePeak[i];
+    }
+
+    for (int i = 0; i < numDecks; i++) {
+        auto deck = decks[i].get();
+        auto& ds = state.decks[i];
+
+        ds = DeckState();
+
+        const auto& levels = deck->getLevelTracker();
+
+        for (int c = 0; c < 2; c++) {
+            ds.level[c] = levels.getLevel(c);
+            ds.peak[c] = levels.getPeak(c);
+            ds.rms[c] = levels.getRMS(c);
+        }
+
+        if (!deck->isTrackLoaded()) {
+            continue;
+        }
+
+        auto nextDeck = getNextDeck(deck);
+        auto sr = deck->getSourceSampleRate();
+        auto nextLeading = (nextDeck != nullptr && nextDeck->isTrackLoaded() && !nextDeck->isMain()) ? nextDeck->getLeadingDuration() : 0.0;
+
+        ds.loaded = 1.0;
+        ds.playing = deck->hasStarted() ? 1.0 : 0.0;
+        ds.main = deck->isMain() ? 1.0 : 0.0;
+        ds.volume = deck->getVolume();
+        ds.position = deck->getPosition();
+        ds.duration = deck->getDuration();
+        ds.first = deck->getFirstAudiblePosition();
+        ds.last = deck->getEndPosition();
+        ds.leading = sr > 0 ? deck->getLeadingSamplePosition() / sr : 0.0;
+        ds.trailing = sr > 0 ? deck->getTrailingSamplePosition() / sr : 0.0;
+        ds.cuePoint = deck->getTransitionCuePosition();
+        ds.transitionStart = deck->getTransitionStartPosition() - nextLeading;
+        ds.transitionEnd = deck->getTransitionEndPosition();
+    }
+}
+
+void Medley::setStateSnapshot(std::shared_ptr<StateSnapshot> snapshot)
+{
+    std::atomic_store(&stateSnapshot, snapshot);
+}
+
+void Medley::publishState()
+{
+    if (auto snapshot = std::atomic_load(&stateSnapshot)) {
+        EngineState state;
+        captureState(state);
+        snapshot->publish(state);
+    }
+}
+
 Medley::SupportedFormats::SupportedFormats()
     : AudioFormatManager()
 {
@@ -155,7 +243,7 @@ void Medley::updateTransition(Deck* deck) {
                 if (position < nextDeckStart) {
                     nextDeck->internalPause();
                     nextDeck->setVolume(decksTransition[nextDeck->index].fader.getFrom());
-                    *pState = DeckTransitionState::NextIsReady;
+                    setTransitionState(d->index, DeckTransitionState::NextIsReady);
                 }
             }
 
@@ -255,6 +343,18 @@ void Medley::changeListenerCallback(ChangeBroadcaster* source)
     }
 }
 
+void Medley::setTransitionState(int deckIndex, DeckTransitionState newState) {
+    static const char* names[] = { "Idle", "Enqueue", "CueNext", "NextIsLoading", "NextIsReady", "TransitToNext" };
+
+    auto& transition = decksTransition[deckIndex];
+
+    if (transition.state != newState) {
+        Trace::instant(names[(int)newState], "transition", "deck", deckIndex);
+    }
+
+    transition.state = newState;
+}
+
 void Medley::loadNextTrack(Deck* currentDeck, bool play, Deck::OnLoadingDone onLoadingDone) {
     // Queue is empty, request to fill it with some tracks
     if (queue.count() <= 0) {
@@ -275,7 +375,11 @@ void Medley::loadNextTrack(Deck* currentDeck, bool play, Deck::OnLoadingDone onL
                 return;
             }
 
-            listener.enqueueNext([this, p = play, onLoadingDone](bool enqueueResult) {
+            auto enqueueStart = Time::getHighResolutionTicks();
+
+            listener.enqueueNext([this, p = play, onLoadingDone, enqueueStart](bool enqueueResult) {
+                Trace::complete("enqueueNext", "queue", enqueueStart, "result", enqueueResult);
+
                 enqueueInProgress.store(false);
 
                 if (enqueueResult && queue.count() > 0) {
@@ -309,6 +413,15 @@ void Medley::loadNextTrack(Deck* currentDeck, bool play, Deck::OnLoadingDone onL
 
         if (auto track = queue.fetchNextTrack()) {
             const Deck::OnLoadingDone deckLoadingHandler = [this, _onLoadingDone = onLoadingDone, p = play, nd = nextDeck](bool loadingResult) {
+                // Not before the deck has taken the prefetched reader, the queue is not touched from this thread
+                {
+                    ScopedLock sl(callbackLock);
+
+                    listeners.call([](Callback& cb) {
+                        cb.trackFetched();
+                    });
+                }
+
                 if (loadingResult) {
                     _onLoadingDone(true);
 
@@ -419,7 +532,7 @@ void Medley::deckStarted(Deck& sender, TrackPlay& trackPlay) {
 }
 
 void Medley::deckFinished(Deck& sender, TrackPlay& trackPlay) {
-    decksTransition[sender.index].state = DeckTransitionState::Idle;
+    setTransitionState(sender.index, DeckTransitionState::Idle);
 
     ScopedLock sl(callbackLock);
     listeners.call([&](Callback& cb) {
@@ -429,7 +542,7 @@ void Medley::deckFinished(Deck& sender, TrackPlay& trackPlay) {
 
 void Medley::deckLoaded(Deck& sender, TrackPlay& trackPlay)
 {
-    decksTransition[sender.index].state = DeckTransitionState::Idle;
+    setTransitionState(sender.index, DeckTransitionState::Idle);
 
     ScopedLock sl(callbackLock);
     listeners.call([&](Callback& cb) {
@@ -452,7 +565,7 @@ void Medley::deckUnloaded(Deck& sender, TrackPlay& trackPlay) {
         }
     }
 
-    decksTransition[sender.index].state = DeckTransitionState::Idle;
+    setTransitionState(sender.index, DeckTransitionState::Idle);
     transitingFromDeck.store(nullptr);
     nextDeck->setVolume(1.0f);
 
@@ -526,7 +639,7 @@ void Medley::deckPosition(Deck& sender, double position) {
             if (position > enqueuePos) {
                 if (queue.count() == 0)
                 {
-                    pTransition->state = DeckTransitionState::Enqueue;
+                    setTransitionState(sender.index, DeckTransitionState::Enqueue);
                     ScopedLock sl(callbackLock);
 
                     auto deckIndex = sender.index;
@@ -538,7 +651,11 @@ void Medley::deckPosition(Deck& sender, double position) {
                             return;
                         }
 
-                        cb.enqueueNext([this, deckIndex, cuePos](bool done) {
+                        auto enqueueStart = Time::getHighResolutionTicks();
+
+                        cb.enqueueNext([this, deckIndex, cuePos, enqueueStart](bool done) {
+                            Trace::complete("enqueueNext", "queue", enqueueStart, "result", done);
+
                             auto pTransition = &decksTransition[deckIndex];
                             auto pSender = decks[deckIndex].get();
 
@@ -547,32 +664,32 @@ void Medley::deckPosition(Deck& sender, double position) {
                             }
 
                             if (done) {
-                                pTransition->state = DeckTransitionState::CueNext;
+                                setTransitionState(deckIndex, DeckTransitionState::CueNext);
 
                                 if (keepPlaying && !hasAnyDeckStarted()) {
                                     // Playing has stopped during enqueuing phase and caused the timing to stop either
                                     // re-trigger timing
                                     logger->warn("Enqueuing had been stalled and could not provide track in time");
                                     deckPosition(*pSender, cuePos + 0.1);
-                                    pTransition->state = DeckTransitionState::Idle;
+                                    setTransitionState(deckIndex, DeckTransitionState::Idle);
                                     return;
                                 }
                             }
                             else {
-                                pTransition->state = DeckTransitionState::Idle; // Move back to the previous state, this will cause a retry
+                                setTransitionState(deckIndex, DeckTransitionState::Idle); // Move back to the previous state, this will cause a retry
                             }
                         });
                     });
                 }
                 else {
-                    pTransition->state = DeckTransitionState::CueNext;
+                    setTransitionState(sender.index, DeckTransitionState::CueNext);
                 }
             }
         }
 
         if (pTransition->state == DeckTransitionState::CueNext) {
             if (position > cuePos) {
-                pTransition->state = DeckTransitionState::NextIsLoading;
+                setTransitionState(sender.index, DeckTransitionState::NextIsLoading);
 
                 auto currentDeckIndex = sender.index;
                 auto nextDeckIndex = nextDeck->index;
@@ -590,7 +707,7 @@ void Medley::deckPosition(Deck& sender, double position) {
 
                     if (loaded) {
                         transitingFromDeck.store(cd);
-                        pTransition->state = DeckTransitionState::NextIsReady;
+                        setTransitionState(currentDeckIndex, DeckTransitionState::NextIsReady);
 
                         if (forceFadingOut.load() > 0) {
                             pNextTransition->fader.start(position, transitionEndPos, 0.0f, 1.0f, fadingFactor * 0.5f);
@@ -603,7 +720,7 @@ void Medley::deckPosition(Deck& sender, double position) {
                     }
                     else {
                         transitingFromDeck.store(nullptr);
-                        pTransition->state = DeckTransitionState::CueNext; // Move back to the previous state, this will cause a retry
+                        setTransitionState(currentDeckIndex, DeckTransitionState::CueNext); // Move back to the previous state, this will cause a retry
 
                         // No more track, do not transit
                         if (forceFadingOut.load() <= 0) {
@@ -642,7 +759,11 @@ void Medley::doTransition(Deck* deck, double position) {
             if (pTransition->state == DeckTransitionState::NextIsReady) {
                 nextDeck->log(LogLevel::Debug, "Transiting to this deck");
 
-                pTransition->state = DeckTransitionState::TransitToNext;
+                setTransitionState(deck->index, DeckTransitionState::TransitToNext);
+
+                if (nextDeckStart >= 0) {
+                    stats.transitionLateness.recordSeconds(position - nextDeckStart);
+                }
 
                 nextDeck->setVolume(1.0f);
                 nextDeck->setPosition(nextDeck->getFirstAudiblePosition());
@@ -850,8 +971,8 @@ void Medley::updateFadingFactor() {
     fadingFactor = (float)(1000.0 / (((100.0 - fadingCurve) / inRange * outRange) + 1.0));
 }
 
-bool Medley::isTrackLoadable(const ITrack::Ptr track) {
-    return utils::isTrackLoadable(formatMgr, track);
+bool Medley::isTrackLoadable(const ITrack::Ptr track, bool deep) {
+    return TrackInfoCache::probe(formatMgr, track->getFile(), deep ? TrackProbe::DeepLoadable : TrackProbe::Loadable)->isLoadable();
 }
 
 void Medley::setReplayGainBoost(float decibels)
@@ -861,6 +982,45 @@ void Medley::setReplayGainBoost(float decibels)
     }
 }
 
+void Medley::setLoudnessCorrectionEnabled(bool enabled)
+{
+    for (auto& deck : decks) {
+        deck->setLoudnessCorrectionEnabled(enabled);
+    }
+
+    prefetcher.setLoudnessMeasuringEnabled(enabled);
+}
+
+void Medley::setPrefetchCount(int count)
+{
+    prefetchCount = jmax(0, count);
+    queueChanged();
+}
+
+void Medley::queueChanged()
+{
+    std::vector<ITrack::Ptr> upcoming;
+
+    for (size_t index = 0; index < (size_t)prefetchCount.load(); index++) {
+        auto track = queue.peek(index);
+
+        if (track == nullptr) {
+            break;
+        }
+
+        upcoming.push_back(track);
+    }
+
+    prefetcher.prefetch(upcoming);
+}
+
+void Medley::setAnalysisTagWritingEnabled(bool enabled)
+{
+    for (auto& deck : decks) {
+        deck->setAnalysisTagWritingEnabled(enabled);
+    }
+}
+
 int Medley::AudioInterceptor::useTimeSlice()
 {
     AudioBuffer<float> buffer;
@@ -873,6 +1033,8 @@ int Medley::AudioInterceptor::useTimeSlice()
 
         buffer = buffers.front();
         buffers.pop();
+
+        medley.stats.interceptorQueueDepth.set((uint32)buffers.size());
     }
 
     medley.dispatchAudio(AudioSourceChannelInfo(&buffer, 0, buffer.getNumSamples()), medley.getCurrentTime());
@@ -891,6 +1053,8 @@ void Medley::AudioInterceptor::addBuffer(AudioBuffer<float>& buffer, int startSa
     {
         ScopedLock sl(lock);
         buffers.push(newBuffer);
+
+        medley.stats.interceptorQueueDepth.set((uint32)buffers.size());
     }
 }
 
@@ -925,7 +1089,19 @@ bool Medley::Mixer::togglePause(bool fade) {
     return !paused;
 }
 
+void Medley::Mixer::prepareToPlay(int samplesPerBlockExpected, double newSampleRate) {
+    // The audio thread is about to start, it binds to a buffer set aside for it
+    Trace::reserveAudioThread();
+
+    MixerAudioSource::prepareToPlay(samplesPerBlockExpected, newSampleRate);
+}
+
 void Medley::Mixer::getNextAudioBlock(const AudioSourceChannelInfo& info) {
+    Histogram::ScopedTimer timer(medley.stats.mixerCallback);
+
+    Trace::bindAudioThread();
+    Trace::ScopedSpan span("audioCallback", "audio");
+
     currentTime = Time::getMillisecondCounterHiRes();
 
     if (!outputStarted) {
@@ -986,7 +1162,13 @@ void Medley::Mixer::changeListenerCallback(ChangeBroadcaster* source) {
 
 int Medley::Mixer::useTimeSlice()
 {
-    processor.updateLevelTracker();
+    processor.updateMeters();
+
+    for (auto& deck : medley.decks) {
+        deck->updateLevelTracker();
+    }
+
+    medley.publishState();
     return 5;
 }
 
@@ -1020,6 +1202,11 @@ void Medley::Mixer::updateAudioConfig()
 
         processor.prepare(audioSpec, latencyInSamples);
 
+        // Decks are heard after going through the processor
+        for (auto& deck : medley.decks) {
+            deck->setOutputLatency(latencyInSamples + processor.getLatencyInSamples());
+        }
+
         prepared = true;
     }
 }
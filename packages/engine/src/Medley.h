@@ -6,6 +6,8 @@
 #include "Deck.h"
 #include "PostProcessor.h"
 #include "Fader.h"
+#include "StateSnapshot.h"
+#include "Prefetcher.h"
 #include <list>
 #include <memory>
 #include <atomic>
@@ -19,6 +21,11 @@ class IQueue {
 public:
     virtual size_t count() const = 0;
     virtual ITrack::Ptr fetchNextTrack() = 0;
+
+    /**
+     * The track at index without removing it, nullptr if there is none. Queues not implementing this are never prefetched
+     */
+    virtual ITrack::Ptr peek(size_t index) const { return nullptr; }
 };
 
 class Medley : public Deck::Callback, juce::ChangeListener, public KaraokeParamController  {
@@ -32,6 +39,12 @@ public:
         virtual void enqueueNext(EnqueueNextDone done = [](bool) { }) = 0;
 
         virtual void mainDeckChanged(Deck& sender, TrackPlay& track) = 0;
+
+        /**
+         * A track was taken from the queue and a deck is done loading it, on the loading thread.
+         * Call queueChanged() from the thread modifying the queue so the tracks no longer upcoming stop being prefetched
+         */
+        virtual void trackFetched() { }
     };
 
     typedef AudioDeviceManager::AudioDeviceSetup AudioDeviceConfig;
@@ -94,6 +107,30 @@ public:
 
     double getOutputSampleRate();
 
+    /**
+     * Proportion of the audio callback period spent in processing, 0.0 - 1.0
+     */
+    inline double getCpuUsage() const { return deviceMgr.getCpuUsage(); }
+
+    struct Stats {
+        /**
+         * Time spent in the mixer audio callback, including decks and post processing
+         */
+        Histogram mixerCallback;
+        /**
+         * Delay between the planned start of the next deck and when it was actually started
+         */
+        Histogram transitionLateness{ Histogram::Unit::Milliseconds };
+        /**
+         * Number of blocks waiting to be dispatched to audio callbacks
+         */
+        Gauge interceptorQueueDepth;
+    };
+
+    const Stats& getStats() const { return stats; }
+
+    const Histogram& getPostProcessTime() const { return mixer.processor.getProcessTime(); }
+
     inline Deck& getDeck1() const { return *decks[0]; }
 
     inline Deck& getDeck2() const { return *decks[1]; }
@@ -168,6 +205,24 @@ public:
         return mixer.processor.isClipping(channel);
     }
 
+    /**
+     * RMS level over the last 300ms
+     */
+    double getRMSLevel(int channel) {
+        return mixer.processor.getRMS(channel);
+    }
+
+    LoudnessMeter::Readings getLoudness() const {
+        return mixer.processor.getLoudness();
+    }
+
+    /**
+     * Restart the integrated loudness measurement
+     */
+    void resetLoudness() {
+        mixer.processor.resetLoudness();
+    }
+
     /**
      * Reduction in dB
      */
@@ -175,14 +230,72 @@ public:
         return mixer.processor.getReduction();
     }
 
+    /**
+     * Limit the inter-sample peaks of the main output as well, see LookAheadLimiter::setTruePeakEnabled()
+     */
+    void setTruePeakLimiterEnabled(bool enabled) { mixer.processor.setTruePeakLimiterEnabled(enabled); }
+
+    bool isTruePeakLimiterEnabled() const { return mixer.processor.isTruePeakLimiterEnabled(); }
+
+    /**
+     * Processing nodes of the main output, see PostProcessor::getGraph()
+     */
+    ProcessingGraph& getProcessingGraph() { return mixer.processor.getGraph(); }
+
+    /**
+     * Multiband processor of the main output, see PostProcessor::getMultiband()
+     */
+    MultibandProcessor& getMultiband() { return mixer.processor.getMultiband(); }
+
+    /**
+     * Fill state with the current playback state, levels and deck positions
+     */
+    void captureState(EngineState& state);
+
+    /**
+     * Periodically publish the engine state into snapshot from the visualization thread, nullptr to stop publishing
+     */
+    void setStateSnapshot(std::shared_ptr<StateSnapshot> snapshot);
+
     void changeListenerCallback(ChangeBroadcaster* source) override;
 
-    bool isTrackLoadable(const ITrack::Ptr track);
+    /**
+     * By default the file header is sniffed and the first frames are parsed, with deep a decoder is created
+     */
+    bool isTrackLoadable(const ITrack::Ptr track, bool deep = false);
 
     void setReplayGainBoost(float decibels);
 
     float getReplayGainBoost() const { return decks[0]->getReplayGainBoost(); }
 
+    /**
+     * Measure the loudness of tracks without ReplayGain metadata while they are being scanned and use it as gain correction
+     */
+    void setLoudnessCorrectionEnabled(bool enabled);
+
+    bool isLoudnessCorrectionEnabled() const { return decks[0]->isLoudnessCorrectionEnabled(); }
+
+    /**
+     * Number of upcoming tracks in the queue to prefetch, 0 disables prefetching
+     */
+    void setPrefetchCount(int count);
+
+    int getPrefetchCount() const { return prefetchCount; }
+
+    Array<File> getPrefetchedFiles() const { return prefetcher.getPrefetchedFiles(); }
+
+    /**
+     * Let the engine know the queue has changed so the upcoming tracks are prefetched, call it from the thread modifying the queue
+     */
+    void queueChanged();
+
+    /**
+     * Write the cue points and the loudness found by the analysis back into the tracks' tags, so they are not analyzed again
+     */
+    void setAnalysisTagWritingEnabled(bool enabled);
+
+    bool isAnalysisTagWritingEnabled() const { return decks[0]->isAnalysisTagWritingEnabled(); }
+
     bool isKaraokeEnabled() const override;
 
     bool setKaraokeEnabled(bool enabled, bool dontTransit = false) override;
@@ -222,6 +335,8 @@ private:
 
     void dispatchAudio(const AudioSourceChannelInfo& info, double timestamp);
 
+    void publishState();
+
     class AudioInterceptor : public juce::TimeSliceClient {
     public:
         friend class Medley;
@@ -254,6 +369,8 @@ private:
 
         bool togglePause(bool fade = true);
 
+        void prepareToPlay(int samplesPerBlockExpected, double newSampleRate) override;
+
         void getNextAudioBlock(const AudioSourceChannelInfo& info) override;
 
         inline bool isPaused() const { return paused; }
@@ -314,8 +431,14 @@ private:
 
     SupportedFormats formatMgr;
 
+    Prefetcher prefetcher;
+
     std::unique_ptr<Deck> decks[numDecks];
 
+    Stats stats;
+
+    std::shared_ptr<StateSnapshot> stateSnapshot;
+
     AudioInterceptor audioInterceptor;
 
     Mixer mixer;
@@ -326,9 +449,10 @@ private:
     IQueue& queue;
 
     TimeSliceThread loadingThread;
-    TimeSliceThread readAheadThread;
     TimeSliceThread visualizationThread;
     TimeSliceThread audioInterceptionThread;
+    TimeSliceThread reclamationThread;
+    ThreadPool tagWritingPool{ 1 };
 
     bool keepPlaying = false;
 
@@ -356,6 +480,8 @@ private:
 
     deck_transition_t decksTransition[numDecks]{};
 
+    void setTransitionState(int deckIndex, DeckTransitionState newState);
+
     double fadingCurve = 60;
     float fadingFactor{};
 
@@ -364,6 +490,7 @@ private:
 
     std::atomic<int> forceFadingOut{0};
     std::atomic<bool> enqueueInProgress{false};
+    std::atomic<int> prefetchCount{ 2 };
 
     CriticalSection callbackLock;
     ListenerList<Callback> listeners;
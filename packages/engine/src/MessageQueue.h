@@ -0,0 +1,53 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+using namespace juce;
+
+/**
+ * Hands small messages, like parameter changes, over to the audio thread
+ *
+ * Any thread can push, pushing is serialized by a lock the audio thread never takes.
+ * The audio thread pops everything pending at the start of a block, without locking or allocating.
+ */
+template <typename Message, int capacity = 128>
+class MessageQueue
+{
+public:
+    /**
+     * Returns false if the queue is full, the message is then dropped
+     */
+    bool push(const Message& message)
+    {
+        const ScopedLock sl(writeLock);
+
+        auto scope = fifo.write(1);
+
+        if (scope.blockSize1 > 0) {
+            messages[scope.startIndex1] = message;
+            return true;
+        }
+
+        if (scope.blockSize2 > 0) {
+            messages[scope.startIndex2] = message;
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * Audio thread, calls callback for every pending message in the order they were pushed
+     */
+    template <typename Callback>
+    void popAll(Callback&& callback)
+    {
+        const auto scope = fifo.read(fifo.getNumReady());
+        scope.forEach([&](int index) { callback(messages[index]); });
+    }
+
+private:
+    CriticalSection writeLock;
+    AbstractFifo fifo{ capacity };
+    Message messages[capacity]{};
+};
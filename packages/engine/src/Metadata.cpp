@@ -1,4 +1,5 @@
 #include "Metadata.h"
+#include "Trace.h"
 #include <taglib/tfilestream.h>
 #include <taglib/textidentificationframe.h>
 #include <taglib/xiphcomment.h>
@@ -98,17 +99,9 @@ void medley::Metadata::readFromTrack(const ITrack::Ptr track)
 
 void medley::Metadata::readFromFile(const File& file)
 {
-    bpm = 0.0f;
-    trackGain = 0.0f;
-    cueIn = -1.0;
-    cueOut = -1.0;
-    lastAudible = -1.0;
-    title = "";
-    artist = "";
-    album = "";
-    isrc = "";
-    albumArtist = "";
-    originalArtist = "";
+    medley::Trace::ScopedSpan span("readMetadata", "io");
+
+    reset();
 
     try {
         auto filetype = utils::getFileTypeFromFileName(file);
@@ -157,6 +150,21 @@ void medley::Metadata::readFromFile(const File& file)
     }
 }
 
+void medley::Metadata::reset()
+{
+    bpm = 0.0f;
+    trackGain = 0.0f;
+    cueIn = -1.0;
+    cueOut = -1.0;
+    lastAudible = -1.0;
+    title = "";
+    artist = "";
+    album = "";
+    isrc = "";
+    albumArtist = "";
+    originalArtist = "";
+}
+
 void medley::Metadata::readMpeg(const juce::File& f)
 {
 #ifdef _WIN32
@@ -173,14 +181,7 @@ void medley::Metadata::readMpeg(const juce::File& f)
 
     try {
         TagLib::MPEG::File file(&stream, false, TagLib::MPEG::Properties::Fast);
-
-        if (!file.hasID3v2Tag()) {
-            return;
-        }
-
-        auto& tag = *file.ID3v2Tag();
-        readBasicTag(tag);
-        readID3Tag(tag);
+        read(file);
     }
     catch (...) {
         throw std::runtime_error("reading MPEG");
@@ -203,14 +204,7 @@ void medley::Metadata::readFLAC(const File& f)
 
     try {
         TagLib::FLAC::File file(&stream, false, TagLib::FLAC::Properties::Fast);
-
-        if (!file.hasXiphComment()) {
-            return;
-        }
-
-        auto& tag = *file.xiphComment();
-        readBasicTag(tag);
-        readXiphTag(tag);
+        read(file);
     }
     catch (...) {
         throw std::runtime_error("reading FLAC");
@@ -233,21 +227,7 @@ void medley::Metadata::readOPUS(const File& f)
 
     try {
         TagLib::Ogg::Opus::File file(&stream, false, TagLib::Ogg::Opus::Properties::Fast);
-
-        auto& tag = *file.tag();
-        readBasicTag(tag);
-        readXiphTag(tag, false); // Do not read replaygain
-
-        // Assume OPUS Output gain was revert during the decoding phase.
-        auto headerGain = file.packet(0).toShort(16, false);
-        if (headerGain != 0) {
-            // The output gain is encoded as decibels in Q7.8 notation, hence divide by 256 here
-            auto outputGain = headerGain / 256.0f;
-            // Since the gain is applied with -23dBFS reference point for opus but we use ReplayGain which has -18dbFS as the reference point
-            // So it's 5dB apart
-            constexpr float gainCompensation = 5.0f;
-            this->trackGain = Decibels::decibelsToGain(outputGain + gainCompensation);
-        }
+        read(file);
     }
     catch (...) {
         throw std::runtime_error("reading OPUS");
@@ -270,10 +250,7 @@ void medley::Metadata::readOggVorbis(const File& f)
 
     try {
         TagLib::Ogg::Vorbis::File file(&stream, false, TagLib::Ogg::Vorbis::Properties::Fast);
-
-        auto& tag = *file.tag();
-        readBasicTag(tag);
-        readXiphTag(tag);
+        read(file);
     }
     catch (...) {
         throw std::runtime_error("reading Ogg Vorbis");
@@ -296,13 +273,7 @@ void medley::Metadata::readWAV(const File& f)
 
     try {
         TagLib::RIFF::WAV::File file(&stream, false, TagLib::RIFF::WAV::Properties::Fast);
-
-        auto& tag = *file.tag();
-        readBasicTag(tag);
-
-        if (file.hasID3v2Tag()) {
-            readID3Tag(*file.ID3v2Tag());
-        }
+        read(file);
     }
     catch (...) {
         throw std::runtime_error("reading Wav");
@@ -325,19 +296,80 @@ void medley::Metadata::readAIFF(const File& f)
 
     try {
         TagLib::RIFF::AIFF::File file(&stream, false, TagLib::RIFF::AIFF::Properties::Fast);
-
-        auto& tag = *file.tag();
-        readBasicTag(tag);
-
-        if (file.hasID3v2Tag()) {
-            readID3Tag(tag);
-        }
+        read(file);
     }
     catch (...) {
         throw std::runtime_error("reading Aiff");
     }
 }
 
+void medley::Metadata::read(TagLib::MPEG::File& file)
+{
+    if (!file.hasID3v2Tag()) {
+        return;
+    }
+
+    auto& tag = *file.ID3v2Tag();
+    readBasicTag(tag);
+    readID3Tag(tag);
+}
+
+void medley::Metadata::read(TagLib::FLAC::File& file)
+{
+    if (!file.hasXiphComment()) {
+        return;
+    }
+
+    auto& tag = *file.xiphComment();
+    readBasicTag(tag);
+    readXiphTag(tag);
+}
+
+void medley::Metadata::read(TagLib::Ogg::Opus::File& file)
+{
+    auto& tag = *file.tag();
+    readBasicTag(tag);
+    readXiphTag(tag, false); // Do not read replaygain
+
+    // Assume OPUS Output gain was revert during the decoding phase.
+    auto headerGain = file.packet(0).toShort(16, false);
+    if (headerGain != 0) {
+        // The output gain is encoded as decibels in Q7.8 notation, hence divide by 256 here
+        auto outputGain = headerGain / 256.0f;
+        // Since the gain is applied with -23dBFS reference point for opus but we use ReplayGain which has -18dbFS as the reference point
+        // So it's 5dB apart
+        constexpr float gainCompensation = 5.0f;
+        this->trackGain = Decibels::decibelsToGain(outputGain + gainCompensation);
+    }
+}
+
+void medley::Metadata::read(TagLib::Ogg::Vorbis::File& file)
+{
+    auto& tag = *file.tag();
+    readBasicTag(tag);
+    readXiphTag(tag);
+}
+
+void medley::Metadata::read(TagLib::RIFF::WAV::File& file)
+{
+    auto& tag = *file.tag();
+    readBasicTag(tag);
+
+    if (file.hasID3v2Tag()) {
+        readID3Tag(*file.ID3v2Tag());
+    }
+}
+
+void medley::Metadata::read(TagLib::RIFF::AIFF::File& file)
+{
+    auto& tag = *file.tag();
+    readBasicTag(tag);
+
+    if (file.hasID3v2Tag()) {
+        readID3Tag(tag);
+    }
+}
+
 void medley::Metadata::readBasicTag(const TagLib::Tag& tag)
 {
     title = tag.title().toCWString();
@@ -494,12 +526,7 @@ void medley::Metadata::CoverAndLyrics::readMpeg(const File& f, bool readCover, b
 
     try {
         TagLib::MPEG::File file(&stream, false, TagLib::MPEG::Properties::Fast);
-
-        if (file.hasID3v2Tag()) {
-            auto& tag = *file.ID3v2Tag();
-            readID3Tag(tag, readCover, readLyrics);
-        }
-
+        read(file, readCover, readLyrics);
     }
     catch (...) {
         throw std::runtime_error("reading MPEG");
@@ -522,20 +549,7 @@ void medley::Metadata::CoverAndLyrics::readFLAC(const File& f, bool readCover, b
 
     try {
         TagLib::FLAC::File file(&stream, false, TagLib::FLAC::Properties::Fast);
-
-        if (readCover) {
-            auto pictures = file.pictureList();
-
-            if (pictures.isEmpty() && file.hasXiphComment()) {
-                pictures = file.xiphComment()->pictureList();
-            }
-
-            readPictures(pictures);
-        }
-
-        if (readLyrics) {
-            readXiphLyrics(*file.xiphComment());
-        }
+        read(file, readCover, readLyrics);
     }
     catch (...) {
         throw std::runtime_error("reading FLAC");
@@ -557,18 +571,8 @@ void medley::Metadata::CoverAndLyrics::readOPUS(const File& f, bool readCover, b
     }
 
     try {
-
         TagLib::Ogg::Opus::File file(&stream, false, TagLib::Ogg::Opus::Properties::Fast);
-
-        auto tag = file.tag();
-
-        if (readCover) {
-            readPictures(tag->pictureList());
-        }
-
-        if (readLyrics) {
-            readXiphLyrics(*tag);
-        }
+        read(file, readCover, readLyrics);
     }
     catch (...) {
         throw std::runtime_error("reading OPUS");
@@ -591,16 +595,7 @@ void medley::Metadata::CoverAndLyrics::readOggVorbis(const File& f, bool readCov
 
     try {
         TagLib::Ogg::Vorbis::File file(&stream, false, TagLib::Ogg::Vorbis::Properties::Fast);
-
-        auto tag = file.tag();
-
-        if (readCover) {
-            readPictures(tag->pictureList());
-        }
-
-        if (readLyrics) {
-            readXiphLyrics(*tag);
-        }
+        read(file, readCover, readLyrics);
     }
     catch (...) {
         throw std::runtime_error("reading Ogg Vorbis");
@@ -623,11 +618,7 @@ void medley::Metadata::CoverAndLyrics::readWAV(const File& f, bool readCover, bo
 
     try {
         TagLib::RIFF::WAV::File file(&stream, false, TagLib::RIFF::WAV::Properties::Fast);
-
-        if (file.hasID3v2Tag()) {
-            auto& tag = *file.ID3v2Tag();
-            readID3Tag(tag, readCover, readLyrics);
-        }
+        read(file, readCover, readLyrics);
     }
     catch (...) {
         throw std::runtime_error("reading WAV");
@@ -650,16 +641,79 @@ void medley::Metadata::CoverAndLyrics::readAIFF(const File& f, bool readCover, b
 
     try {
         TagLib::RIFF::AIFF::File file(&stream, false, TagLib::RIFF::AIFF::Properties::Fast);
-
-        if (file.hasID3v2Tag()) {
-            readID3Tag(*file.tag(), readCover, readLyrics);
-        }
+        read(file, readCover, readLyrics);
     }
     catch (...) {
         throw std::runtime_error("reading AIFF");
     }
 }
 
+void medley::Metadata::CoverAndLyrics::read(TagLib::MPEG::File& file, bool readCover, bool readLyrics)
+{
+    if (file.hasID3v2Tag()) {
+        auto& tag = *file.ID3v2Tag();
+        readID3Tag(tag, readCover, readLyrics);
+    }
+}
+
+void medley::Metadata::CoverAndLyrics::read(TagLib::FLAC::File& file, bool readCover, bool readLyrics)
+{
+    if (readCover) {
+        auto pictures = file.pictureList();
+
+        if (pictures.isEmpty() && file.hasXiphComment()) {
+            pictures = file.xiphComment()->pictureList();
+        }
+
+        readPictures(pictures);
+    }
+
+    if (readLyrics) {
+        readXiphLyrics(*file.xiphComment());
+    }
+}
+
+void medley::Metadata::CoverAndLyrics::read(TagLib::Ogg::Opus::File& file, bool readCover, bool readLyrics)
+{
+    auto tag = file.tag();
+
+    if (readCover) {
+        readPictures(tag->pictureList());
+    }
+
+    if (readLyrics) {
+        readXiphLyrics(*tag);
+    }
+}
+
+void medley::Metadata::CoverAndLyrics::read(TagLib::Ogg::Vorbis::File& file, bool readCover, bool readLyrics)
+{
+    auto tag = file.tag();
+
+    if (readCover) {
+        readPictures(tag->pictureList());
+    }
+
+    if (readLyrics) {
+        readXiphLyrics(*tag);
+    }
+}
+
+void medley::Metadata::CoverAndLyrics::read(TagLib::RIFF::WAV::File& file, bool readCover, bool readLyrics)
+{
+    if (file.hasID3v2Tag()) {
+        auto& tag = *file.ID3v2Tag();
+        readID3Tag(tag, readCover, readLyrics);
+    }
+}
+
+void medley::Metadata::CoverAndLyrics::read(TagLib::RIFF::AIFF::File& file, bool readCover, bool readLyrics)
+{
+    if (file.hasID3v2Tag()) {
+        readID3Tag(*file.tag(), readCover, readLyrics);
+    }
+}
+
 void medley::Metadata::CoverAndLyrics::readID3Tag(const TagLib::ID3v2::Tag& tag, bool readCover, bool readLyrics)
 {
     if (readCover) {
@@ -8,12 +8,16 @@
 #include <taglib/mpegfile.h>
 #include <taglib/wavfile.h>
 #include <taglib/fileref.h>
+#include <taglib/opusfile.h>
+#include <taglib/vorbisfile.h>
 #include <map>
 #include "ITrack.h"
 #include "utils.h"
 
 namespace medley {
 
+class TrackProbe;
+
 class ReplayGain {
 
 };
@@ -56,6 +60,10 @@ public:
         const Cover& getCover() const { return cover; }
         const juce::String& getLyrics() const { return lyrics; }
     private:
+        friend class TrackProbe;
+
+        CoverAndLyrics() {}
+
         void read(const File& file, bool readCover, bool readLyrics);
         void readMpeg(const File& f, bool readCover, bool readLyrics);
         void readFLAC(const File& f, bool readCover, bool readLyrics);
@@ -64,6 +72,13 @@ public:
         void readWAV(const File& f, bool readCover, bool readLyrics);
         void readAIFF(const File& f, bool readCover, bool readLyrics);
         //
+        void read(TagLib::MPEG::File& file, bool readCover, bool readLyrics);
+        void read(TagLib::FLAC::File& file, bool readCover, bool readLyrics);
+        void read(TagLib::Ogg::Opus::File& file, bool readCover, bool readLyrics);
+        void read(TagLib::Ogg::Vorbis::File& file, bool readCover, bool readLyrics);
+        void read(TagLib::RIFF::WAV::File& file, bool readCover, bool readLyrics);
+        void read(TagLib::RIFF::AIFF::File& file, bool readCover, bool readLyrics);
+        //
         void readID3Tag(const TagLib::ID3v2::Tag& tag, bool readCover, bool readLyrics);
         void readPictures(const TagLib::List<TagLib::FLAC::Picture*> pictures);
         void readXiphLyrics(const TagLib::Ogg::XiphComment& tag);
@@ -83,6 +98,10 @@ public:
         double getDuration() const { return duration; }
 
     private:
+        friend class TrackProbe;
+
+        AudioProperties() {}
+
         void read(const File& file, TagLib::AudioProperties::ReadStyle readStyle);
         void readMpeg(const File& f, TagLib::AudioProperties::ReadStyle readStyle);
         void readFLAC(const File& f, TagLib::AudioProperties::ReadStyle readStyle);
@@ -120,7 +139,13 @@ public:
 
     std::vector<std::pair<juce::String, juce::String>>&  getComments() { return comments; }
 
+    const std::vector<std::pair<juce::String, juce::String>>& getComments() const { return comments; }
+
 private:
+    friend class TrackProbe;
+
+    void reset();
+
     void readMpeg(const File& f);
     void readFLAC(const File& f);
     void readOPUS(const File& f);
@@ -128,6 +153,13 @@ private:
     void readWAV(const File& f);
     void readAIFF(const File& f);
     //
+    void read(TagLib::MPEG::File& file);
+    void read(TagLib::FLAC::File& file);
+    void read(TagLib::Ogg::Opus::File& file);
+    void read(TagLib::Ogg::Vorbis::File& file);
+    void read(TagLib::RIFF::WAV::File& file);
+    void read(TagLib::RIFF::AIFF::File& file);
+    //
     void readBasicTag(const TagLib::Tag& tag);
     void readID3Tag(const TagLib::ID3v2::Tag& tag);
     void readXiphTag(const TagLib::Ogg::XiphComment& tag, bool readReplayGain = true);
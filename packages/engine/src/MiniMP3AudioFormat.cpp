@@ -1,6 +1,10 @@
 #include "MiniMP3AudioFormat.h"
 #include "MiniMP3AudioFormatReader.h"
 
+#define MINIMP3_FLOAT_OUTPUT
+
+#include <minimp3.h>
+
 AudioFormatReader* MiniMP3AudioFormat::createReaderFor(InputStream* sourceStream, bool deleteStreamIfOpeningFails)
 {
     std::unique_ptr<MiniMP3AudioFormatReader> r(new MiniMP3AudioFormatReader(sourceStream));
@@ -13,3 +17,14 @@ AudioFormatReader* MiniMP3AudioFormat::createReaderFor(InputStream* sourceStream
 
     return nullptr;
 }
+
+bool MiniMP3AudioFormat::containsFrames(const void* data, int size)
+{
+    mp3dec_t dec;
+    mp3dec_frame_info_t info;
+
+    mp3dec_init(&dec);
+
+    // Without an output buffer nothing is decoded, the number of samples of the first valid frame is returned
+    return mp3dec_decode_frame(&dec, (const uint8_t*)data, size, nullptr, &info) > 0;
+}
@@ -44,5 +44,11 @@ public:
     }
 
     using AudioFormat::createWriterFor;
+
+    /**
+     * Whether data holds MPEG audio frames, only headers are parsed.
+     * A frame is accepted when the frames following it have matching headers, like the decoder does when opening a file
+     */
+    static bool containsFrames(const void* data, int size);
 };
 
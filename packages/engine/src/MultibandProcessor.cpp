@@ -0,0 +1,429 @@
+#include "MultibandProcessor.h"
+
+using namespace juce;
+using namespace dsp;
+using namespace medley;
+
+namespace {
+    struct BandSettings {
+        // AGC target, RMS in dBFS
+        float target;
+        float threshold;
+        float ratio;
+        float knee;
+        float attack;
+        float release;
+        // Make-up gain in dB
+        float gain;
+    };
+
+    struct PresetSettings {
+        float crossovers[MultibandProcessor::numBands - 1];
+        // AGC time constant in seconds
+        float agcTime;
+        float agcMaxBoost;
+        float agcMaxCut;
+        // The AGC holds its gain while a band is quieter than this, so pauses and fades are not pulled up
+        float agcGate;
+        BandSettings bands[MultibandProcessor::numBands];
+    };
+
+    const PresetSettings kPresets[] = {
+        // Gentle
+        {
+            { 200.0f, 1200.0f, 5000.0f }, 5.0f, 6.0f, 6.0f, -50.0f,
+            {
+                { -20.0f, -16.0f, 2.0f, 6.0f, 0.030f, 0.400f, 1.0f },
+                { -22.0f, -18.0f, 2.0f, 6.0f, 0.020f, 0.300f, 1.0f },
+                { -26.0f, -22.0f, 2.0f, 6.0f, 0.010f, 0.200f, 1.0f },
+                { -30.0f, -26.0f, 2.0f, 6.0f, 0.005f, 0.150f, 1.0f }
+            }
+        },
+        // Broadcast
+        {
+            { 150.0f, 800.0f, 4000.0f }, 3.0f, 10.0f, 10.0f, -45.0f,
+            {
+                { -18.0f, -22.0f, 3.0f, 6.0f, 0.040f, 0.300f, 3.0f },
+                { -19.0f, -20.0f, 3.5f, 6.0f, 0.020f, 0.200f, 3.0f },
+                { -23.0f, -24.0f, 4.0f, 6.0f, 0.008f, 0.120f, 3.5f },
+                { -27.0f, -28.0f, 4.0f, 6.0f, 0.004f, 0.080f, 4.0f }
+            }
+        },
+        // Speech
+        {
+            { 250.0f, 2000.0f, 6000.0f }, 2.0f, 8.0f, 10.0f, -45.0f,
+            {
+                { -24.0f, -22.0f, 2.5f, 6.0f, 0.030f, 0.250f, -2.0f },
+                { -20.0f, -20.0f, 3.0f, 6.0f, 0.015f, 0.150f, 2.0f },
+                { -22.0f, -22.0f, 3.0f, 6.0f, 0.008f, 0.100f, 3.0f },
+                { -28.0f, -26.0f, 3.0f, 6.0f, 0.004f, 0.080f, 0.0f }
+            }
+        }
+    };
+
+    // Time constant of the level the AGC follows, in seconds
+    constexpr float kLevelTime = 0.4f;
+
+    constexpr float kSqrt2 = 1.41421356f;
+
+    constexpr float kLowerLanes[4] = { 1.0f, 1.0f, 0.0f, 0.0f };
+    constexpr float kUpperLanes[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+
+    constexpr float kLaneOffsets[4] = { 1.0f, 2.0f, 3.0f, 4.0f };
+
+    inline float powerToDecibels(float meanSquare)
+    {
+        return 10.0f * std::log10(jmax(meanSquare, 1.0e-10f));
+    }
+}
+
+void MultibandProcessor::Svf::setCutOff(const float (&frequencies)[4], double sampleRate)
+{
+    float gs[4], rs[4], hs[4];
+
+    for (int i = 0; i < 4; i++) {
+        auto frequency = jmin((double)frequencies[i], sampleRate * 0.49);
+        auto gain = (float)std::tan(MathConstants<double>::pi * frequency / sampleRate);
+
+        gs[i] = gain;
+        rs[i] = kSqrt2 + gain;
+        hs[i] = 1.0f / (1.0f + kSqrt2 * gain + gain * gain);
+    }
+
+    g = simd::Float4::load(gs);
+    r = simd::Float4::load(rs);
+    h = simd::Float4::load(hs);
+}
+
+simd::Float4 MultibandProcessor::Svf::allPass(simd::Float4 x)
+{
+    simd::Float4 lowPass, bandPass, highPass;
+    tick(x, lowPass, bandPass, highPass);
+
+    return lowPass + highPass - simd::Float4::broadcast(kSqrt2) * bandPass;
+}
+
+void MultibandProcessor::Svf::reset()
+{
+    s1 = simd::Float4::zero();
+    s2 = simd::Float4::zero();
+}
+
+void MultibandProcessor::Split::setCutOff(const float (&frequencies)[4], double sampleRate)
+{
+    first.setCutOff(frequencies, sampleRate);
+    second.setCutOff(frequencies, sampleRate);
+}
+
+void MultibandProcessor::Split::tick(simd::Float4 x, simd::Float4& low, simd::Float4& high)
+{
+    simd::Float4 lowPass, bandPass, highPass;
+    first.tick(x, lowPass, bandPass, highPass);
+
+    // The low and the high outputs of a Linkwitz-Riley crossover sum to the allpass of one Butterworth section
+    auto allPass = lowPass + highPass - simd::Float4::broadcast(kSqrt2) * bandPass;
+
+    simd::Float4 bandPass2, highPass2;
+    second.tick(lowPass, low, bandPass2, highPass2);
+
+    high = allPass - low;
+}
+
+void MultibandProcessor::Split::reset()
+{
+    first.reset();
+    second.reset();
+}
+
+MultibandProcessor::MultibandProcessor()
+{
+    applyPreset(currentPreset);
+    resetState();
+}
+
+void MultibandProcessor::prepare(const ProcessSpec& spec)
+{
+    const ScopedLock sl(processLock);
+
+    sampleRate = spec.sampleRate;
+    maxBlockSize = jmax(1, (int)spec.maximumBlockSize);
+
+    bands.setSize(numBands * 2, maxBlockSize);
+    dry.setSize(2, maxBlockSize);
+    levels.allocate(maxBlockSize, true);
+    gains.allocate(maxBlockSize, true);
+
+    applyPreset(preset.load(std::memory_order_relaxed));
+    resetState();
+}
+
+void MultibandProcessor::reset()
+{
+    const ScopedLock sl(processLock);
+    resetState();
+}
+
+void MultibandProcessor::resetState()
+{
+    middleSplit.reset();
+    compensation.reset();
+    outerSplit.reset();
+
+    for (int band = 0; band < numBands; band++) {
+        states[band] = {};
+        bandGains[band].store(0.0f, std::memory_order_relaxed);
+    }
+}
+
+void MultibandProcessor::applyPreset(Preset newPreset)
+{
+    currentPreset = newPreset;
+
+    const auto& settings = kPresets[(int)newPreset];
+    const auto& f = settings.crossovers;
+
+    const float middle[4] = { f[1], f[1], f[1], f[1] };
+    const float outer[4] = { f[0], f[0], f[2], f[2] };
+    const float opposite[4] = { f[2], f[2], f[0], f[0] };
+
+    middleSplit.setCutOff(middle, sampleRate);
+    outerSplit.setCutOff(outer, sampleRate);
+    compensation.setCutOff(opposite, sampleRate);
+
+    for (int band = 0; band < numBands; band++) {
+        const auto& bandSettings = settings.bands[band];
+
+        alphaAttack[band] = 1.0f - std::exp(-1.0f / ((float)sampleRate * bandSettings.attack));
+        alphaRelease[band] = 1.0f - std::exp(-1.0f / ((float)sampleRate * bandSettings.release));
+    }
+}
+
+void MultibandProcessor::process(const ProcessContextReplacing<float>& context)
+{
+    const ScopedTryLock sl(processLock);
+
+    if (!sl.isLocked()) {
+        return;
+    }
+
+    const auto shouldBeActive = enabled.load(std::memory_order_relaxed);
+
+    if (!shouldBeActive && !active) {
+        return;
+    }
+
+    const auto& output = context.getOutputBlock();
+
+    const auto numChannels = jmin((int)output.getNumChannels(), 2);
+    const auto numSamples = (int)output.getNumSamples();
+
+    if (numChannels <= 0 || maxBlockSize <= 0) {
+        return;
+    }
+
+    ScopedNoDenormals noDenormals;
+
+    auto newPreset = preset.load(std::memory_order_relaxed);
+    if (newPreset != currentPreset) {
+        applyPreset(newPreset);
+    }
+
+    const auto fadeIn = shouldBeActive && !active;
+    const auto fadeOut = !shouldBeActive && active;
+
+    if (fadeIn) {
+        // Whatever left in the filters and the AGC is from before being disabled
+        resetState();
+    }
+
+    for (int start = 0; start < numSamples; start += maxBlockSize) {
+        float* channels[2] = {
+            output.getChannelPointer(0) + start,
+            output.getChannelPointer(numChannels > 1 ? 1 : 0) + start
+        };
+
+        // Only the first chunk crossfades
+        processChunk(channels, numChannels, jmin(maxBlockSize, numSamples - start), fadeIn && start == 0, fadeOut && start == 0);
+
+        if (fadeOut) {
+            break;
+        }
+    }
+
+    active = shouldBeActive;
+
+    if (!active) {
+        for (int band = 0; band < numBands; band++) {
+            bandGains[band].store(0.0f, std::memory_order_relaxed);
+        }
+    }
+}
+
+void MultibandProcessor::processChunk(float* const* channels, int numChannels, int numSamples, bool fadeIn, bool fadeOut)
+{
+    const auto fading = fadeIn || fadeOut;
+
+    if (fading) {
+        for (int ch = 0; ch < numChannels; ch++) {
+            dry.copyFrom(ch, 0, channels[ch], numSamples);
+        }
+    }
+
+    split(channels[0], channels[1], numSamples);
+
+    for (int ch = 0; ch < numChannels; ch++) {
+        FloatVectorOperations::clear(channels[ch], numSamples);
+    }
+
+    for (int band = 0; band < numBands; band++) {
+        processBand(band, channels, numChannels, numSamples);
+    }
+
+    if (fading) {
+        const auto step = 1.0f / (float)numSamples;
+
+        for (int ch = 0; ch < numChannels; ch++) {
+            auto out = channels[ch];
+            auto in = dry.getReadPointer(ch);
+
+            for (int i = 0; i < numSamples; i++) {
+                auto wet = (float)(i + 1) * step;
+
+                if (fadeOut) {
+                    wet = 1.0f - wet;
+                }
+
+                out[i] = in[i] + wet * (out[i] - in[i]);
+            }
+        }
+    }
+}
+
+void MultibandProcessor::split(const float* left, const float* right, int numSamples)
+{
+    const auto lowerLanes = simd::Float4::load(kLowerLanes);
+    const auto upperLanes = simd::Float4::load(kUpperLanes);
+
+    float* outputs[numBands * 2];
+    for (int i = 0; i < numBands * 2; i++) {
+        outputs[i] = bands.getWritePointer(i);
+    }
+
+    // Both channels and both halves of the spectrum run side by side in the lanes,
+    // the crossover is recursive so it cannot be vectorized across samples
+    for (int i = 0; i < numSamples; i++) {
+        const float input[4] = { left[i], right[i], left[i], right[i] };
+
+        simd::Float4 low, high;
+        middleSplit.tick(simd::Float4::load(input), low, high);
+
+        // { low left, low right, high left, high right }
+        auto halves = compensation.allPass(low * lowerLanes + high * upperLanes);
+        outerSplit.tick(halves, low, high);
+
+        float lows[4], highs[4];
+        low.store(lows);
+        high.store(highs);
+
+        outputs[0][i] = lows[0];
+        outputs[1][i] = lows[1];
+        outputs[2][i] = highs[0];
+        outputs[3][i] = highs[1];
+        outputs[4][i] = lows[2];
+        outputs[5][i] = lows[3];
+        outputs[6][i] = highs[2];
+        outputs[7][i] = highs[3];
+    }
+}
+
+void MultibandProcessor::processBand(int band, float* const* outputs, int numChannels, int numSamples)
+{
+    const auto& presetSettings = kPresets[(int)currentPreset];
+    const auto& settings = presetSettings.bands[band];
+    auto& state = states[band];
+
+    const auto left = bands.getReadPointer(band * 2);
+    const auto right = bands.getReadPointer(band * 2 + 1);
+
+    const auto level = levels.get();
+    const auto gain = gains.get();
+
+    // Stereo linked level
+    FloatVectorOperations::abs(level, left, numSamples);
+    FloatVectorOperations::abs(gain, right, numSamples);
+    FloatVectorOperations::max(level, level, gain, numSamples);
+
+    // AGC, updated once per block then ramped across it
+    const auto blockTime = (float)numSamples / (float)sampleRate;
+    const auto meanSquare = (float)((simd::sumOfSquares(left, numSamples) + simd::sumOfSquares(right, numSamples)) / (2.0 * numSamples));
+
+    state.meanSquare += (1.0f - std::exp(-blockTime / kLevelTime)) * (meanSquare - state.meanSquare);
+
+    const auto agcStart = state.agcGain;
+
+    if (powerToDecibels(meanSquare) > presetSettings.agcGate) {
+        auto target = jlimit(-presetSettings.agcMaxCut, presetSettings.agcMaxBoost, settings.target - powerToDecibels(state.meanSquare));
+        state.agcGain += (1.0f - std::exp(-blockTime / presetSettings.agcTime)) * (target - state.agcGain);
+    }
+
+    const auto agcStep = (state.agcGain - agcStart) / (float)numSamples;
+
+    // Soft knee gain computer, branch-free so it vectorizes
+    simd::gainToDecibels(level, level, numSamples);
+
+    const auto slope = 1.0f / settings.ratio - 1.0f;
+    const auto kneeHalf = settings.knee * 0.5f;
+    const auto kneeScale = 0.5f / settings.knee;
+
+    {
+        const auto slopes = simd::Float4::broadcast(slope);
+        const auto knees = simd::Float4::broadcast(settings.knee);
+        const auto kneeHalves = simd::Float4::broadcast(kneeHalf);
+        const auto kneeScales = simd::Float4::broadcast(kneeScale);
+        const auto thresholds = simd::Float4::broadcast(settings.threshold);
+        const auto zero = simd::Float4::zero();
+        const auto agcSteps = simd::Float4::broadcast(agcStep * 4.0f);
+
+        auto agc = simd::Float4::broadcast(agcStart) + simd::Float4::broadcast(agcStep) * simd::Float4::load(kLaneOffsets);
+
+        int i = 0;
+
+        for (; i + 4 <= numSamples; i += 4) {
+            auto overshoot = simd::Float4::load(level + i) + agc - thresholds;
+            auto x = simd::Float4::min(simd::Float4::max(overshoot + kneeHalves, zero), knees);
+
+            (slopes * (x * x * kneeScales + simd::Float4::max(overshoot - kneeHalves, zero))).store(level + i);
+            agc = agc + agcSteps;
+        }
+
+        for (; i < numSamples; i++) {
+            auto overshoot = level[i] + agcStart + agcStep * (float)(i + 1) - settings.threshold;
+            auto x = jlimit(0.0f, settings.knee, overshoot + kneeHalf);
+
+            level[i] = slope * (x * x * kneeScale + jmax(overshoot - kneeHalf, 0.0f));
+        }
+    }
+
+    // Attack/release smoothing is recursive, then the AGC and the make-up gain are added on top
+    auto s = state.reduction;
+    const auto attack = alphaAttack[band];
+    const auto release = alphaRelease[band];
+
+    for (int i = 0; i < numSamples; i++) {
+        const auto diff = level[i] - s;
+        s += (diff < 0.0f ? attack : release) * diff;
+
+        level[i] = s + agcStart + agcStep * (float)(i + 1) + settings.gain;
+    }
+
+    state.reduction = s;
+    bandGains[band].store(s + state.agcGain, std::memory_order_relaxed);
+
+    simd::decibelsToGain(gain, level, 0.0f, numSamples);
+
+    FloatVectorOperations::addWithMultiply(outputs[0], left, gain, numSamples);
+
+    if (numChannels > 1) {
+        FloatVectorOperations::addWithMultiply(outputs[1], right, gain, numSamples);
+    }
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include "Simd.h"
+
+using namespace juce;
+using namespace dsp;
+
+/**
+ * Broadcast style multiband processor
+ *
+ * The signal is split into 4 bands by a Linkwitz-Riley (LR4) crossover, each band then goes through a slow AGC
+ * riding its level toward a target, followed by a compressor. The bands sum back to an allpassed version of the input.
+ *
+ * It adds no latency, peaks are left to the look-ahead limiter following it.
+ */
+class MultibandProcessor : public ProcessorBase
+{
+public:
+    static constexpr int numBands = 4;
+
+    enum class Preset : uint8_t {
+        Gentle,
+        Broadcast,
+        Speech
+    };
+
+    MultibandProcessor();
+
+    void prepare(const ProcessSpec& spec) override;
+
+    void process(const ProcessContextReplacing<float>& context) override;
+
+    void reset() override;
+
+    /**
+     * Enabling or disabling crossfades over one block
+     */
+    void setEnabled(bool enabled) { this->enabled = enabled; }
+
+    bool isEnabled() const { return enabled; }
+
+    /**
+     * Presets can be switched at any time, the crossover and the AGC keep their states
+     */
+    void setPreset(Preset preset) { this->preset = preset; }
+
+    Preset getPreset() const { return preset; }
+
+    /**
+     * Current gain of a band, AGC and compression combined, in dB
+     */
+    float getBandGain(int band) const { return bandGains[band].load(std::memory_order_relaxed); }
+
+private:
+    /**
+     * State variable filters (TPT) in 4 lanes, every lane has its own cut-off
+     */
+    struct Svf {
+        medley::simd::Float4 g, r, h;
+        medley::simd::Float4 s1, s2;
+
+        void setCutOff(const float (&frequencies)[4], double sampleRate);
+
+        void tick(medley::simd::Float4 x, medley::simd::Float4& lowPass, medley::simd::Float4& bandPass, medley::simd::Float4& highPass) {
+            highPass = (x - r * s1 - s2) * h;
+
+            auto v = g * highPass;
+            bandPass = v + s1;
+            s1 = v + bandPass;
+
+            auto w = g * bandPass;
+            lowPass = w + s2;
+            s2 = w + lowPass;
+        }
+
+        /**
+         * Second order Butterworth allpass
+         */
+        medley::simd::Float4 allPass(medley::simd::Float4 x);
+
+        void reset();
+    };
+
+    /**
+     * Linkwitz-Riley crossover in 4 lanes, two cascaded Butterworth sections
+     */
+    struct Split {
+        Svf first;
+        Svf second;
+
+        void setCutOff(const float (&frequencies)[4], double sampleRate);
+
+        void tick(medley::simd::Float4 x, medley::simd::Float4& low, medley::simd::Float4& high);
+
+        void reset();
+    };
+
+    struct BandState {
+        float meanSquare = 0.0f;
+        float agcGain = 0.0f;
+        float reduction = 0.0f;
+    };
+
+    void applyPreset(Preset newPreset);
+
+    void resetState();
+
+    void processChunk(float* const* channels, int numChannels, int numSamples, bool fadeIn, bool fadeOut);
+
+    void split(const float* left, const float* right, int numSamples);
+
+    void processBand(int band, float* const* outputs, int numChannels, int numSamples);
+
+    double sampleRate = 44100.0;
+    int maxBlockSize = 0;
+
+    std::atomic<bool> enabled{ false };
+    std::atomic<Preset> preset{ Preset::Broadcast };
+
+    bool active = false;
+    Preset currentPreset = Preset::Broadcast;
+
+    // Lane layout is { left, right, left, right }, all lanes are split at the middle cut-off
+    Split middleSplit;
+
+    // Lane layout is { low left, low right, high left, high right },
+    // the lower half is split at the lowest cut-off and allpassed at the highest one, the other way round for the upper half
+    Svf compensation;
+    Split outerSplit;
+
+    BandState states[numBands];
+    float alphaAttack[numBands]{};
+    float alphaRelease[numBands]{};
+    std::atomic<float> bandGains[numBands]{};
+
+    // Band signals, two channels per band
+    juce::AudioBuffer<float> bands;
+    juce::AudioBuffer<float> dry;
+    HeapBlock<float> levels;
+    HeapBlock<float> gains;
+
+    // Guards prepare() and reset() against process(), process() only tries to lock and passes the audio through while being prepared
+    CriticalSection processLock;
+};
@@ -13,3 +13,8 @@ juce::AudioFormatReader* OpusAudioFormat::createReaderFor(juce::InputStream* sou
 
     return nullptr;
 }
+
+bool OpusAudioFormat::containsOpusHead(const void* data, int size)
+{
+    return op_test(nullptr, (const unsigned char*)data, (size_t)size) == 0;
+}
@@ -39,4 +39,9 @@ public:
     }
 
     using AudioFormat::createWriterFor;
+
+    /**
+     * Whether data starts with the pages of an Opus stream, its ID and comment headers are parsed
+     */
+    static bool containsOpusHead(const void* data, int size);
 };
@@ -2,27 +2,30 @@
 
 PostProcessor::PostProcessor()
 {
-    chain.setBypassed<index::Karaoke>(false);
-    chain.setBypassed<index::Limiter>(false);
-
-    karaokeMix = getKaraokeParams(DeFXKaraoke::Param::Mix);
-    karaokeMixFader.alwaysResetTime(true);
+    karaokeFader.alwaysResetTime(true);
 }
 
 void PostProcessor::prepare(const ProcessSpec& spec, const int latencyInSamples) {
     buffer.setSize(2, spec.maximumBlockSize);
     levelTracker.prepare(spec.numChannels, (int)spec.sampleRate, latencyInSamples);
-    chain.prepare(spec);
+    loudnessMeter.prepare(spec.numChannels, spec.sampleRate, spec.maximumBlockSize);
+    karaoke.prepare(spec);
+    graph.prepare(spec);
+    multiband.prepare(spec);
+    limiter.prepare(spec);
 }
 
 void PostProcessor::process(const AudioSourceChannelInfo& info, double timestamp) {
+    medley::Histogram::ScopedTimer timer(processTime);
+
     currentTime = timestamp;
 
-    if (karaokeMixFader.shouldUpdate(currentTime)) {
-        chain.get<index::Karaoke>().setParam(
-            DeFXKaraoke::Param::Mix,
-            karaokeMixFader.update(currentTime)
-        );
+    karaokeTransitions.popAll([this](const KaraokeTransition& transition) {
+        startKaraokeTransition(transition);
+    });
+
+    if (karaokeFader.shouldUpdate(currentTime)) {
+        karaoke.setFade(karaokeFader.update(currentTime));
     }
 
     AudioBlock<float> block(
@@ -32,11 +35,16 @@ void PostProcessor::process(const AudioSourceChannelInfo& info, double timestamp
         (size_t)info.numSamples
     );
 
-    chain.process(ProcessContextReplacing<float>(block));
+    ProcessContextReplacing<float> context(block);
 
-    {
-        ScopedLock sl(levelTrackerLock);
+    karaoke.process(context);
+    graph.process(context);
+    multiband.process(context);
+    limiter.process(context);
+
+    if (meteringEnabled.load(std::memory_order_relaxed)) {
         levelTracker.process(info);
+        loudnessMeter.process(info);
     }
 
     for (int i = info.buffer->getNumChannels(); --i >= 0;) {
@@ -47,30 +55,35 @@ void PostProcessor::process(const AudioSourceChannelInfo& info, double timestamp
 }
 
 void PostProcessor::reset() {
-    chain.reset();
+    karaoke.reset();
+    graph.reset();
+    multiband.reset();
+    limiter.reset();
 }
 
-void PostProcessor::updateLevelTracker()
+void PostProcessor::updateMeters()
 {
-    ScopedLock sl(levelTrackerLock);
     levelTracker.update();
+    loudnessMeter.update();
 }
 
 double PostProcessor::getLevel(int channel) const
 {
-    ScopedLock sl(levelTrackerLock);
     return levelTracker.getLevel(channel);
 }
 
 double PostProcessor::getPeak(int channel) const
 {
-    ScopedLock sl(levelTrackerLock);
     return levelTracker.getPeak(channel);
 }
 
+double PostProcessor::getRMS(int channel) const
+{
+    return levelTracker.getRMS(channel);
+}
+
 bool PostProcessor::isClipping(int channel) const
 {
-    ScopedLock sl(levelTrackerLock);
     return levelTracker.isClipping(channel);
 }
 
@@ -93,52 +106,51 @@ bool PostProcessor::setKaraokeEnabled(bool enabled, bool dontTransit) {
         return true;
     }
 
+    if (!karaokeTransitions.push({ enabled, dontTransit })) {
+        return false;
+    }
+
     karaokeEnabled = enabled;
+    return true;
+}
+
+void PostProcessor::startKaraokeTransition(const KaraokeTransition& transition) {
+    if (transition.dontTransit) {
+        karaokeFader.stop();
+        karaokeFader.reset(1.0f);
 
-    if (dontTransit) {
-        auto& fx = chain.get<index::Karaoke>();
-        fx.setEnabled(karaokeEnabled);
-        fx.setParam(DeFXKaraoke::Param::Mix, karaokeMix);
-        return fx.isEnabled();
+        karaoke.setFade(1.0f);
+        karaoke.setEnabled(transition.enabled);
+        return;
     }
 
     auto start = currentTime + 100;
     auto end = start + 600;
 
-    if (karaokeEnabled) {
-        chain.get<index::Karaoke>().setEnabled(true);
+    if (transition.enabled) {
+        // Start silent, the fader takes it from here
+        karaoke.setFade(0.0f);
+        karaoke.setEnabled(true);
 
-        karaokeMixFader.start(start, end, 0.0f, karaokeMix, 0.7f, karaokeMix, [=] {
-            // Ensure resetting to the up-to-date value
-            karaokeMixFader.reset(karaokeMix);
-            chain.get<index::Karaoke>().setParam(DeFXKaraoke::Param::Mix, karaokeMix);
+        karaokeFader.start(start, end, 0.0f, 1.0f, 0.7f, 1.0f, [this] {
+            karaokeFader.reset(1.0f);
+            karaoke.setFade(1.0f);
         });
-
-        return chain.get<index::Karaoke>().isEnabled();
     }
     else {
-        karaokeMixFader.start(start, end, karaokeMix, 0.0f, 0.7f, karaokeMix, [=] {
-            karaokeMixFader.reset(0.0f);
+        karaokeFader.start(start, end, 1.0f, 0.0f, 0.7f, 0.0f, [this] {
+            karaokeFader.reset(0.0f);
 
-            auto& fx = chain.get<index::Karaoke>();
-            fx.setParam(DeFXKaraoke::Param::Mix, 0.0f);
-            fx.setEnabled(false);
+            karaoke.setFade(0.0f);
+            karaoke.setEnabled(false);
         });
-
-        return true;
     }
 }
 
 float PostProcessor::getKaraokeParams(DeFXKaraoke::Param param) const {
-    return chain.get<index::Karaoke>().getParam(param);
+    return karaoke.getParam(param);
 }
 
 float PostProcessor::setKaraokeParams(DeFXKaraoke::Param param, float newValue) {
-    auto result = chain.get<index::Karaoke>().setParam(param, newValue);
-
-    if (param == DeFXKaraoke::Param::Mix) {
-        karaokeMix = result;
-    }
-
-    return result;
+    return karaoke.setParam(param, newValue);
 }
@@ -5,21 +5,15 @@
 #include "DeFXKaraoke.h"
 #include "Fader.h"
 #include "LookAheadLimiter.h"
+#include "MessageQueue.h"
 #include "LevelTracker.h"
+#include "LoudnessMeter.h"
+#include "MultibandProcessor.h"
+#include "ProcessingGraph.h"
+#include "Stats.h"
 
 using namespace juce::dsp;
 
-namespace medley {
-    namespace processor {
-        namespace index {
-            constexpr auto Karaoke = 0;
-            constexpr auto Limiter = 1;
-        }
-    }
-}
-
-using namespace medley::processor;
-
 class KaraokeParamController {
 public:
     virtual bool isKaraokeEnabled() const = 0;
@@ -41,18 +35,51 @@ public:
 
     void reset();
 
-    void updateLevelTracker();
+    /**
+     * Publish the latest meter readings, must always be called from the same thread
+     */
+    void updateMeters();
 
     double getLevel(int channel) const;
 
     double getPeak(int channel) const;
 
+    double getRMS(int channel) const;
+
     bool isClipping(int channel) const;
 
+    LoudnessMeter::Readings getLoudness() const { return loudnessMeter.getReadings(); }
+
+    void resetLoudness() { loudnessMeter.resetIntegrated(); }
+
+    /**
+     * Metering is enabled by default, disable it for outputs nobody is watching
+     */
+    void setMeteringEnabled(bool enabled) { meteringEnabled = enabled; }
+
     /**
      * Reduction in dB
      */
-    inline float getReduction() const { return chain.get<1>().getReduction(); }
+    inline float getReduction() const { return limiter.getReduction(); }
+
+    void setTruePeakLimiterEnabled(bool enabled) { limiter.setTruePeakEnabled(enabled); }
+
+    bool isTruePeakLimiterEnabled() const { return limiter.isTruePeakEnabled(); }
+
+    /**
+     * Delay added by the processing chain
+     */
+    int getLatencyInSamples() const { return graph.getLatencyInSamples() + limiter.getLatencyInSamples(); }
+
+    /**
+     * Nodes running in between the karaoke effect and the limiter, the limiter always comes last so the output never clips
+     */
+    ProcessingGraph& getGraph() { return graph; }
+
+    /**
+     * Runs after the graph, right before the limiter, disabled by default
+     */
+    MultibandProcessor& getMultiband() { return multiband; }
 
     float getVolume() const;
 
@@ -66,20 +93,46 @@ public:
 
     float setKaraokeParams(DeFXKaraoke::Param param, float newValue) override;
 
+    /**
+     * Time spent in process(), in microseconds
+     */
+    const medley::Histogram& getProcessTime() const { return processTime; }
+
 private:
     double currentTime = 0.0;
 
     juce::AudioBuffer<float> buffer;
 
-    CriticalSection levelTrackerLock;
+    std::atomic<bool> meteringEnabled{ true };
     LevelTracker levelTracker;
+    LoudnessMeter loudnessMeter;
 
-    ProcessorChain<DeFXKaraoke, LookAheadLimiter> chain;
+    // Processed in this order
+    DeFXKaraoke karaoke;
+    ProcessingGraph graph;
+    MultibandProcessor multiband;
+    LookAheadLimiter limiter;
 
     float volume = 1.0f;
     float lastVolume = 1.0f;
 
+    struct KaraokeTransition {
+        bool enabled;
+        bool dontTransit;
+    };
+
+    /**
+     * Audio thread
+     */
+    void startKaraokeTransition(const KaraokeTransition& transition);
+
+    // Caller side, the audio thread follows through karaokeTransitions
     bool karaokeEnabled = false;
-    Fader karaokeMixFader;
-    float karaokeMix = 0.0f;
+
+    MessageQueue<KaraokeTransition, 16> karaokeTransitions;
+
+    // Audio thread, fades the karaoke effect in and out by scaling its mix
+    Fader karaokeFader;
+
+    medley::Histogram processTime;
 };
@@ -0,0 +1,214 @@
+#include "Prefetcher.h"
+#include "TrackInfoCache.h"
+#include "Trace.h"
+#include "utils.h"
+
+namespace medley {
+
+namespace {
+    constexpr int kWarmingChunkSize = 1024 * 1024;
+
+    // Only the beginning of larger files is read into the page cache
+    constexpr int64 kMaxWarmingSize = 256 * 1024 * 1024;
+
+    constexpr int kIdleInterval = 1000;
+}
+
+Prefetcher::Prefetcher(AudioFormatManager& formatMgr)
+    :
+    formatMgr(formatMgr),
+    thread("Prefetching Thread")
+{
+    warmingBuffer.malloc(kWarmingChunkSize);
+
+    thread.addTimeSliceClient(this);
+    thread.startThread(2);
+}
+
+Prefetcher::~Prefetcher()
+{
+    thread.removeTimeSliceClient(this);
+    thread.stopThread(1000);
+}
+
+void Prefetcher::prefetch(const std::vector<ITrack::Ptr>& tracks)
+{
+    {
+        ScopedLock sl(lock);
+
+        upcoming = tracks;
+
+        auto isUpcoming = [&](const ITrack* track) {
+            return std::any_of(upcoming.begin(), upcoming.end(), [track](const ITrack::Ptr& t) { return t.get() == track; });
+        };
+
+        for (auto it = prefetched.begin(); it != prefetched.end();) {
+            it = isUpcoming(it->first) ? std::next(it) : prefetched.erase(it);
+        }
+
+        if (current != nullptr && !isUpcoming(current.get())) {
+            cancelled = true;
+        }
+    }
+
+    thread.moveToFrontOfQueue(this);
+}
+
+std::unique_ptr<AudioFormatReader> Prefetcher::takeReader(const ITrack::Ptr track)
+{
+    ScopedLock sl(lock);
+
+    auto it = prefetched.find(track.get());
+
+    if (it == prefetched.end()) {
+        return nullptr;
+    }
+
+    auto& entry = it->second;
+    auto file = track->getFile();
+
+    if (file.getLastModificationTime() != entry.modified || file.getSize() != entry.size) {
+        entry.reader = nullptr;
+    }
+
+    return std::move(entry.reader);
+}
+
+Array<File> Prefetcher::getPrefetchedFiles() const
+{
+    ScopedLock sl(lock);
+
+    Array<File> files;
+
+    for (auto& track : upcoming) {
+        if (prefetched.find(track.get()) != prefetched.end()) {
+            files.add(track->getFile());
+        }
+    }
+
+    return files;
+}
+
+int Prefetcher::useTimeSlice()
+{
+    if (cancelled.exchange(false)) {
+        finish();
+    }
+
+    switch (stage) {
+    case Stage::Idle:
+        return startNext() ? 0 : kIdleInterval;
+
+    case Stage::Warming:
+        warm();
+        return 0;
+
+    case Stage::Probing:
+        probe();
+        return 0;
+
+    case Stage::Measuring:
+        if (analyzer.useTimeSlice() < 0) {
+            finish();
+        }
+        return 0;
+    }
+
+    return kIdleInterval;
+}
+
+bool Prefetcher::startNext()
+{
+    {
+        ScopedLock sl(lock);
+
+        for (auto& track : upcoming) {
+            if (prefetched.find(track.get()) == prefetched.end()) {
+                current = track;
+                break;
+            }
+        }
+    }
+
+    if (current == nullptr) {
+        return false;
+    }
+
+    warmingStream = std::make_unique<FileInputStream>(current->getFile());
+
+    if (warmingStream->failedToOpen()) {
+        warmingStream = nullptr;
+    }
+
+    stage = warmingStream ? Stage::Warming : Stage::Probing;
+    return true;
+}
+
+void Prefetcher::warm()
+{
+    Trace::ScopedSpan span("warmPageCache", "prefetch");
+
+    // The content is thrown away, it only has to go through the OS page cache
+    if (warmingStream->read(warmingBuffer, kWarmingChunkSize) <= 0 || warmingStream->getPosition() >= kMaxWarmingSize) {
+        warmingStream = nullptr;
+        stage = Stage::Probing;
+    }
+}
+
+void Prefetcher::probe()
+{
+    Trace::ScopedSpan span("prefetchTrack", "prefetch");
+
+    auto file = current->getFile();
+
+    Prefetched entry;
+    entry.track = current;
+    entry.modified = file.getLastModificationTime();
+    entry.size = file.getSize();
+
+    // Tags end up in TrackInfoCache, the reader scans what it needs to seek
+    auto probed = TrackInfoCache::probe(formatMgr, file, TrackProbe::Tags | TrackProbe::Gain | TrackProbe::Properties | TrackProbe::Reader);
+    entry.reader = probed->takeReader();
+
+    auto shouldMeasure = loudnessMeasuring && entry.reader && probed->getMetadata().getTrackGain() <= 0.0f;
+
+    if (shouldMeasure) {
+        double cachedLoudness = 0.0;
+        shouldMeasure = !LoudnessAnalyzer::findCached(file, cachedLoudness);
+    }
+
+    {
+        ScopedLock sl(lock);
+
+        // No longer upcoming, the next time slice finishes it
+        if (cancelled) {
+            return;
+        }
+
+        // Recorded even if the track could not be opened, it is not tried again while upcoming
+        prefetched[current.get()] = std::move(entry);
+    }
+
+    if (shouldMeasure) {
+        // The prefetched reader is kept for the deck, measuring goes through another one
+        if (auto reader = utils::createAudioReaderFor(formatMgr, current)) {
+            analyzer.analyze(current, reader, nullptr);
+            stage = Stage::Measuring;
+            return;
+        }
+    }
+
+    finish();
+}
+
+void Prefetcher::finish()
+{
+    analyzer.cancel();
+    warmingStream = nullptr;
+    stage = Stage::Idle;
+
+    ScopedLock sl(lock);
+    current = nullptr;
+}
+
+}
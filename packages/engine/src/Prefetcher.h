@@ -0,0 +1,88 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include "ITrack.h"
+#include "LoudnessAnalyzer.h"
+
+namespace medley {
+
+/**
+ * Warms upcoming tracks in the background, before a deck needs them
+ *
+ * Tracks are prefetched one at a time, in order, on a low priority thread:
+ * the file is read through so it sits in the OS page cache, the tags are parsed into TrackInfoCache,
+ * a reader is opened ahead, which builds its seek index, and the loudness of tracks without ReplayGain is measured into the LoudnessAnalyzer cache.
+ *
+ * Each time slice only does a small step, changes of the upcoming tracks are picked up quickly.
+ */
+class Prefetcher : private TimeSliceClient {
+public:
+    Prefetcher(AudioFormatManager& formatMgr);
+
+    ~Prefetcher() override;
+
+    /**
+     * Replace the tracks to prefetch, in order.
+     * Work on a track which is no longer upcoming is cancelled, what was prefetched for it is discarded
+     */
+    void prefetch(const std::vector<ITrack::Ptr>& tracks);
+
+    /**
+     * The reader opened ahead for the track, nullptr if it was not prefetched or its file has changed since. Handed over once
+     */
+    std::unique_ptr<AudioFormatReader> takeReader(const ITrack::Ptr track);
+
+    /**
+     * Files of the upcoming tracks which are done prefetching, in order
+     */
+    Array<File> getPrefetchedFiles() const;
+
+    void setLoudnessMeasuringEnabled(bool enabled) { loudnessMeasuring = enabled; }
+
+private:
+    enum class Stage {
+        Idle,
+        Warming,
+        Probing,
+        Measuring
+    };
+
+    struct Prefetched {
+        ITrack::Ptr track;
+        Time modified;
+        int64 size = 0;
+        std::unique_ptr<AudioFormatReader> reader;
+    };
+
+    int useTimeSlice() override;
+
+    /**
+     * Pick the first upcoming track not prefetched yet
+     */
+    bool startNext();
+
+    void warm();
+
+    void probe();
+
+    void finish();
+
+    AudioFormatManager& formatMgr;
+    TimeSliceThread thread;
+
+    CriticalSection lock;
+    std::vector<ITrack::Ptr> upcoming;
+    std::map<ITrack*, Prefetched> prefetched;
+    ITrack::Ptr current;
+    std::atomic<bool> cancelled{ false };
+    std::atomic<bool> loudnessMeasuring{ true };
+
+    // Only touched by the prefetching thread
+    Stage stage = Stage::Idle;
+    std::unique_ptr<FileInputStream> warmingStream;
+    HeapBlock<char> warmingBuffer;
+    LoudnessAnalyzer analyzer;
+};
+
+}
@@ -0,0 +1,571 @@
+#include "ProcessingGraph.h"
+
+namespace {
+    constexpr int kMaxChannels = 2;
+
+    /**
+     * Transposed direct form II, double precision state
+     */
+    struct Biquad {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+        double z1 = 0.0, z2 = 0.0;
+
+        inline float process(float in) {
+            auto out = b0 * in + z1;
+            z1 = b1 * in - a1 * out + z2;
+            z2 = b2 * in - a2 * out;
+            return (float)out;
+        }
+
+        void setCoefficients(double nb0, double nb1, double nb2, double a0, double na1, double na2) {
+            b0 = nb0 / a0;
+            b1 = nb1 / a0;
+            b2 = nb2 / a0;
+            a1 = na1 / a0;
+            a2 = na2 / a0;
+        }
+
+        void snapToZero() {
+            JUCE_SNAP_TO_ZERO(z1);
+            JUCE_SNAP_TO_ZERO(z2);
+        }
+
+        void reset() { z1 = z2 = 0.0; }
+    };
+
+    /**
+     * Linear ramp from one gain to another over the block, to avoid zipper noise
+     */
+    void applyGainRamp(float* data, int numSamples, float startGain, float endGain) {
+        if (startGain == endGain) {
+            FloatVectorOperations::multiply(data, startGain, numSamples);
+            return;
+        }
+
+        const auto step = (endGain - startGain) / numSamples;
+
+        for (int i = 0; i < numSamples; i++) {
+            data[i] *= startGain + step * (i + 1);
+        }
+    }
+
+    class GainNode : public GraphNode {
+    public:
+        static constexpr ParamInfo params[] = {
+            { "gain", -24.0f, 24.0f, 0.0f }
+        };
+
+        explicit GainNode(const String& id)
+            : GraphNode("gain", id, params, numElementsInArray(params))
+        {
+
+        }
+
+    protected:
+        void prepareNode(const ProcessSpec&) override {
+
+        }
+
+        void parametersChanged(const float* values) override {
+            targetGain = Decibels::decibelsToGain(values[0], -1000.0f);
+        }
+
+        void processNode(const ProcessContextReplacing<float>& context) override {
+            auto& block = context.getOutputBlock();
+            auto numSamples = (int)block.getNumSamples();
+
+            for (size_t ch = 0; ch < block.getNumChannels(); ch++) {
+                applyGainRamp(block.getChannelPointer(ch), numSamples, currentGain, targetGain);
+            }
+
+            currentGain = targetGain;
+        }
+
+    private:
+        float currentGain = 1.0f;
+        float targetGain = 1.0f;
+    };
+
+    /**
+     * Mid/side stereo width, 0 is mono, 1 leaves the signal untouched
+     */
+    class WidthNode : public GraphNode {
+    public:
+        static constexpr ParamInfo params[] = {
+            { "width", 0.0f, 2.0f, 1.0f }
+        };
+
+        explicit WidthNode(const String& id)
+            : GraphNode("width", id, params, numElementsInArray(params))
+        {
+
+        }
+
+    protected:
+        void prepareNode(const ProcessSpec&) override {
+
+        }
+
+        void parametersChanged(const float* values) override {
+            targetWidth = values[0];
+        }
+
+        void processNode(const ProcessContextReplacing<float>& context) override {
+            auto& block = context.getOutputBlock();
+
+            if (block.getNumChannels() < 2) {
+                return;
+            }
+
+            auto left = block.getChannelPointer(0);
+            auto right = block.getChannelPointer(1);
+            auto numSamples = (int)block.getNumSamples();
+
+            const auto step = (targetWidth - currentWidth) / numSamples;
+
+            for (int i = 0; i < numSamples; i++) {
+                auto width = currentWidth + step * (i + 1);
+                auto mid = (left[i] + right[i]) * 0.5f;
+                auto side = (left[i] - right[i]) * 0.5f * width;
+
+                left[i] = mid + side;
+                right[i] = mid - side;
+            }
+
+            currentWidth = targetWidth;
+        }
+
+    private:
+        float currentWidth = 1.0f;
+        float targetWidth = 1.0f;
+    };
+
+    /**
+     * Low shelf, peak and high shelf, Audio EQ Cookbook by Robert Bristow-Johnson
+     */
+    class EqNode : public GraphNode {
+    public:
+        static constexpr ParamInfo params[] = {
+            { "lowFrequency", 20.0f, 1000.0f, 100.0f },
+            { "lowGain", -24.0f, 24.0f, 0.0f },
+            { "midFrequency", 100.0f, 10000.0f, 1000.0f },
+            { "midGain", -24.0f, 24.0f, 0.0f },
+            { "midQ", 0.1f, 10.0f, 0.7071f },
+            { "highFrequency", 1000.0f, 20000.0f, 8000.0f },
+            { "highGain", -24.0f, 24.0f, 0.0f }
+        };
+
+        explicit EqNode(const String& id)
+            : GraphNode("eq", id, params, numElementsInArray(params))
+        {
+
+        }
+
+        void reset() override {
+            for (auto& band : bands) {
+                for (auto& f : band.filters) {
+                    f.reset();
+                }
+            }
+        }
+
+    protected:
+        enum Band { Low, Mid, High, NumBands };
+
+        void prepareNode(const ProcessSpec& spec) override {
+            sampleRate = spec.sampleRate;
+            reset();
+        }
+
+        void parametersChanged(const float* values) override {
+            // Indexes into params
+            constexpr int frequencyParams[NumBands] = { 0, 2, 5 };
+            constexpr int gainParams[NumBands] = { 1, 3, 6 };
+            constexpr int midQParam = 4;
+
+            const auto pi = MathConstants<double>::pi;
+            const auto nyquistLimit = sampleRate * 0.49;
+
+            for (int b = 0; b < NumBands; b++) {
+                auto frequency = jmin((double)values[frequencyParams[b]], nyquistLimit);
+                auto gain = (double)values[gainParams[b]];
+
+                auto& band = bands[b];
+                auto wasActive = band.active;
+                band.active = gain != 0.0;
+
+                if (!band.active) {
+                    continue;
+                }
+
+                // Whatever was left in the filters is from before the band was turned off
+                if (!wasActive) {
+                    for (auto& f : band.filters) {
+                        f.reset();
+                    }
+                }
+
+                const auto A = std::pow(10.0, gain / 40.0);
+                const auto w0 = 2.0 * pi * frequency / sampleRate;
+                const auto cosw = std::cos(w0);
+                const auto sinw = std::sin(w0);
+
+                double b0, b1, b2, a0, a1, a2;
+
+                if (b == Mid) {
+                    const auto alpha = sinw / (2.0 * values[midQParam]);
+
+                    b0 = 1.0 + alpha * A;
+                    b1 = -2.0 * cosw;
+                    b2 = 1.0 - alpha * A;
+                    a0 = 1.0 + alpha / A;
+                    a1 = -2.0 * cosw;
+                    a2 = 1.0 - alpha / A;
+                }
+                else {
+                    // Shelf slope of 1, the steepest without overshoot
+                    const auto twoSqrtAAlpha = std::sqrt(A) * sinw * MathConstants<double>::sqrt2;
+                    const auto sign = (b == Low) ? 1.0 : -1.0;
+
+                    b0 = A * ((A + 1.0) - sign * (A - 1.0) * cosw + twoSqrtAAlpha);
+                    b1 = sign * 2.0 * A * ((A - 1.0) - sign * (A + 1.0) * cosw);
+                    b2 = A * ((A + 1.0) - sign * (A - 1.0) * cosw - twoSqrtAAlpha);
+                    a0 = (A + 1.0) + sign * (A - 1.0) * cosw + twoSqrtAAlpha;
+                    a1 = -sign * 2.0 * ((A - 1.0) + sign * (A + 1.0) * cosw);
+                    a2 = (A + 1.0) + sign * (A - 1.0) * cosw - twoSqrtAAlpha;
+                }
+
+                for (auto& f : band.filters) {
+                    f.setCoefficients(b0, b1, b2, a0, a1, a2);
+                }
+            }
+        }
+
+        void processNode(const ProcessContextReplacing<float>& context) override {
+            auto& block = context.getOutputBlock();
+            auto numChannels = jmin((int)block.getNumChannels(), kMaxChannels);
+            auto numSamples = (int)block.getNumSamples();
+
+            for (auto& band : bands) {
+                if (!band.active) {
+                    continue;
+                }
+
+                for (int ch = 0; ch < numChannels; ch++) {
+                    auto data = block.getChannelPointer((size_t)ch);
+                    auto& f = band.filters[ch];
+
+                    for (int i = 0; i < numSamples; i++) {
+                        data[i] = f.process(data[i]);
+                    }
+
+                    f.snapToZero();
+                }
+            }
+        }
+
+    private:
+        struct BandState {
+            bool active = false;
+            Biquad filters[kMaxChannels];
+        };
+
+        double sampleRate = 44100.0;
+        BandState bands[NumBands];
+    };
+}
+
+GraphNode::Ptr GraphNode::create(const String& type, const String& id)
+{
+    if (type == "eq") {
+        return std::make_shared<EqNode>(id);
+    }
+
+    if (type == "width") {
+        return std::make_shared<WidthNode>(id);
+    }
+
+    if (type == "gain") {
+        return std::make_shared<GainNode>(id);
+    }
+
+    return nullptr;
+}
+
+StringArray GraphNode::getTypes()
+{
+    return { "eq", "width", "gain" };
+}
+
+GraphNode::GraphNode(const String& type, const String& id, const ParamInfo* paramInfos, int numParams)
+    : type(type),
+    id(id),
+    paramInfos(paramInfos),
+    numParams(jmin(numParams, maxParams))
+{
+    for (int i = 0; i < this->numParams; i++) {
+        values[i] = paramInfos[i].defaultValue;
+    }
+
+    for (auto& buffer : buffers) {
+        std::copy(values, values + maxParams, buffer);
+    }
+}
+
+int GraphNode::indexOfParam(const String& name) const
+{
+    for (int i = 0; i < numParams; i++) {
+        if (name == paramInfos[i].name) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+float GraphNode::getParam(int index) const
+{
+    if (!isPositiveAndBelow(index, numParams)) {
+        return 0.0f;
+    }
+
+    const ScopedLock sl(paramLock);
+    return values[index];
+}
+
+float GraphNode::setParam(int index, float newValue)
+{
+    if (!isPositiveAndBelow(index, numParams)) {
+        return 0.0f;
+    }
+
+    auto& info = paramInfos[index];
+
+    const ScopedLock sl(paramLock);
+
+    values[index] = jlimit(info.minValue, info.maxValue, newValue);
+    publish();
+
+    return values[index];
+}
+
+void GraphNode::prepare(const ProcessSpec& spec)
+{
+    prepareNode(spec);
+
+    // Derived values depend on the spec, have them recalculated on the next block
+    const ScopedLock sl(paramLock);
+    publish();
+}
+
+void GraphNode::process(const ProcessContextReplacing<float>& context)
+{
+    if (middleIndex.load(std::memory_order_relaxed) & kDirty) {
+        readIndex = middleIndex.exchange(readIndex, std::memory_order_acq_rel) & ~kDirty;
+        parametersChanged(buffers[readIndex]);
+    }
+
+    if (!isBypassed()) {
+        processNode(context);
+    }
+}
+
+void GraphNode::publish()
+{
+    std::copy(values, values + maxParams, buffers[writeIndex]);
+    writeIndex = middleIndex.exchange(writeIndex | kDirty, std::memory_order_acq_rel) & ~kDirty;
+}
+
+namespace {
+    TimeSliceThread& getReclamationThread() {
+        static struct ReclamationThread : public TimeSliceThread {
+            ReclamationThread() : TimeSliceThread("Graph reclamation") { startThread(1); }
+            ~ReclamationThread() override { stopThread(1000); }
+        } thread;
+
+        return thread;
+    }
+
+    constexpr int kReclamationInterval = 100;
+}
+
+ProcessingGraph::ProcessingGraph()
+{
+    getReclamationThread().addTimeSliceClient(this);
+}
+
+ProcessingGraph::~ProcessingGraph()
+{
+    getReclamationThread().removeTimeSliceClient(this);
+
+    releaseRetired();
+
+    deleteList(pending.exchange(nullptr));
+    deleteList(active);
+}
+
+void ProcessingGraph::prepare(const ProcessSpec& spec)
+{
+    const ScopedLock sl(lock);
+    const ScopedLock psl(processLock);
+
+    this->spec = spec;
+    prepared = true;
+
+    // The audio thread is held off, take the latest list right away so every node in use gets prepared
+    if (auto next = pending.exchange(nullptr, std::memory_order_acquire)) {
+        deleteList(active);
+        active = next;
+    }
+
+    for (auto& node : latest) {
+        node->prepare(spec);
+    }
+
+    releaseRetired();
+}
+
+void ProcessingGraph::process(const ProcessContextReplacing<float>& context)
+{
+    const ScopedTryLock sl(processLock);
+
+    if (!sl.isLocked()) {
+        return;
+    }
+
+    if (auto next = pending.exchange(nullptr, std::memory_order_acquire)) {
+        if (active != nullptr) {
+            retire(active);
+        }
+
+        active = next;
+    }
+
+    if (active == nullptr) {
+        return;
+    }
+
+    for (auto& node : active->nodes) {
+        node->process(context);
+    }
+}
+
+void ProcessingGraph::reset()
+{
+    const ScopedLock sl(lock);
+    const ScopedLock psl(processLock);
+
+    for (auto& node : latest) {
+        node->reset();
+    }
+}
+
+void ProcessingGraph::setNodes(const std::vector<GraphNode::Ptr>& nodes)
+{
+    const ScopedLock sl(lock);
+
+    releaseRetired();
+
+    if (prepared) {
+        for (auto& node : nodes) {
+            // Nodes the audio thread may still process were prepared for the current spec already, every node in use is prepared by prepare()
+            if (!isInUse(node)) {
+                node->prepare(spec);
+            }
+        }
+    }
+
+    latest = nodes;
+
+    // A list the audio thread has never picked up can be deleted right away
+    deleteList(pending.exchange(createList(nodes), std::memory_order_acq_rel));
+}
+
+std::vector<GraphNode::Ptr> ProcessingGraph::getNodes() const
+{
+    const ScopedLock sl(lock);
+    return latest;
+}
+
+GraphNode::Ptr ProcessingGraph::findNode(const String& id) const
+{
+    const ScopedLock sl(lock);
+
+    for (auto& node : latest) {
+        if (node->getId() == id) {
+            return node;
+        }
+    }
+
+    return nullptr;
+}
+
+int ProcessingGraph::getLatencyInSamples() const
+{
+    const ScopedLock sl(lock);
+
+    int latency = 0;
+
+    for (auto& node : latest) {
+        latency += node->getLatencyInSamples();
+    }
+
+    return latency;
+}
+
+int ProcessingGraph::useTimeSlice()
+{
+    const ScopedLock sl(lock);
+    releaseRetired();
+
+    return kReclamationInterval;
+}
+
+ProcessingGraph::NodeList* ProcessingGraph::createList(const std::vector<GraphNode::Ptr>& nodes)
+{
+    for (auto& node : nodes) {
+        listed[node.get()]++;
+    }
+
+    return new NodeList{ nodes };
+}
+
+void ProcessingGraph::deleteList(NodeList* list)
+{
+    if (list == nullptr) {
+        return;
+    }
+
+    for (auto& node : list->nodes) {
+        auto it = listed.find(node.get());
+
+        if (it != listed.end() && --it->second <= 0) {
+            listed.erase(it);
+        }
+    }
+
+    delete list;
+}
+
+bool ProcessingGraph::isInUse(const GraphNode::Ptr& node) const
+{
+    return listed.find(node.get()) != listed.end();
+}
+
+void ProcessingGraph::retire(NodeList* list)
+{
+    list->nextRetired = retired.load(std::memory_order_relaxed);
+    while (!retired.compare_exchange_weak(list->nextRetired, list, std::memory_order_release, std::memory_order_relaxed)) {}
+}
+
+void ProcessingGraph::releaseRetired()
+{
+    // The audio thread never touches a list again once it has been retired
+    auto list = retired.exchange(nullptr, std::memory_order_acquire);
+
+    while (list != nullptr) {
+        auto next = list->nextRetired;
+        deleteList(list);
+        list = next;
+    }
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <map>
+#include <vector>
+
+using namespace juce;
+using namespace dsp;
+
+/**
+ * A processor in ProcessingGraph
+ *
+ * Parameters can be set from any thread, they are triple buffered:
+ * the audio thread picks up the latest complete set at the start of a block, without locking or allocating.
+ */
+class GraphNode
+{
+public:
+    using Ptr = std::shared_ptr<GraphNode>;
+
+    struct ParamInfo {
+        const char* name;
+        float minValue;
+        float maxValue;
+        float defaultValue;
+    };
+
+    static constexpr int maxParams = 16;
+
+    virtual ~GraphNode() = default;
+
+    /**
+     * Create one of the built-in nodes: `eq`, `width` or `gain`, returns nullptr for an unknown type
+     */
+    static Ptr create(const String& type, const String& id);
+
+    static StringArray getTypes();
+
+    const String& getType() const { return type; }
+
+    const String& getId() const { return id; }
+
+    int getNumParams() const { return numParams; }
+
+    const ParamInfo& getParamInfo(int index) const { return paramInfos[index]; }
+
+    /**
+     * -1 if this node has no such parameter
+     */
+    int indexOfParam(const String& name) const;
+
+    float getParam(int index) const;
+
+    /**
+     * The value is clamped to the parameter range, the clamped value is returned
+     */
+    float setParam(int index, float newValue);
+
+    bool isBypassed() const { return bypassed.load(std::memory_order_relaxed); }
+
+    void setBypassed(bool value) { bypassed.store(value, std::memory_order_relaxed); }
+
+    virtual int getLatencyInSamples() const { return 0; }
+
+    /**
+     * Never called while the node may be processed
+     */
+    void prepare(const ProcessSpec& spec);
+
+    /**
+     * Audio thread
+     */
+    void process(const ProcessContextReplacing<float>& context);
+
+    virtual void reset() {}
+
+protected:
+    GraphNode(const String& type, const String& id, const ParamInfo* paramInfos, int numParams);
+
+    virtual void prepareNode(const ProcessSpec& spec) = 0;
+
+    /**
+     * Called on the audio thread before processing a block, whenever a new set of parameters has been published
+     */
+    virtual void parametersChanged(const float* values) = 0;
+
+    virtual void processNode(const ProcessContextReplacing<float>& context) = 0;
+
+private:
+    static constexpr int kDirty = 4;
+
+    void publish();
+
+    const String type;
+    const String id;
+
+    const ParamInfo* paramInfos;
+    const int numParams;
+
+    // Writer side
+    CriticalSection paramLock;
+    float values[maxParams]{};
+    int writeIndex = 0;
+
+    // Index of the buffer in between the writer and the reader, ORed with kDirty when it holds a set the reader has not seen
+    std::atomic<int> middleIndex{ 1 | kDirty };
+
+    // Reader side
+    int readIndex = 2;
+
+    float buffers[3][maxParams]{};
+
+    std::atomic<bool> bypassed{ false };
+};
+
+/**
+ * An ordered list of nodes which can be replaced at runtime, while audio is running
+ *
+ * Changing the nodes builds a new list on the calling thread, new nodes are prepared there as well.
+ * The audio thread swaps it in at the start of the next block through an atomic pointer and hands the previous list back,
+ * it is then released on a background thread shortly after.
+ *
+ * A node removed then added back before the audio thread let go of it is not prepared again, it is still being processed.
+ */
+class ProcessingGraph : private TimeSliceClient
+{
+public:
+    ProcessingGraph();
+
+    ~ProcessingGraph() override;
+
+    void prepare(const ProcessSpec& spec);
+
+    /**
+     * Audio thread
+     */
+    void process(const ProcessContextReplacing<float>& context);
+
+    void reset();
+
+    void setNodes(const std::vector<GraphNode::Ptr>& nodes);
+
+    std::vector<GraphNode::Ptr> getNodes() const;
+
+    GraphNode::Ptr findNode(const String& id) const;
+
+    int getLatencyInSamples() const;
+
+private:
+    struct NodeList {
+        std::vector<GraphNode::Ptr> nodes;
+        NodeList* nextRetired = nullptr;
+    };
+
+    int useTimeSlice() override;
+
+    NodeList* createList(const std::vector<GraphNode::Ptr>& nodes);
+
+    void deleteList(NodeList* list);
+
+    /**
+     * Whether the audio thread may still process the node
+     */
+    bool isInUse(const GraphNode::Ptr& node) const;
+
+    void retire(NodeList* list);
+
+    void releaseRetired();
+
+    // Guards the writer side
+    CriticalSection lock;
+
+    // Guards prepare() against process(), process() only tries to lock and passes the audio through while being prepared
+    CriticalSection processLock;
+
+    ProcessSpec spec{ 44100.0, 0, 0 };
+    bool prepared = false;
+    std::vector<GraphNode::Ptr> latest;
+
+    // Number of lists not deleted yet each node is in
+    std::map<GraphNode*, int> listed;
+
+    std::atomic<NodeList*> pending{ nullptr };
+    NodeList* active = nullptr;
+    std::atomic<NodeList*> retired{ nullptr };
+};
@@ -1,8 +1,15 @@
 #include "ReductionCalculator.h"
+#include "Simd.h"
 
 // Adapted from https://github.com/DanielRudrich/SimpleCompressor
 
 using namespace juce;
+using namespace medley;
+
+namespace {
+    // Any reduction smaller than this is inaudible, snapping it to 0 lets the fast path skip the release entirely
+    constexpr float kSettledDecibels = 1.0e-4f;
+}
 
 void ReductionCalculator::prepare(const double newSampleRate)
 {
@@ -14,41 +21,84 @@ void ReductionCalculator::prepare(const double newSampleRate)
 
 void ReductionCalculator::calculateDecibels(const float* signal, float* result, const int numSamples)
 {
-    maxInputLevel = -std::numeric_limits<float>::infinity();
-    maxGainReduction = 0.0f;
+    // The signal is expected to be rectified already, its peak is the highest level of the block
+    const auto peakInDecibels = Decibels::gainToDecibels(simd::findPeak(signal, numSamples));
+    maxInputLevel.store(peakInDecibels, std::memory_order_relaxed);
+
+    if (peakInDecibels - threshold <= -kneeHalf) {
+        // The whole block is below the knee, the gain computer would output 0dB for every sample
+        // so only the release of any remaining reduction is left
+        release(result, numSamples);
+        return;
+    }
 
-    for (int i = 0; i < numSamples; i++) {
-        const float levelInDecibels = Decibels::gainToDecibels(signal[i]);
+    simd::gainToDecibels(result, signal, numSamples);
 
-        if (levelInDecibels > maxInputLevel) {
-            maxInputLevel = levelInDecibels;
-        }
+    if (knee <= 0.0f) {
+        const auto thresholds = simd::Float4::broadcast(threshold);
+        const auto slopes = simd::Float4::broadcast(slope);
+        const auto zero = simd::Float4::zero();
 
-        const float overShoot = levelInDecibels - threshold;
-        const float gainReduction = apply(overShoot);
+        int i = 0;
 
-        const float diff = gainReduction - state;
-        if (diff < 0.0f) {
-            state += alphaAttack * diff;
+        for (; i + 4 <= numSamples; i += 4) {
+            (slopes * simd::Float4::max(simd::Float4::load(result + i) - thresholds, zero)).store(result + i);
         }
-        else {
-            state += alphaRelease * diff;
+
+        for (; i < numSamples; i++) {
+            result[i] = slope * jmax(result[i] - threshold, 0.0f);
         }
+    }
+    else {
+        for (int i = 0; i < numSamples; i++) {
+            result[i] = apply(result[i] - threshold);
+        }
+    }
 
-        result[i] = state;
+    // Attack/release smoothing is a recursive filter, it cannot be vectorized across samples
+    auto s = state;
+    auto minimum = 0.0f;
 
-        if (state < maxGainReduction) {
-            maxGainReduction = state;
-        }
+    for (int i = 0; i < numSamples; i++) {
+        const float diff = result[i] - s;
+        s += (diff < 0.0f ? alphaAttack : alphaRelease) * diff;
+
+        result[i] = s;
+        minimum = jmin(minimum, s);
+    }
+
+    state = s;
+    maxGainReduction.store(minimum, std::memory_order_relaxed);
+}
+
+void ReductionCalculator::release(float* result, const int numSamples)
+{
+    if (state > -kSettledDecibels) {
+        state = 0.0f;
     }
+
+    if (state == 0.0f) {
+        FloatVectorOperations::clear(result, numSamples);
+        maxGainReduction.store(0.0f, std::memory_order_relaxed);
+        return;
+    }
+
+    const float decay = 1.0f - alphaRelease;
+    auto s = state;
+
+    for (int i = 0; i < numSamples; i++) {
+        s *= decay;
+        result[i] = s;
+    }
+
+    maxGainReduction.store(numSamples > 0 ? result[0] : 0.0f, std::memory_order_relaxed);
+    state = s;
 }
 
 void ReductionCalculator::calculateLinear(const float* signal, float* result, const int numSamples)
 {
     calculateDecibels(signal, result, numSamples);
-    for (int i = 0; i < numSamples; i++) {
-        result[i] = Decibels::decibelsToGain(result[i] + makeUpGain);
-    }
+    simd::decibelsToGain(result, result, makeUpGain, numSamples);
 }
 
 float ReductionCalculator::timeToGain(const float timeInSeconds)
@@ -48,6 +48,11 @@ private:
     float timeToGain(const float timeInSeconds);
     float apply(const float overShootInDecibels);
 
+    /**
+     * Output for a block with no overshoot, the current reduction only decays toward 0dB
+     */
+    void release(float* result, const int numSamples);
+
     std::atomic<float> maxInputLevel{ -std::numeric_limits<float>::infinity() };
     std::atomic<float> maxGainReduction{ 0 };
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <atomic>
 
 using namespace juce;
 
@@ -39,11 +40,18 @@ public:
         auto numToDo = jmin(this->numSamples, numSamples);
 
         if (fifo.getFreeSpace() <= 0) {
+            droppedSamples.fetch_add((uint64_t)fifo.getNumReady(), std::memory_order_relaxed);
+            overflows.fetch_add(1, std::memory_order_relaxed);
+
             fifo.reset();
         }
 
         auto w = fifo.write(numToDo);
 
+        if (auto written = w.blockSize1 + w.blockSize2; written < numSamples) {
+            droppedSamples.fetch_add((uint64_t)(numSamples - written), std::memory_order_relaxed);
+        }
+
         auto channels = jmin(source.getNumChannels(), numChannels);
 
         for (int i = 0; i < channels; i++) {
@@ -84,10 +92,25 @@ public:
 
     uint32_t getNumReady() const { return (uint32_t)fifo.getNumReady(); }
 
+    uint32_t getCapacity() const { return (uint32_t)fifo.getTotalSize(); }
+
+    /**
+     * Number of samples discarded because the reader did not keep up
+     */
+    uint64_t getDroppedSamples() const { return droppedSamples.load(std::memory_order_relaxed); }
+
+    /**
+     * Number of times the buffer was full and had to be reset
+     */
+    uint32_t getOverflows() const { return overflows.load(std::memory_order_relaxed); }
+
 private:
     int numChannels;
     int numSamples;
 
     AudioBuffer<SampleType> audioData;
     AbstractFifo fifo;
+
+    std::atomic<uint64_t> droppedSamples{ 0 };
+    std::atomic<uint32_t> overflows{ 0 };
 };
\ No newline at end of file
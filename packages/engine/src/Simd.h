@@ -0,0 +1,398 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MEDLEY_SIMD_SSE 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define MEDLEY_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace medley {
+namespace simd {
+
+/**
+ * Four packed floats, loads and stores do not require any alignment
+ *
+ * Falls back to plain arrays on targets without SSE2 or NEON.
+ */
+struct Float4 {
+#if MEDLEY_SIMD_SSE
+    __m128 v;
+
+    static Float4 load(const float* p) { return { _mm_loadu_ps(p) }; }
+    static Float4 broadcast(float x) { return { _mm_set1_ps(x) }; }
+    static Float4 zero() { return { _mm_setzero_ps() }; }
+
+    void store(float* p) const { _mm_storeu_ps(p, v); }
+
+    friend Float4 operator+(Float4 a, Float4 b) { return { _mm_add_ps(a.v, b.v) }; }
+    friend Float4 operator-(Float4 a, Float4 b) { return { _mm_sub_ps(a.v, b.v) }; }
+    friend Float4 operator*(Float4 a, Float4 b) { return { _mm_mul_ps(a.v, b.v) }; }
+
+    static Float4 max(Float4 a, Float4 b) { return { _mm_max_ps(a.v, b.v) }; }
+    static Float4 min(Float4 a, Float4 b) { return { _mm_min_ps(a.v, b.v) }; }
+
+    Float4 abs() const { return { _mm_andnot_ps(_mm_set1_ps(-0.0f), v) }; }
+#elif MEDLEY_SIMD_NEON
+    float32x4_t v;
+
+    static Float4 load(const float* p) { return { vld1q_f32(p) }; }
+    static Float4 broadcast(float x) { return { vdupq_n_f32(x) }; }
+    static Float4 zero() { return { vdupq_n_f32(0.0f) }; }
+
+    void store(float* p) const { vst1q_f32(p, v); }
+
+    friend Float4 operator+(Float4 a, Float4 b) { return { vaddq_f32(a.v, b.v) }; }
+    friend Float4 operator-(Float4 a, Float4 b) { return { vsubq_f32(a.v, b.v) }; }
+    friend Float4 operator*(Float4 a, Float4 b) { return { vmulq_f32(a.v, b.v) }; }
+
+    static Float4 max(Float4 a, Float4 b) { return { vmaxq_f32(a.v, b.v) }; }
+    static Float4 min(Float4 a, Float4 b) { return { vminq_f32(a.v, b.v) }; }
+
+    Float4 abs() const { return { vabsq_f32(v) }; }
+#else
+    float v[4];
+
+    static Float4 load(const float* p) { return { { p[0], p[1], p[2], p[3] } }; }
+    static Float4 broadcast(float x) { return { { x, x, x, x } }; }
+    static Float4 zero() { return broadcast(0.0f); }
+
+    void store(float* p) const { for (int i = 0; i < 4; i++) p[i] = v[i]; }
+
+    friend Float4 operator+(Float4 a, Float4 b) { return apply(a, b, [](float x, float y) { return x + y; }); }
+    friend Float4 operator-(Float4 a, Float4 b) { return apply(a, b, [](float x, float y) { return x - y; }); }
+    friend Float4 operator*(Float4 a, Float4 b) { return apply(a, b, [](float x, float y) { return x * y; }); }
+
+    static Float4 max(Float4 a, Float4 b) { return apply(a, b, [](float x, float y) { return jmax(x, y); }); }
+    static Float4 min(Float4 a, Float4 b) { return apply(a, b, [](float x, float y) { return jmin(x, y); }); }
+
+    Float4 abs() const { return { { std::abs(v[0]), std::abs(v[1]), std::abs(v[2]), std::abs(v[3]) } }; }
+
+    template <typename Op>
+    static Float4 apply(Float4 a, Float4 b, Op op) {
+        return { { op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]), op(a.v[3], b.v[3]) } };
+    }
+#endif
+
+    float sum() const {
+        float t[4];
+        store(t);
+        return (t[0] + t[1]) + (t[2] + t[3]);
+    }
+
+    float maxElement() const {
+        float t[4];
+        store(t);
+        return jmax(jmax(t[0], t[1]), jmax(t[2], t[3]));
+    }
+};
+
+/**
+ * Two packed doubles, used to run a pair of independent recursive filters side by side
+ *
+ * 32-bit ARM NEON has no double lanes, it takes the scalar fallback.
+ */
+struct Double2 {
+#if MEDLEY_SIMD_SSE
+    __m128d v;
+
+    static Double2 set(double a, double b) { return { _mm_set_pd(b, a) }; }
+    static Double2 broadcast(double x) { return { _mm_set1_pd(x) }; }
+    static Double2 zero() { return { _mm_setzero_pd() }; }
+
+    void store(double* p) const { _mm_storeu_pd(p, v); }
+
+    friend Double2 operator+(Double2 a, Double2 b) { return { _mm_add_pd(a.v, b.v) }; }
+    friend Double2 operator-(Double2 a, Double2 b) { return { _mm_sub_pd(a.v, b.v) }; }
+    friend Double2 operator*(Double2 a, Double2 b) { return { _mm_mul_pd(a.v, b.v) }; }
+
+    double sum() const { return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v))); }
+#elif MEDLEY_SIMD_NEON && (defined(__aarch64__) || defined(_M_ARM64))
+    float64x2_t v;
+
+    static Double2 set(double a, double b) { double t[2] = { a, b }; return { vld1q_f64(t) }; }
+    static Double2 broadcast(double x) { return { vdupq_n_f64(x) }; }
+    static Double2 zero() { return { vdupq_n_f64(0.0) }; }
+
+    void store(double* p) const { vst1q_f64(p, v); }
+
+    friend Double2 operator+(Double2 a, Double2 b) { return { vaddq_f64(a.v, b.v) }; }
+    friend Double2 operator-(Double2 a, Double2 b) { return { vsubq_f64(a.v, b.v) }; }
+    friend Double2 operator*(Double2 a, Double2 b) { return { vmulq_f64(a.v, b.v) }; }
+
+    double sum() const { return vaddvq_f64(v); }
+#else
+    double v[2];
+
+    static Double2 set(double a, double b) { return { { a, b } }; }
+    static Double2 broadcast(double x) { return { { x, x } }; }
+    static Double2 zero() { return broadcast(0.0); }
+
+    void store(double* p) const { p[0] = v[0]; p[1] = v[1]; }
+
+    friend Double2 operator+(Double2 a, Double2 b) { return { { a.v[0] + b.v[0], a.v[1] + b.v[1] } }; }
+    friend Double2 operator-(Double2 a, Double2 b) { return { { a.v[0] - b.v[0], a.v[1] - b.v[1] } }; }
+    friend Double2 operator*(Double2 a, Double2 b) { return { { a.v[0] * b.v[0], a.v[1] * b.v[1] } }; }
+
+    double sum() const { return v[0] + v[1]; }
+#endif
+};
+
+namespace detail {
+    // Float lanes are flushed into a double accumulator every this many samples to bound rounding errors
+    constexpr int kFlushInterval = 1024;
+
+    // log2(1 + t) / t for t in [0, 1), near-minimax fit, absolute error of log2(x) is below 1.1e-5
+    constexpr float kLog2Coefficients[] = { 1.4426848f, -0.720519772f, 0.469920504f, -0.30512161f, 0.148412364f, -0.0353865249f };
+
+    // (2^f - 1) / f for f in [0, 1), near-minimax fit, relative error of exp2(x) is below 5e-7 before input rounding
+    constexpr float kExp2Coefficients[] = { 0.693147588f, 0.240206549f, 0.0556602862f, 0.00919420833f, 0.00179096137f };
+
+    constexpr float kDecibelsPerOctave = 6.02059991f; // 20 * log10(2)
+    constexpr float kOctavesPerDecibel = 0.166096404f; // log2(10) / 20
+    constexpr float kMinusInfinityDb = -100.0f;
+
+    template <typename T, size_t N>
+    inline T polynomial(T x, const float (&c)[N]) {
+        T result = T(c[N - 1]);
+
+        for (int i = (int)N - 2; i >= 0; i--) {
+            result = result * x + T(c[i]);
+        }
+
+        return result;
+    }
+
+    template <size_t N>
+    inline Float4 polynomial(Float4 x, const float (&c)[N]) {
+        auto result = Float4::broadcast(c[N - 1]);
+
+        for (int i = (int)N - 2; i >= 0; i--) {
+            result = result * x + Float4::broadcast(c[i]);
+        }
+
+        return result;
+    }
+}
+
+/**
+ * Approximated log2(x), x must be a positive normal number
+ */
+inline float fastLog2(float x)
+{
+    uint32 bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+
+    auto exponent = (int)(bits >> 23) - 127;
+    bits = (bits & 0x007fffffu) | 0x3f800000u;
+
+    float mantissa;
+    std::memcpy(&mantissa, &bits, sizeof(bits));
+
+    auto t = mantissa - 1.0f;
+    return (float)exponent + t * detail::polynomial(t, detail::kLog2Coefficients);
+}
+
+/**
+ * Approximated 2^x, x is clamped to [-126, 126]
+ */
+inline float fastExp2(float x)
+{
+    x = jlimit(-126.0f, 126.0f, x);
+
+    auto floored = std::floor(x);
+    auto f = x - floored;
+    auto result = 1.0f + f * detail::polynomial(f, detail::kExp2Coefficients);
+
+    uint32 bits;
+    std::memcpy(&bits, &result, sizeof(bits));
+    bits += (uint32)((int32)floored << 23);
+    std::memcpy(&result, &bits, sizeof(bits));
+
+    return result;
+}
+
+#if MEDLEY_SIMD_SSE
+inline Float4 fastLog2(Float4 x)
+{
+    auto bits = _mm_castps_si128(x.v);
+    auto exponent = _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127));
+    auto mantissa = _mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f800000));
+
+    Float4 t{ _mm_sub_ps(_mm_castsi128_ps(mantissa), _mm_set1_ps(1.0f)) };
+    return Float4{ _mm_cvtepi32_ps(exponent) } + t * detail::polynomial(t, detail::kLog2Coefficients);
+}
+
+inline Float4 fastExp2(Float4 x)
+{
+    x = Float4::min(Float4::max(x, Float4::broadcast(-126.0f)), Float4::broadcast(126.0f));
+
+    // Truncation rounds negative numbers up, step back by one where that happened
+    auto truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(x.v));
+    auto floored = _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, x.v), _mm_set1_ps(1.0f)));
+
+    Float4 f{ _mm_sub_ps(x.v, floored) };
+    auto result = Float4::broadcast(1.0f) + f * detail::polynomial(f, detail::kExp2Coefficients);
+
+    auto exponent = _mm_slli_epi32(_mm_cvttps_epi32(floored), 23);
+    return { _mm_castsi128_ps(_mm_add_epi32(_mm_castps_si128(result.v), exponent)) };
+}
+#elif MEDLEY_SIMD_NEON
+inline Float4 fastLog2(Float4 x)
+{
+    auto bits = vreinterpretq_s32_f32(x.v);
+    auto exponent = vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_f32(x.v), 23)), vdupq_n_s32(127));
+    auto mantissa = vorrq_s32(vandq_s32(bits, vdupq_n_s32(0x007fffff)), vdupq_n_s32(0x3f800000));
+
+    Float4 t{ vsubq_f32(vreinterpretq_f32_s32(mantissa), vdupq_n_f32(1.0f)) };
+    return Float4{ vcvtq_f32_s32(exponent) } + t * detail::polynomial(t, detail::kLog2Coefficients);
+}
+
+inline Float4 fastExp2(Float4 x)
+{
+    x = Float4::min(Float4::max(x, Float4::broadcast(-126.0f)), Float4::broadcast(126.0f));
+
+    // Truncation rounds negative numbers up, step back by one where that happened
+    auto truncated = vcvtq_f32_s32(vcvtq_s32_f32(x.v));
+    auto adjust = vreinterpretq_f32_u32(vandq_u32(vcgtq_f32(truncated, x.v), vreinterpretq_u32_f32(vdupq_n_f32(1.0f))));
+    auto floored = vsubq_f32(truncated, adjust);
+
+    Float4 f{ vsubq_f32(x.v, floored) };
+    auto result = Float4::broadcast(1.0f) + f * detail::polynomial(f, detail::kExp2Coefficients);
+
+    auto exponent = vshlq_n_s32(vcvtq_s32_f32(floored), 23);
+    return { vreinterpretq_f32_s32(vaddq_s32(vreinterpretq_s32_f32(result.v), exponent)) };
+}
+#else
+inline Float4 fastLog2(Float4 x)
+{
+    return { { fastLog2(x.v[0]), fastLog2(x.v[1]), fastLog2(x.v[2]), fastLog2(x.v[3]) } };
+}
+
+inline Float4 fastExp2(Float4 x)
+{
+    return { { fastExp2(x.v[0]), fastExp2(x.v[1]), fastExp2(x.v[2]), fastExp2(x.v[3]) } };
+}
+#endif
+
+/**
+ * Largest absolute sample value
+ */
+inline float findPeak(const float* src, int numSamples)
+{
+    auto acc = Float4::zero();
+    int i = 0;
+
+    for (; i + 4 <= numSamples; i += 4) {
+        acc = Float4::max(acc, Float4::load(src + i).abs());
+    }
+
+    auto peak = acc.maxElement();
+
+    for (; i < numSamples; i++) {
+        peak = jmax(peak, std::abs(src[i]));
+    }
+
+    return peak;
+}
+
+inline double sumOfProducts(const float* a, const float* b, int numSamples)
+{
+    double total = 0.0;
+    int i = 0;
+
+    while (i + 4 <= numSamples) {
+        auto end = jmin(numSamples, i + detail::kFlushInterval);
+        auto acc = Float4::zero();
+
+        for (; i + 4 <= end; i += 4) {
+            acc = acc + Float4::load(a + i) * Float4::load(b + i);
+        }
+
+        total += acc.sum();
+    }
+
+    for (; i < numSamples; i++) {
+        total += (double)a[i] * b[i];
+    }
+
+    return total;
+}
+
+inline double sumOfSquares(const float* src, int numSamples)
+{
+    return sumOfProducts(src, src, numSamples);
+}
+
+inline double sum(const float* src, int numSamples)
+{
+    double total = 0.0;
+    int i = 0;
+
+    while (i + 4 <= numSamples) {
+        auto end = jmin(numSamples, i + detail::kFlushInterval);
+        auto acc = Float4::zero();
+
+        for (; i + 4 <= end; i += 4) {
+            acc = acc + Float4::load(src + i);
+        }
+
+        total += acc.sum();
+    }
+
+    for (; i < numSamples; i++) {
+        total += src[i];
+    }
+
+    return total;
+}
+
+/**
+ * Same as juce::Decibels::gainToDecibels() with the default -100dB floor, the error is below 7e-5 dB
+ */
+inline void gainToDecibels(float* dest, const float* src, int numSamples)
+{
+    const auto floor = Float4::broadcast(detail::kMinusInfinityDb);
+    const auto minGain = Float4::broadcast(1.0e-5f);
+    const auto scale = Float4::broadcast(detail::kDecibelsPerOctave);
+
+    int i = 0;
+
+    for (; i + 4 <= numSamples; i += 4) {
+        auto x = Float4::max(Float4::load(src + i), minGain);
+        Float4::max(fastLog2(x) * scale, floor).store(dest + i);
+    }
+
+    for (; i < numSamples; i++) {
+        auto x = jmax(src[i], 1.0e-5f);
+        dest[i] = jmax(fastLog2(x) * detail::kDecibelsPerOctave, detail::kMinusInfinityDb);
+    }
+}
+
+/**
+ * dest = decibelsToGain(src + offsetDecibels), the relative error is below 1e-6, results are floored at -100dB
+ */
+inline void decibelsToGain(float* dest, const float* src, float offsetDecibels, int numSamples)
+{
+    const auto offset = Float4::broadcast(offsetDecibels);
+    const auto floor = Float4::broadcast(detail::kMinusInfinityDb);
+    const auto scale = Float4::broadcast(detail::kOctavesPerDecibel);
+
+    int i = 0;
+
+    for (; i + 4 <= numSamples; i += 4) {
+        auto db = Float4::max(Float4::load(src + i) + offset, floor);
+        fastExp2(db * scale).store(dest + i);
+    }
+
+    for (; i < numSamples; i++) {
+        auto db = jmax(src[i] + offsetDecibels, detail::kMinusInfinityDb);
+        dest[i] = fastExp2(db * detail::kOctavesPerDecibel);
+    }
+}
+
+}
+}
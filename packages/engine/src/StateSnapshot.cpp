@@ -0,0 +1,47 @@
+#include "StateSnapshot.h"
+#include <thread>
+
+namespace medley {
+
+StateSnapshot::StateSnapshot()
+    : memory(sizeInBytes / sizeof(double), true),
+    sequence(new (memory.get()) std::atomic<uint32>(0)),
+    data(reinterpret_cast<EngineState*>(reinterpret_cast<uint8*>(memory.get()) + stateOffset))
+{
+    auto version = reinterpret_cast<uint32*>(reinterpret_cast<uint8*>(memory.get()) + sizeof(uint32));
+    *version = layoutVersion;
+
+    publish(EngineState());
+}
+
+void StateSnapshot::publish(const EngineState& state)
+{
+    auto seq = sequence->load(std::memory_order_relaxed);
+
+    sequence->store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::memcpy(data, &state, sizeof(EngineState));
+
+    sequence->store(seq + 2, std::memory_order_release);
+}
+
+void StateSnapshot::read(EngineState& state) const
+{
+    for (;;) {
+        auto before = sequence->load(std::memory_order_acquire);
+
+        if ((before & 1) == 0) {
+            std::memcpy(&state, data, sizeof(EngineState));
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (sequence->load(std::memory_order_relaxed) == before) {
+                return;
+            }
+        }
+
+        std::this_thread::yield();
+    }
+}
+
+}
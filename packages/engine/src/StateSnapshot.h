@@ -0,0 +1,106 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+using namespace juce;
+
+namespace medley {
+
+/**
+ * Every field is a double so the whole state can be viewed as a Float64Array from JS
+ */
+struct DeckState {
+    double loaded = 0.0;
+    double playing = 0.0;
+    double main = 0.0;
+    double volume = 0.0;
+    double position = 0.0;
+    double duration = 0.0;
+    double first = 0.0;
+    double last = 0.0;
+    double leading = 0.0;
+    double trailing = 0.0;
+    double cuePoint = 0.0;
+    double transitionStart = 0.0;
+    double transitionEnd = 0.0;
+    double level[2]{};
+    double peak[2]{};
+    double rms[2]{};
+};
+
+struct EngineState {
+    static constexpr int numDecks = 3;
+
+    double playing = 0.0;
+    double paused = 0.0;
+    /**
+     * Index of the main deck, -1 if there is none
+     */
+    double mainDeck = -1.0;
+    double volume = 0.0;
+    /**
+     * Limiter reduction in dB
+     */
+    double reduction = 0.0;
+    double level[2]{};
+    double peak[2]{};
+    double rms[2]{};
+    /**
+     * Loudness in LUFS, -Infinity when silent
+     */
+    double momentary = -std::numeric_limits<double>::infinity();
+    double shortTerm = -std::numeric_limits<double>::infinity();
+    double integrated = -std::numeric_limits<double>::infinity();
+    double correlation = 0.0;
+    double truePeak[2]{};
+    double maxTruePeak[2]{};
+    DeckState decks[numDecks];
+};
+
+/**
+ * Seqlock protected EngineState published into a memory block of its own, which can be shared with a reader in another runtime, e.g. as an external JS ArrayBuffer.
+ * The memory lives as long as the snapshot, whoever shares it must hold a reference to the snapshot.
+ *
+ * Layout:
+ *  0: uint32 sequence, odd while being written
+ *  4: uint32 layout version
+ *  8: EngineState
+ *
+ * A reader reads the sequence, copies the state and reads the sequence again,
+ * the copy is consistent if both sequences are equal and even.
+ *
+ * Only a single thread may publish.
+ */
+class StateSnapshot {
+public:
+    static constexpr uint32 layoutVersion = 2;
+
+    static constexpr size_t stateOffset = 8;
+
+    static constexpr size_t sizeInBytes = stateOffset + sizeof(EngineState);
+
+    StateSnapshot();
+
+    void publish(const EngineState& state);
+
+    /**
+     * sizeInBytes, 8 bytes aligned
+     */
+    void* getMemory() const { return memory.get(); }
+
+    /**
+     * Copy the latest consistent state, for native consumers
+     */
+    void read(EngineState& state) const;
+
+private:
+    HeapBlock<double> memory;
+    std::atomic<uint32>* sequence;
+    EngineState* data;
+};
+
+static_assert(std::atomic<uint32>::is_always_lock_free, "Sequence must be readable from JS with Atomics");
+static_assert(sizeof(EngineState) % sizeof(double) == 0, "EngineState must be a flat array of doubles");
+
+}
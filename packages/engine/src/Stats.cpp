@@ -0,0 +1,103 @@
+#include "Stats.h"
+
+namespace medley {
+
+Histogram::Histogram(Unit unit)
+    : unit(unit)
+{
+
+}
+
+int Histogram::bucketOf(uint32 value)
+{
+    // Bucket 0 holds 0, bucket n holds [2^(n-1), 2^n)
+    return value == 0 ? 0 : jmin(numBuckets - 1, findHighestSetBit(value) + 1);
+}
+
+void Histogram::record(uint32 value)
+{
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+    buckets[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+
+    auto m = min.load(std::memory_order_relaxed);
+    while (value < m && !min.compare_exchange_weak(m, value, std::memory_order_relaxed)) {}
+
+    m = max.load(std::memory_order_relaxed);
+    while (value > m && !max.compare_exchange_weak(m, value, std::memory_order_relaxed)) {}
+}
+
+void Histogram::recordTicks(int64 ticks)
+{
+    recordSeconds(Time::highResolutionTicksToSeconds(ticks));
+}
+
+void Histogram::recordSeconds(double seconds)
+{
+    auto value = std::round(seconds * (unit == Unit::Microseconds ? 1.0e6 : 1.0e3));
+
+    if (value < 0.0) {
+        negative.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    record((uint32)jmin((double)std::numeric_limits<uint32>::max(), value));
+}
+
+Histogram::Snapshot Histogram::snapshot() const
+{
+    Snapshot s;
+    s.unit = unit;
+    s.count = count.load(std::memory_order_relaxed);
+    s.sum = sum.load(std::memory_order_relaxed);
+    s.max = max.load(std::memory_order_relaxed);
+    s.min = s.count > 0 ? min.load(std::memory_order_relaxed) : 0;
+    s.negative = negative.load(std::memory_order_relaxed);
+
+    for (int i = 0; i < numBuckets; i++) {
+        s.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+    }
+
+    return s;
+}
+
+void Histogram::reset()
+{
+    count.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    min.store(std::numeric_limits<uint32>::max(), std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+    negative.store(0, std::memory_order_relaxed);
+
+    for (auto& b : buckets) {
+        b.store(0, std::memory_order_relaxed);
+    }
+}
+
+double Histogram::Snapshot::percentile(double p) const
+{
+    uint64 total = 0;
+    for (auto b : buckets) {
+        total += b;
+    }
+
+    if (total == 0) {
+        return 0.0;
+    }
+
+    auto target = (uint64)std::ceil(jlimit(0.0, 1.0, p) * (double)total);
+    uint64 seen = 0;
+
+    for (int i = 0; i < numBuckets; i++) {
+        seen += buckets[i];
+
+        if (seen >= target && buckets[i] > 0) {
+            // Never report more than the actual maximum
+            return jmin((double)max, i == 0 ? 0.0 : std::ldexp(1.0, i));
+        }
+    }
+
+    return (double)max;
+}
+
+}
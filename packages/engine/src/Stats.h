@@ -0,0 +1,120 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+using namespace juce;
+
+namespace medley {
+
+/**
+ * Lock-free histogram with power-of-two buckets, safe to record into from the audio thread
+ */
+class Histogram {
+public:
+    enum class Unit : uint8_t {
+        Microseconds,
+        Milliseconds
+    };
+
+    static constexpr int numBuckets = 32;
+
+    struct Snapshot {
+        Unit unit = Unit::Microseconds;
+        uint64 count = 0;
+        uint64 sum = 0;
+        uint32 min = 0;
+        uint32 max = 0;
+        uint32 buckets[numBuckets]{};
+
+        /**
+         * Number of values below zero, they are not part of the other fields
+         */
+        uint64 negative = 0;
+
+        double mean() const { return count > 0 ? (double)sum / (double)count : 0.0; }
+
+        /**
+         * Upper bound of the bucket containing the p-th percentile (0.0 - 1.0)
+         */
+        double percentile(double p) const;
+
+        /**
+         * Convert a value in this snapshot's unit into milliseconds
+         */
+        double toMilliseconds(double value) const { return unit == Unit::Microseconds ? value / 1000.0 : value; }
+    };
+
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(Histogram& histogram)
+            : histogram(histogram),
+            start(Time::getHighResolutionTicks())
+        {
+
+        }
+
+        ~ScopedTimer() {
+            histogram.recordTicks(Time::getHighResolutionTicks() - start);
+        }
+
+    private:
+        Histogram& histogram;
+        int64 start;
+    };
+
+    explicit Histogram(Unit unit = Unit::Microseconds);
+
+    void record(uint32 value);
+
+    void recordTicks(int64 ticks);
+
+    /**
+     * Negative values are only counted, the buckets start at zero
+     */
+    void recordSeconds(double seconds);
+
+    Snapshot snapshot() const;
+
+    void reset();
+
+private:
+    static int bucketOf(uint32 value);
+
+    Unit unit;
+
+    std::atomic<uint64> count{ 0 };
+    std::atomic<uint64> sum{ 0 };
+    std::atomic<uint32> min{ std::numeric_limits<uint32>::max() };
+    std::atomic<uint32> max{ 0 };
+    std::atomic<uint32> buckets[numBuckets]{};
+    std::atomic<uint64> negative{ 0 };
+};
+
+/**
+ * Lock-free last/maximum value holder
+ */
+class Gauge {
+public:
+    void set(uint32 value) {
+        current.store(value, std::memory_order_relaxed);
+
+        auto m = max.load(std::memory_order_relaxed);
+        while (value > m && !max.compare_exchange_weak(m, value, std::memory_order_relaxed)) {}
+    }
+
+    uint32 get() const { return current.load(std::memory_order_relaxed); }
+
+    uint32 getMax() const { return max.load(std::memory_order_relaxed); }
+
+    void reset() {
+        current.store(0, std::memory_order_relaxed);
+        max.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint32> current{ 0 };
+    std::atomic<uint32> max{ 0 };
+};
+
+}
@@ -0,0 +1,298 @@
+#include "TagWriter.h"
+#include "Metadata.h"
+#include "Trace.h"
+#include <taglib/id3v2header.h>
+#include <taglib/tfilestream.h>
+#include <taglib/textidentificationframe.h>
+#include <taglib/xiphcomment.h>
+
+namespace {
+
+using namespace medley;
+
+struct Entry {
+    const char* key;
+    const char* alias;
+    juce::String value;
+};
+
+std::vector<Entry> toEntries(const TagWriter::Values& values, bool withGain) {
+    std::vector<Entry> entries;
+
+    if (values.cueIn >= 0.0) {
+        entries.push_back({ "CUE-IN", "CUE_IN", juce::String(values.cueIn, 3) });
+    }
+
+    if (values.cueOut >= 0.0) {
+        entries.push_back({ "CUE-OUT", "CUE_OUT", juce::String(values.cueOut, 3) });
+    }
+
+    if (values.lastAudible >= 0.0) {
+        entries.push_back({ "LAST_AUDIBLE", nullptr, juce::String(values.lastAudible, 3) });
+    }
+
+    if (withGain && values.trackGain > 0.0f) {
+        entries.push_back({ "REPLAYGAIN_TRACK_GAIN", nullptr, juce::String::formatted("%.2f dB", Decibels::gainToDecibels(values.trackGain)) });
+    }
+
+    return entries;
+}
+
+bool matches(const TagLib::String& name, const Entry& entry) {
+    juce::String s(name.toCWString());
+    return s.equalsIgnoreCase(entry.key) || (entry.alias && s.equalsIgnoreCase(entry.alias));
+}
+
+bool hasEntry(const TagLib::ID3v2::Tag& tag, const Entry& entry) {
+    for (auto& frame : tag.frameListMap()["TXXX"]) {
+        if (auto pFrame = dynamic_cast<TagLib::ID3v2::UserTextIdentificationFrame*>(frame)) {
+            if (matches(pFrame->description(), entry) && (pFrame->fieldList().size() > 1) && !pFrame->fieldList()[1].isEmpty()) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void setEntry(TagLib::ID3v2::Tag& tag, const Entry& entry) {
+    // Copied, frames are removed from the map while iterating
+    auto frames = tag.frameListMap()["TXXX"];
+
+    for (auto& frame : frames) {
+        if (auto pFrame = dynamic_cast<TagLib::ID3v2::UserTextIdentificationFrame*>(frame)) {
+            if (matches(pFrame->description(), entry)) {
+                tag.removeFrame(pFrame);
+            }
+        }
+    }
+
+    tag.addFrame(new TagLib::ID3v2::UserTextIdentificationFrame(entry.key, TagLib::StringList(TagLib::String(entry.value.toRawUTF8(), TagLib::String::UTF8)), TagLib::String::UTF8));
+}
+
+bool hasEntry(const TagLib::Ogg::XiphComment& tag, const Entry& entry) {
+    for (auto const& field : tag.fieldListMap()) {
+        if (matches(field.first, entry)) {
+            for (const auto& value : field.second) {
+                if (!value.isEmpty()) {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+void setEntry(TagLib::Ogg::XiphComment& tag, const Entry& entry) {
+    if (entry.alias) {
+        tag.removeAllFields(entry.alias);
+    }
+
+    tag.addField(entry.key, TagLib::String(entry.value.toRawUTF8(), TagLib::String::UTF8), true);
+}
+
+/**
+ * Either an ID3v2 tag or a Xiph comment, of any supported format
+ */
+class TaggedFile {
+public:
+    TaggedFile(FileType type, TagLib::IOStream* stream)
+        : type(type)
+    {
+        switch (type) {
+        case FileType::MP3: {
+            auto f = new TagLib::MPEG::File(stream, false);
+            id3 = f->ID3v2Tag(true);
+            file.reset(f);
+            keepVersion();
+            break;
+        }
+
+        case FileType::FLAC: {
+            auto f = new TagLib::FLAC::File(stream, false);
+            xiph = f->xiphComment(true);
+            file.reset(f);
+            break;
+        }
+
+        case FileType::OPUS: {
+            auto f = new TagLib::Ogg::Opus::File(stream, false);
+            xiph = f->tag();
+            file.reset(f);
+            break;
+        }
+
+        case FileType::OGG: {
+            auto f = new TagLib::Ogg::Vorbis::File(stream, false);
+            xiph = f->tag();
+            file.reset(f);
+            break;
+        }
+
+        case FileType::WAV: {
+            auto f = new TagLib::RIFF::WAV::File(stream, false);
+            id3 = f->ID3v2Tag();
+            file.reset(f);
+            keepVersion();
+            break;
+        }
+
+        case FileType::AIFF: {
+            auto f = new TagLib::RIFF::AIFF::File(stream, false);
+            id3 = f->tag();
+            file.reset(f);
+            keepVersion();
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
+
+    bool isValid() const {
+        return file && file->isValid() && (id3 || xiph);
+    }
+
+    bool has(const Entry& entry) const {
+        return id3 ? hasEntry(*id3, entry) : hasEntry(*xiph, entry);
+    }
+
+    void set(const Entry& entry) {
+        if (id3) {
+            setEntry(*id3, entry);
+        }
+        else {
+            setEntry(*xiph, entry);
+        }
+    }
+
+    bool save() {
+        switch (type) {
+        case FileType::MP3:
+            // Leave ID3v1 and APE tags alone
+            return static_cast<TagLib::MPEG::File*>(file.get())->save(TagLib::MPEG::File::ID3v2, TagLib::File::StripNone, id3Version, TagLib::File::DoNotDuplicate);
+
+        case FileType::WAV:
+            return static_cast<TagLib::RIFF::WAV::File*>(file.get())->save(TagLib::RIFF::WAV::File::AllTags, TagLib::File::StripNone, id3Version);
+
+        case FileType::AIFF:
+            return static_cast<TagLib::RIFF::AIFF::File*>(file.get())->save(id3Version);
+
+        default:
+            return file->save();
+        }
+    }
+
+private:
+    /**
+     * Players not supporting ID3v2.4 keep reading the tag, ID3v2.2 cannot be written and is upgraded
+     */
+    void keepVersion() {
+        if (id3 && id3->header()->majorVersion() == 3) {
+            id3Version = TagLib::ID3v2::v3;
+        }
+    }
+
+    FileType type;
+    std::unique_ptr<TagLib::File> file;
+    TagLib::ID3v2::Tag* id3 = nullptr;
+    TagLib::ID3v2::Version id3Version = TagLib::ID3v2::v4;
+    TagLib::Ogg::XiphComment* xiph = nullptr;
+};
+
+}
+
+namespace medley {
+
+bool TagWriter::write(const File& file, const Values& values, bool overwrite)
+{
+    medley::Trace::ScopedSpan span("writeTags", "io");
+
+    auto type = utils::getFileTypeFromFileName(file);
+
+    auto entries = toEntries(values, type != FileType::OPUS);
+    if (entries.empty()) {
+        return false;
+    }
+
+    auto modified = file.getLastModificationTime();
+    auto size = file.getSize();
+
+    // Find out what is missing from the original first, most of the time nothing is and no copy is made
+    {
+        auto path = file.getFullPathName();
+#ifdef _WIN32
+        TagLib::FileStream stream((const wchar_t*)path.toWideCharPointer(), true);
+#else
+        TagLib::FileStream stream(path.toRawUTF8(), true);
+#endif
+
+        if (!stream.isOpen()) {
+            throw std::runtime_error("Could not open file");
+        }
+
+        TaggedFile tagged(type, &stream);
+
+        if (!tagged.isValid()) {
+            throw std::runtime_error("Unsupported file");
+        }
+
+        if (!overwrite) {
+            entries.erase(std::remove_if(entries.begin(), entries.end(), [&](const Entry& entry) {
+                return tagged.has(entry);
+            }), entries.end());
+        }
+    }
+
+    if (entries.empty()) {
+        return false;
+    }
+
+    TemporaryFile temp(file);
+
+    if (!file.copyFileTo(temp.getFile())) {
+        throw std::runtime_error("Could not make a copy");
+    }
+
+    {
+        auto path = temp.getFile().getFullPathName();
+#ifdef _WIN32
+        TagLib::FileStream stream((const wchar_t*)path.toWideCharPointer());
+#else
+        TagLib::FileStream stream(path.toRawUTF8());
+#endif
+
+        if (!stream.isOpen()) {
+            throw std::runtime_error("Could not open the copy");
+        }
+
+        TaggedFile tagged(type, &stream);
+
+        if (!tagged.isValid()) {
+            throw std::runtime_error("Could not read the copy");
+        }
+
+        for (const auto& entry : entries) {
+            tagged.set(entry);
+        }
+
+        if (!tagged.save()) {
+            throw std::runtime_error("Could not save tags");
+        }
+    }
+
+    if (file.getLastModificationTime() != modified || file.getSize() != size) {
+        throw std::runtime_error("File was modified while being tagged");
+    }
+
+    // May fail while the file is opened elsewhere on platforms locking opened files
+    if (!temp.overwriteTargetFileWithTemporary()) {
+        throw std::runtime_error("Could not replace the file");
+    }
+
+    return true;
+}
+
+}
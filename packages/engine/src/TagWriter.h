@@ -0,0 +1,43 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace medley {
+
+using namespace juce;
+
+/**
+ * Stores analysis results back into the tags Metadata reads them from
+ *
+ * CUE-IN, CUE-OUT, LAST_AUDIBLE and REPLAYGAIN_TRACK_GAIN are written as ID3v2 TXXX frames for MP3, WAV and AIFF, as Xiph comments for FLAC, Ogg Vorbis and Opus.
+ * ReplayGain is never written to Opus files, their gain is carried by the header.
+ * The ID3v2 version of an existing tag is kept, ID3v2.2 tags are upgraded to ID3v2.4.
+ */
+class TagWriter {
+public:
+    /**
+     * Values less than zero, or a gain of zero, are not written
+     */
+    struct Values {
+        double cueIn = -1.0;
+        double cueOut = -1.0;
+        double lastAudible = -1.0;
+        /**
+         * As a ratio, like Metadata::getTrackGain()
+         */
+        float trackGain = 0.0f;
+    };
+
+    /**
+     * Tags already present are kept unless overwrite is true.
+     *
+     * The file is tagged as a copy next to it, the copy then replaces the original.
+     * Nothing is replaced if the original was modified in the meantime.
+     *
+     * @return true if the file was rewritten, false if there was nothing to write
+     * @throws std::runtime_error
+     */
+    static bool write(const File& file, const Values& values, bool overwrite = false);
+};
+
+}
@@ -0,0 +1,383 @@
+#include "Trace.h"
+
+namespace medley {
+
+namespace {
+    constexpr int kEventsPerThread = 1 << 13;
+
+    struct Slot {
+        // Odd while the event is being written
+        std::atomic<uint64> sequence{ 0 };
+        Trace::Event event;
+    };
+
+    /**
+     * Never freed, a buffer is taken over by another thread once its thread has exited
+     */
+    struct ThreadBuffer {
+        // Odd while being handed over to a thread, 0 if it never was
+        std::atomic<uint32> generation{ 0 };
+        std::atomic<bool> claimed{ false };
+
+        // Set aside for an audio thread, which is then bound by its id instead of thread_local storage
+        bool forAudio = false;
+        std::atomic<Thread::ThreadID> audioThread{ nullptr };
+
+        int id = 0;
+        char name[64] = {};
+
+        // Events before it were recorded by the thread which had the buffer before
+        uint64 firstIndex = 0;
+
+        std::atomic<uint64> written{ 0 };
+        Slot slots[kEventsPerThread];
+
+        ThreadBuffer* next = nullptr;
+    };
+
+    /**
+     * Lock-free, buffers are only ever prepended to the list
+     */
+    struct Registry {
+        std::atomic<ThreadBuffer*> head{ nullptr };
+        std::atomic<int> numBuffers{ 0 };
+        std::atomic<int> numAudioBuffers{ 0 };
+        std::atomic<int64> origin{ 0 };
+        std::atomic<int64> clearedAt{ 0 };
+    };
+
+    Registry& getRegistry() {
+        static Registry registry;
+        return registry;
+    }
+
+    ThreadBuffer* addBuffer(bool claimed, bool forAudio = false) {
+        auto& registry = getRegistry();
+
+        auto buffer = new ThreadBuffer();
+        buffer->id = ++registry.numBuffers;
+        buffer->claimed.store(claimed, std::memory_order_relaxed);
+        buffer->forAudio = forAudio;
+
+        if (forAudio) {
+            registry.numAudioBuffers++;
+            ("Audio " + String(buffer->id)).copyToUTF8(buffer->name, sizeof(buffer->name));
+        }
+
+        buffer->next = registry.head.load(std::memory_order_relaxed);
+
+        while (!registry.head.compare_exchange_weak(buffer->next, buffer, std::memory_order_release, std::memory_order_relaxed));
+
+        return buffer;
+    }
+
+    ThreadBuffer* claimBuffer() {
+        for (auto buffer = getRegistry().head.load(std::memory_order_acquire); buffer != nullptr; buffer = buffer->next) {
+            auto expected = false;
+
+            if (!buffer->claimed.load(std::memory_order_relaxed) && buffer->claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return buffer;
+            }
+        }
+
+        return addBuffer(true);
+    }
+
+    /**
+     * Gives the buffer back when the thread exits
+     */
+    struct BufferOwner {
+        ThreadBuffer* buffer = nullptr;
+
+        ~BufferOwner() {
+            if (buffer != nullptr) {
+                buffer->claimed.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    ThreadBuffer* getThreadBuffer() {
+        thread_local BufferOwner owner;
+
+        if (owner.buffer == nullptr) {
+            auto buffer = claimBuffer();
+
+            buffer->generation.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            // Unnamed threads are named after their buffer when exporting
+            buffer->name[0] = 0;
+
+            if (auto thread = Thread::getCurrentThread()) {
+                thread->getThreadName().copyToUTF8(buffer->name, sizeof(buffer->name));
+            }
+
+            buffer->firstIndex = buffer->written.load(std::memory_order_relaxed);
+
+            buffer->generation.fetch_add(1, std::memory_order_release);
+
+            owner.buffer = buffer;
+        }
+
+        return owner.buffer;
+    }
+
+    /**
+     * The buffer bound to the calling thread if it is an audio thread, looked up by thread id, never allocates
+     */
+    ThreadBuffer* findAudioThreadBuffer(Thread::ThreadID threadId) {
+        auto& registry = getRegistry();
+
+        if (registry.numAudioBuffers.load(std::memory_order_relaxed) == 0) {
+            return nullptr;
+        }
+
+        for (auto buffer = registry.head.load(std::memory_order_acquire); buffer != nullptr; buffer = buffer->next) {
+            if (buffer->forAudio && buffer->audioThread.load(std::memory_order_acquire) == threadId) {
+                return buffer;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void setAsideAudioBuffer() {
+        for (auto buffer = getRegistry().head.load(std::memory_order_acquire); buffer != nullptr; buffer = buffer->next) {
+            if (buffer->forAudio && buffer->audioThread.load(std::memory_order_acquire) == nullptr) {
+                return;
+            }
+        }
+
+        // Never claimed by an ordinary thread
+        addBuffer(true, true);
+    }
+}
+
+std::atomic<bool> Trace::enabled{ false };
+
+void Trace::setEnabled(bool shouldBeEnabled)
+{
+    auto& registry = getRegistry();
+
+    if (shouldBeEnabled) {
+        int64 expected = 0;
+        registry.origin.compare_exchange_strong(expected, Time::getHighResolutionTicks());
+
+        reserve();
+
+        // Set aside before enabling, an audio thread which is already running binds to it on its next callback
+        setAsideAudioBuffer();
+    }
+
+    enabled.store(shouldBeEnabled, std::memory_order_relaxed);
+}
+
+void Trace::reserve()
+{
+    for (auto buffer = getRegistry().head.load(std::memory_order_acquire); buffer != nullptr; buffer = buffer->next) {
+        if (!buffer->claimed.load(std::memory_order_relaxed)) {
+            return;
+        }
+    }
+
+    addBuffer(false);
+}
+
+void Trace::reserveAudioThread()
+{
+    if (isEnabled()) {
+        setAsideAudioBuffer();
+    }
+}
+
+void Trace::bindAudioThread()
+{
+    if (!isEnabled()) {
+        return;
+    }
+
+    auto threadId = Thread::getCurrentThreadId();
+
+    if (findAudioThreadBuffer(threadId) != nullptr) {
+        return;
+    }
+
+    for (auto buffer = getRegistry().head.load(std::memory_order_acquire); buffer != nullptr; buffer = buffer->next) {
+        Thread::ThreadID expected = nullptr;
+
+        if (buffer->forAudio && buffer->audioThread.compare_exchange_strong(expected, threadId, std::memory_order_acq_rel)) {
+            buffer->generation.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            buffer->firstIndex = buffer->written.load(std::memory_order_relaxed);
+
+            buffer->generation.fetch_add(1, std::memory_order_release);
+            return;
+        }
+    }
+}
+
+void Trace::complete(const char* name, const char* category, int64 startTicks, const char* argName, int64 argValue)
+{
+    if (!isEnabled()) {
+        return;
+    }
+
+    Event e;
+    e.name = name;
+    e.category = category;
+    e.phase = 'X';
+    e.start = startTicks;
+    e.duration = Time::getHighResolutionTicks() - startTicks;
+    e.argName = argName;
+    e.argValue = argValue;
+
+    record(e);
+}
+
+void Trace::instant(const char* name, const char* category, const char* argName, int64 argValue)
+{
+    if (!isEnabled()) {
+        return;
+    }
+
+    Event e;
+    e.name = name;
+    e.category = category;
+    e.phase = 'i';
+    e.start = Time::getHighResolutionTicks();
+    e.argName = argName;
+    e.argValue = argValue;
+
+    record(e);
+}
+
+void Trace::record(const Event& event)
+{
+    auto buffer = findAudioThreadBuffer(Thread::getCurrentThreadId());
+
+    if (buffer == nullptr) {
+        buffer = getThreadBuffer();
+    }
+
+    // Only this thread writes into its own buffer
+    auto index = buffer->written.load(std::memory_order_relaxed);
+    auto& slot = buffer->slots[index & (kEventsPerThread - 1)];
+
+    slot.sequence.store(index * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.event = event;
+
+    slot.sequence.store(index * 2 + 2, std::memory_order_release);
+    buffer->written.store(index + 1, std::memory_order_release);
+}
+
+void Trace::clear()
+{
+    getRegistry().clearedAt.store(Time::getHighResolutionTicks(), std::memory_order_relaxed);
+}
+
+String Trace::toJSON()
+{
+    auto& registry = getRegistry();
+    auto origin = registry.origin.load(std::memory_order_relaxed);
+    auto clearedAt = registry.clearedAt.load(std::memory_order_relaxed);
+
+    auto toMicroseconds = [](int64 ticks) {
+        return Time::highResolutionTicksToSeconds(ticks) * 1.0e6;
+    };
+
+    Array<var> events;
+
+    for (auto buffer = registry.head.load(std::memory_order_acquire); buffer != nullptr; buffer = buffer->next) {
+        auto generation = buffer->generation.load(std::memory_order_acquire);
+
+        // Never used, or being handed over right now
+        if (generation == 0 || (generation & 1) != 0) {
+            continue;
+        }
+
+        auto name = String::fromUTF8(buffer->name);
+        auto firstIndex = buffer->firstIndex;
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (buffer->generation.load(std::memory_order_relaxed) != generation) {
+            continue;
+        }
+
+        Array<var> threadEvents;
+
+        auto meta = new DynamicObject();
+        auto metaArgs = new DynamicObject();
+        metaArgs->setProperty("name", name.isNotEmpty() ? name : "Thread " + String(buffer->id));
+
+        meta->setProperty("name", "thread_name");
+        meta->setProperty("ph", "M");
+        meta->setProperty("pid", 1);
+        meta->setProperty("tid", buffer->id);
+        meta->setProperty("args", var(metaArgs));
+        threadEvents.add(var(meta));
+
+        auto end = buffer->written.load(std::memory_order_acquire);
+        auto begin = jmax(firstIndex, end > (uint64)kEventsPerThread ? end - kEventsPerThread : 0);
+
+        for (auto index = begin; index < end; index++) {
+            auto& slot = buffer->slots[index & (kEventsPerThread - 1)];
+
+            if (slot.sequence.load(std::memory_order_acquire) != index * 2 + 2) {
+                continue;
+            }
+
+            auto e = slot.event;
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            // Overwritten while being copied
+            if (slot.sequence.load(std::memory_order_relaxed) != index * 2 + 2) {
+                continue;
+            }
+
+            if (e.start < clearedAt || e.start < origin) {
+                continue;
+            }
+
+            auto obj = new DynamicObject();
+            obj->setProperty("name", e.name);
+            obj->setProperty("cat", e.category);
+            obj->setProperty("ph", String::charToString(e.phase));
+            obj->setProperty("ts", toMicroseconds(e.start - origin));
+            obj->setProperty("pid", 1);
+            obj->setProperty("tid", buffer->id);
+
+            if (e.phase == 'X') {
+                obj->setProperty("dur", toMicroseconds(e.duration));
+            }
+            else if (e.phase == 'i') {
+                obj->setProperty("s", "t");
+            }
+
+            if (e.argName != nullptr) {
+                auto args = new DynamicObject();
+                args->setProperty(e.argName, e.argValue);
+                obj->setProperty("args", var(args));
+            }
+
+            threadEvents.add(var(obj));
+        }
+
+        // Taken over by another thread while being serialized, the events may belong to either
+        if (buffer->generation.load(std::memory_order_acquire) == generation) {
+            events.addArray(threadEvents);
+        }
+    }
+
+    auto result = new DynamicObject();
+    result->setProperty("traceEvents", events);
+    result->setProperty("displayTimeUnit", "ms");
+
+    return JSON::toString(var(result), true);
+}
+
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+using namespace juce;
+
+namespace medley {
+
+/**
+ * Process-wide recorder for Chrome trace events (chrome://tracing, https://ui.perfetto.dev)
+ *
+ * Every thread writes into its own fixed size ring buffer without locking, old events are overwritten when the buffer is full.
+ * Buffers are never freed, the buffer of a thread which has exited is reused by the next thread starting to record.
+ * When disabled, recording costs a single relaxed atomic load.
+ *
+ * An audio thread binds itself to a buffer set aside by reserveAudioThread() before it started,
+ * from then on its events are looked up by thread id and recording from the realtime callback never allocates.
+ *
+ * Names, categories and argument names must be string literals, only the pointers are stored.
+ */
+class Trace {
+public:
+    struct Event {
+        const char* name = nullptr;
+        const char* category = nullptr;
+        char phase = 'X';
+        int64 start = 0;
+        int64 duration = 0;
+        const char* argName = nullptr;
+        int64 argValue = 0;
+    };
+
+    class ScopedSpan {
+    public:
+        ScopedSpan(const char* name, const char* category)
+            : name(name),
+            category(category),
+            start(Trace::isEnabled() ? Time::getHighResolutionTicks() : 0)
+        {
+
+        }
+
+        ~ScopedSpan() {
+            if (start != 0) {
+                Trace::complete(name, category, start);
+            }
+        }
+
+    private:
+        const char* name;
+        const char* category;
+        int64 start;
+    };
+
+    static void setEnabled(bool shouldBeEnabled);
+
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * Make sure a buffer is free for the next thread to record
+     */
+    static void reserve();
+
+    /**
+     * Set aside a buffer for the next audio thread to start, must be called from outside the audio thread, does nothing while disabled
+     */
+    static void reserveAudioThread();
+
+    /**
+     * Bind the calling audio thread to a buffer set aside by reserveAudioThread(), if it is not bound already.
+     * Never allocates, meant to be called at the start of every audio callback
+     */
+    static void bindAudioThread();
+
+    /**
+     * Record a span which started at startTicks and ends now
+     */
+    static void complete(const char* name, const char* category, int64 startTicks, const char* argName = nullptr, int64 argValue = 0);
+
+    static void instant(const char* name, const char* category, const char* argName = nullptr, int64 argValue = 0);
+
+    /**
+     * Discard all events recorded so far
+     */
+    static void clear();
+
+    /**
+     * Serialize the recorded events as Chrome trace-event JSON
+     */
+    static String toJSON();
+
+private:
+    static void record(const Event& event);
+
+    static std::atomic<bool> enabled;
+};
+
+}
@@ -0,0 +1,91 @@
+#include "TrackInfoCache.h"
+
+namespace medley {
+
+FileCache<std::shared_ptr<const TrackProbe>>& TrackInfoCache::getCache()
+{
+    static FileCache<std::shared_ptr<const TrackProbe>> cache(capacity);
+    return cache;
+}
+
+uint32_t TrackInfoCache::expand(uint32_t fields)
+{
+    if (fields & (TrackProbe::Tags | TrackProbe::Gain)) {
+        fields |= TrackProbe::Tags | TrackProbe::Gain;
+    }
+
+    return fields;
+}
+
+uint32_t TrackInfoCache::getAvailableFields(const TrackProbe& cached, TagLib::AudioProperties::ReadStyle readStyle)
+{
+    auto available = cached.getFields() & cacheableFields;
+
+    // Properties read with a less accurate style do not satisfy a more accurate request
+    if ((available & TrackProbe::Properties) && cached.getReadStyle() < readStyle) {
+        available &= ~(uint32_t)TrackProbe::Properties;
+    }
+
+    return available;
+}
+
+std::unique_ptr<TrackProbe> TrackInfoCache::probe(AudioFormatManager& formatMgr, const File& file, uint32_t fields, TagLib::AudioProperties::ReadStyle readStyle)
+{
+    auto& cache = getCache();
+
+    if (fields & TrackProbe::DeepLoadable) {
+        fields |= TrackProbe::Loadable;
+    }
+
+    std::shared_ptr<const TrackProbe> cached;
+    cache.find(file, cached);
+
+    const auto available = cached ? getAvailableFields(*cached, readStyle) : 0u;
+    auto missing = expand(fields & cacheableFields) & ~available;
+
+    // Read together so the sniffed result cannot be copied over the one from the decoder
+    if (missing & TrackProbe::DeepLoadable) {
+        missing |= TrackProbe::Loadable;
+    }
+
+    const auto uncacheable = fields & ~cacheableFields;
+
+    if (missing == 0 && uncacheable == 0) {
+        auto result = std::unique_ptr<TrackProbe>(new TrackProbe(readStyle));
+        result->copyFrom(*cached, fields);
+        return result;
+    }
+
+    auto result = std::make_unique<TrackProbe>(formatMgr, file, missing | uncacheable, readStyle);
+
+    if (result->getError().isEmpty()) {
+        auto entry = std::shared_ptr<TrackProbe>(new TrackProbe(readStyle));
+
+        if (cached) {
+            entry->copyFrom(*cached, available & ~missing);
+        }
+
+        entry->copyFrom(*result, missing);
+        cache.set(file, entry);
+    }
+
+    if (cached) {
+        result->copyFrom(*cached, fields & available & ~missing);
+    }
+
+    // Only what was asked for, tags and gain may have been read together
+    result->fields &= fields;
+    return result;
+}
+
+void TrackInfoCache::clear()
+{
+    getCache().clear();
+}
+
+size_t TrackInfoCache::size()
+{
+    return getCache().size();
+}
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "TrackProbe.h"
+#include "FileCache.h"
+
+namespace medley {
+
+/**
+ * What TrackProbe reads about tracks, shared by every deck, every Medley instance and the static APIs of the process
+ *
+ * Tags, gain, audio properties and loadability are cached, a track costs one parse per change of the file rather than several per play.
+ * Unloadable tracks are cached as well, a broken file is not sniffed again on every queue decision.
+ * Loadability told by a decoder supersedes the sniffed one.
+ * Cover, lyrics and the reader are never cached, they still open the file but the cached fields are not parsed again.
+ */
+class TrackInfoCache {
+public:
+    static constexpr uint32_t cacheableFields = TrackProbe::Tags | TrackProbe::Gain | TrackProbe::Properties | TrackProbe::Loadable | TrackProbe::DeepLoadable;
+
+    static constexpr size_t capacity = 4096;
+
+    /**
+     * Same as constructing a TrackProbe, the file is only opened for the fields the cache cannot serve.
+     * Failed reads are not cached.
+     */
+    static std::unique_ptr<TrackProbe> probe(AudioFormatManager& formatMgr, const File& file, uint32_t fields, TagLib::AudioProperties::ReadStyle readStyle = TagLib::AudioProperties::Fast);
+
+    static void clear();
+
+    static size_t size();
+
+private:
+    /**
+     * Tags and gain come from the same parse, one is never read without the other
+     */
+    static uint32_t expand(uint32_t fields);
+
+    static uint32_t getAvailableFields(const TrackProbe& cached, TagLib::AudioProperties::ReadStyle readStyle);
+
+    static FileCache<std::shared_ptr<const TrackProbe>>& getCache();
+};
+
+}
@@ -0,0 +1,451 @@
+#include "TrackProbe.h"
+#include "Trace.h"
+#include "MiniMP3AudioFormat.h"
+#include "OpusAudioFormat.h"
+#include "BlockInputStream.h"
+#include <taglib/tiostream.h>
+
+namespace {
+
+/**
+ * Lets TagLib parse through a JUCE stream, read only
+ */
+class InputStreamIO : public TagLib::IOStream
+{
+public:
+    InputStreamIO(juce::InputStream& stream, const juce::File& file)
+        :
+        stream(stream),
+        path(file.getFullPathName())
+    {
+
+    }
+
+    TagLib::FileName name() const override
+    {
+#ifdef _WIN32
+        return (const wchar_t*)path.toWideCharPointer();
+#else
+        return path.toRawUTF8();
+#endif
+    }
+
+    TagLib::ByteVector readBlock(size_t length) override
+    {
+        TagLib::ByteVector data((unsigned int)length, 0);
+
+        auto numRead = stream.read(data.data(), (int)length);
+        data.resize((unsigned int)juce::jmax(0, numRead));
+
+        return data;
+    }
+
+    void writeBlock(const TagLib::ByteVector&) override {}
+
+    void insert(const TagLib::ByteVector&, TagLib::offset_t, size_t) override {}
+
+    void removeBlock(TagLib::offset_t, size_t) override {}
+
+    bool readOnly() const override { return true; }
+
+    bool isOpen() const override { return true; }
+
+    void seek(TagLib::offset_t offset, Position p) override
+    {
+        switch (p) {
+        case Beginning:
+            stream.setPosition(offset);
+            break;
+
+        case Current:
+            stream.setPosition(stream.getPosition() + offset);
+            break;
+
+        case End:
+            stream.setPosition(stream.getTotalLength() + offset);
+            break;
+        }
+    }
+
+    TagLib::offset_t tell() const override { return stream.getPosition(); }
+
+    TagLib::offset_t length() override { return stream.getTotalLength(); }
+
+    void truncate(TagLib::offset_t) override {}
+
+private:
+    juce::InputStream& stream;
+    juce::String path;
+};
+
+uint32_t readBE32(const uint8_t* p) { return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3]; }
+
+uint32_t readLE32(const uint8_t* p) { return ((uint32_t)p[3] << 24) | ((uint32_t)p[2] << 16) | ((uint32_t)p[1] << 8) | p[0]; }
+
+uint16_t readBE16(const uint8_t* p) { return (uint16_t)((p[0] << 8) | p[1]); }
+
+uint16_t readLE16(const uint8_t* p) { return (uint16_t)((p[1] << 8) | p[0]); }
+
+/**
+ * Size of the ID3v2 tag at the start of a file, including its header and footer, 0 if there is none
+ */
+juce::int64 getID3v2Size(const uint8_t* header)
+{
+    if (memcmp(header, "ID3", 3) != 0 || ((header[6] | header[7] | header[8] | header[9]) & 0x80)) {
+        return 0;
+    }
+
+    juce::int64 size = 10 + (((juce::int64)header[6] << 21) | (header[7] << 14) | (header[8] << 7) | header[9]);
+
+    // Footer present
+    if (header[5] & 0x10) {
+        size += 10;
+    }
+
+    return size;
+}
+
+bool hasFlacStreamInfo(const uint8_t* data, size_t size)
+{
+    // The first metadata block must be a 34 bytes STREAMINFO
+    if (size < 8 + 34 || (data[4] & 0x7F) != 0 || (readBE32(data + 4) & 0xFFFFFF) != 34) {
+        return false;
+    }
+
+    auto sampleRate = (readBE32(data + 8 + 10) >> 12);
+    return sampleRate > 0;
+}
+
+bool hasVorbisHeader(const uint8_t* data, size_t size)
+{
+    if (size < 27) {
+        return false;
+    }
+
+    // Identification header: packet type 1, "vorbis", version, channels and sample rate
+    auto packetStart = 27 + (size_t)data[26];
+
+    return packetStart + 16 <= size
+        && memcmp(data + packetStart, "\x01vorbis", 7) == 0
+        && data[packetStart + 11] > 0
+        && readLE32(data + packetStart + 12) > 0;
+}
+
+bool hasWaveFormat(const uint8_t* data, size_t size)
+{
+    // RIFF chunks are little endian and padded to an even size
+    size_t pos = 12;
+
+    while (pos + 8 <= size) {
+        auto chunkSize = (size_t)readLE32(data + pos + 4);
+
+        if (memcmp(data + pos, "fmt ", 4) == 0) {
+            return pos + 8 + 16 <= size
+                && readLE16(data + pos + 8 + 2) > 0
+                && readLE32(data + pos + 8 + 4) > 0;
+        }
+
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    return false;
+}
+
+bool hasAiffCommon(const uint8_t* data, size_t size)
+{
+    // IFF chunks are big endian and padded to an even size
+    size_t pos = 12;
+
+    while (pos + 8 <= size) {
+        auto chunkSize = (size_t)readBE32(data + pos + 4);
+
+        if (memcmp(data + pos, "COMM", 4) == 0) {
+            return pos + 8 + 18 <= size
+                && readBE16(data + pos + 8) > 0;
+        }
+
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    return false;
+}
+
+juce::String getExtensionForFileType(medley::utils::FileType type)
+{
+    switch (type) {
+    case medley::utils::FileType::MP3: return ".mp3";
+    case medley::utils::FileType::MP4: return ".m4a";
+    case medley::utils::FileType::FLAC: return ".flac";
+    case medley::utils::FileType::OGG: return ".ogg";
+    case medley::utils::FileType::WAV: return ".wav";
+    case medley::utils::FileType::AIFF: return ".aiff";
+    case medley::utils::FileType::OPUS: return ".opus";
+    default: return {};
+    }
+}
+
+}
+
+medley::TrackProbe::TrackProbe(AudioFormatManager& formatMgr, const File& file, uint32_t fields, TagLib::AudioProperties::ReadStyle readStyle)
+    :
+    fields((fields & DeepLoadable) ? (fields | Loadable) : fields),
+    readStyle(readStyle)
+{
+    medley::Trace::ScopedSpan span("probeTrack", "io");
+
+    std::unique_ptr<InputStream> stream;
+
+    // A reader kept for playing is served from blocks read ahead in the background
+    if (fields & Reader) {
+        auto blockStream = std::make_unique<BlockInputStream>(file);
+
+        if (!blockStream->failedToOpen()) {
+            stream = std::move(blockStream);
+        }
+    }
+    else {
+        auto fileStream = std::make_unique<FileInputStream>(file);
+
+        if (!fileStream->failedToOpen()) {
+            stream = std::move(fileStream);
+        }
+    }
+
+    if (stream == nullptr) {
+        error = "Could not open " + file.getFullPathName();
+        return;
+    }
+
+    if (fields & (Tags | Gain | Properties | Cover | Lyrics)) {
+        try {
+            parse(*stream, file, readStyle);
+        }
+        catch (std::exception& e) {
+            error = "Could not read " + file.getFullPathName() + " Error was: " + e.what();
+        }
+        catch (...) {
+            error = "Could not read " + file.getFullPathName();
+        }
+    }
+
+    if (fields & (DeepLoadable | Reader)) {
+        try {
+            createReader(formatMgr, std::move(stream), file);
+        }
+        catch (...) {
+            loadable = false;
+            reader = nullptr;
+        }
+    }
+    else if (fields & Loadable) {
+        checkLoadable(formatMgr, *stream, file);
+    }
+}
+
+medley::TrackProbe::TrackProbe(TagLib::AudioProperties::ReadStyle readStyle)
+    :
+    fields(0),
+    readStyle(readStyle)
+{
+
+}
+
+void medley::TrackProbe::copyFrom(const TrackProbe& source, uint32_t fieldsToCopy)
+{
+    fieldsToCopy &= source.fields;
+
+    if (fieldsToCopy & (Tags | Gain)) {
+        metadata = source.metadata;
+    }
+
+    if (fieldsToCopy & Properties) {
+        audioProperties = source.audioProperties;
+        readStyle = source.readStyle;
+    }
+
+    if (fieldsToCopy & (Cover | Lyrics)) {
+        coverAndLyrics = source.coverAndLyrics;
+    }
+
+    if (fieldsToCopy & (Loadable | DeepLoadable)) {
+        loadable = source.loadable;
+    }
+
+    fields |= fieldsToCopy & ~Reader;
+}
+
+void medley::TrackProbe::parse(InputStream& stream, const File& file, TagLib::AudioProperties::ReadStyle readStyle)
+{
+    InputStreamIO io(stream, file);
+
+    // Parsing the properties is skipped entirely unless asked for, like the dedicated readers do
+    const auto readProperties = has(Properties);
+
+    switch (utils::getFileTypeFromFileName(file)) {
+    case utils::FileType::MP3: {
+        TagLib::MPEG::File tagFile(&io, readProperties, readStyle);
+        parse(tagFile);
+        return;
+    }
+
+    case utils::FileType::FLAC: {
+        TagLib::FLAC::File tagFile(&io, readProperties, readStyle);
+        parse(tagFile);
+        return;
+    }
+
+    case utils::FileType::OPUS: {
+        TagLib::Ogg::Opus::File tagFile(&io, readProperties, readStyle);
+        parse(tagFile);
+        return;
+    }
+
+    case utils::FileType::OGG: {
+        TagLib::Ogg::Vorbis::File tagFile(&io, readProperties, readStyle);
+        parse(tagFile);
+        return;
+    }
+
+    case utils::FileType::WAV: {
+        TagLib::RIFF::WAV::File tagFile(&io, readProperties, readStyle);
+        parse(tagFile);
+        return;
+    }
+
+    case utils::FileType::AIFF: {
+        TagLib::RIFF::AIFF::File tagFile(&io, readProperties, readStyle);
+        parse(tagFile);
+        return;
+    }
+
+    default:
+        metadata.title = file.getFileNameWithoutExtension();
+        return;
+    }
+}
+
+template <typename TagLibFile>
+void medley::TrackProbe::parse(TagLibFile& tagFile)
+{
+    if (fields & (Tags | Gain)) {
+        metadata.read(tagFile);
+    }
+
+    if (has(Properties) && tagFile.audioProperties()) {
+        audioProperties.readAudioProperties(tagFile.audioProperties());
+    }
+
+    if (fields & (Cover | Lyrics)) {
+        coverAndLyrics.read(tagFile, has(Cover), has(Lyrics));
+    }
+}
+
+void medley::TrackProbe::createReader(AudioFormatManager& formatMgr, std::unique_ptr<InputStream> stream, const File& file)
+{
+    // Like AudioFormatManager::createReaderFor(File), only formats claiming the file extension are tried
+    for (int i = 0; i < formatMgr.getNumKnownFormats(); i++) {
+        auto format = formatMgr.getKnownFormat(i);
+
+        if (!format->canHandleFile(file)) {
+            continue;
+        }
+
+        stream->setPosition(0);
+
+        if (auto newReader = format->createReaderFor(stream.get(), false)) {
+            // The reader owns the stream from now on
+            stream.release();
+            loadable = true;
+
+            if (has(Reader)) {
+                reader.reset(newReader);
+            }
+            else {
+                delete newReader;
+            }
+
+            return;
+        }
+    }
+}
+
+void medley::TrackProbe::checkLoadable(AudioFormatManager& formatMgr, InputStream& stream, const File& file)
+{
+    loadable = false;
+
+    const auto totalLength = stream.getTotalLength();
+
+    uint8_t id3Header[10];
+    juce::int64 start = 0;
+
+    if (stream.setPosition(0) && stream.read(id3Header, sizeof(id3Header)) == (int)sizeof(id3Header)) {
+        start = getID3v2Size(id3Header);
+    }
+
+    // A tag claiming more than the whole file, nothing is left to play
+    if (start >= totalLength) {
+        return;
+    }
+
+    const auto size = (int)jmin<juce::int64>(sniffSize, totalLength - start);
+    HeapBlock<uint8_t> head(size);
+
+    if (!stream.setPosition(start) || stream.read(head, size) != size) {
+        return;
+    }
+
+    const auto type = utils::sniffFileType(head, (size_t)size);
+
+    // The decoder is picked by the extension when loading, it must be the one for the sniffed format
+    auto format = formatMgr.findFormatForFileExtension(getExtensionForFileType(type));
+
+    if (format == nullptr || format != formatMgr.findFormatForFileExtension(file.getFileExtension())) {
+        return;
+    }
+
+    switch (type) {
+    case utils::FileType::MP3:
+        loadable = MiniMP3AudioFormat::containsFrames(head, size);
+        break;
+
+    case utils::FileType::OPUS:
+        loadable = OpusAudioFormat::containsOpusHead(head, size);
+        break;
+
+    case utils::FileType::OGG:
+        loadable = hasVorbisHeader(head, (size_t)size);
+        break;
+
+    case utils::FileType::FLAC:
+        loadable = hasFlacStreamInfo(head, (size_t)size);
+        break;
+
+    case utils::FileType::WAV:
+        loadable = hasWaveFormat(head, (size_t)size);
+        break;
+
+    case utils::FileType::AIFF:
+        loadable = hasAiffCommon(head, (size_t)size);
+        break;
+
+    case utils::FileType::MP4:
+        // Containers are left to the platform decoder
+        loadable = true;
+        break;
+
+    default:
+        break;
+    }
+}
+
+std::vector<std::unique_ptr<medley::TrackProbe>> medley::TrackProbe::probeAll(AudioFormatManager& formatMgr, const Array<File>& files, uint32_t fields, TagLib::AudioProperties::ReadStyle readStyle)
+{
+    std::vector<std::unique_ptr<TrackProbe>> probes;
+    probes.reserve((size_t)files.size());
+
+    for (auto& file : files) {
+        probes.push_back(std::make_unique<TrackProbe>(formatMgr, file, fields, readStyle));
+    }
+
+    return probes;
+}
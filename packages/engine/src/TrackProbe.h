@@ -0,0 +1,111 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "Metadata.h"
+
+namespace medley {
+
+/**
+ * Reads whatever is asked about a track with the file opened only once
+ *
+ * TagLib parses the tags, the audio properties, the cover and the lyrics in a single pass through the same stream
+ * the decoder is then created from.
+ */
+class TrackProbe {
+public:
+    enum Field : uint32_t {
+        // Title, artist, album, ISRC, album artist, original artist, BPM and comments
+        Tags = 1 << 0,
+        // ReplayGain track gain, cue-in, cue-out and last audible position
+        Gain = 1 << 1,
+        Properties = 1 << 2,
+        Cover = 1 << 3,
+        Lyrics = 1 << 4,
+        // Whether the track looks playable, the format is sniffed from its magic bytes, it must be the one of the file extension, and the first frames are parsed
+        Loadable = 1 << 5,
+        // Keep the decoder for takeReader(), implies Loadable
+        Reader = 1 << 6,
+        // Loadable, told by actually creating a decoder. Some decoders scan the whole file to be created
+        DeepLoadable = 1 << 7,
+
+        All = Tags | Gain | Properties | Cover | Lyrics | Loadable
+    };
+
+    TrackProbe(AudioFormatManager& formatMgr, const File& file, uint32_t fields, TagLib::AudioProperties::ReadStyle readStyle = TagLib::AudioProperties::Fast);
+
+    uint32_t getFields() const { return fields; }
+
+    TagLib::AudioProperties::ReadStyle getReadStyle() const { return readStyle; }
+
+    bool has(Field field) const { return (fields & field) != 0; }
+
+    /**
+     * Tags and Gain fields
+     */
+    const Metadata& getMetadata() const { return metadata; }
+
+    const Metadata::AudioProperties& getAudioProperties() const { return audioProperties; }
+
+    /**
+     * Cover and Lyrics fields
+     */
+    const Metadata::CoverAndLyrics& getCoverAndLyrics() const { return coverAndLyrics; }
+
+    bool isLoadable() const { return loadable; }
+
+    /**
+     * Only with the Reader field, the reader is handed over once
+     */
+    std::unique_ptr<AudioFormatReader> takeReader() { return std::move(reader); }
+
+    /**
+     * Why the file could not be parsed, empty on success. Loadability is probed regardless
+     */
+    const juce::String& getError() const { return error; }
+
+    /**
+     * Probe files one after another, the format manager is shared
+     */
+    static std::vector<std::unique_ptr<TrackProbe>> probeAll(AudioFormatManager& formatMgr, const Array<File>& files, uint32_t fields, TagLib::AudioProperties::ReadStyle readStyle = TagLib::AudioProperties::Fast);
+
+private:
+    friend class TrackInfoCache;
+
+    /**
+     * Empty, to be filled with copyFrom()
+     */
+    explicit TrackProbe(TagLib::AudioProperties::ReadStyle readStyle);
+
+    /**
+     * Take what was read for the given fields from another probe, the reader excluded
+     */
+    void copyFrom(const TrackProbe& source, uint32_t fieldsToCopy);
+
+    void parse(InputStream& stream, const File& file, TagLib::AudioProperties::ReadStyle readStyle);
+
+    template <typename TagLibFile>
+    void parse(TagLibFile& tagFile);
+
+    void createReader(AudioFormatManager& formatMgr, std::unique_ptr<InputStream> stream, const File& file);
+
+    /**
+     * Only the first few kilobytes following the ID3v2 tag are read
+     */
+    void checkLoadable(AudioFormatManager& formatMgr, InputStream& stream, const File& file);
+
+    static constexpr int sniffSize = 16 * 1024;
+
+    uint32_t fields;
+    TagLib::AudioProperties::ReadStyle readStyle;
+
+    Metadata metadata;
+    Metadata::AudioProperties audioProperties;
+    Metadata::CoverAndLyrics coverAndLyrics;
+
+    bool loadable = false;
+    std::unique_ptr<AudioFormatReader> reader;
+
+    juce::String error;
+};
+
+}
@@ -0,0 +1,97 @@
+#include "TruePeakDetector.h"
+#include "Simd.h"
+
+using medley::simd::Float4;
+
+namespace {
+    // ITU-R BS.1770-4 Annex 2, 48 taps interpolation filter split into 4 phases
+    constexpr float kFilter[4][12] = {
+        { 0.0017089843750f, 0.0109863281250f, -0.0196533203125f, 0.0332031250000f, -0.0594482421875f, 0.1373291015625f, 0.9721679687500f, -0.1022949218750f, 0.0476074218750f, -0.0266113281250f, 0.0148925781250f, -0.0083007812500f },
+        { -0.0291748046875f, 0.0292968750000f, -0.0517578125000f, 0.0891113281250f, -0.1665039062500f, 0.4650878906250f, 0.7797851562500f, -0.2003173828125f, 0.1015625000000f, -0.0582275390625f, 0.0330810546875f, -0.0189208984375f },
+        { -0.0189208984375f, 0.0330810546875f, -0.0582275390625f, 0.1015625000000f, -0.2003173828125f, 0.7797851562500f, 0.4650878906250f, -0.1665039062500f, 0.0891113281250f, -0.0517578125000f, 0.0292968750000f, -0.0291748046875f },
+        { -0.0083007812500f, 0.0148925781250f, -0.0266113281250f, 0.0476074218750f, -0.1022949218750f, 0.9721679687500f, 0.1373291015625f, -0.0594482421875f, 0.0332031250000f, -0.0196533203125f, 0.0109863281250f, 0.0017089843750f }
+    };
+}
+
+TruePeakDetector::TruePeakDetector()
+{
+    // Stored transposed and time reversed so one tap of all the 4 phases can be computed at once
+    for (int t = 0; t < kTaps; t++) {
+        for (int p = 0; p < kPhases; p++) {
+            coefficients[t][p] = kFilter[p][kTaps - 1 - t];
+        }
+    }
+}
+
+void TruePeakDetector::prepare(const int maximumBlockSize)
+{
+    inputSize = jmax(1, maximumBlockSize);
+    input.allocate(inputSize + kTaps - 1, true);
+
+    reset();
+}
+
+void TruePeakDetector::reset()
+{
+    for (auto& h : history) {
+        std::fill(std::begin(h), std::end(h), 0.0f);
+    }
+}
+
+template <typename Output>
+void TruePeakDetector::interpolate(int channel, const float* src, int numSamples, Output output)
+{
+    constexpr int historySize = kTaps - 1;
+
+    if (inputSize <= 0 || !isPositiveAndBelow(channel, maxChannels)) {
+        return;
+    }
+
+    Float4 c[kTaps];
+    for (int t = 0; t < kTaps; t++) {
+        c[t] = Float4::load(coefficients[t]);
+    }
+
+    auto buffer = input.get();
+    auto h = history[channel];
+
+    for (int start = 0; start < numSamples; start += inputSize) {
+        auto count = jmin(inputSize, numSamples - start);
+
+        // The filter needs the previous samples to be laid out contiguously with the current ones
+        std::copy(h, h + historySize, buffer);
+        std::copy(src + start, src + start + count, buffer + historySize);
+
+        for (int i = 0; i < count; i++) {
+            auto x = buffer + i;
+            auto acc = Float4::zero();
+
+            // Each lane produces one of the 4 interpolated samples
+            for (int t = 0; t < kTaps; t++) {
+                acc = acc + Float4::broadcast(x[t]) * c[t];
+            }
+
+            output(start + i, acc);
+        }
+
+        std::copy(buffer + count, buffer + count + historySize, h);
+    }
+}
+
+float TruePeakDetector::findPeak(int channel, const float* src, int numSamples)
+{
+    auto peak = Float4::zero();
+
+    interpolate(channel, src, numSamples, [&](int, Float4 interpolated) {
+        peak = Float4::max(peak, interpolated.abs());
+    });
+
+    return peak.maxElement();
+}
+
+void TruePeakDetector::accumulatePeaks(int channel, const float* src, float* dest, int numSamples)
+{
+    interpolate(channel, src, numSamples, [&](int i, Float4 interpolated) {
+        dest[i] = jmax(dest[i], interpolated.abs().maxElement());
+    });
+}
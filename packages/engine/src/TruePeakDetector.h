@@ -0,0 +1,50 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+using namespace juce;
+
+/**
+ * ITU-R BS.1770-4 true-peak detector, a 4x polyphase interpolator looking for peaks between samples
+ *
+ * The interpolated signal lags the input by latencyInSamples, peaks found for input sample i lie between samples i - 6 and i - 5.
+ */
+class TruePeakDetector
+{
+public:
+    static constexpr int maxChannels = 2;
+
+    /**
+     * The 48 taps filter delays the signal by 23.5 oversampled samples, rounded up to whole input samples
+     */
+    static constexpr int latencyInSamples = 6;
+
+    TruePeakDetector();
+
+    void prepare(const int maximumBlockSize);
+
+    void reset();
+
+    /**
+     * Highest absolute interpolated value of the block
+     */
+    float findPeak(int channel, const float* src, int numSamples);
+
+    /**
+     * For every input sample, raise dest[i] to the highest absolute value of its 4 interpolated samples
+     */
+    void accumulatePeaks(int channel, const float* src, float* dest, int numSamples);
+
+private:
+    static constexpr int kPhases = 4;
+    static constexpr int kTaps = 12;
+
+    template <typename Output>
+    void interpolate(int channel, const float* src, int numSamples, Output output);
+
+    float coefficients[kTaps][kPhases]{};
+    float history[maxChannels][kTaps - 1]{};
+
+    HeapBlock<float> input;
+    int inputSize = 0;
+};
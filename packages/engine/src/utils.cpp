@@ -1,4 +1,5 @@
 #include "utils.h"
+#include "BlockInputStream.h"
 
 namespace medley {
 namespace utils {
@@ -11,7 +12,27 @@ AudioFormatReader* createAudioReaderFor(juce::AudioFormatManager& formatMgr, con
             return nullptr;
         }
 
-        return formatMgr.createReaderFor(file);
+        // Like AudioFormatManager::createReaderFor(File), read through blocks read ahead in the background
+        for (int i = 0; i < formatMgr.getNumKnownFormats(); i++) {
+            auto format = formatMgr.getKnownFormat(i);
+
+            if (!format->canHandleFile(file)) {
+                continue;
+            }
+
+            auto stream = std::make_unique<BlockInputStream>(file);
+
+            if (stream->failedToOpen()) {
+                return nullptr;
+            }
+
+            // The stream is deleted if it fails
+            if (auto reader = format->createReaderFor(stream.release(), true)) {
+                return reader;
+            }
+        }
+
+        return nullptr;
     }
     catch (...) {
         return nullptr;
@@ -66,5 +87,36 @@ FileType getFileTypeFromFileName(juce::File file) {
     return FileType::Unknown;
 }
 
+FileType sniffFileType(const uint8_t* data, size_t size) {
+    auto matches = [&](size_t offset, const char* magic) {
+        auto len = strlen(magic);
+        return offset + len <= size && memcmp(data + offset, magic, len) == 0;
+    };
+
+    if ((matches(0, "RIFF") || matches(0, "RF64")) && matches(8, "WAVE")) {
+        return FileType::WAV;
+    }
+
+    if (matches(0, "FORM") && (matches(8, "AIFF") || matches(8, "AIFC"))) {
+        return FileType::AIFF;
+    }
+
+    if (matches(0, "fLaC")) {
+        return FileType::FLAC;
+    }
+
+    if (matches(0, "OggS")) {
+        // The first packet starts right after the segment table
+        auto packetStart = size > 26 ? 27 + (size_t)data[26] : size;
+        return matches(packetStart, "OpusHead") ? FileType::OPUS : FileType::OGG;
+    }
+
+    if (matches(4, "ftyp")) {
+        return FileType::MP4;
+    }
+
+    return FileType::MP3;
+}
+
 }
 }
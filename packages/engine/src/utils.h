@@ -22,5 +22,11 @@ bool isTrackLoadable(juce::AudioFormatManager& formatMgr, const ITrack::Ptr trac
 FileType getFileTypeFromFileName(juce::String& filename);
 FileType getFileTypeFromFileName(juce::File file);
 
+/**
+ * Tell the format from the magic bytes at the start of data, the file extension is not looked at.
+ * MPEG audio has no magic of its own, data not matching any container is assumed to be MP3
+ */
+FileType sniffFileType(const uint8_t* data, size_t size);
+
 }
 }
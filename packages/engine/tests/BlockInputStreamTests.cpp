@@ -0,0 +1,118 @@
+#include <JuceHeader.h>
+#include "BlockInputStream.h"
+
+namespace medley {
+
+class BlockInputStreamTests : public UnitTest {
+public:
+    BlockInputStreamTests() : UnitTest("BlockInputStream", "io") {}
+
+    void runTest() override
+    {
+        constexpr int blockSize = BlockInputStream::blockSize;
+        constexpr int numBlocks = 40;
+
+        TemporaryFile temp;
+        MemoryBlock content(numBlocks * blockSize + 12345);
+
+        {
+            auto random = getRandom();
+            auto data = static_cast<uint8*>(content.getData());
+
+            for (size_t i = 0; i < content.getSize(); i++) {
+                data[i] = (uint8)random.nextInt(256);
+            }
+
+            expect(temp.getFile().replaceWithData(content.getData(), content.getSize()));
+        }
+
+        const auto length = (int64)content.getSize();
+        HeapBlock<char> buffer(blockSize * 10);
+
+        auto readAt = [&](BlockInputStream& stream, int64 position, int numBytes) {
+            stream.setPosition(position);
+
+            auto expected = (int)jmin((int64)numBytes, length - position);
+            auto numRead = stream.read(buffer, numBytes);
+
+            return numRead == expected && memcmp(buffer, static_cast<const char*>(content.getData()) + position, (size_t)numRead) == 0;
+        };
+
+        beginTest("Sequential reads");
+        {
+            BlockInputStream stream(temp.getFile());
+
+            expect(!stream.failedToOpen());
+            expectEquals(stream.getTotalLength(), length);
+
+            MemoryBlock result;
+            int chunk = 4096;
+
+            while (!stream.isExhausted()) {
+                auto numRead = stream.read(buffer, chunk++);
+
+                if (numRead <= 0) {
+                    break;
+                }
+
+                result.append(buffer, (size_t)numRead);
+            }
+
+            expect(result == content);
+        }
+
+        beginTest("Random seeks");
+        {
+            BlockInputStream stream(temp.getFile());
+            auto random = getRandom();
+            auto matched = true;
+
+            for (int i = 0; i < 500 && matched; i++) {
+                matched = readAt(stream, (int64)(random.nextDouble() * (double)length), random.nextInt(blockSize * 3));
+            }
+
+            expect(matched);
+            expect(readAt(stream, length - 50, blockSize));
+        }
+
+        // Stepping back out of the read-ahead window while the blocks at its end are still being read,
+        // then reading through the window again, schedules those blocks a second time
+        beginTest("Seeking back and forth while reads are in flight");
+        {
+            auto matched = true;
+
+            for (int round = 0; round < 20 && matched; round++) {
+                BlockInputStream stream(temp.getFile());
+
+                for (int index = 1; index + 9 < numBlocks && matched; index += 9) {
+                    auto start = (int64)(index - 1) * blockSize;
+
+                    matched = readAt(stream, start, blockSize + 100);
+
+                    // Varies how far the I/O thread got into the window
+                    Thread::sleep(round);
+
+                    matched = matched
+                        && readAt(stream, start + 10, 10)
+                        && readAt(stream, start + 20, blockSize * 8)
+                        && readAt(stream, length - 100, 100)
+                        && readAt(stream, start, blockSize * 9);
+                }
+            }
+
+            expect(matched);
+        }
+
+        beginTest("Missing file");
+        {
+            BlockInputStream stream(temp.getFile().getSiblingFile("missing"));
+
+            expect(stream.failedToOpen());
+            expectEquals(stream.read(buffer, 100), 0);
+        }
+    }
+};
+
+static BlockInputStreamTests blockInputStreamTests;
+
+}
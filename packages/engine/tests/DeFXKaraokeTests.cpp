@@ -0,0 +1,319 @@
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+#include "DeFXKaraoke.h"
+
+namespace medley {
+
+namespace {
+    using Param = DeFXKaraoke::Param;
+    using Params = std::array<float, DeFXKaraoke::numParams>;
+
+    constexpr double sampleRate = 48000.0;
+    constexpr float tolerance = 1.0e-5f;
+
+    // Same as DeFXKaraoke, filter coefficients are recomputed this often while being ramped
+    constexpr int filterRampInterval = 32;
+
+    constexpr Params defaults = { 0.8f, 0.65f, 125.0f, 3.5f, 7000.0f, 2.0f };
+
+    float at(const Params& params, Param index) { return params[(size_t)index]; }
+
+    /**
+     * The karaoke filter written plainly, one IIR::Filter<double> per band, one sample at a time.
+     *
+     * A parameter change is applied from the start of the next block, the mix and the background level ramp linearly over that block,
+     * cut-off frequencies ramp on a log scale and Qs linearly, in steps of filterRampInterval.
+     */
+    class ReferenceKaraoke {
+    public:
+        ReferenceKaraoke(const Params& params)
+            : current(params)
+        {
+            setFilters(1.0f, params);
+        }
+
+        void process(AudioBuffer<float>& buffer, const Params& targets)
+        {
+            auto left = buffer.getWritePointer(0);
+            auto right = buffer.getWritePointer(1);
+
+            const auto numSamples = buffer.getNumSamples();
+
+            const auto mixFrom = at(current, Param::Mix);
+            const auto mixStep = (at(targets, Param::Mix) - mixFrom) / (float)numSamples;
+
+            const auto bgFrom = 1.25f * at(current, Param::OriginalBgLevel) * mixFrom;
+            const auto bgStep = (1.25f * at(targets, Param::OriginalBgLevel) * at(targets, Param::Mix) - bgFrom) / (float)numSamples;
+
+            const auto filterChanging = !isSameFilter(current, targets);
+
+            for (int i = 0; i < numSamples; i++) {
+                if (filterChanging && (i % filterRampInterval) == 0) {
+                    auto end = jmin(i + filterRampInterval, numSamples);
+                    setFilters((float)end / (float)numSamples, targets);
+                }
+
+                auto l = left[i];
+                auto r = right[i];
+
+                auto mono = (l + r) * 0.25f;
+                auto filtered = (float)(lowPass.processSample(mono) + highPass.processSample(mono));
+
+                auto mix = mixFrom + mixStep * (float)(i + 1);
+                auto bgMix = filtered * (bgFrom + bgStep * (float)(i + 1));
+
+                left[i] = l - (r * mix) + bgMix;
+                right[i] = r - (l * mix) + bgMix;
+            }
+
+            lowPass.snapToZero();
+            highPass.snapToZero();
+
+            if (filterChanging) {
+                setFilters(1.0f, targets);
+            }
+
+            current = targets;
+        }
+
+    private:
+        static bool isSameFilter(const Params& a, const Params& b)
+        {
+            for (auto param : { Param::LowPassCutOff, Param::LowPassQ, Param::HighPassCutOff, Param::HighPassQ }) {
+                if (at(a, param) != at(b, param)) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        void setFilters(float position, const Params& targets)
+        {
+            auto ramp = [&](Param param, bool logarithmic) {
+                const auto from = at(current, param);
+                const auto to = at(targets, param);
+
+                if (position >= 1.0f || from == to) {
+                    return (double)to;
+                }
+
+                return logarithmic
+                    ? from * std::pow((double)to / from, (double)position)
+                    : from + ((double)to - from) * position;
+            };
+
+            lowPass.coefficients = IIR::Coefficients<double>::makeLowPass(sampleRate, ramp(Param::LowPassCutOff, true), ramp(Param::LowPassQ, false));
+            highPass.coefficients = IIR::Coefficients<double>::makeHighPass(sampleRate, ramp(Param::HighPassCutOff, true), ramp(Param::HighPassQ, false));
+        }
+
+        Params current;
+        IIR::Filter<double> lowPass;
+        IIR::Filter<double> highPass;
+    };
+
+    /**
+     * Sines over the whole spectrum with some noise, left and right differ
+     */
+    class Program {
+    public:
+        void next(AudioBuffer<float>& buffer)
+        {
+            static constexpr double frequencies[] = { 55.0, 220.0, 261.63, 1244.5, 4186.0, 9000.0 };
+
+            for (int i = 0; i < buffer.getNumSamples(); i++) {
+                auto t = (double)(position + i) / sampleRate;
+
+                for (int ch = 0; ch < 2; ch++) {
+                    auto s = 0.0;
+
+                    for (auto frequency : frequencies) {
+                        s += 0.1 * std::sin(MathConstants<double>::twoPi * frequency * (1.0 + ch * 0.003) * t);
+                    }
+
+                    buffer.setSample(ch, i, (float)s + (random.nextFloat() * 2.0f - 1.0f) * 0.02f);
+                }
+            }
+
+            position += buffer.getNumSamples();
+        }
+
+    private:
+        Random random{ 0x6d65646c };
+        int64 position = 0;
+    };
+}
+
+class DeFXKaraokeTests : public UnitTest {
+public:
+    DeFXKaraokeTests() : UnitTest("DeFXKaraoke", "dsp") {}
+
+    void runTest() override
+    {
+        // 77 leaves a tail to the scalar path
+        for (auto blockSize : { 64, 77, 480, 512, 1024 }) {
+            beginTest("Default parameters, block size " + String(blockSize));
+            expectMatchesReference(blockSize, defaults, {});
+        }
+
+        beginTest("Non-default parameters");
+        {
+            const Params params = { 0.35f, 0.2f, 300.0f, 0.7f, 4000.0f, 1.2f };
+
+            for (auto blockSize : { 77, 512 }) {
+                expectMatchesReference(blockSize, params, {});
+            }
+        }
+
+        beginTest("Parameter ramps");
+        {
+            // Applied between blocks, each one ramps across the next block
+            const std::vector<std::pair<int, Params>> changes = {
+                { 20, { 0.4f, 0.65f, 125.0f, 3.5f, 7000.0f, 2.0f } },
+                { 30, { 0.4f, 0.1f, 125.0f, 3.5f, 7000.0f, 2.0f } },
+                { 40, { 0.4f, 0.1f, 800.0f, 1.0f, 2500.0f, 0.8f } },
+                { 41, { 0.9f, 0.9f, 60.0f, 5.0f, 12000.0f, 3.0f } },
+                { 60, { 0.0f, 0.9f, 60.0f, 5.0f, 12000.0f, 3.0f } },
+                { 61, { 0.6f, 0.5f, 60.0f, 5.0f, 12000.0f, 3.0f } }
+            };
+
+            for (auto blockSize : { 77, 512 }) {
+                expectMatchesReference(blockSize, defaults, changes);
+            }
+        }
+
+        beginTest("Ramped, not stepped");
+        {
+            constexpr int blockSize = 512;
+
+            // Without the background, right only gets left times the mix
+            DeFXKaraoke fx;
+            fx.setParam(Param::OriginalBgLevel, 0.0f);
+            fx.prepare({ sampleRate, (uint32)blockSize, 2 });
+            fx.setEnabled(true);
+
+            AudioBuffer<float> buffer(2, blockSize);
+            Program program;
+
+            for (int block = 0; block < 10; block++) {
+                program.next(buffer);
+                process(fx, buffer);
+            }
+
+            fx.setParam(Param::Mix, 0.0f);
+
+            buffer.clear();
+
+            for (int i = 0; i < blockSize; i++) {
+                buffer.setSample(0, i, 0.5f);
+            }
+
+            process(fx, buffer);
+
+            const auto first = buffer.getSample(1, 0);
+            const auto middle = buffer.getSample(1, blockSize / 2 - 1);
+            const auto last = buffer.getSample(1, blockSize - 1);
+
+            // From 0.8 down to 0 across the block
+            expectWithinAbsoluteError(first, -0.5f * 0.8f, 0.001f);
+            expectWithinAbsoluteError(middle, -0.5f * 0.4f, 0.001f);
+            expectWithinAbsoluteError(last, 0.0f, 1.0e-6f);
+        }
+
+        beginTest("Disabled");
+        {
+            DeFXKaraoke fx;
+            fx.prepare({ sampleRate, 512u, 2 });
+
+            AudioBuffer<float> buffer(2, 512);
+            Program program;
+            program.next(buffer);
+
+            AudioBuffer<float> original;
+            original.makeCopyOf(buffer);
+
+            process(fx, buffer);
+
+            auto maxError = 0.0f;
+
+            for (int ch = 0; ch < 2; ch++) {
+                for (int i = 0; i < 512; i++) {
+                    maxError = jmax(maxError, std::abs(buffer.getSample(ch, i) - original.getSample(ch, i)));
+                }
+            }
+
+            expectEquals(maxError, 0.0f);
+        }
+    }
+
+private:
+    static void process(DeFXKaraoke& fx, AudioBuffer<float>& buffer)
+    {
+        AudioBlock<float> block(buffer);
+        fx.process(ProcessContextReplacing<float>(block));
+    }
+
+    /**
+     * Runs DeFXKaraoke and ReferenceKaraoke side by side over 100 blocks of program material,
+     * params are in place before preparing, then each change is set right before its block is processed
+     */
+    void expectMatchesReference(int blockSize, const Params& params, const std::vector<std::pair<int, Params>>& changes)
+    {
+        constexpr int numBlocks = 100;
+
+        DeFXKaraoke fx;
+
+        for (int i = 0; i < DeFXKaraoke::numParams; i++) {
+            fx.setParam((Param)i, params[(size_t)i]);
+        }
+
+        fx.prepare({ sampleRate, (uint32)blockSize, 2 });
+        fx.setEnabled(true);
+
+        ReferenceKaraoke reference(params);
+        auto targets = params;
+
+        AudioBuffer<float> actual(2, blockSize);
+        AudioBuffer<float> expected(2, blockSize);
+        Program program;
+
+        auto maxError = 0.0f;
+        auto worstBlock = 0;
+
+        for (int block = 0; block < numBlocks; block++) {
+            for (const auto& change : changes) {
+                if (change.first == block) {
+                    for (int i = 0; i < DeFXKaraoke::numParams; i++) {
+                        fx.setParam((Param)i, change.second[(size_t)i]);
+                    }
+
+                    targets = change.second;
+                }
+            }
+
+            program.next(actual);
+            expected.makeCopyOf(actual, true);
+
+            process(fx, actual);
+            reference.process(expected, targets);
+
+            for (int ch = 0; ch < 2; ch++) {
+                for (int i = 0; i < blockSize; i++) {
+                    auto error = std::abs(actual.getSample(ch, i) - expected.getSample(ch, i));
+
+                    if (error > maxError) {
+                        maxError = error;
+                        worstBlock = block;
+                    }
+                }
+            }
+        }
+
+        expectLessOrEqual(maxError, tolerance, "Block size " + String(blockSize) + ", worst at block " + String(worstBlock));
+    }
+};
+
+static DeFXKaraokeTests deFXKaraokeTests;
+
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace medley {
+namespace tests {
+
+/**
+ * Where the sample files are, set with --fixtures
+ */
+juce::File getFixturesDirectory();
+
+}
+}
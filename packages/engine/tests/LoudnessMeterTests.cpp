@@ -0,0 +1,88 @@
+#include <JuceHeader.h>
+#include "LoudnessMeter.h"
+
+namespace medley {
+
+namespace {
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 480;
+
+    /**
+     * Meters a sine for the given duration, right is either silent or a copy of left
+     */
+    LoudnessMeter::Readings measureSine(double frequency, float amplitude, double phase, bool stereo, double seconds)
+    {
+        LoudnessMeter meter;
+        meter.prepare(2, sampleRate, blockSize);
+
+        const auto step = MathConstants<double>::twoPi * frequency / sampleRate;
+        const auto numSamples = (int)(sampleRate * seconds);
+
+        AudioBuffer<float> buffer(2, blockSize);
+
+        for (int start = 0; start < numSamples; start += blockSize) {
+            buffer.clear();
+
+            for (int i = 0; i < blockSize; i++) {
+                auto sample = amplitude * (float)std::sin(step * (start + i) + phase);
+
+                buffer.setSample(0, i, sample);
+
+                if (stereo) {
+                    buffer.setSample(1, i, sample);
+                }
+            }
+
+            meter.process(AudioSourceChannelInfo(buffer));
+            meter.update();
+        }
+
+        return meter.getReadings();
+    }
+}
+
+class LoudnessMeterTests : public UnitTest {
+public:
+    LoudnessMeterTests() : UnitTest("LoudnessMeter", "dsp") {}
+
+    void runTest() override
+    {
+        beginTest("Reference level");
+        {
+            // BS.1770 reference, a 997Hz sine at -20dBFS on a single channel reads -23 LUFS
+            auto readings = measureSine(997.0, Decibels::decibelsToGain(-20.0f), 0.0, false, 5.0);
+
+            expectWithinAbsoluteError(readings.momentary, -23.0, 0.1);
+            expectWithinAbsoluteError(readings.shortTerm, -23.0, 0.1);
+            expectWithinAbsoluteError(readings.integrated, -23.0, 0.1);
+        }
+
+        beginTest("Stereo");
+        {
+            // Twice the power of a single channel
+            auto readings = measureSine(997.0, Decibels::decibelsToGain(-20.0f), 0.0, true, 5.0);
+
+            expectWithinAbsoluteError(readings.integrated, -23.0 + 10.0 * std::log10(2.0), 0.1);
+            expectWithinAbsoluteError(readings.correlation, 1.0, 0.01);
+        }
+
+        beginTest("Inter-sample peak");
+        {
+            // At a quarter of the sample rate and 45 degrees off, every sample lands 3dB below the actual peak
+            const auto amplitude = Decibels::decibelsToGain(-6.0f);
+            auto readings = measureSine(sampleRate / 4.0, amplitude, MathConstants<double>::pi / 4.0, false, 1.0);
+
+            auto samplePeak = Decibels::gainToDecibels(amplitude * std::sqrt(0.5f));
+
+            // EBU Tech 3341 allows +0.2dB / -0.4dB
+            expectWithinAbsoluteError(Decibels::gainToDecibels(readings.truePeak[0]), -6.0 - 0.1, 0.3);
+            expectWithinAbsoluteError(Decibels::gainToDecibels(readings.maxTruePeak[0]), -6.0 - 0.1, 0.3);
+            expectGreaterThan(Decibels::gainToDecibels(readings.maxTruePeak[0]), (double)samplePeak + 2.5);
+            expectEquals(readings.maxTruePeak[1], 0.0);
+        }
+    }
+};
+
+static LoudnessMeterTests loudnessMeterTests;
+
+}
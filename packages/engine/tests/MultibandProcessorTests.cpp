@@ -0,0 +1,100 @@
+#include <JuceHeader.h>
+#include "MultibandProcessor.h"
+
+namespace medley {
+
+namespace {
+    constexpr double sampleRate = 44100.0;
+    constexpr int blockSize = 512;
+
+    /**
+     * Plays a stereo sine through the processor for 2 seconds, returns the gain of the last half second in dB
+     */
+    float measureGain(MultibandProcessor& processor, float frequency, float amplitude)
+    {
+        processor.prepare({ sampleRate, (uint32)blockSize, 2 });
+
+        const auto numSamples = (int)sampleRate * 2;
+        const auto measureFrom = numSamples - (int)sampleRate / 2;
+        const auto step = MathConstants<double>::twoPi * frequency / sampleRate;
+
+        AudioBuffer<float> buffer(2, blockSize);
+        double inputSquares = 0.0;
+        double outputSquares = 0.0;
+
+        for (int start = 0; start < numSamples; start += blockSize) {
+            for (int i = 0; i < blockSize; i++) {
+                auto sample = amplitude * (float)std::sin(step * (start + i));
+
+                buffer.setSample(0, i, sample);
+                buffer.setSample(1, i, sample);
+
+                if (start + i >= measureFrom) {
+                    inputSquares += sample * sample;
+                }
+            }
+
+            AudioBlock<float> block(buffer);
+            processor.process(ProcessContextReplacing<float>(block));
+
+            for (int i = jmax(0, measureFrom - start); i < blockSize; i++) {
+                auto sample = buffer.getSample(0, i);
+                outputSquares += sample * sample;
+            }
+        }
+
+        return Decibels::gainToDecibels((float)std::sqrt(outputSquares / inputSquares), -200.0f);
+    }
+}
+
+class MultibandProcessorTests : public UnitTest {
+public:
+    MultibandProcessorTests() : UnitTest("MultibandProcessor", "dsp") {}
+
+    void runTest() override
+    {
+        beginTest("Flat crossover");
+        {
+            // Below every threshold and below the AGC gate, each band only gets the 1dB make-up gain of the preset
+            for (auto frequency : { 40.0f, 100.0f, 200.0f, 500.0f, 1200.0f, 3000.0f, 5000.0f, 12000.0f }) {
+                MultibandProcessor processor;
+                processor.setPreset(MultibandProcessor::Preset::Gentle);
+                processor.setEnabled(true);
+
+                expectWithinAbsoluteError(measureGain(processor, frequency, 0.001f), 1.0f, 0.1f, String(frequency) + "Hz");
+
+                for (int band = 0; band < MultibandProcessor::numBands; band++) {
+                    expectWithinAbsoluteError(processor.getBandGain(band), 0.0f, 0.01f);
+                }
+            }
+        }
+
+        beginTest("Gain reduction");
+        {
+            MultibandProcessor processor;
+            processor.setPreset(MultibandProcessor::Preset::Gentle);
+            processor.setEnabled(true);
+
+            // -6dBFS in the second band, its threshold is -18dB
+            const auto gain = measureGain(processor, 600.0f, 0.5f);
+
+            expectLessThan(gain, -3.0f);
+            expectLessThan(processor.getBandGain(1), -3.0f);
+
+            // The other bands have nothing to compress
+            expectGreaterThan(processor.getBandGain(3), -1.0f);
+        }
+
+        beginTest("Disabled");
+        {
+            MultibandProcessor processor;
+            processor.setEnabled(false);
+
+            expectWithinAbsoluteError(measureGain(processor, 600.0f, 0.5f), 0.0f, 0.001f);
+        }
+    }
+};
+
+static MultibandProcessorTests multibandProcessorTests;
+
+}
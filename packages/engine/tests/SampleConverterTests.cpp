@@ -0,0 +1,186 @@
+#include <JuceHeader.h>
+#include "audio_req/converter.h"
+
+using namespace audio_req;
+
+namespace medley {
+
+namespace {
+    constexpr SampleFormat allFormats[] = { SampleFormat::Int16LE, SampleFormat::Int16BE, SampleFormat::FloatLE, SampleFormat::FloatBE };
+
+    String getFormatName(SampleFormat format)
+    {
+        switch (format) {
+        case SampleFormat::Int16LE: return "Int16LE";
+        case SampleFormat::Int16BE: return "Int16BE";
+        case SampleFormat::FloatLE: return "FloatLE";
+        case SampleFormat::FloatBE: return "FloatBE";
+        }
+
+        return {};
+    }
+
+    int16 readInt16(const MemoryBlock& block, int index, bool bigEndian)
+    {
+        auto p = static_cast<const uint8*>(block.getData()) + index * 2;
+        return bigEndian ? (int16)ByteOrder::bigEndianShort(p) : (int16)ByteOrder::littleEndianShort(p);
+    }
+}
+
+class SampleConverterTests : public UnitTest {
+public:
+    SampleConverterTests() : UnitTest("SampleConverter", "dsp") {}
+
+    void runTest() override
+    {
+        // Not a multiple of 4, the vectorized stereo path leaves a tail to the scalar one
+        constexpr int numSamples = 1027;
+
+        AudioBuffer<float> input(2, numSamples);
+
+        {
+            auto random = getRandom();
+
+            for (int ch = 0; ch < 2; ch++) {
+                for (int i = 0; i < numSamples; i++) {
+                    // Every third sample lies exactly halfway between two Int16 values, some are out of range
+                    auto value = (i % 3 == 0)
+                        ? ((float)random.nextInt({ -33000, 33000 }) + 0.5f) / 32768.0f
+                        : random.nextFloat() * 2.4f - 1.2f;
+
+                    input.setSample(ch, i, value);
+                }
+            }
+        }
+
+        for (auto format : allFormats) {
+            beginTest("Stereo against scalar " + getFormatName(format));
+
+            SampleConverter stereo(format, 2);
+            const auto bytesPerSample = (int)stereo.getBytesPerSample();
+
+            MemoryBlock interleaved((size_t)(numSamples * 2 * bytesPerSample));
+            stereo.convert(input.getArrayOfReadPointers(), numSamples, interleaved.getData());
+
+            // A single channel never takes the vectorized path
+            for (int ch = 0; ch < 2; ch++) {
+                SampleConverter mono(format, 1);
+
+                MemoryBlock single((size_t)(numSamples * bytesPerSample));
+                const float* source[] = { input.getReadPointer(ch) };
+                mono.convert(source, numSamples, single.getData());
+
+                auto mismatches = 0;
+
+                for (int i = 0; i < numSamples; i++) {
+                    auto a = static_cast<const char*>(interleaved.getData()) + (i * 2 + ch) * bytesPerSample;
+                    auto b = static_cast<const char*>(single.getData()) + i * bytesPerSample;
+
+                    if (memcmp(a, b, (size_t)bytesPerSample) != 0) {
+                        mismatches++;
+                    }
+                }
+
+                expectEquals(mismatches, 0, "Channel " + String(ch));
+            }
+        }
+
+        beginTest("Int16 rounding and clipping");
+        {
+            const float values[] = { 0.0f, 0.5f / 32768.0f, 1.5f / 32768.0f, -2.5f / 32768.0f, 0.25f, -0.25f, 1.0f, -1.0f, 2.0f, -2.0f };
+            const int16 expected[] = { 0, 0, 2, -2, 8192, -8192, 32767, -32768, 32767, -32768 };
+            constexpr int count = numElementsInArray(values);
+
+            for (auto bigEndian : { false, true }) {
+                SampleConverter converter(bigEndian ? SampleFormat::Int16BE : SampleFormat::Int16LE, 2);
+
+                // Both channels carry the same values, 8 of them go through the vectorized path
+                const float* source[] = { values, values };
+                MemoryBlock output((size_t)(count * 2 * 2));
+                converter.convert(source, count, output.getData());
+
+                for (int i = 0; i < count; i++) {
+                    expectEquals((int)readInt16(output, i * 2, bigEndian), (int)expected[i], String(values[i] * 32768.0f) + " LSB");
+                    expectEquals((int)readInt16(output, i * 2 + 1, bigEndian), (int)expected[i]);
+                }
+            }
+        }
+
+        beginTest("Float byte order");
+        {
+            const float values[] = { 0.1f, -0.2f, 0.3f, -0.4f, 0.5f };
+            const float* source[] = { values, values };
+
+            SampleConverter little(SampleFormat::FloatLE, 2);
+            SampleConverter big(SampleFormat::FloatBE, 2);
+
+            MemoryBlock a(sizeof(values) * 2);
+            MemoryBlock b(sizeof(values) * 2);
+
+            little.convert(source, 5, a.getData());
+            big.convert(source, 5, b.getData());
+
+            for (int i = 0; i < 10; i++) {
+                uint32 bits;
+                std::memcpy(&bits, values + i / 2, sizeof(bits));
+
+                expectEquals((int64)ByteOrder::littleEndianInt(static_cast<const char*>(a.getData()) + i * 4), (int64)bits);
+                expectEquals((int64)ByteOrder::bigEndianInt(static_cast<const char*>(b.getData()) + i * 4), (int64)bits);
+            }
+        }
+
+        beginTest("Dithering");
+        {
+            constexpr int count = 48000;
+
+            HeapBlock<float> quiet(count);
+            HeapBlock<float> loud(count);
+
+            for (int i = 0; i < count; i++) {
+                // A quarter of an LSB, only dithering makes it through on average
+                quiet[i] = 0.25f / 32768.0f;
+                loud[i] = (i & 1) ? 1.0e10f : -1.0e10f;
+            }
+
+            for (auto shaping : { false, true }) {
+                SampleConverter converter(SampleFormat::Int16LE, 1);
+                converter.setDither(true);
+                converter.setNoiseShaping(shaping);
+
+                MemoryBlock output((size_t)(count * 2));
+
+                const float* quietSource[] = { quiet.get() };
+                converter.convert(quietSource, count, output.getData());
+
+                auto sum = 0.0;
+                auto peak = 0;
+
+                for (int i = 0; i < count; i++) {
+                    auto value = (int)readInt16(output, i, false);
+
+                    sum += value;
+                    peak = jmax(peak, std::abs(value));
+                }
+
+                expectWithinAbsoluteError(sum / count, 0.25, 0.05);
+                expectLessOrEqual(peak, shaping ? 3 : 1);
+
+                // Far out of range values clip instead of wrapping around
+                const float* loudSource[] = { loud.get() };
+                converter.convert(loudSource, count, output.getData());
+
+                auto clipped = 0;
+
+                for (int i = 0; i < count; i++) {
+                    clipped += readInt16(output, i, false) == ((i & 1) ? 32767 : -32768) ? 1 : 0;
+                }
+
+                expectEquals(clipped, count);
+            }
+        }
+    }
+};
+
+static SampleConverterTests sampleConverterTests;
+
+}
@@ -0,0 +1,114 @@
+#include <JuceHeader.h>
+#include <taglib/id3v2header.h>
+#include <taglib/textidentificationframe.h>
+#include <taglib/tpropertymap.h>
+#include "Fixtures.h"
+#include "Metadata.h"
+#include "TagWriter.h"
+
+namespace medley {
+
+namespace {
+    TagLib::FileName toFileName(const File& file) {
+#ifdef _WIN32
+        return TagLib::FileName((const wchar_t*)file.getFullPathName().toWideCharPointer());
+#else
+        return TagLib::FileName(file.getFullPathName().toRawUTF8());
+#endif
+    }
+
+    /**
+     * Tags not written by TagWriter, they must survive the rewrite
+     */
+    bool writeUnrelatedTags(const File& file) {
+        if (file.hasFileExtension("mp3")) {
+            TagLib::MPEG::File f(toFileName(file));
+
+            auto tag = f.ID3v2Tag(true);
+            tag->setTitle("Middle C");
+            tag->addFrame(new TagLib::ID3v2::UserTextIdentificationFrame("UNRELATED", TagLib::StringList("kept")));
+
+            return f.save(TagLib::MPEG::File::ID3v2, TagLib::File::StripOthers, TagLib::ID3v2::v3);
+        }
+
+        TagLib::FileRef ref(toFileName(file));
+
+        if (ref.isNull()) {
+            return false;
+        }
+
+        auto properties = ref.properties();
+        properties.replace("TITLE", TagLib::StringList("Middle C"));
+        properties.replace("UNRELATED", TagLib::StringList("kept"));
+        ref.setProperties(properties);
+
+        return ref.save();
+    }
+
+    int readID3MajorVersion(const File& file) {
+        FileInputStream stream(file);
+        char header[4] = {};
+
+        if (stream.read(header, 4) != 4 || memcmp(header, "ID3", 3) != 0) {
+            return 0;
+        }
+
+        return header[3];
+    }
+}
+
+class TagWriterTests : public UnitTest {
+public:
+    TagWriterTests() : UnitTest("TagWriter", "tags") {}
+
+    void runTest() override
+    {
+        TagWriter::Values values;
+        values.cueIn = 0.5;
+        values.cueOut = 2.25;
+        values.lastAudible = 2.75;
+        values.trackGain = Decibels::decibelsToGain(-3.5f);
+
+        for (auto ext : { "mp3", "flac", "ogg" }) {
+            beginTest(String("Round trip ") + ext);
+
+            auto source = tests::getFixturesDirectory().getChildFile(String("middlec.") + ext);
+            expect(source.existsAsFile(), "Missing fixture " + source.getFullPathName());
+
+            TemporaryFile temp(String(".") + ext);
+            auto file = temp.getFile();
+
+            expect(source.copyFileTo(file));
+            expect(writeUnrelatedTags(file));
+
+            expect(TagWriter::write(file, values));
+
+            Metadata metadata;
+            metadata.readFromFile(file);
+
+            expectWithinAbsoluteError(metadata.getCueIn(), values.cueIn, 0.001);
+            expectWithinAbsoluteError(metadata.getCueOut(), values.cueOut, 0.001);
+            expectWithinAbsoluteError(metadata.getLastAudible(), values.lastAudible, 0.001);
+            expectWithinAbsoluteError(Decibels::gainToDecibels(metadata.getTrackGain()), -3.5f, 0.01f);
+            expectEquals(metadata.getTitle(), String("Middle C"));
+
+            {
+                TagLib::FileRef ref(toFileName(file));
+                auto unrelated = ref.properties()["UNRELATED"];
+
+                expect(unrelated.size() == 1 && unrelated.front() == "kept", "Unrelated tag was not preserved");
+            }
+
+            if (file.hasFileExtension("mp3")) {
+                expectEquals(readID3MajorVersion(file), 3, "ID3v2 version was not preserved");
+            }
+
+            // Everything is there already
+            expect(!TagWriter::write(file, values));
+        }
+    }
+};
+
+static TagWriterTests tagWriterTests;
+
+}
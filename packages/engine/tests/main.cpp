@@ -0,0 +1,67 @@
+#include <JuceHeader.h>
+#include <iostream>
+#include "Fixtures.h"
+
+using namespace juce;
+
+namespace {
+    File fixturesDir = File::getCurrentWorkingDirectory().getChildFile("test");
+
+    void printUsage() {
+        std::cerr
+            << "Usage: medley-engine-tests [options]" << std::endl
+            << "  --category <name>     Only run tests of this category" << std::endl
+            << "  --seed <n>            Seed for randomized tests (default random)" << std::endl
+            << "  --fixtures <dir>      Directory containing the middlec.* files (default test)" << std::endl;
+    }
+}
+
+File medley::tests::getFixturesDirectory()
+{
+    return fixturesDir;
+}
+
+int main(int argc, char* argv[])
+{
+    String category;
+    int64 seed = 0;
+
+    for (int i = 1; i < argc; i++) {
+        String arg(argv[i]);
+        auto hasValue = i + 1 < argc;
+
+        if (arg == "--category" && hasValue) {
+            category = argv[++i];
+        }
+        else if (arg == "--seed" && hasValue) {
+            seed = String(argv[++i]).getLargeIntValue();
+        }
+        else if (arg == "--fixtures" && hasValue) {
+            fixturesDir = File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        }
+        else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+
+    if (category.isNotEmpty()) {
+        runner.runTestsInCategory(category, seed);
+    }
+    else {
+        runner.runAllTests(seed);
+    }
+
+    int failures = 0;
+
+    for (int i = 0; i < runner.getNumResults(); i++) {
+        failures += runner.getResult(i)->failures;
+    }
+
+    std::cerr << (failures == 0 ? "PASSED" : "FAILED") << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,24 @@
+import { spawnSync } from 'node:child_process';
+import { existsSync } from 'node:fs';
+import { join } from 'node:path';
+
+function main() {
+  const [name, ...args] = process.argv.slice(2);
+
+  if (!name) {
+    console.error('Usage: tsx scripts/run-tool.ts <tool> [...args]');
+    process.exit(1);
+  }
+
+  const executable = join('build', 'Release', process.platform === 'win32' ? `${name}.exe` : name);
+
+  if (!existsSync(executable)) {
+    console.error(`${executable} not found, invoke \`pnpm build:tools\` first`);
+    process.exit(1);
+  }
+
+  const { status } = spawnSync(executable, args, { stdio: 'inherit' });
+  process.exit(status ?? 1);
+}
+
+main();
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <napi.h>
+#include "track.h"
+#include "track_req/pool.h"
+
+/**
+ * State of the module for a Node environment, the module can be loaded by the main thread and any number of worker threads at once
+ */
+struct AddonData {
+    explicit AddonData(Napi::Env env)
+        : trackReleaser(Track::Releaser::create(env))
+    {
+
+    }
+
+    static AddonData& get(Napi::Env env) {
+        return *env.GetInstanceData<AddonData>();
+    }
+
+    std::shared_ptr<Track::Releaser> trackReleaser;
+
+    track_req::TaskPool taskPool;
+};
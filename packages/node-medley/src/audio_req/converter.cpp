@@ -0,0 +1,224 @@
+#include <Simd.h>
+#include "converter.h"
+
+namespace audio_req {
+
+namespace {
+    constexpr float kInt16Scale = 32768.0f;
+    constexpr float kInt16Min = -32768.0f;
+    constexpr float kInt16Max = 32767.0f;
+
+    // Without clipping the error stays within half an LSB of rounding plus the dither peak
+    constexpr float kMaxError = 1.5f;
+
+    inline void writeInt16(char* dest, int value, bool bigEndian)
+    {
+        auto sample = (uint16)(int16)value;
+        sample = bigEndian ? juce::ByteOrder::swapIfLittleEndian(sample) : juce::ByteOrder::swapIfBigEndian(sample);
+        std::memcpy(dest, &sample, sizeof(sample));
+    }
+
+    inline void writeFloat(char* dest, float value, bool bigEndian)
+    {
+        uint32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        bits = bigEndian ? juce::ByteOrder::swapIfLittleEndian(bits) : juce::ByteOrder::swapIfBigEndian(bits);
+        std::memcpy(dest, &bits, sizeof(bits));
+    }
+}
+
+SampleConverter::SampleConverter(SampleFormat format, int numChannels)
+    : format(format),
+    numChannels(numChannels),
+    errors((size_t)juce::jmax(numChannels, 1), 0.0f)
+{
+
+}
+
+uint8_t SampleConverter::getBytesPerSample() const
+{
+    return isFloat() ? 4 : 2;
+}
+
+void SampleConverter::convert(const float* const* source, int numSamples, void* dest)
+{
+    if (!isFloat() && dither.load(std::memory_order_relaxed)) {
+        convertDithered(source, numSamples, dest);
+        return;
+    }
+
+    int done = 0;
+
+    if (numChannels == 2) {
+        done = convertStereo(source[0], source[1], numSamples, dest);
+    }
+
+    convertScalar(source, done, numSamples - done, dest);
+}
+
+void SampleConverter::convertScalar(const float* const* source, int startSample, int numSamples, void* dest)
+{
+    const auto bigEndian = isBigEndian();
+    const auto bytesPerSample = getBytesPerSample();
+    const auto frameSize = bytesPerSample * numChannels;
+
+    for (int ch = 0; ch < numChannels; ch++) {
+        auto src = source[ch] + startSample;
+        auto out = static_cast<char*>(dest) + startSample * frameSize + ch * bytesPerSample;
+
+        if (isFloat()) {
+            for (int i = 0; i < numSamples; i++, out += frameSize) {
+                writeFloat(out, src[i], bigEndian);
+            }
+        }
+        else {
+            for (int i = 0; i < numSamples; i++, out += frameSize) {
+                writeInt16(out, juce::roundToInt(juce::jlimit(kInt16Min, kInt16Max, src[i] * kInt16Scale)), bigEndian);
+            }
+        }
+    }
+}
+
+#if MEDLEY_SIMD_SSE && JUCE_LITTLE_ENDIAN
+int SampleConverter::convertStereo(const float* left, const float* right, int numSamples, void* dest)
+{
+    auto out = static_cast<char*>(dest);
+    const auto bigEndian = isBigEndian();
+    int i = 0;
+
+    if (isFloat()) {
+        for (; i + 4 <= numSamples; i += 4, out += 32) {
+            auto l = _mm_loadu_ps(left + i);
+            auto r = _mm_loadu_ps(right + i);
+
+            auto lo = _mm_castps_si128(_mm_unpacklo_ps(l, r));
+            auto hi = _mm_castps_si128(_mm_unpackhi_ps(l, r));
+
+            if (bigEndian) {
+                // Swap the bytes of each 16-bit half, then swap the halves
+                lo = _mm_or_si128(_mm_slli_epi16(lo, 8), _mm_srli_epi16(lo, 8));
+                hi = _mm_or_si128(_mm_slli_epi16(hi, 8), _mm_srli_epi16(hi, 8));
+
+                lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+                hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), lo);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), hi);
+        }
+
+        return i;
+    }
+
+    const auto scale = _mm_set1_ps(kInt16Scale);
+    const auto minimum = _mm_set1_ps(kInt16Min);
+    const auto maximum = _mm_set1_ps(kInt16Max);
+
+    for (; i + 4 <= numSamples; i += 4, out += 16) {
+        // Clamped first, out of range floats would convert to INT_MIN
+        auto l = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(left + i), scale), minimum), maximum));
+        auto r = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(right + i), scale), minimum), maximum));
+
+        auto packed = _mm_packs_epi32(_mm_unpacklo_epi32(l, r), _mm_unpackhi_epi32(l, r));
+
+        if (bigEndian) {
+            packed = _mm_or_si128(_mm_slli_epi16(packed, 8), _mm_srli_epi16(packed, 8));
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), packed);
+    }
+
+    return i;
+}
+#elif MEDLEY_SIMD_NEON && JUCE_LITTLE_ENDIAN
+int SampleConverter::convertStereo(const float* left, const float* right, int numSamples, void* dest)
+{
+    auto out = static_cast<char*>(dest);
+    const auto bigEndian = isBigEndian();
+    int i = 0;
+
+    if (isFloat()) {
+        for (; i + 4 <= numSamples; i += 4, out += 32) {
+            float32x4x2_t frames = { { vld1q_f32(left + i), vld1q_f32(right + i) } };
+
+            if (bigEndian) {
+                frames.val[0] = vreinterpretq_f32_u8(vrev32q_u8(vreinterpretq_u8_f32(frames.val[0])));
+                frames.val[1] = vreinterpretq_f32_u8(vrev32q_u8(vreinterpretq_u8_f32(frames.val[1])));
+            }
+
+            vst2q_f32(reinterpret_cast<float*>(out), frames);
+        }
+
+        return i;
+    }
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+    const auto scale = vdupq_n_f32(kInt16Scale);
+
+    // Rounds half to even like roundToInt() and SSE do, narrowing saturates
+    auto toInt16 = [&](float32x4_t x) {
+        return vqmovn_s32(vcvtnq_s32_f32(vmulq_f32(x, scale)));
+    };
+
+    for (; i + 4 <= numSamples; i += 4, out += 16) {
+        int16x4x2_t frames = { { toInt16(vld1q_f32(left + i)), toInt16(vld1q_f32(right + i)) } };
+
+        if (bigEndian) {
+            frames.val[0] = vreinterpret_s16_u8(vrev16_u8(vreinterpret_u8_s16(frames.val[0])));
+            frames.val[1] = vreinterpret_s16_u8(vrev16_u8(vreinterpret_u8_s16(frames.val[1])));
+        }
+
+        vst2_s16(reinterpret_cast<int16_t*>(out), frames);
+    }
+#endif
+
+    // 32-bit ARM can only convert by truncating, Int16 is left for the scalar path
+    return i;
+}
+#else
+int SampleConverter::convertStereo(const float*, const float*, int, void*)
+{
+    return 0;
+}
+#endif
+
+void SampleConverter::convertDithered(const float* const* source, int numSamples, void* dest)
+{
+    const auto bigEndian = isBigEndian();
+    const auto frameSize = 2 * numChannels;
+    const auto shaping = noiseShaping.load(std::memory_order_relaxed) ? 1.0f : 0.0f;
+
+    // Error feedback is recursive per channel, channels are independent
+    for (int ch = 0; ch < numChannels; ch++) {
+        auto src = source[ch];
+        auto out = static_cast<char*>(dest) + ch * 2;
+        auto error = errors[ch];
+
+        for (int i = 0; i < numSamples; i++, out += frameSize) {
+            const auto value = src[i] * kInt16Scale - shaping * error;
+
+            // Triangular PDF, 2 LSB peak to peak
+            const auto noise = nextRandom() + nextRandom();
+            // Clamped first, rounding an out of range value would overflow
+            const auto quantized = (float)juce::roundToInt(juce::jlimit(kInt16Min, kInt16Max, value + noise));
+
+            // Clipping leaves a large error behind, feeding it back would only clip further
+            error = juce::jlimit(-kMaxError, kMaxError, quantized - value);
+            writeInt16(out, (int)quantized, bigEndian);
+        }
+
+        errors[ch] = error;
+    }
+}
+
+float SampleConverter::nextRandom()
+{
+    // xorshift32, uniform in [-0.5, 0.5)
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+
+    return (float)(seed >> 8) * (1.0f / 16777216.0f) - 0.5f;
+}
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+
+namespace audio_req {
+
+enum class SampleFormat : uint8_t {
+    Int16LE, Int16BE, FloatLE, FloatBE
+};
+
+/**
+ * Converts planar float channels into one interleaved buffer of the requested format
+ *
+ * Stereo, the common case, is converted and interleaved in one vectorized pass, byte swapping included.
+ * Int16 can be dithered (TPDF), optionally with noise shaping, dithering keeps its state across calls so it must be used by one stream only.
+ */
+class SampleConverter {
+public:
+    SampleConverter(SampleFormat format, int numChannels);
+
+    SampleFormat getFormat() const { return format; }
+
+    uint8_t getBytesPerSample() const;
+
+    /**
+     * Only applies to Int16 formats
+     */
+    void setDither(bool enabled) { dither = enabled; }
+
+    bool isDither() const { return dither; }
+
+    /**
+     * First order error feedback, moves the dither noise away from where hearing is most sensitive, only applies when dithering
+     */
+    void setNoiseShaping(bool enabled) { noiseShaping = enabled; }
+
+    bool isNoiseShaping() const { return noiseShaping; }
+
+    /**
+     * dest must be able to hold numSamples * numChannels * getBytesPerSample() bytes
+     */
+    void convert(const float* const* source, int numSamples, void* dest);
+
+private:
+    bool isFloat() const { return format == SampleFormat::FloatLE || format == SampleFormat::FloatBE; }
+
+    bool isBigEndian() const { return format == SampleFormat::Int16BE || format == SampleFormat::FloatBE; }
+
+    /**
+     * Returns the number of samples converted, the rest is left for the scalar path
+     */
+    int convertStereo(const float* left, const float* right, int numSamples, void* dest);
+
+    void convertScalar(const float* const* source, int startSample, int numSamples, void* dest);
+
+    void convertDithered(const float* const* source, int numSamples, void* dest);
+
+    float nextRandom();
+
+    const SampleFormat format;
+    const int numChannels;
+
+    std::atomic<bool> dither{ false };
+    std::atomic<bool> noiseShaping{ false };
+
+    uint32_t seed = 0x9e3779b9u;
+    std::vector<float> errors;
+};
+
+}
@@ -69,9 +69,7 @@ void AudioRequestProcessor::Process(uint64_t requestedNumSamples)
     bytesReady = outSamples * numChannels * outputBytesPerSample;
     request->scratch.ensureSize(bytesReady);
 
-    for (int i = 0; i < numChannels; i++) {
-        request->converter->convertSamples(request->scratch.getData(), i, sourceBuffer->getReadPointer(i), 0, outSamples);
-    }
+    request->converter->convert(sourceBuffer->getArrayOfReadPointers(), outSamples, request->scratch.getData());
 }
 
 }
@@ -9,7 +9,7 @@ AudioRequest::AudioRequest(
     int inSampleRate,
     int requestedSampleRate,
     uint8_t outputBytesPerSample,
-    std::shared_ptr<juce::AudioData::Converter> converter,
+    std::shared_ptr<SampleConverter> converter,
     std::shared_ptr<PostProcessor> processor,
     float preferredGain
 ) :
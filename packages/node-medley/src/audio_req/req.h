@@ -5,6 +5,7 @@
 #include <PostProcessor.h>
 #include <Fader.h>
 #include "../audio/SecretRabbitCode.h"
+#include "converter.h"
 
 namespace audio_req {
 
@@ -16,7 +17,7 @@ struct AudioRequest {
         int inSampleRate,
         int requestedSampleRate,
         uint8_t outputBytesPerSample,
-        std::shared_ptr<juce::AudioData::Converter> converter,
+        std::shared_ptr<SampleConverter> converter,
         std::shared_ptr<PostProcessor> processor,
         float preferredGain
     );
@@ -33,7 +34,7 @@ struct AudioRequest {
     uint8_t outputBytesPerSample;
     //
     RingBuffer<float> buffer;
-    std::shared_ptr<juce::AudioData::Converter> converter;
+    std::shared_ptr<SampleConverter> converter;
     std::shared_ptr<PostProcessor> processor;
     //
     std::vector<std::shared_ptr<SecretRabbitCode>> resamplers;
@@ -1,4 +1,5 @@
 #include <chrono>
+#include <optional>
 #include "core.h"
 
 using namespace std::literals::chrono_literals;
@@ -43,20 +44,208 @@ namespace {
         return result;
     }
 
-    void readAudioProperties(juce::String trackFile, TagLib::AudioProperties::ReadStyle readStyle, Object& result) {
-        medley::Metadata::AudioProperties audProps(trackFile, readStyle);
+    Napi::Object createJSAudioProperties(Napi::Env env, const medley::Metadata::AudioProperties& audProps) {
+        auto result = Object::New(env);
 
         auto channels = audProps.getChannels();
         auto bitrate = audProps.getBitrate();
         auto sampleRate = audProps.getSampleRate();
         auto duration = audProps.getDuration();
 
-        auto env = result.Env();
-
         result.Set("channels", channels != 0 ? Napi::Number::New(env, channels) : env.Undefined());
         result.Set("bitrate", bitrate != 0 ? Napi::Number::New(env, bitrate) : env.Undefined());
         result.Set("sampleRate", sampleRate != 0 ? Napi::Number::New(env, sampleRate) : env.Undefined());
         result.Set("duration", duration != 0.0f ? Napi::Number::New(env, duration) : env.Undefined());
+
+        return result;
+    }
+
+    /**
+     * The data is handed over without copying, the buffer holds a reference to it.
+     * Copied where external buffers are not allowed, like in Electron
+     */
+    Napi::Buffer<uint8_t> createJSBuffer(Napi::Env env, const TagLib::ByteVector& data) {
+        if (data.isEmpty()) {
+            return Napi::Buffer<uint8_t>::New(env, 0);
+        }
+
+        auto holder = new TagLib::ByteVector(data);
+        // Only the const data() leaves the implicitly shared data alone, the other one detaches it into a copy
+        auto bytes = (uint8_t*)static_cast<const TagLib::ByteVector&>(*holder).data();
+
+        return Napi::Buffer<uint8_t>::NewOrCopy(env, bytes, holder->size(), [](Napi::Env, uint8_t*, TagLib::ByteVector* holder) {
+            delete holder;
+        }, holder);
+    }
+
+    Napi::Buffer<uint8_t> createJSBuffer(Napi::Env env, std::shared_ptr<const medley::CoverArt::Thumbnail> thumbnail) {
+        using Holder = std::shared_ptr<const medley::CoverArt::Thumbnail>;
+
+        auto holder = new Holder(std::move(thumbnail));
+        auto& data = (*holder)->getData();
+
+        return Napi::Buffer<uint8_t>::NewOrCopy(env, (uint8_t*)data.getData(), data.getSize(), [](Napi::Env, uint8_t*, Holder* holder) {
+            delete holder;
+        }, holder);
+    }
+
+    struct CoverOptions {
+        bool fullCover = true;
+        int thumbnailSize = 0;
+    };
+
+    CoverOptions toCoverOptions(const Napi::Value& value) {
+        CoverOptions options;
+
+        if (value.IsObject()) {
+            auto obj = value.ToObject();
+
+            if (obj.Has("fullCover")) {
+                options.fullCover = obj.Get("fullCover").ToBoolean();
+            }
+
+            if (obj.Get("thumbnailSize").IsNumber()) {
+                options.thumbnailSize = obj.Get("thumbnailSize").ToNumber().Int32Value();
+            }
+        }
+
+        return options;
+    }
+
+    /**
+     * Derived from the cover where the file is read, off the JS thread for the asynchronous variant
+     */
+    struct CoverExtras {
+        CoverExtras(const medley::Metadata::Cover& cover, const CoverOptions& options)
+            :
+            hash(medley::CoverArt::getHash(cover.getData())),
+            thumbnail(medley::CoverArt::getThumbnail(cover, hash, options.thumbnailSize))
+        {
+
+        }
+
+        juce::String hash;
+        std::shared_ptr<const medley::CoverArt::Thumbnail> thumbnail;
+    };
+
+    Napi::Object createJSCoverAndLyrics(Napi::Env env, const medley::Metadata::CoverAndLyrics& cal, const CoverOptions& options, const CoverExtras& extras) {
+        auto result = Object::New(env);
+
+        auto& cover = cal.getCover();
+
+        result.Set("cover", options.fullCover ? createJSBuffer(env, cover.getData()) : Napi::Buffer<uint8_t>::New(env, 0));
+        result.Set("coverMimeType", Napi::String::New(env, cover.getMimeType().toStdString()));
+        result.Set("coverHash", safeString(env, extras.hash));
+
+        if (extras.thumbnail) {
+            result.Set("thumbnail", createJSBuffer(env, extras.thumbnail));
+            result.Set("thumbnailMimeType", Napi::String::New(env, extras.thumbnail->getMimeType().toStdString()));
+        }
+
+        result.Set("lyrics", Napi::String::New(env, cal.getLyrics().toStdString()));
+
+        return result;
+    }
+
+    TagLib::AudioProperties::ReadStyle toReadStyle(const Napi::Value& value) {
+        auto readStyleStr = juce::String(value.ToString().Utf8Value());
+
+        if (readStyleStr.compareIgnoreCase("average") == 0) {
+            return TagLib::AudioProperties::Average;
+        }
+
+        if (readStyleStr.compareIgnoreCase("accurate") == 0) {
+            return TagLib::AudioProperties::Accurate;
+        }
+
+        return TagLib::AudioProperties::Fast;
+    }
+
+    /**
+     * Loadability is sniffed from the file header, a decoder is only created with the deep option
+     */
+    uint32_t toLoadableField(const Napi::Object& options) {
+        return options.Get("deep").ToBoolean() ? medley::TrackProbe::DeepLoadable : medley::TrackProbe::Loadable;
+    }
+
+    uint32_t toProbeFields(const Napi::Object& options) {
+        auto value = options.Get("fields");
+
+        if (!value.IsArray()) {
+            return medley::TrackProbe::All | toLoadableField(options);
+        }
+
+        static const std::map<std::string, medley::TrackProbe::Field> fieldsMap = {
+            { "tags", medley::TrackProbe::Tags },
+            { "gain", medley::TrackProbe::Gain },
+            { "properties", medley::TrackProbe::Properties },
+            { "cover", medley::TrackProbe::Cover },
+            { "lyrics", medley::TrackProbe::Lyrics },
+            { "loadable", medley::TrackProbe::Loadable }
+        };
+
+        uint32_t fields = 0;
+        auto names = value.As<Napi::Array>();
+
+        for (uint32_t i = 0; i < names.Length(); i++) {
+            auto it = fieldsMap.find(names.Get(i).ToString().Utf8Value());
+
+            if (it != fieldsMap.end()) {
+                fields |= it->second;
+            }
+        }
+
+        if (fields & medley::TrackProbe::Loadable) {
+            fields |= toLoadableField(options);
+        }
+
+        return fields;
+    }
+
+    Napi::Object createJSProbeResult(Napi::Env env, const medley::TrackProbe& probe) {
+        auto result = Object::New(env);
+        auto& metadata = probe.getMetadata();
+
+        if (probe.has(medley::TrackProbe::Tags)) {
+            result.Set("tags", createJSMetadata(env, metadata));
+        }
+
+        if (probe.has(medley::TrackProbe::Gain)) {
+            auto gain = Object::New(env);
+            auto trackGain = metadata.getTrackGain();
+
+            gain.Set("trackGain", trackGain != 0.0f ? Napi::Number::New(env, trackGain) : env.Undefined());
+            gain.Set("cueIn", metadata.getCueIn() >= 0.0 ? Napi::Number::New(env, metadata.getCueIn()) : env.Undefined());
+            gain.Set("cueOut", metadata.getCueOut() >= 0.0 ? Napi::Number::New(env, metadata.getCueOut()) : env.Undefined());
+            gain.Set("lastAudible", metadata.getLastAudible() >= 0.0 ? Napi::Number::New(env, metadata.getLastAudible()) : env.Undefined());
+
+            result.Set("gain", gain);
+        }
+
+        if (probe.has(medley::TrackProbe::Properties)) {
+            result.Set("properties", createJSAudioProperties(env, probe.getAudioProperties()));
+        }
+
+        auto& cal = probe.getCoverAndLyrics();
+
+        if (probe.has(medley::TrackProbe::Cover)) {
+            auto& cover = cal.getCover();
+
+            result.Set("cover", createJSBuffer(env, cover.getData()));
+            result.Set("coverMimeType", Napi::String::New(env, cover.getMimeType().toStdString()));
+        }
+
+        if (probe.has(medley::TrackProbe::Lyrics)) {
+            result.Set("lyrics", Napi::String::New(env, cal.getLyrics().toStdString()));
+        }
+
+        if (probe.has(medley::TrackProbe::Loadable)) {
+            result.Set("loadable", Napi::Boolean::New(env, probe.isLoadable()));
+        }
+
+        result.Set("error", safeString(env, probe.getError()));
+
+        return result;
     }
 
 }
@@ -74,6 +263,12 @@ void Medley::Initialize(Object& exports) {
         InstanceMethod<&Medley::seekFractional>("seekFractional"),
         InstanceMethod<&Medley::getDeckMetadata>("getDeckMetadata"),
         InstanceMethod<&Medley::getDeckPositions>("getDeckPositions"),
+        InstanceMethod<&Medley::getStats>("getStats"),
+        InstanceMethod<&Medley::getTrace>("getTrace"),
+        InstanceMethod<&Medley::getStateBuffer>("*$getStateBuffer"),
+        InstanceMethod<&Medley::copyState>("*$copyState"),
+        InstanceMethod<&Medley::getPrefetched>("*$getPrefetched"),
+        InstanceMethod<&Medley::resetLoudness>("resetLoudness"),
         //
         InstanceMethod<&Medley::requestAudioStream>("*$reqAudio"),
         InstanceMethod<&Medley::reqAudioGetSamplesReady>("*$reqAudio$getSamplesReady"),
@@ -83,12 +278,19 @@ void Medley::Initialize(Object& exports) {
         InstanceMethod<&Medley::reqAudioDispose>("*$reqAudio$dispose"),
         InstanceMethod<&Medley::reqAudioGetFx>("*$reqAudio$getFx"),
         InstanceMethod<&Medley::reqAudioSetFx>("*$reqAudio$setFx"),
+        InstanceMethod<&Medley::reqAudioGetGraph>("*$reqAudio$getGraph"),
+        InstanceMethod<&Medley::reqAudioSetGraph>("*$reqAudio$setGraph"),
+        InstanceMethod<&Medley::reqAudioSetGraphParams>("*$reqAudio$setGraphParams"),
 
         InstanceMethod<&Medley::getFx>("getFx"),
         InstanceMethod<&Medley::setFx>("setFx"),
+        InstanceMethod<&Medley::getGraph>("getGraph"),
+        InstanceMethod<&Medley::setGraph>("setGraph"),
+        InstanceMethod<&Medley::setGraphParams>("setGraphParams"),
         //
         InstanceAccessor<&Medley::level>("level"),
         InstanceAccessor<&Medley::reduction>("reduction"),
+        InstanceAccessor<&Medley::loudness>("loudness"),
         InstanceAccessor<&Medley::playing>("playing"),
         InstanceAccessor<&Medley::paused>("paused"),
         InstanceAccessor<&Medley::getVolume, &Medley::setVolume>("volume"),
@@ -96,12 +298,25 @@ void Medley::Initialize(Object& exports) {
         InstanceAccessor<&Medley::getMinimumLeadingToFade, &Medley::setMinimumLeadingToFade>("minimumLeadingToFade"),
         InstanceAccessor<&Medley::getMaximumFadeOutDuration, &Medley::setMaximumFadeOutDuration>("maximumFadeOutDuration"),
         InstanceAccessor<&Medley::getReplayGainBoost, &Medley::setReplayGainBoost>("replayGainBoost"),
+        InstanceAccessor<&Medley::getLoudnessCorrection, &Medley::setLoudnessCorrection>("loudnessCorrection"),
+        InstanceAccessor<&Medley::getWriteAnalysisTags, &Medley::setWriteAnalysisTags>("writeAnalysisTags"),
+        InstanceAccessor<&Medley::getPrefetch, &Medley::setPrefetch>("prefetch"),
+        InstanceAccessor<&Medley::getTruePeakLimiter, &Medley::setTruePeakLimiter>("truePeakLimiter"),
+        InstanceAccessor<&Medley::getTracing, &Medley::setTracing>("tracing"),
         //
         StaticMethod<&Medley::static_getMetadata>("getMetadata"),
         StaticMethod<&Medley::static_getAudioProperties>("getAudioProperties"),
         StaticMethod<&Medley::static_getCoverAndLyrics>("getCoverAndLyrics"),
         StaticMethod<&Medley::static_isTrackLoadable>("isTrackLoadable"),
         StaticMethod<&Medley::static_getInfo>("$getInfo"),
+        StaticMethod<&Medley::static_getMetadataAsync>("$getMetadataAsync"),
+        StaticMethod<&Medley::static_getAudioPropertiesAsync>("$getAudioPropertiesAsync"),
+        StaticMethod<&Medley::static_getCoverAndLyricsAsync>("$getCoverAndLyricsAsync"),
+        StaticMethod<&Medley::static_isTrackLoadableAsync>("$isTrackLoadableAsync"),
+        StaticMethod<&Medley::static_probe>("probe"),
+        StaticMethod<&Medley::static_probeAsync>("$probeAsync"),
+        StaticMethod<&Medley::static_probeAllAsync>("$probeAllAsync"),
+        StaticMethod<&Medley::static_cancelTask>("$cancelTask"),
     };
 
     auto env = exports.Env();
@@ -176,6 +391,10 @@ Medley::Medley(const CallbackInfo& info)
         engine = new Engine(*queue, logging ? this : nullptr, skipDeviceScanning);
         engine->addListener(this);
         engine->setAudioCallback(this);
+
+        // The queue may have been filled before
+        queue->addListener(this);
+        engine->queueChanged();
     }
     catch (std::exception const& e) {
         throw Napi::Error::New(info.Env(), e.what());
@@ -186,6 +405,7 @@ Medley::Medley(const CallbackInfo& info)
 }
 
 Medley::~Medley() {
+    queue->removeListener(this);
     delete engine;
     delete queue;
 }
@@ -337,6 +557,17 @@ void Medley::enqueueNext(EnqueueNextDone done) {
     });
 }
 
+void Medley::trackFetched() {
+    // Peeking the queue takes references to tracks, it is only done on the JS thread
+    threadSafeEmitter.NonBlockingCall([this](Napi::Env env, Napi::Function fn) {
+        engine->queueChanged();
+    });
+}
+
+void Medley::queueChanged() {
+    engine->queueChanged();
+}
+
 void Medley::emitDeckEvent(const std::string& name,  medley::Deck& deck, medley::TrackPlay& trackPlay) {
     auto index = deck.getIndex();
 
@@ -424,10 +655,12 @@ Napi::Value Medley::level(const CallbackInfo& info) {
     auto left = Object::New(env);
     left.Set("magnitude", Number::New(env, engine->getLevel(0)));
     left.Set("peak", Number::New(env, engine->getPeakLevel(0)));
+    left.Set("rms", Number::New(env, engine->getRMSLevel(0)));
 
     auto right = Object::New(env);
     right.Set("magnitude", Number::New(env, engine->getLevel(1)));
     right.Set("peak", Number::New(env, engine->getPeakLevel(1)));
+    right.Set("rms", Number::New(env, engine->getRMSLevel(1)));
 
     auto result = Object::New(env);
     result.Set("left", left);
@@ -442,6 +675,32 @@ Napi::Value Medley::reduction(const CallbackInfo& info) {
     return Number::New(env, (double)engine->getReduction());
 }
 
+Napi::Value Medley::loudness(const CallbackInfo& info) {
+    auto env = info.Env();
+    auto readings = engine->getLoudness();
+
+    auto createStereo = [&](const double (&values)[LoudnessMeter::maxChannels]) {
+        auto obj = Object::New(env);
+        obj.Set("left", Number::New(env, values[0]));
+        obj.Set("right", Number::New(env, values[1]));
+        return obj;
+    };
+
+    auto result = Object::New(env);
+    result.Set("momentary", Number::New(env, readings.momentary));
+    result.Set("shortTerm", Number::New(env, readings.shortTerm));
+    result.Set("integrated", Number::New(env, readings.integrated));
+    result.Set("correlation", Number::New(env, readings.correlation));
+    result.Set("truePeak", createStereo(readings.truePeak));
+    result.Set("maxTruePeak", createStereo(readings.maxTruePeak));
+
+    return result;
+}
+
+void Medley::resetLoudness(const CallbackInfo& info) {
+    engine->resetLoudness();
+}
+
 Napi::Value Medley::playing(const CallbackInfo& info) {
     return Napi::Boolean::New(info.Env(), engine->hasStarted());
 }
@@ -490,6 +749,58 @@ void Medley::setReplayGainBoost(const CallbackInfo& info, const Napi::Value& val
     engine->setReplayGainBoost(value.ToNumber().FloatValue());
 }
 
+Napi::Value Medley::getLoudnessCorrection(const CallbackInfo& info) {
+    return Napi::Boolean::New(info.Env(), engine->isLoudnessCorrectionEnabled());
+}
+
+void Medley::setLoudnessCorrection(const CallbackInfo& info, const Napi::Value& value) {
+    engine->setLoudnessCorrectionEnabled(value.ToBoolean());
+}
+
+Napi::Value Medley::getPrefetch(const CallbackInfo& info) {
+    return Napi::Number::New(info.Env(), engine->getPrefetchCount());
+}
+
+void Medley::setPrefetch(const CallbackInfo& info, const Napi::Value& value) {
+    engine->setPrefetchCount(value.ToNumber().Int32Value());
+}
+
+Napi::Value Medley::getPrefetched(const CallbackInfo& info) {
+    auto env = info.Env();
+    auto files = engine->getPrefetchedFiles();
+    auto result = Napi::Array::New(env, files.size());
+
+    for (int i = 0; i < files.size(); i++) {
+        result.Set((uint32_t)i, Napi::String::New(env, files[i].getFullPathName().toStdString()));
+    }
+
+    return result;
+}
+
+Napi::Value Medley::getWriteAnalysisTags(const CallbackInfo& info) {
+    return Napi::Boolean::New(info.Env(), engine->isAnalysisTagWritingEnabled());
+}
+
+void Medley::setWriteAnalysisTags(const CallbackInfo& info, const Napi::Value& value) {
+    engine->setAnalysisTagWritingEnabled(value.ToBoolean());
+}
+
+Napi::Value Medley::getTruePeakLimiter(const CallbackInfo& info) {
+    return Napi::Boolean::New(info.Env(), engine->isTruePeakLimiterEnabled());
+}
+
+void Medley::setTruePeakLimiter(const CallbackInfo& info, const Napi::Value& value) {
+    engine->setTruePeakLimiterEnabled(value.ToBoolean());
+}
+
+Napi::Value Medley::getTracing(const CallbackInfo& info) {
+    return Napi::Boolean::New(info.Env(), medley::Trace::isEnabled());
+}
+
+void Medley::setTracing(const CallbackInfo& info, const Napi::Value& value) {
+    medley::Trace::setEnabled(value.ToBoolean());
+}
+
 Napi::Value Medley::getDeckMetadata(const CallbackInfo& info) {
     auto env = info.Env();
 
@@ -569,6 +880,155 @@ Napi::Value Medley::getDeckPositions(const CallbackInfo& info) {
     return result;
 }
 
+namespace {
+    Napi::Object createJSHistogram(Napi::Env env, const medley::Histogram& histogram) {
+        auto s = histogram.snapshot();
+
+        auto result = Object::New(env);
+        result.Set("count", Napi::Number::New(env, (double)s.count));
+        result.Set("mean", s.toMilliseconds(s.mean()));
+        result.Set("min", s.toMilliseconds(s.min));
+        result.Set("max", s.toMilliseconds(s.max));
+        result.Set("p50", s.toMilliseconds(s.percentile(0.50)));
+        result.Set("p90", s.toMilliseconds(s.percentile(0.90)));
+        result.Set("p99", s.toMilliseconds(s.percentile(0.99)));
+        result.Set("negative", Napi::Number::New(env, (double)s.negative));
+        return result;
+    }
+}
+
+Napi::Value Medley::getStats(const CallbackInfo& info) {
+    auto env = info.Env();
+    auto& stats = engine->getStats();
+
+    auto mixer = Object::New(env);
+    mixer.Set("callback", createJSHistogram(env, stats.mixerCallback));
+    mixer.Set("postProcessor", createJSHistogram(env, engine->getPostProcessTime()));
+    mixer.Set("cpu", engine->getCpuUsage());
+
+    auto interceptor = Object::New(env);
+    interceptor.Set("depth", stats.interceptorQueueDepth.get());
+    interceptor.Set("maxDepth", stats.interceptorQueueDepth.getMax());
+
+    auto transition = Object::New(env);
+    transition.Set("lateness", createJSHistogram(env, stats.transitionLateness));
+
+    auto decks = Array::New(env);
+    for (int i = 0; i < engine->numDecks; i++) {
+        auto& deckStats = engine->getDeck(i)->getStats();
+
+        auto deck = Object::New(env);
+        deck.Set("bufferedSeconds", deckStats.bufferedSeconds.load());
+        deck.Set("underruns", deckStats.underruns.load());
+        deck.Set("load", createJSHistogram(env, deckStats.loadTime));
+        deck.Set("scan", createJSHistogram(env, deckStats.scanTime));
+
+        decks.Set(i, deck);
+    }
+
+    auto requests = Object::New(env);
+    for (auto& [id, req] : audioRequests) {
+        auto request = Object::New(env);
+        request.Set("ready", req->buffer.getNumReady());
+        request.Set("capacity", req->buffer.getCapacity());
+        request.Set("droppedSamples", Napi::Number::New(env, (double)req->buffer.getDroppedSamples()));
+        request.Set("overflows", req->buffer.getOverflows());
+        request.Set("process", createJSHistogram(env, req->processor->getProcessTime()));
+
+        requests.Set(id, request);
+    }
+
+    auto result = Object::New(env);
+    result.Set("mixer", mixer);
+    result.Set("interceptor", interceptor);
+    result.Set("transition", transition);
+    result.Set("decks", decks);
+    result.Set("audioRequests", requests);
+    return result;
+}
+
+Napi::Value Medley::getTrace(const CallbackInfo& info) {
+    auto json = medley::Trace::toJSON();
+
+    if (info.Length() > 0 && info[0].ToBoolean()) {
+        medley::Trace::clear();
+    }
+
+    return Napi::String::New(info.Env(), json.toStdString());
+}
+
+Napi::Value Medley::getStateBuffer(const CallbackInfo& info) {
+    if (stateSnapshot == nullptr) {
+        stateSnapshot = std::make_shared<medley::StateSnapshot>();
+        engine->setStateSnapshot(stateSnapshot);
+    }
+
+    auto env = info.Env();
+
+    // Detached or transferred from JS, the snapshot is shared again through a new buffer
+    if (stateBuffer.IsEmpty() || stateBuffer.Value().IsDetached()) {
+        // The memory is owned by the snapshot, the buffer holds a reference to it until it is collected.
+        // Either the engine or the buffer going away first never leaves the other with freed memory
+        auto holder = new std::shared_ptr<medley::StateSnapshot>(stateSnapshot);
+
+        napi_value value;
+        auto status = napi_create_external_arraybuffer(
+            env,
+            stateSnapshot->getMemory(),
+            medley::StateSnapshot::sizeInBytes,
+            [](napi_env, void*, void* holder) {
+                delete static_cast<std::shared_ptr<medley::StateSnapshot>*>(holder);
+            },
+            holder,
+            &value
+        );
+
+        if (status == napi_ok) {
+            stateBufferShared = true;
+            stateBuffer = Napi::Persistent(Napi::ArrayBuffer(env, value));
+        }
+        else {
+            delete holder;
+
+            if (status != napi_no_external_buffers_allowed) {
+                throw Napi::Error::New(env);
+            }
+
+            // External buffers are not allowed, like in Electron, JS reads a copy which copyState() refreshes
+            stateBufferShared = false;
+
+            auto buffer = Napi::ArrayBuffer::New(env, medley::StateSnapshot::sizeInBytes);
+            auto header = static_cast<uint32*>(buffer.Data());
+            header[0] = 0;
+            header[1] = medley::StateSnapshot::layoutVersion;
+
+            stateBuffer = Napi::Persistent(buffer);
+            copyState(info);
+        }
+    }
+
+    auto result = Object::New(env);
+    result.Set("buffer", stateBuffer.Value());
+    result.Set("shared", stateBufferShared);
+    return result;
+}
+
+Napi::Value Medley::copyState(const CallbackInfo& info) {
+    // Nothing to copy when the memory of the snapshot is shared
+    if (stateSnapshot == nullptr || stateBuffer.IsEmpty() || stateBufferShared || stateBuffer.Value().IsDetached()) {
+        return info.Env().Undefined();
+    }
+
+    // Consistent as read under the seqlock, the sequence of the copy stays even
+    medley::EngineState state;
+    stateSnapshot->read(state);
+
+    auto bytes = static_cast<uint8_t*>(stateBuffer.Value().Data());
+    std::memcpy(bytes + medley::StateSnapshot::stateOffset, &state, sizeof(state));
+
+    return info.Env().Undefined();
+}
+
 void Medley::audioDeviceUpdate(juce::AudioIODevice* device, const medley::Medley::AudioDeviceConfig& config) {
     auto numSamples = device->getCurrentBufferSizeSamples();
     auto numChannels = device->getOutputChannelNames().size();
@@ -645,6 +1105,202 @@ void Medley::setKaraokeParams(KaraokeParamController& ctrl, const Napi::Object&
     }
 }
 
+namespace {
+    Napi::Object createJSGraphNode(Napi::Env env, const GraphNode& node) {
+        auto params = Object::New(env);
+
+        for (int i = 0; i < node.getNumParams(); i++) {
+            params.Set(node.getParamInfo(i).name, node.getParam(i));
+        }
+
+        auto result = Object::New(env);
+        result.Set("id", node.getId().toStdString());
+        result.Set("type", node.getType().toStdString());
+        result.Set("bypassed", node.isBypassed());
+        result.Set("params", params);
+        return result;
+    }
+
+    Napi::Array createJSGraph(Napi::Env env, const ProcessingGraph& graph) {
+        auto nodes = graph.getNodes();
+        auto result = Napi::Array::New(env, nodes.size());
+
+        for (uint32_t i = 0; i < nodes.size(); i++) {
+            result.Set(i, createJSGraphNode(env, *nodes[i]));
+        }
+
+        return result;
+    }
+
+    void applyJSGraphParams(GraphNode& node, const Napi::Object& params) {
+        for (int i = 0; i < node.getNumParams(); i++) {
+            auto name = node.getParamInfo(i).name;
+
+            if (params.Has(name)) {
+                node.setParam(i, params.Get(name).ToNumber().FloatValue());
+            }
+        }
+    }
+
+    /**
+     * Replace all nodes of the graph, nodes with the same id and type are kept along with their state
+     */
+    bool applyJSGraph(Napi::Env env, ProcessingGraph& graph, const Napi::Value& descriptors) {
+        if (!descriptors.IsArray()) {
+            TypeError::New(env, "Graph must be an array").ThrowAsJavaScriptException();
+            return false;
+        }
+
+        auto array = descriptors.As<Napi::Array>();
+
+        std::vector<GraphNode::Ptr> nodes;
+        std::vector<Napi::Object> nodeDescriptors;
+        juce::StringArray ids;
+
+        // Validate everything before touching any node
+        for (uint32_t i = 0; i < array.Length(); i++) {
+            auto value = array.Get(i);
+
+            if (!value.IsObject()) {
+                TypeError::New(env, "Graph node must be an object").ThrowAsJavaScriptException();
+                return false;
+            }
+
+            auto desc = value.ToObject();
+            auto type = juce::String(desc.Get("type").ToString().Utf8Value());
+            auto idValue = desc.Get("id");
+            auto id = idValue.IsString() ? juce::String(idValue.ToString().Utf8Value()) : type + "-" + juce::String(i);
+
+            if (ids.contains(id)) {
+                TypeError::New(env, ("Duplicated graph node id: " + id).toStdString()).ThrowAsJavaScriptException();
+                return false;
+            }
+
+            auto node = graph.findNode(id);
+
+            if (node == nullptr || node->getType() != type) {
+                node = GraphNode::create(type, id);
+            }
+
+            if (node == nullptr) {
+                TypeError::New(env, ("Unknown graph node type: " + type).toStdString()).ThrowAsJavaScriptException();
+                return false;
+            }
+
+            ids.add(id);
+            nodes.push_back(node);
+            nodeDescriptors.push_back(desc);
+        }
+
+        for (size_t i = 0; i < nodes.size(); i++) {
+            auto& desc = nodeDescriptors[i];
+
+            if (desc.Has("params") && desc.Get("params").IsObject()) {
+                applyJSGraphParams(*nodes[i], desc.Get("params").ToObject());
+            }
+
+            if (desc.Has("bypassed")) {
+                nodes[i]->setBypassed(desc.Get("bypassed").ToBoolean());
+            }
+        }
+
+        graph.setNodes(nodes);
+        return true;
+    }
+
+    Napi::Value setJSGraphParams(const CallbackInfo& info, ProcessingGraph& graph, const Napi::Value& id, const Napi::Value& params) {
+        auto env = info.Env();
+
+        if (!params.IsObject()) {
+            TypeError::New(env, "Graph node params must be an object").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        auto node = graph.findNode(juce::String(id.ToString().Utf8Value()));
+
+        if (node == nullptr) {
+            return Boolean::New(env, false);
+        }
+
+        applyJSGraphParams(*node, params.ToObject());
+        return Boolean::New(env, true);
+    }
+
+    struct PresetMap {
+        const char* name;
+        MultibandProcessor::Preset preset;
+    };
+
+    PresetMap presetsMap[] = {
+        { "gentle",    MultibandProcessor::Preset::Gentle },
+        { "broadcast", MultibandProcessor::Preset::Broadcast },
+        { "speech",    MultibandProcessor::Preset::Speech }
+    };
+
+    Napi::Object getMultibandParams(Napi::Env env, const MultibandProcessor& multiband) {
+        auto result = Object::New(env);
+        result.Set("enabled", multiband.isEnabled());
+
+        for (auto& p : presetsMap) {
+            if (p.preset == multiband.getPreset()) {
+                result.Set("preset", p.name);
+            }
+        }
+
+        auto gains = Napi::Array::New(env, MultibandProcessor::numBands);
+
+        for (int band = 0; band < MultibandProcessor::numBands; band++) {
+            gains.Set(band, multiband.getBandGain(band));
+        }
+
+        result.Set("gains", gains);
+        return result;
+    }
+
+    bool setMultibandParams(Napi::Env env, MultibandProcessor& multiband, const Napi::Object& params) {
+        if (params.Has("preset")) {
+            auto name = juce::String(params.Get("preset").ToString().Utf8Value());
+            auto found = false;
+
+            for (auto& p : presetsMap) {
+                if (name.compareIgnoreCase(p.name) == 0) {
+                    multiband.setPreset(p.preset);
+                    found = true;
+                    break;
+                }
+            }
+
+            if (!found) {
+                TypeError::New(env, ("Unknown multiband preset: " + name).toStdString()).ThrowAsJavaScriptException();
+                return false;
+            }
+        }
+
+        if (params.Has("enabled")) {
+            multiband.setEnabled(params.Get("enabled").ToBoolean());
+        }
+
+        return true;
+    }
+
+    /**
+     * Apply `fx.multiband` of the stream options, if any
+     */
+    bool applyJSMultiband(Napi::Env env, MultibandProcessor& multiband, const Napi::Value& fx) {
+        if (!fx.IsObject()) {
+            return true;
+        }
+
+        auto fxObj = fx.ToObject();
+
+        if (!fxObj.Has("multiband") || !fxObj.Get("multiband").IsObject()) {
+            return true;
+        }
+
+        return setMultibandParams(env, multiband, fxObj.Get("multiband").ToObject());
+    }
+}
+
 Napi::Value Medley::requestAudioStream(const CallbackInfo& info) {
     auto env = info.Env();
 
@@ -697,6 +1353,30 @@ Napi::Value Medley::requestAudioStream(const CallbackInfo& info) {
         fx
     );
 
+    if (request && options.Has("truePeakLimiter")) {
+        request->processor->setTruePeakLimiterEnabled(options.Get("truePeakLimiter").ToBoolean());
+    }
+
+    if (request && options.Has("dither")) {
+        request->converter->setDither(options.Get("dither").ToBoolean());
+    }
+
+    if (request && options.Has("noiseShaping")) {
+        request->converter->setNoiseShaping(options.Get("noiseShaping").ToBoolean());
+    }
+
+    if (request && options.Has("graph") && !applyJSGraph(env, request->processor->getGraph(), options.Get("graph"))) {
+        request->running = false;
+        audioRequests.erase(audioRequestId);
+        return env.Undefined();
+    }
+
+    if (request && !applyJSMultiband(env, request->processor->getMultiband(), fx)) {
+        request->running = false;
+        audioRequests.erase(audioRequestId);
+        return env.Undefined();
+    }
+
     auto result = Object::New(env);
     //
     result.Set("id", audioRequestId++);
@@ -709,40 +1389,6 @@ Napi::Value Medley::requestAudioStream(const CallbackInfo& info) {
 }
 
 std::shared_ptr<audio_req::AudioRequest> Medley::registerAudioRequest(uint32_t id, AudioRequestFormat audioFormat, double outSampleRate, uint32_t bufferSize, float gain, Napi::Value fx) {
-    auto audioConveter = audioConverters.find(audioFormat);
-    if (audioConveter == audioConverters.end()) {
-        switch (audioFormat) {
-            case AudioRequestFormat::FloatLE:
-                audioConverters[audioFormat] = std::make_shared<AudioData::ConverterInstance<NativeAudioFormat, Float32LittleEndianFormat>>(1, 2);
-                break;
-            case AudioRequestFormat::FloatBE:
-                audioConverters[audioFormat] = std::make_shared<AudioData::ConverterInstance<NativeAudioFormat, Float32BigEndianFormat>>(1, 2);
-                break;
-            case AudioRequestFormat::Int16LE:
-                audioConverters[audioFormat] = std::make_shared<AudioData::ConverterInstance<NativeAudioFormat, Int16LittleEndianFormat>>(1, 2);
-                break;
-            case AudioRequestFormat::Int16BE:
-                audioConverters[audioFormat] = std::make_shared<AudioData::ConverterInstance<NativeAudioFormat, Int16BigEndianFormat>>(1, 2);
-                break;
-
-            default:
-                return nullptr;
-        }
-    }
-
-    uint8_t bytesPerSample = 0;
-
-    switch (audioFormat) {
-        case AudioRequestFormat::FloatLE:
-        case AudioRequestFormat::FloatBE:
-            bytesPerSample = 4;
-            break;
-        case AudioRequestFormat::Int16LE:
-        case AudioRequestFormat::Int16BE:
-            bytesPerSample = 2;
-            break;
-    }
-
     auto config = engine->getAudioDeviceSetup();
     auto device = engine->getCurrentAudioDevice();
     auto numSamples = device->getCurrentBufferSizeSamples();
@@ -756,9 +1402,13 @@ std::shared_ptr<audio_req::AudioRequest> Medley::registerAudioRequest(uint32_t i
         bufferSize = (uint32_t)(outputSampleRate * 0.25f);
     }
 
+    auto converter = std::make_shared<audio_req::SampleConverter>(audioFormat, numChannels);
+
     std::shared_ptr<PostProcessor> processor = std::make_shared<PostProcessor>();
     ProcessSpec audioSpec{ config.sampleRate, (uint32)numSamples, (uint32)numChannels };
 
+    // Nobody reads the levels of an audio stream
+    processor->setMeteringEnabled(false);
     processor->prepare(audioSpec, latencyInSamples);
 
     if (fx.IsObject()) {
@@ -777,8 +1427,8 @@ std::shared_ptr<audio_req::AudioRequest> Medley::registerAudioRequest(uint32_t i
         numChannels,
         deviceSampleRate,
         outSampleRate,
-        bytesPerSample,
-        audioConverters[audioFormat],
+        converter->getBytesPerSample(),
+        converter,
         processor,
         gain
     );
@@ -846,6 +1496,22 @@ Napi::Value Medley::updateAudioStream(const CallbackInfo& info) {
         request->preferredGain = newGain;
     }
 
+    if (options.Has("truePeakLimiter")) {
+        request->processor->setTruePeakLimiterEnabled(options.Get("truePeakLimiter").ToBoolean());
+    }
+
+    if (options.Has("dither")) {
+        request->converter->setDither(options.Get("dither").ToBoolean());
+    }
+
+    if (options.Has("noiseShaping")) {
+        request->converter->setNoiseShaping(options.Get("noiseShaping").ToBoolean());
+    }
+
+    if (options.Has("graph") && !applyJSGraph(env, request->processor->getGraph(), options.Get("graph"))) {
+        return Boolean::New(env, false);
+    }
+
     if (options.Has("fx")) {
         auto fx = options.Get("fx");
 
@@ -856,6 +1522,10 @@ Napi::Value Medley::updateAudioStream(const CallbackInfo& info) {
                 setKaraokeParams(*request->processor.get(), karaokeParam.ToObject());
             }
         }
+
+        if (!applyJSMultiband(env, request->processor->getMultiband(), fx)) {
+            return Boolean::New(env, false);
+        }
     }
 
     return Boolean::New(env, true);
@@ -876,7 +1546,7 @@ Napi::Value Medley::reqAudioGetlatency(const CallbackInfo& info) {
     }
 
     auto sampleRate = engine->getOutputSampleRate();
-    auto outputLatency = (double)engine->getOutputLatency();
+    auto outputLatency = (double)(engine->getOutputLatency() + it->second->processor->getLatencyInSamples());
 
     auto latencyMs = outputLatency / sampleRate * 1000;
 
@@ -912,6 +1582,10 @@ Napi::Value Medley::getFx(const CallbackInfo& info) {
         return getKaraokeParams(*engine, info);
     }
 
+    if (type.compareIgnoreCase("multiband") == 0) {
+        return getMultibandParams(env, engine->getMultiband());
+    }
+
     TypeError::New(env, "Unknown effect type").ThrowAsJavaScriptException();
     return env.Undefined();
 }
@@ -932,6 +1606,10 @@ Napi::Value Medley::setFx(const CallbackInfo& info) {
         return Boolean::From(env, true);
     }
 
+    if (type.compareIgnoreCase("multiband") == 0) {
+        return Boolean::From(env, setMultibandParams(env, engine->getMultiband(), params));
+    }
+
     TypeError::New(env, "Unknown effect type").ThrowAsJavaScriptException();
     return Boolean::From(env, false);
 }
@@ -957,6 +1635,10 @@ Napi::Value Medley::reqAudioGetFx(const CallbackInfo& info) {
         return getKaraokeParams(*it->second->processor, info);
     }
 
+    if (type.compareIgnoreCase("multiband") == 0) {
+        return getMultibandParams(env, it->second->processor->getMultiband());
+    }
+
     return env.Undefined();
 }
 
@@ -984,67 +1666,108 @@ Napi::Value Medley::reqAudioSetFx(const CallbackInfo& info) {
         return Boolean::From(env, true);
     }
 
+    if (type.compareIgnoreCase("multiband") == 0) {
+        return Boolean::From(env, setMultibandParams(env, it->second->processor->getMultiband(), params));
+    }
+
     TypeError::New(env, "Unknown effect type").ThrowAsJavaScriptException();
     return Boolean::From(env, false);
 }
 
-Napi::Value Medley::static_getMetadata(const CallbackInfo& info) {
+Napi::Value Medley::getGraph(const CallbackInfo& info) {
+    return createJSGraph(info.Env(), engine->getProcessingGraph());
+}
+
+Napi::Value Medley::setGraph(const CallbackInfo& info) {
     auto env = info.Env();
 
     if (info.Length() < 1) {
-        RangeError::New(env, "Insufficient parameter").ThrowAsJavaScriptException();
+        TypeError::New(env, "Insufficient parameter").ThrowAsJavaScriptException();
         return env.Undefined();
     }
 
-    medley::Metadata metadata;
+    return Boolean::New(env, applyJSGraph(env, engine->getProcessingGraph(), info[0]));
+}
 
-    try {
-        juce::String trackFile = info[0].ToString().Utf8Value();
-        metadata.readFromFile(trackFile);
-    }
-    catch (std::exception const& e) {
-        throw Napi::Error::New(info.Env(), e.what());
+Napi::Value Medley::setGraphParams(const CallbackInfo& info) {
+    auto env = info.Env();
+
+    if (info.Length() < 2) {
+        TypeError::New(env, "Insufficient parameter").ThrowAsJavaScriptException();
+        return env.Undefined();
     }
-    catch (...) {
-        throw Napi::Error::New(info.Env(), "Error reading file");
+
+    return setJSGraphParams(info, engine->getProcessingGraph(), info[0], info[1]);
+}
+
+Napi::Value Medley::reqAudioGetGraph(const CallbackInfo& info) {
+    auto env = info.Env();
+
+    auto streamId = static_cast<uint32_t>(info[0].As<Number>().Int32Value());
+
+    auto it = audioRequests.find(streamId);
+    if (it == audioRequests.end()) {
+        return env.Undefined();
     }
 
-    return createJSMetadata(env, metadata);
+    return createJSGraph(env, it->second->processor->getGraph());
 }
 
-Napi::Value Medley::static_getAudioProperties(const Napi::CallbackInfo& info) {
+Napi::Value Medley::reqAudioSetGraph(const CallbackInfo& info) {
     auto env = info.Env();
 
-    if (info.Length() < 1) {
+    if (info.Length() < 2) {
         TypeError::New(env, "Insufficient parameter").ThrowAsJavaScriptException();
         return env.Undefined();
     }
 
-    TagLib::AudioProperties::ReadStyle readStyle = TagLib::AudioProperties::Fast;
+    auto streamId = static_cast<uint32_t>(info[0].As<Number>().Int32Value());
+
+    auto it = audioRequests.find(streamId);
+    if (it == audioRequests.end()) {
+        return Boolean::New(env, false);
+    }
+
+    return Boolean::New(env, applyJSGraph(env, it->second->processor->getGraph(), info[1]));
+}
 
-    auto readStyleStr = juce::String(info[1].ToString().Utf8Value());
+Napi::Value Medley::reqAudioSetGraphParams(const CallbackInfo& info) {
+    auto env = info.Env();
 
-    if (readStyleStr.compareIgnoreCase("average") == 0) {
-        readStyle = TagLib::AudioProperties::Average;
+    if (info.Length() < 3) {
+        TypeError::New(env, "Insufficient parameter").ThrowAsJavaScriptException();
+        return env.Undefined();
     }
-    else if (readStyleStr.compareIgnoreCase("accurate") == 0) {
-        readStyle = TagLib::AudioProperties::Accurate;
+
+    auto streamId = static_cast<uint32_t>(info[0].As<Number>().Int32Value());
+
+    auto it = audioRequests.find(streamId);
+    if (it == audioRequests.end()) {
+        return Boolean::New(env, false);
     }
 
-    auto result = Object::New(env);
+    return setJSGraphParams(info, it->second->processor->getGraph(), info[1], info[2]);
+}
 
-    try {
-        juce::String trackFile = info[0].ToString().Utf8Value();
-        readAudioProperties(trackFile, readStyle, result);
+Napi::Value Medley::static_getMetadata(const CallbackInfo& info) {
+    auto env = info.Env();
+
+    if (info.Length() < 1) {
+        RangeError::New(env, "Insufficient parameter").ThrowAsJavaScriptException();
+        return env.Undefined();
     }
-    catch (...) {
 
+    juce::String trackFile = info[0].ToString().Utf8Value();
+    auto probe = medley::TrackInfoCache::probe(supportedFormats, trackFile, medley::TrackProbe::Tags);
+
+    if (probe->getError().isNotEmpty()) {
+        throw Napi::Error::New(info.Env(), probe->getError().toStdString());
     }
 
-    return result;
+    return createJSMetadata(env, probe->getMetadata());
 }
 
-Napi::Value Medley::static_getCoverAndLyrics(const Napi::CallbackInfo& info) {
+Napi::Value Medley::static_getAudioProperties(const Napi::CallbackInfo& info) {
     auto env = info.Env();
 
     if (info.Length() < 1) {
@@ -1052,25 +1775,32 @@ Napi::Value Medley::static_getCoverAndLyrics(const Napi::CallbackInfo& info) {
         return env.Undefined();
     }
 
-    auto result = Object::New(env);
+    juce::String trackFile = info[0].ToString().Utf8Value();
+    auto probe = medley::TrackInfoCache::probe(supportedFormats, trackFile, medley::TrackProbe::Properties, toReadStyle(info[1]));
 
-    try {
+    return createJSAudioProperties(env, probe->getAudioProperties());
+}
 
+Napi::Value Medley::static_getCoverAndLyrics(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+
+    if (info.Length() < 1) {
+        TypeError::New(env, "Insufficient parameter").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    try {
         juce::String trackFile = info[0].ToString().Utf8Value();
+        auto options = toCoverOptions(info[1]);
 
         medley::Metadata::CoverAndLyrics cal(trackFile, true, true);
-        auto cover = cal.getCover();
-        auto coverData = cover.getData();
-
-        result.Set("cover", Napi::Buffer<uint8_t>::Copy(env, (uint8_t*)coverData.data(), coverData.size()));
-        result.Set("coverMimeType", Napi::String::New(env, cover.getMimeType().toStdString()));
-        result.Set("lyrics", Napi::String::New(env, cal.getLyrics().toStdString()));
+        return createJSCoverAndLyrics(env, cal, options, CoverExtras(cal.getCover(), options));
     }
     catch (...) {
 
     }
 
-    return result;
+    return Object::New(env);
 }
 
 Napi::Value Medley::static_isTrackLoadable(const CallbackInfo& info) {
@@ -1083,11 +1813,223 @@ Napi::Value Medley::static_isTrackLoadable(const CallbackInfo& info) {
 
     try {
         auto trackPtr = Track::fromJS(info[0]);
-        return Boolean::New(env, medley::utils::isTrackLoadable(supportedFormats, trackPtr));
+        auto options = info[1].IsObject() ? info[1].ToObject() : Object::New(env);
+        auto probe = medley::TrackInfoCache::probe(supportedFormats, trackPtr->getFile(), toLoadableField(options));
+        return Boolean::New(env, probe->isLoadable());
+    }
+    catch (...) {
+        return Boolean::New(env, false);
+    }
+}
+
+Napi::Value Medley::static_getMetadataAsync(const CallbackInfo& info) {
+    auto env = info.Env();
+
+    if (info.Length() < 1) {
+        TypeError::New(env, "Insufficient parameter").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    juce::String trackFile = info[0].ToString().Utf8Value();
+    auto probe = std::make_shared<std::unique_ptr<medley::TrackProbe>>();
+
+    return track_req::TaskPool::submit(
+        env,
+        [trackFile, probe] {
+            *probe = medley::TrackInfoCache::probe(supportedFormats, trackFile, medley::TrackProbe::Tags);
+
+            if ((*probe)->getError().isNotEmpty()) {
+                throw std::runtime_error((*probe)->getError().toStdString());
+            }
+        },
+        [probe](Napi::Env env) -> Napi::Value {
+            return createJSMetadata(env, (*probe)->getMetadata());
+        }
+    );
+}
+
+Napi::Value Medley::static_getAudioPropertiesAsync(const CallbackInfo& info) {
+    auto env = info.Env();
+
+    if (info.Length() < 1) {
+        TypeError::New(env, "Insufficient parameter").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    juce::String trackFile = info[0].ToString().Utf8Value();
+    auto readStyle = toReadStyle(info[1]);
+    auto probe = std::make_shared<std::unique_ptr<medley::TrackProbe>>();
+
+    return track_req::TaskPool::submit(
+        env,
+        [trackFile, readStyle, probe] {
+            *probe = medley::TrackInfoCache::probe(supportedFormats, trackFile, medley::TrackProbe::Properties, readStyle);
+        },
+        [probe](Napi::Env env) -> Napi::Value {
+            return createJSAudioProperties(env, (*probe)->getAudioProperties());
+        }
+    );
+}
+
+Napi::Value Medley::static_getCoverAndLyricsAsync(const CallbackInfo& info) {
+    auto env = info.Env();
+
+    if (info.Length() < 1) {
+        TypeError::New(env, "Insufficient parameter").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    juce::String trackFile = info[0].ToString().Utf8Value();
+    auto options = toCoverOptions(info[1]);
+    auto cal = std::make_shared<std::optional<medley::Metadata::CoverAndLyrics>>();
+    auto extras = std::make_shared<std::optional<CoverExtras>>();
+
+    return track_req::TaskPool::submit(
+        env,
+        [trackFile, options, cal, extras] {
+            try {
+                cal->emplace(trackFile, true, true);
+                extras->emplace((*cal)->getCover(), options);
+            }
+            catch (...) {
+
+            }
+        },
+        [options, cal, extras](Napi::Env env) -> Napi::Value {
+            return extras->has_value() ? createJSCoverAndLyrics(env, **cal, options, **extras) : Object::New(env);
+        }
+    );
+}
+
+Napi::Value Medley::static_isTrackLoadableAsync(const CallbackInfo& info) {
+    auto env = info.Env();
+
+    if (info.Length() < 1) {
+        TypeError::New(env, "Insufficient parameter").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    // Only the file is taken, the JS object must not be touched from the pool
+    juce::File trackFile;
+
+    try {
+        trackFile = Track::fromJS(info[0])->getFile();
     }
     catch (...) {
+        // Not a track, resolved as not loadable like the synchronous variant does
+        return track_req::TaskPool::submit(
+            env,
+            [] {},
+            [](Napi::Env env) -> Napi::Value {
+                return Boolean::New(env, false);
+            }
+        );
+    }
+
+    auto options = info[1].IsObject() ? info[1].ToObject() : Object::New(env);
+    auto field = toLoadableField(options);
+    auto loadable = std::make_shared<bool>(false);
+
+    return track_req::TaskPool::submit(
+        env,
+        [trackFile, field, loadable] {
+            *loadable = medley::TrackInfoCache::probe(supportedFormats, trackFile, field)->isLoadable();
+        },
+        [loadable](Napi::Env env) -> Napi::Value {
+            return Boolean::New(env, *loadable);
+        }
+    );
+}
+
+Napi::Value Medley::static_probe(const CallbackInfo& info) {
+    auto env = info.Env();
+
+    if (info.Length() < 1) {
+        TypeError::New(env, "Insufficient parameter").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    juce::String trackFile = info[0].ToString().Utf8Value();
+    auto options = info[1].IsObject() ? info[1].ToObject() : Object::New(env);
+
+    auto probe = medley::TrackInfoCache::probe(supportedFormats, trackFile, toProbeFields(options), toReadStyle(options.Get("readMode")));
+    return createJSProbeResult(env, *probe);
+}
+
+Napi::Value Medley::static_probeAsync(const CallbackInfo& info) {
+    auto env = info.Env();
+
+    if (info.Length() < 1) {
+        TypeError::New(env, "Insufficient parameter").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    juce::String trackFile = info[0].ToString().Utf8Value();
+    auto options = info[1].IsObject() ? info[1].ToObject() : Object::New(env);
+    auto fields = toProbeFields(options);
+    auto readStyle = toReadStyle(options.Get("readMode"));
+    auto probe = std::make_shared<std::unique_ptr<medley::TrackProbe>>();
+
+    return track_req::TaskPool::submit(
+        env,
+        [trackFile, fields, readStyle, probe] {
+            *probe = medley::TrackInfoCache::probe(supportedFormats, trackFile, fields, readStyle);
+        },
+        [probe](Napi::Env env) -> Napi::Value {
+            return createJSProbeResult(env, **probe);
+        }
+    );
+}
+
+Napi::Value Medley::static_probeAllAsync(const CallbackInfo& info) {
+    auto env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsArray()) {
+        TypeError::New(env, "Insufficient parameter").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    auto paths = info[0].As<Napi::Array>();
+    juce::Array<juce::File> files;
+
+    for (uint32_t i = 0; i < paths.Length(); i++) {
+        files.add(juce::File(juce::String(paths.Get(i).ToString().Utf8Value())));
+    }
+
+    auto options = info[1].IsObject() ? info[1].ToObject() : Object::New(env);
+    auto fields = toProbeFields(options);
+    auto readStyle = toReadStyle(options.Get("readMode"));
+    auto probes = std::make_shared<std::vector<std::unique_ptr<medley::TrackProbe>>>();
+
+    return track_req::TaskPool::submit(
+        env,
+        [files, fields, readStyle, probes] {
+            for (auto& file : files) {
+                probes->push_back(medley::TrackInfoCache::probe(supportedFormats, file, fields, readStyle));
+            }
+        },
+        [probes](Napi::Env env) -> Napi::Value {
+            auto results = Napi::Array::New(env, probes->size());
+
+            for (size_t i = 0; i < probes->size(); i++) {
+                results.Set((uint32_t)i, createJSProbeResult(env, *probes->at(i)));
+            }
+
+            return results;
+        }
+    );
+}
+
+Napi::Value Medley::static_cancelTask(const CallbackInfo& info) {
+    auto env = info.Env();
+
+    if (info.Length() < 1) {
+        TypeError::New(env, "Insufficient parameter").ThrowAsJavaScriptException();
         return Boolean::New(env, false);
     }
+
+    auto taskId = static_cast<uint32_t>(info[0].ToNumber().Int64Value());
+    return Boolean::New(env, track_req::TaskPool::cancel(env, taskId));
 }
 
 Napi::Value Medley::static_getInfo(const Napi::CallbackInfo& info) {
@@ -1173,6 +2115,21 @@ Napi::Value Medley::static_getInfo(const Napi::CallbackInfo& info) {
     return result;
 }
 
+Napi::Object Medley::toJSMetadata(Napi::Env env, const medley::Metadata& metadata) {
+    return createJSMetadata(env, metadata);
+}
+
+juce::StringArray Medley::getSupportedExtensions() {
+    juce::StringArray extensions;
+
+    for (int i = 0; i < supportedFormats.getNumKnownFormats(); i++) {
+        extensions.addArray(supportedFormats.getKnownFormat(i)->getFileExtensions());
+    }
+
+    extensions.removeDuplicates(true);
+    return extensions;
+}
+
 uint32_t Medley::audioRequestId = 0;
 
 Engine::SupportedFormats Medley::supportedFormats;
@@ -5,7 +5,11 @@
 #include <Medley.h>
 #include <ITrack.h>
 #include <ILogger.h>
+#include <Trace.h>
+#include <TrackInfoCache.h>
+#include <CoverArt.h>
 #include "audio_req/consumer.h"
+#include "track_req/pool.h"
 #include "track.h"
 #include "queue.h"
 #include "version.h"
@@ -14,7 +18,7 @@ using namespace Napi;
 
 using Engine = medley::Medley;
 
-class Medley : public ObjectWrap<Medley>, public Engine::Callback, public Engine::AudioCallback, public medley::ILoggerWriter {
+class Medley : public ObjectWrap<Medley>, public Engine::Callback, public Engine::AudioCallback, public Queue::Listener, public medley::ILoggerWriter {
 public:
 
     static void Initialize(Object& exports);
@@ -45,6 +49,10 @@ public:
 
     void enqueueNext(Engine::Callback::EnqueueNextDone done) override;
 
+    void trackFetched() override;
+
+    void queueChanged() override;
+
     void audioDeviceUpdate(juce::AudioIODevice* device, const medley::Medley::AudioDeviceConfig& config) override;
 
     void audioData(const AudioSourceChannelInfo& info, double timestamp) override;
@@ -65,6 +73,10 @@ public:
 
     Napi::Value reduction(const CallbackInfo& info);
 
+    Napi::Value loudness(const CallbackInfo& info);
+
+    void resetLoudness(const CallbackInfo& info);
+
     Napi::Value playing(const CallbackInfo& info);
 
     Napi::Value paused(const CallbackInfo& info);
@@ -89,6 +101,26 @@ public:
 
     void setReplayGainBoost(const CallbackInfo& info, const Napi::Value& value);
 
+    Napi::Value getLoudnessCorrection(const CallbackInfo& info);
+
+    void setLoudnessCorrection(const CallbackInfo& info, const Napi::Value& value);
+
+    Napi::Value getPrefetch(const CallbackInfo& info);
+
+    void setPrefetch(const CallbackInfo& info, const Napi::Value& value);
+
+    Napi::Value getWriteAnalysisTags(const CallbackInfo& info);
+
+    void setWriteAnalysisTags(const CallbackInfo& info, const Napi::Value& value);
+
+    Napi::Value getTruePeakLimiter(const CallbackInfo& info);
+
+    void setTruePeakLimiter(const CallbackInfo& info, const Napi::Value& value);
+
+    Napi::Value getTracing(const CallbackInfo& info);
+
+    void setTracing(const CallbackInfo& info, const Napi::Value& value);
+
     Napi::Value getAvailableDevices(const CallbackInfo& info);
 
     Napi::Value setAudioDevice(const CallbackInfo& info);
@@ -99,6 +131,16 @@ public:
 
     Napi::Value getDeckPositions(const CallbackInfo& info);
 
+    Napi::Value getStats(const CallbackInfo& info);
+
+    Napi::Value getTrace(const CallbackInfo& info);
+
+    Napi::Value getStateBuffer(const CallbackInfo& info);
+
+    Napi::Value copyState(const CallbackInfo& info);
+
+    Napi::Value getPrefetched(const CallbackInfo& info);
+
     Napi::Value requestAudioStream(const CallbackInfo& info);
 
     Napi::Value reqAudioConsume(const CallbackInfo& info);
@@ -123,6 +165,18 @@ public:
 
     Napi::Value reqAudioSetFx(const CallbackInfo& info);
 
+    Napi::Value getGraph(const CallbackInfo& info);
+
+    Napi::Value setGraph(const CallbackInfo& info);
+
+    Napi::Value setGraphParams(const CallbackInfo& info);
+
+    Napi::Value reqAudioGetGraph(const CallbackInfo& info);
+
+    Napi::Value reqAudioSetGraph(const CallbackInfo& info);
+
+    Napi::Value reqAudioSetGraphParams(const CallbackInfo& info);
+
     static Napi::Value static_getMetadata(const Napi::CallbackInfo& info);
 
     static Napi::Value static_getAudioProperties(const Napi::CallbackInfo& info);
@@ -132,11 +186,37 @@ public:
     static Napi::Value static_isTrackLoadable(const Napi::CallbackInfo& info);
 
     static Napi::Value static_getInfo(const Napi::CallbackInfo& info);
+
+    static Napi::Value static_getMetadataAsync(const Napi::CallbackInfo& info);
+
+    static Napi::Value static_getAudioPropertiesAsync(const Napi::CallbackInfo& info);
+
+    static Napi::Value static_getCoverAndLyricsAsync(const Napi::CallbackInfo& info);
+
+    static Napi::Value static_isTrackLoadableAsync(const Napi::CallbackInfo& info);
+
+    static Napi::Value static_probe(const Napi::CallbackInfo& info);
+
+    static Napi::Value static_probeAsync(const Napi::CallbackInfo& info);
+
+    static Napi::Value static_probeAllAsync(const Napi::CallbackInfo& info);
+
+    static Napi::Value static_cancelTask(const Napi::CallbackInfo& info);
+
+    /**
+     * Like ".mp3", of every supported format
+     */
+    static juce::StringArray getSupportedExtensions();
+
+    static Engine::SupportedFormats& getSupportedFormats() { return supportedFormats; }
+
+    /**
+     * Same object as returned by getMetadata()
+     */
+    static Napi::Object toJSMetadata(Napi::Env env, const medley::Metadata& metadata);
 private:
 
-    enum class AudioRequestFormat : uint8_t {
-        Int16LE, Int16BE, FloatLE, FloatBE
-    };
+    using AudioRequestFormat = audio_req::SampleFormat;
 
     void emitDeckEvent(const std::string& name, medley::Deck& deck, medley::TrackPlay& track);
 
@@ -146,48 +226,15 @@ private:
 
     std::map<uint32_t, std::shared_ptr<audio_req::AudioRequest>> audioRequests;
 
-    using NativeAudioFormat = AudioData::Pointer<
-        AudioData::Float32,
-        AudioData::NativeEndian,
-        AudioData::NonInterleaved,
-        AudioData::Const
-    >;
-
-    using Int16LittleEndianFormat = AudioData::Pointer<
-        AudioData::Int16,
-        AudioData::LittleEndian,
-        AudioData::Interleaved,
-        AudioData::NonConst
-    >;
-
-    using Int16BigEndianFormat = AudioData::Pointer<
-        AudioData::Int16,
-        AudioData::BigEndian,
-        AudioData::Interleaved,
-        AudioData::NonConst
-    >;
-
-    using Float32LittleEndianFormat = AudioData::Pointer<
-        AudioData::Float32,
-        AudioData::LittleEndian,
-        AudioData::Interleaved,
-        AudioData::NonConst
-    >;
-
-    using Float32BigEndianFormat = AudioData::Pointer<
-        AudioData::Float32,
-        AudioData::BigEndian,
-        AudioData::Interleaved,
-        AudioData::NonConst
-    >;
-
-    std::map<AudioRequestFormat, std::shared_ptr<juce::AudioData::Converter>> audioConverters;
-
     ObjectReference queueJS;
     Queue* queue = nullptr;
     Engine* engine = nullptr;
 
     Reference<Napi::Value> self;
+    std::shared_ptr<medley::StateSnapshot> stateSnapshot;
+    Reference<Napi::ArrayBuffer> stateBuffer;
+    // false when stateBuffer is a copy which copyState() refreshes
+    bool stateBufferShared = false;
     ThreadSafeFunction threadSafeEmitter;
 
     static Engine::SupportedFormats supportedFormats;
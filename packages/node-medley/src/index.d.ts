@@ -36,6 +36,13 @@ export declare class Queue<T extends TrackInfo = TrackInfo> {
 
   get length(): number;
 
+  /**
+   * Incremented on every change to this `Queue`, including tracks taken by the engine.
+   *
+   * Can be compared against a previously seen value to tell whether the result of `toArray()` needs refreshing.
+   */
+  get version(): number;
+
   add(track: TrackDescriptor<T> | TrackDescriptor<T>[]): void;
 
   /**
@@ -78,6 +85,11 @@ export declare class Queue<T extends TrackInfo = TrackInfo> {
 export interface AudioLevel {
   magnitude: number;
   peak: number;
+
+  /**
+   * RMS level over the last 300ms
+   */
+  rms: number;
 }
 
 export interface AudioLevels {
@@ -92,6 +104,46 @@ export interface AudioLevels {
   right: AudioLevel;
 }
 
+export type StereoValue = {
+  left: number;
+  right: number;
+}
+
+/**
+ * EBU R128 loudness, all loudness values are in LUFS and are `-Infinity` when silent
+ */
+export type Loudness = {
+  /**
+   * Loudness over the last 400ms
+   */
+  momentary: number;
+
+  /**
+   * Loudness over the last 3s
+   */
+  shortTerm: number;
+
+  /**
+   * Gated loudness since the engine started or since the last call to `resetLoudness()`
+   */
+  integrated: number;
+
+  /**
+   * Correlation between the left and right channels over the last 400ms, from -1.0 to 1.0
+   */
+  correlation: number;
+
+  /**
+   * 4x oversampled peak over the last 400ms, in gain
+   */
+  truePeak: StereoValue;
+
+  /**
+   * Highest true-peak since the engine started or since the last call to `resetLoudness()`, in gain
+   */
+  maxTruePeak: StereoValue;
+}
+
 type NormalEvent = 'audioDeviceChanged';
 type DeckEvent = 'loaded' | 'unloaded' | 'started' | 'finished' | 'mainDeckChanged';
 
@@ -147,6 +199,13 @@ export declare class Medley<T extends TrackInfo = TrackInfo> {
    */
   get reduction(): number;
 
+  get loudness(): Loudness;
+
+  /**
+   * Restart the integrated loudness and the maximum true-peak measurement
+   */
+  resetLoudness(): void;
+
   /**
    * @returns `true` if the engine is running, `false` otherwise.
    *
@@ -192,6 +251,61 @@ export declare class Medley<T extends TrackInfo = TrackInfo> {
   get replayGainBoost(): number;
   set replayGainBoost(decibels: number);
 
+  /**
+   * Measure the integrated loudness (EBU R128) of tracks having no ReplayGain metadata while they are being scanned,
+   * and use it as gain correction, the same way as ReplayGain would, including `replayGainBoost`.
+   *
+   * The gain is only applied if the measurement completes before the track starts playing,
+   * measurements are cached for the lifetime of the process so the gain will be applied the next time the track is loaded.
+   *
+   * @default true
+   */
+  get loudnessCorrection(): boolean;
+  set loudnessCorrection(value: boolean);
+
+  /**
+   * Number of upcoming tracks in the queue to prefetch, `0` disables prefetching.
+   *
+   * Upcoming tracks are warmed in the background one after another: the file is read into the OS page cache,
+   * the tags are parsed, a decoder is opened ahead and the loudness is measured if `loudnessCorrection` is enabled,
+   * so loading them is near-instant. Changing the queue cancels the work on tracks which are no longer upcoming.
+   *
+   * @default 2
+   */
+  get prefetch(): number;
+  set prefetch(value: number);
+
+  /**
+   * Write the cue points and the measured loudness found while scanning tracks back into their tags,
+   * `CUE-IN`, `CUE-OUT`, `LAST_AUDIBLE` and `REPLAYGAIN_TRACK_GAIN`, so they are not analyzed again the next time they are loaded.
+   *
+   * Only missing tags are written, files are tagged as a copy which then replaces the original.
+   *
+   * @default false
+   */
+  get writeAnalysisTags(): boolean;
+  set writeAnalysisTags(value: boolean);
+
+  /**
+   * Let the output limiter detect peaks on the 4x oversampled signal, so inter-sample peaks are limited as well
+   * and do not clip after lossy encoding.
+   *
+   * @default false
+   */
+  get truePeakLimiter(): boolean;
+  set truePeakLimiter(value: boolean);
+
+  /**
+   * Record a timeline of decks loading, scanning, read-ahead, audio callbacks and transition states,
+   * use `getTrace()` to retrieve it.
+   *
+   * Recording is shared by all instances in the process.
+   *
+   * @default false
+   */
+  get tracing(): boolean;
+  set tracing(value: boolean);
+
   /**
    * Start the engine, also clear the `paused` state.
    */
@@ -237,6 +351,29 @@ export declare class Medley<T extends TrackInfo = TrackInfo> {
 
   getDeckPositions(index: DeckIndex): DeckPositions;
 
+  /**
+   * Realtime performance counters, collected since the engine was created
+   */
+  getStats(): Stats;
+
+  /**
+   * Recorded timeline as Chrome trace-event JSON, can be opened with `chrome://tracing` or https://ui.perfetto.dev
+   *
+   * @param clear Discard the recorded events after returning them
+   */
+  getTrace(clear?: boolean): string;
+
+  /**
+   * Snapshot of the engine state, decks positions and audio levels.
+   *
+   * The engine publishes the state into memory shared with JS every ~5ms,
+   * reading it does not call into the native module, so it is cheap enough to be polled by every frame of a UI.
+   *
+   * Where external buffers are not allowed, like in Electron, the memory cannot be shared,
+   * each call then copies the latest state from the native module instead.
+   */
+  getState(): EngineState;
+
   async requestAudioStream(options?: RequestAudioOptions): Promise<RequestAudioStreamResult>;
 
   updateAudioStream(id: RequestAudioResult['id'], options: UpdateAudioStreamOptions): boolean;
@@ -244,22 +381,180 @@ export declare class Medley<T extends TrackInfo = TrackInfo> {
   deleteAudioStream(id: number): boolean;
 
   getFx(type: 'karaoke'): KaraokeParams;
+  getFx(type: 'multiband'): MultibandParams;
   getFx(type: any): never;
 
   setFx(type: 'karaoke', params: KaraokeUpdateParams): boolean;
+  setFx(type: 'multiband', params: MultibandUpdateParams): boolean;
   setFx(type: any, params: never): false;
 
+  /**
+   * Processing nodes of the main output, they run after the karaoke effect and before the limiter
+   */
+  getGraph(): GraphNodeInfo[];
+
+  /**
+   * Replace all processing nodes of the main output, nodes having the same `id` and `type` as an existing one keep their state.
+   *
+   * The change takes effect at the next audio block, without interrupting the audio.
+   */
+  setGraph(nodes: GraphNodeDescriptor[]): boolean;
+
+  /**
+   * Change parameters of a single node, values are clamped to their ranges
+   *
+   * @returns `false` if there is no node with such id
+   */
+  setGraphParams(id: string, params: Record<string, number>): boolean;
+
   static getMetadata(path: string): Metadata | undefined;
 
   static getAudioProperties(path: string, readMode?: AudioPropertiesReadMode): AudioProperties;
 
-  static getCoverAndLyrics(path: string): CoverAndLyrics;
+  static getCoverAndLyrics(path: string, options?: CoverOptions): CoverAndLyrics;
+
+  /**
+   * Sniff the format from the file header, it must be the format of the file extension, and parse the first frames, a decoder is only created with the `deep` option
+   */
+  static isTrackLoadable(track: TrackDescriptor<any>, options?: LoadableOptions): boolean;
+
+  /**
+   * Same as `getMetadata`, but the file is read on a native thread pool without blocking the event loop
+   */
+  static getMetadataAsync(path: string, options?: AsyncReadOptions): Promise<Metadata>;
+
+  /**
+   * Same as `getAudioProperties`, but the file is read on a native thread pool without blocking the event loop
+   */
+  static getAudioPropertiesAsync(path: string, readMode?: AudioPropertiesReadMode, options?: AsyncReadOptions): Promise<AudioProperties>;
+
+  /**
+   * Same as `getCoverAndLyrics`, but the file is read on a native thread pool without blocking the event loop
+   */
+  static getCoverAndLyricsAsync(path: string, options?: CoverOptions & AsyncReadOptions): Promise<CoverAndLyrics>;
+
+  /**
+   * Same as `isTrackLoadable`, but the track is probed on a native thread pool without blocking the event loop
+   */
+  static isTrackLoadableAsync(track: TrackDescriptor<any>, options?: LoadableOptions & AsyncReadOptions): Promise<boolean>;
 
-  static isTrackLoadable(track: TrackDescriptor<any>): boolean;
+  /**
+   * Read the requested fields of a track with the file opened and parsed only once
+   */
+  static probe(path: string, options?: ProbeOptions): ProbeResult;
+
+  /**
+   * Same as `probe`, but the file is read on a native thread pool without blocking the event loop
+   */
+  static probeAsync(path: string, options?: ProbeOptions & AsyncReadOptions): Promise<ProbeResult>;
+
+  /**
+   * Probe files one after another in a single task, results are in the same order as `paths`
+   *
+   * Intended for library scans, submitting several batches at once lets them run in parallel
+   */
+  static probeAllAsync(paths: string[], options?: ProbeOptions & AsyncReadOptions): Promise<ProbeResult[]>;
 
   static getInfo(): MedleyInfo;
 }
 
+/**
+ * Keeps track of the audio files under directories, only what was added, changed or removed since the previous scan is reported
+ */
+export declare class LibraryScanner {
+  constructor(options?: LibraryScannerOptions);
+
+  /**
+   * Number of files known
+   */
+  readonly size: number;
+
+  /**
+   * Walk directories in parallel on native threads, tags are read only for files not seen before or modified since.
+   * Paths may also be files
+   *
+   * Directories scanned are watched by `watch`
+   */
+  scan(paths: string[]): Promise<LibraryChanges>;
+
+  /**
+   * Keep watching the scanned directories, `listener` is called with the changes once they have settled.
+   * Calling `watch` again replaces the listener
+   *
+   * Uses inotify on Linux, elsewhere the directories are scanned again every `pollInterval`
+   */
+  watch(listener: (changes: LibraryChanges) => void): void;
+
+  unwatch(): void;
+
+  /**
+   * Write the state to `stateFile`, this is done after every scan that found changes
+   */
+  save(): boolean;
+
+  /**
+   * Forget every known file, the next scan reports all of them as added
+   */
+  reset(): void;
+}
+
+export type LibraryScannerOptions = {
+  /**
+   * Where the known files are persisted, so the first scan after a restart is incremental as well
+   */
+  stateFile?: string;
+
+  /**
+   * File extensions to scan
+   *
+   * @default Extensions of every supported format
+   */
+  extensions?: string[];
+
+  /**
+   * Threads walking directories and reading tags
+   *
+   * @default Number of CPUs, between 2 and 8
+   */
+  threads?: number;
+
+  /**
+   * Milliseconds without file system events before changes are scanned and reported
+   *
+   * @default 1000
+   */
+  debounce?: number;
+
+  /**
+   * Milliseconds between scans where inotify is not available
+   *
+   * @default 60000
+   */
+  pollInterval?: number;
+}
+
+export type ScannedFile = {
+  path: string;
+
+  /**
+   * Modification time, in milliseconds since the epoch
+   */
+  modified: number;
+
+  size: number;
+
+  /**
+   * Not set if the tags could not be read
+   */
+  tags?: Metadata;
+}
+
+export type LibraryChanges = {
+  added: ScannedFile[];
+  changed: ScannedFile[];
+  removed: string[];
+}
+
 export type MedleyInfo = {
   runtime: {
     file: string;
@@ -320,12 +615,39 @@ export type RequestAudioOptions = {
    */
   gain?: number;
 
+  /**
+   * Limit the inter-sample peaks of this stream, see `Medley.truePeakLimiter`
+   *
+   * @default false
+   */
+  truePeakLimiter?: boolean;
+
+  /**
+   * Add triangular (TPDF) dither when converting to `Int16LE` or `Int16BE`, has no effect on float formats
+   *
+   * @default false
+   */
+  dither?: boolean;
+
+  /**
+   * Shape the dither noise with first order error feedback, only applies when `dither` is enabled
+   *
+   * @default false
+   */
+  noiseShaping?: boolean;
+
+  /**
+   * Processing nodes for this stream, see `Medley.setGraph()`
+   */
+  graph?: GraphNodeDescriptor[];
+
   fx?: {
     karaoke?: KaraokeUpdateParams;
+    multiband?: MultibandUpdateParams;
   }
 }
 
-export type UpdateAudioStreamOptions = Partial<Pick<RequestAudioOptions, 'buffering' | 'gain' | 'fx'>>;
+export type UpdateAudioStreamOptions = Partial<Pick<RequestAudioOptions, 'buffering' | 'gain' | 'truePeakLimiter' | 'dither' | 'noiseShaping' | 'graph' | 'fx'>>;
 
 export type RequestAudioResult = {
   readonly id: number;
@@ -346,10 +668,18 @@ export type RequestAudioStreamResult = RequestAudioResult & {
   getLatency(): number;
 
   getFx(type: 'karaoke'): KaraokeParams | undefined;
+  getFx(type: 'multiband'): MultibandParams | undefined;
   getFx(type: any): never;
 
   setFx(type: 'karaoke', params: KaraokeUpdateParams): boolean;
+  setFx(type: 'multiband', params: MultibandUpdateParams): boolean;
   setFx(type: any, params: never): false;
+
+  getGraph(): GraphNodeInfo[];
+
+  setGraph(nodes: GraphNodeDescriptor[]): boolean;
+
+  setGraphParams(id: string, params: Record<string, number>): boolean;
 }
 
 export type NullAudioDeviceDescriptor = {
@@ -382,6 +712,88 @@ export type Metadata = {
   comments: [string, string][];
 }
 
+export type ProbeField = 'tags' | 'gain' | 'properties' | 'cover' | 'lyrics' | 'loadable';
+
+export type LoadableOptions = {
+  /**
+   * Create a decoder to tell whether the track is loadable, some decoders scan the whole file to be created
+   *
+   * @default false
+   */
+  deep?: boolean;
+}
+
+export type ProbeOptions = LoadableOptions & {
+  /**
+   * Fields to read, only what is asked for is parsed
+   *
+   * @default All fields
+   */
+  fields?: ProbeField[];
+
+  /**
+   * @default 'fast'
+   */
+  readMode?: AudioPropertiesReadMode;
+}
+
+export type ProbeResult = {
+  /**
+   * With the `tags` field
+   */
+  tags?: Metadata;
+
+  /**
+   * With the `gain` field, positions are in seconds
+   */
+  gain?: {
+    trackGain?: number;
+    cueIn?: number;
+    cueOut?: number;
+    lastAudible?: number;
+  };
+
+  /**
+   * With the `properties` field
+   */
+  properties?: AudioProperties;
+
+  /**
+   * With the `cover` field
+   */
+  cover?: Buffer;
+  coverMimeType?: string;
+
+  /**
+   * With the `lyrics` field
+   */
+  lyrics?: string;
+
+  /**
+   * With the `loadable` field
+   */
+  loadable?: boolean;
+
+  /**
+   * Set if the file could not be opened or parsed
+   */
+  error?: string;
+}
+
+export type AsyncReadOptions = {
+  /**
+   * Reject with an error if the read has not completed within this number of milliseconds
+   *
+   * A read that has not started yet is cancelled, a running one cannot be interrupted and its result is discarded
+   */
+  timeout?: number;
+
+  /**
+   * Abort the read, the promise is rejected with the abort reason
+   */
+  signal?: AbortSignal;
+}
+
 export type AudioPropertiesReadMode = 'fast' | 'average' | 'accurate';
 
 export type AudioProperties = {
@@ -393,9 +805,38 @@ export type AudioProperties = {
 
 export type MetadataFields = keyof Metadata;
 
+export type CoverOptions = {
+  /**
+   * Return the full cover picture, the hash and the thumbnail are enough to tell covers apart and to show them
+   *
+   * @default true
+   */
+  fullCover?: boolean;
+
+  /**
+   * Also return a thumbnail fitting in this number of pixels in both dimensions, cached by the cover hash
+   */
+  thumbnailSize?: number;
+}
+
 export type CoverAndLyrics = {
+  /**
+   * Empty without a cover or with `fullCover: false`
+   */
   cover: Buffer;
   coverMimeType: string;
+
+  /**
+   * Hash of the cover picture data, identical covers have the same hash
+   */
+  coverHash?: string;
+
+  /**
+   * With the `thumbnailSize` option, JPEG or PNG if the cover has transparency
+   */
+  thumbnail?: Buffer;
+  thumbnailMimeType?: string;
+
   lyrics: string;
 }
 
@@ -434,6 +875,139 @@ export type DeckPositions = {
   transitionEnd?: number;
 }
 
+/**
+ * Distribution of a timing measurement, all values are in milliseconds
+ *
+ * Percentiles are approximated by power-of-two buckets
+ */
+export type StatsHistogram = {
+  count: number;
+  mean: number;
+  min: number;
+  max: number;
+  p50: number;
+  p90: number;
+  p99: number;
+
+  /**
+   * Number of values below zero, e.g. a transition started early, they are not part of the other fields
+   */
+  negative: number;
+}
+
+export type DeckStats = {
+  /**
+   * Amount of audio ready in the deck's read-ahead buffer
+   */
+  bufferedSeconds: number;
+
+  /**
+   * Number of audio blocks requested while the read-ahead buffer was not ready
+   */
+  underruns: number;
+
+  /**
+   * Time spent loading tracks
+   */
+  load: StatsHistogram;
+
+  /**
+   * Time spent scanning tracks for silence and cue points
+   */
+  scan: StatsHistogram;
+}
+
+export type AudioStreamStats = {
+  /**
+   * Number of frames waiting to be consumed
+   */
+  ready: number;
+
+  capacity: number;
+
+  /**
+   * Number of frames discarded because the stream did not consume fast enough
+   */
+  droppedSamples: number;
+
+  overflows: number;
+
+  /**
+   * Time spent in the stream's post processor
+   */
+  process: StatsHistogram;
+}
+
+export type Stats = {
+  mixer: {
+    /**
+     * Time spent in the audio callback, including decks and post processing
+     */
+    callback: StatsHistogram;
+
+    postProcessor: StatsHistogram;
+
+    /**
+     * Proportion of the audio callback period spent in processing, 0.0 - 1.0
+     */
+    cpu: number;
+  };
+
+  interceptor: {
+    /**
+     * Number of blocks waiting to be delivered to audio streams
+     */
+    depth: number;
+    maxDepth: number;
+  };
+
+  transition: {
+    /**
+     * Delay between the planned start of the next deck and when it was actually started
+     */
+    lateness: StatsHistogram;
+  };
+
+  decks: DeckStats[];
+
+  audioRequests: Record<number, AudioStreamStats>;
+}
+
+export type DeckState = Required<DeckPositions> & {
+  loaded: boolean;
+  playing: boolean;
+
+  /**
+   * Whether this deck is the main deck
+   */
+  main: boolean;
+
+  volume: number;
+
+  /**
+   * Output level of this deck
+   */
+  level: AudioLevels;
+}
+
+export type EngineState = {
+  playing: boolean;
+  paused: boolean;
+  mainDeck?: DeckIndex;
+  volume: number;
+
+  /**
+   * Reduction level in dB
+   */
+  reduction: number;
+
+  level: AudioLevels;
+
+  loudness: Loudness;
+
+  decks: DeckState[];
+}
+
 export type KaraokeParams = {
   enabled: boolean;
   mix: number;
@@ -447,4 +1021,50 @@ export type KaraokeUpdateParams = Partial<KaraokeParams & {
   dontTransit?: boolean;
 }>;
 
+/**
+ * - `gentle` - Light AGC and 2:1 compression, keeps most of the dynamics
+ * - `broadcast` - Dense and loud, for music stations
+ * - `speech` - Tighter AGC with the low end reduced and presence lifted, for talk programs
+ */
+export type MultibandPreset = 'gentle' | 'broadcast' | 'speech';
+
+export type MultibandParams = {
+  enabled: boolean;
+  preset: MultibandPreset;
+
+  /**
+   * Current gain of each band from low to high, AGC and compression combined, in dB
+   */
+  readonly gains: number[];
+}
+
+export type MultibandUpdateParams = Partial<Omit<MultibandParams, 'gains'>>;
+
+/**
+ * - `eq` - Low shelf, peak and high shelf
+ *    - `lowFrequency` (20 - 1000Hz, default 100), `lowGain` (dB, -24 - 24, default 0)
+ *    - `midFrequency` (100 - 10000Hz, default 1000), `midGain` (dB, -24 - 24, default 0), `midQ` (0.1 - 10, default 0.7071)
+ *    - `highFrequency` (1000 - 20000Hz, default 8000), `highGain` (dB, -24 - 24, default 0)
+ * - `width` - Stereo width
+ *    - `width` (0 - 2, default 1), 0 is mono
+ * - `gain`
+ *    - `gain` (dB, -24 - 24, default 0)
+ */
+export type GraphNodeType = 'eq' | 'width' | 'gain';
+
+export type GraphNodeDescriptor = {
+  type: GraphNodeType;
+
+  /**
+   * Identifies the node across `setGraph()` calls, defaults to `<type>-<index>`
+   */
+  id?: string;
+
+  bypassed?: boolean;
+
+  params?: Record<string, number>;
+}
+
+export type GraphNodeInfo = Required<GraphNodeDescriptor>;
+
 export declare function createMedley<T extends TrackInfo = TrackInfo>(options?: MedleyOptions): { medley: Medley<T>, queue: Queue<T> };
@@ -1,7 +1,7 @@
 import { EventEmitter } from 'node:events';
 import { basename, dirname } from 'node:path';
 import { Readable } from 'node:stream';
-import type { AudioFormat, MedleyOptions, Medley as MedleyType, Queue as QueueType, RequestAudioOptions, RequestAudioResult, RequestAudioStreamResult, TrackInfo } from './index.d';
+import type { AsyncReadOptions, AudioFormat, AudioLevels, AudioPropertiesReadMode, CoverOptions, DeckState, EngineState, LoadableOptions, MedleyOptions, Medley as MedleyType, ProbeOptions, Queue as QueueType, RequestAudioOptions, RequestAudioResult, RequestAudioStreamResult, TrackDescriptor, TrackInfo } from './index.d';
 
 const nodeGypBuild = require('node-gyp-build');
 const module_id = process.env.MEDLEY_DEV ? dirname(__dirname) : __dirname;
@@ -10,6 +10,7 @@ const medley = nodeGypBuild(module_id);
 
 export const Medley = medley.Medley;
 export const Queue = medley.Queue;
+export const LibraryScanner = medley.LibraryScanner;
 
 Object.setPrototypeOf(Medley.prototype, EventEmitter.prototype);
 
@@ -25,6 +26,74 @@ Medley.getInfo = function() {
   }
 };
 
+type TaskHandle<T> = {
+  id: number;
+  promise: Promise<T>;
+}
+
+const runTask = <T>({ id, promise }: TaskHandle<T>, { timeout, signal }: AsyncReadOptions = {}): Promise<T> => {
+  if (!timeout && !signal) {
+    return promise;
+  }
+
+  return new Promise<T>((resolve, reject) => {
+    let timer: NodeJS.Timeout | undefined;
+
+    const cleanup = () => {
+      clearTimeout(timer);
+      signal?.removeEventListener('abort', onAbort);
+    }
+
+    // The native promise is rejected as well, it is still observed below so the rejection is handled
+    const cancel = (reason: unknown) => {
+      cleanup();
+      Medley.$cancelTask(id);
+      reject(reason);
+    }
+
+    const onAbort = () => cancel(signal?.reason ?? new Error('Aborted'));
+
+    promise.then(
+      (value) => {
+        cleanup();
+        resolve(value);
+      },
+      (error) => {
+        cleanup();
+        reject(error);
+      }
+    );
+
+    if (signal?.aborted) {
+      onAbort();
+      return;
+    }
+
+    signal?.addEventListener('abort', onAbort, { once: true });
+
+    if (timeout) {
+      timer = setTimeout(() => cancel(new Error(`Timed out after ${timeout}ms`)), timeout);
+    }
+  });
+}
+
+Medley.getMetadataAsync = (path: string, options?: AsyncReadOptions) => runTask(Medley.$getMetadataAsync(path), options);
+
+Medley.getAudioPropertiesAsync = (path: string, readMode?: AudioPropertiesReadMode, options?: AsyncReadOptions) => runTask(Medley.$getAudioPropertiesAsync(path, readMode), options);
+
+Medley.getCoverAndLyricsAsync = (path: string, options?: CoverOptions & AsyncReadOptions) => runTask(Medley.$getCoverAndLyricsAsync(path, options), options);
+
+Medley.isTrackLoadableAsync = (track: TrackDescriptor<any>, options?: LoadableOptions & AsyncReadOptions) => runTask(Medley.$isTrackLoadableAsync(track, options), options);
+
+Medley.probeAsync = (path: string, options?: ProbeOptions & AsyncReadOptions) => runTask(Medley.$probeAsync(path, options), options);
+
+Medley.probeAllAsync = (paths: string[], options?: ProbeOptions & AsyncReadOptions) => runTask(Medley.$probeAllAsync(paths, options), options);
+
+// Not cancellable, files reported by a discarded scan would never be reported again
+LibraryScanner.prototype.scan = function(paths: string[]) {
+  return this.$scan(paths).promise;
+}
+
 export const audioFormats = ['Int16LE', 'Int16BE', 'FloatLE', 'FloatBE'] as const;
 
 const formatToBytesPerSample = (format: AudioFormat) => {
@@ -128,7 +197,10 @@ Medley.prototype.requestAudioStream = async function(options: RequestAudioOption
 
     },
     getFx: type => this['*$reqAudio$getFx'](streamId, type) as never,
-    setFx: (type, params) => this['*$reqAudio$setFx'](streamId, type, params)
+    setFx: (type, params) => this['*$reqAudio$setFx'](streamId, type, params),
+    getGraph: () => this['*$reqAudio$getGraph'](streamId),
+    setGraph: (nodes) => this['*$reqAudio$setGraph'](streamId, nodes),
+    setGraphParams: (id, params) => this['*$reqAudio$setGraphParams'](streamId, id, params)
   }
 
   audioStreamResults.set(streamId, streamResult);
@@ -150,6 +222,108 @@ Medley.prototype.deleteAudioStream = function(id: number) {
   return result;
 }
 
+const stateLayoutVersion = 2;
+const engineStateFields = 19;
+const deckStateFields = 19;
+
+type StateReader = (() => EngineState) & { buffer: ArrayBuffer };
+
+const stateReaders = new WeakMap<object, StateReader>();
+
+/**
+ * @param refresh Copies the latest state into the buffer before each read, when it is a copy rather than memory shared with the engine
+ */
+const createStateReader = (buffer: ArrayBuffer, refresh?: () => void): StateReader => {
+  const header = new Int32Array(buffer, 0, 2);
+  const values = new Float64Array(buffer, 8);
+  const copy = new Float64Array(values.length);
+
+  if (header[1] !== stateLayoutVersion) {
+    throw new Error(`Unsupported state layout version: ${header[1]}`);
+  }
+
+  // level[2], peak[2] and rms[2] are laid out one after another
+  const readLevels = (offset: number): AudioLevels => ({
+    left: { magnitude: copy[offset], peak: copy[offset + 2], rms: copy[offset + 4] },
+    right: { magnitude: copy[offset + 1], peak: copy[offset + 3], rms: copy[offset + 5] }
+  });
+
+  const readDeck = (offset: number): DeckState => ({
+    loaded: copy[offset] !== 0,
+    playing: copy[offset + 1] !== 0,
+    main: copy[offset + 2] !== 0,
+    volume: copy[offset + 3],
+    current: copy[offset + 4],
+    duration: copy[offset + 5],
+    first: copy[offset + 6],
+    last: copy[offset + 7],
+    leading: copy[offset + 8],
+    trailing: copy[offset + 9],
+    cuePoint: copy[offset + 10],
+    transitionStart: copy[offset + 11],
+    transitionEnd: copy[offset + 12],
+    level: readLevels(offset + 13)
+  });
+
+  const reader = () => {
+    refresh?.();
+
+    // Seqlock, the sequence is odd while the engine is writing
+    for (;;) {
+      const before = Atomics.load(header, 0);
+
+      if ((before & 1) === 0) {
+        copy.set(values);
+
+        if (Atomics.load(header, 0) === before) {
+          break;
+        }
+      }
+    }
+
+    const mainDeck = copy[2];
+
+    return {
+      playing: copy[0] !== 0,
+      paused: copy[1] !== 0,
+      mainDeck: mainDeck >= 0 ? mainDeck : undefined,
+      volume: copy[3],
+      reduction: copy[4],
+      level: readLevels(5),
+      loudness: {
+        momentary: copy[11],
+        shortTerm: copy[12],
+        integrated: copy[13],
+        correlation: copy[14],
+        truePeak: {
+          left: copy[15],
+          right: copy[16]
+        },
+        maxTruePeak: {
+          left: copy[17],
+          right: copy[18]
+        }
+      },
+      decks: [0, 1, 2].map(index => readDeck(engineStateFields + index * deckStateFields))
+    } as EngineState;
+  }
+
+  return Object.assign(reader, { buffer });
+}
+
+Medley.prototype.getState = function() {
+  let reader = stateReaders.get(this);
+
+  // A detached buffer reads as empty, the native side hands out a new one
+  if (!reader || reader.buffer.byteLength === 0) {
+    const { buffer, shared } = this['*$getStateBuffer']() as { buffer: ArrayBuffer, shared: boolean };
+    reader = createStateReader(buffer, shared ? undefined : () => this['*$copyState']());
+    stateReaders.set(this, reader);
+  }
+
+  return reader();
+}
+
 export function createMedley<T extends TrackInfo = TrackInfo>(options?: MedleyOptions) {
   const queue = new Queue() as QueueType<T>;
   const medley = new Medley(queue, options) as MedleyType<T>;
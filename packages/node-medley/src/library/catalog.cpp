@@ -0,0 +1,339 @@
+#include "catalog.h"
+#include <atomic>
+#include <functional>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+namespace library {
+
+Catalog::Catalog(juce::AudioFormatManager& formatMgr, const juce::StringArray& extensions, int numThreads)
+    :
+    formatMgr(formatMgr),
+    extensions(extensions),
+    pool(juce::jmax(1, numThreads))
+{
+
+}
+
+Changes Catalog::scan(const juce::StringArray& paths)
+{
+    const juce::ScopedLock scanSl(scanLock);
+
+    Changes changes;
+
+    juce::CriticalSection walkLock;
+    std::set<juce::String> seen;
+    std::set<juce::String> visited;
+    std::set<juce::String> unlisted;
+
+    // The caller holds one, so the count cannot drop to zero while directories are still being submitted
+    std::atomic<int> pending{ 1 };
+    juce::WaitableEvent done;
+
+    std::function<void(const juce::File&)> walk;
+
+    auto submit = [&](const juce::File& dir) {
+        {
+            const juce::ScopedLock sl(walkLock);
+
+            // Symbolic links may lead back to a directory already walked
+            if (!visited.insert(dir.getLinkedTarget().getFullPathName()).second) {
+                return;
+            }
+        }
+
+        pending++;
+
+        pool.addJob([&, dir] {
+            walk(dir);
+
+            if (--pending == 0) {
+                done.signal();
+            }
+        });
+    };
+
+    auto visit = [&](const juce::File& file, const FileState& state) {
+        if (!isAudioFile(file)) {
+            return;
+        }
+
+        {
+            const juce::ScopedLock sl(walkLock);
+            seen.insert(file.getFullPathName());
+        }
+
+        visitFile(file, state, changes);
+    };
+
+    walk = [&](const juce::File& dir) {
+        // Listing an unreadable directory yields nothing, which must not be taken as all of its files being gone
+        if (!dir.hasReadAccess()) {
+            const juce::ScopedLock sl(walkLock);
+            unlisted.insert(dir.getFullPathName());
+            return;
+        }
+
+        for (const auto& entry : juce::RangedDirectoryIterator(dir, false, "*", juce::File::findFilesAndDirectories | juce::File::ignoreHiddenFiles)) {
+            if (entry.isDirectory()) {
+                submit(entry.getFile());
+                continue;
+            }
+
+            visit(entry.getFile(), { entry.getModificationTime().toMilliseconds(), entry.getFileSize() });
+        }
+    };
+
+    for (auto& path : paths) {
+        juce::File file(path);
+
+        if (file.isDirectory()) {
+            submit(file);
+        }
+        else if (file.existsAsFile()) {
+            visit(file, { file.getLastModificationTime().toMilliseconds(), file.getSize() });
+        }
+    }
+
+    if (--pending == 0) {
+        done.signal();
+    }
+
+    done.wait();
+
+    for (auto& path : paths) {
+        juce::File root(path);
+
+        if (canRemoveUnder(root, unlisted)) {
+            removeMissing(root.getFullPathName(), seen, unlisted, changes);
+        }
+    }
+
+    return changes;
+}
+
+bool Catalog::isAudioFile(const juce::File& file) const
+{
+    return extensions.contains(file.getFileExtension(), true);
+}
+
+void Catalog::visitFile(const juce::File& file, const FileState& state, Changes& changes)
+{
+    auto path = file.getFullPathName();
+    bool known;
+
+    {
+        const juce::ScopedLock sl(lock);
+
+        auto it = files.find(path);
+
+        if (it != files.end() && it->second == state) {
+            return;
+        }
+
+        known = it != files.end();
+    }
+
+    ScannedFile scanned;
+    scanned.path = path;
+    scanned.state = state;
+
+    // Tags are read outside of the lock, this is where the time goes
+    auto probe = medley::TrackInfoCache::probe(formatMgr, file, medley::TrackProbe::Tags);
+
+    if (probe->getError().isEmpty()) {
+        scanned.metadata = probe->getMetadata();
+        scanned.hasMetadata = true;
+    }
+
+    const juce::ScopedLock sl(lock);
+
+    files[path] = state;
+    (known ? changes.changed : changes.added).push_back(std::move(scanned));
+}
+
+bool Catalog::canRemoveUnder(const juce::File& root, const std::set<juce::String>& unlisted)
+{
+    if (!root.exists()) {
+        return root.getParentDirectory().exists();
+    }
+
+    if (!root.isDirectory()) {
+        return true;
+    }
+
+    auto path = root.getFullPathName();
+
+    // A mount point left behind by an unmounted drive is usually empty
+    if (unlisted.count(path) || root.getNumberOfChildFiles(juce::File::findFilesAndDirectories | juce::File::ignoreHiddenFiles) == 0) {
+        return false;
+    }
+
+    auto device = getDeviceId(root);
+
+    if (device == 0) {
+        return true;
+    }
+
+    const juce::ScopedLock sl(lock);
+
+    // Directories reported by the watcher are compared against the scanned directory they are under
+    auto it = std::find_if(devices.begin(), devices.end(), [&](const auto& entry) {
+        return path == entry.first || path.startsWith(entry.first + juce::File::getSeparatorString());
+    });
+
+    if (it == devices.end()) {
+        devices[path] = device;
+        return true;
+    }
+
+    // Something else is mounted there, the files known on the previous device are kept for when it comes back
+    return it->second == device;
+}
+
+void Catalog::removeMissing(const juce::String& path, const std::set<juce::String>& seen, const std::set<juce::String>& unlisted, Changes& changes)
+{
+    const juce::ScopedLock sl(lock);
+
+    auto isUnlisted = [&](const juce::String& filePath) {
+        return std::any_of(unlisted.begin(), unlisted.end(), [&](const juce::String& dir) {
+            return filePath.startsWith(dir + juce::File::getSeparatorString());
+        });
+    };
+
+    auto remove = [&](std::map<juce::String, FileState>::iterator it) {
+        if (seen.count(it->first) || isUnlisted(it->first)) {
+            return std::next(it);
+        }
+
+        changes.removed.add(it->first);
+        return files.erase(it);
+    };
+
+    auto exact = files.find(path);
+
+    if (exact != files.end()) {
+        remove(exact);
+    }
+
+    // Not a single range from path, "a b" sorts between "a" and "a/"
+    auto prefix = path + juce::File::getSeparatorString();
+
+    for (auto it = files.lower_bound(prefix); it != files.end() && it->first.startsWith(prefix);) {
+        it = remove(it);
+    }
+}
+
+bool Catalog::load(const juce::File& file)
+{
+    juce::FileInputStream in(file);
+
+    if (in.failedToOpen()) {
+        return false;
+    }
+
+    auto firstLine = in.readNextLine();
+
+    if (firstLine != header) {
+        return false;
+    }
+
+    std::map<juce::String, FileState> loaded;
+    std::map<juce::String, juce::uint64> loadedDevices;
+
+    // modified, size and path separated by tabs, one file per line.
+    // Scanned directories are "device", their device id and path
+    while (!in.isExhausted()) {
+        auto line = in.readNextLine();
+
+        auto modifiedEnd = line.indexOfChar('\t');
+        auto sizeEnd = modifiedEnd >= 0 ? line.indexOfChar(modifiedEnd + 1, '\t') : -1;
+
+        if (sizeEnd < 0) {
+            continue;
+        }
+
+        if (line.startsWith("device\t")) {
+            loadedDevices[line.substring(sizeEnd + 1)] = (juce::uint64)line.substring(modifiedEnd + 1, sizeEnd).getLargeIntValue();
+            continue;
+        }
+
+        loaded[line.substring(sizeEnd + 1)] = {
+            line.substring(0, modifiedEnd).getLargeIntValue(),
+            line.substring(modifiedEnd + 1, sizeEnd).getLargeIntValue()
+        };
+    }
+
+    const juce::ScopedLock sl(lock);
+    files = std::move(loaded);
+    devices = std::move(loadedDevices);
+
+    return true;
+}
+
+bool Catalog::save(const juce::File& file) const
+{
+    juce::TemporaryFile temp(file);
+
+    {
+        juce::FileOutputStream out(temp.getFile());
+
+        if (out.failedToOpen()) {
+            return false;
+        }
+
+        out << header << "\n";
+
+        {
+            const juce::ScopedLock sl(lock);
+
+            for (auto& [path, device] : devices) {
+                out << "device\t" << juce::String((juce::int64)device) << "\t" << path << "\n";
+            }
+
+            for (auto& [path, state] : files) {
+                out << juce::String(state.modified) << "\t" << juce::String(state.size) << "\t" << path << "\n";
+            }
+        }
+
+        out.flush();
+
+        if (out.getStatus().failed()) {
+            return false;
+        }
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+void Catalog::clear()
+{
+    const juce::ScopedLock sl(lock);
+    files.clear();
+    devices.clear();
+}
+
+size_t Catalog::size() const
+{
+    const juce::ScopedLock sl(lock);
+    return files.size();
+}
+
+juce::uint64 Catalog::getDeviceId(const juce::File& file)
+{
+#ifdef _WIN32
+    return (juce::uint64)(juce::uint32)file.getVolumeSerialNumber();
+#else
+    struct stat st;
+
+    if (stat(file.getFullPathName().toRawUTF8(), &st) != 0) {
+        return 0;
+    }
+
+    return (juce::uint64)st.st_dev;
+#endif
+}
+
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <Metadata.h>
+#include <TrackInfoCache.h>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace library {
+
+struct FileState {
+    juce::int64 modified = 0;
+    juce::int64 size = 0;
+
+    bool operator==(const FileState& other) const { return modified == other.modified && size == other.size; }
+    bool operator!=(const FileState& other) const { return !operator==(other); }
+};
+
+struct ScannedFile {
+    juce::String path;
+    FileState state;
+    medley::Metadata metadata;
+    // Tags could be read
+    bool hasMetadata = false;
+};
+
+struct Changes {
+    std::vector<ScannedFile> added;
+    std::vector<ScannedFile> changed;
+    juce::StringArray removed;
+
+    bool isEmpty() const { return added.empty() && changed.empty() && removed.isEmpty(); }
+};
+
+/**
+ * Every audio file known under the scanned directories, with its modification time and size
+ *
+ * Scanning only reads the tags of files not seen before or modified since, what is known can be persisted between restarts
+ * so the first scan after a restart is incremental as well.
+ */
+class Catalog {
+public:
+    /**
+     * extensions are like ".mp3", files with other extensions are ignored
+     */
+    Catalog(juce::AudioFormatManager& formatMgr, const juce::StringArray& extensions, int numThreads);
+
+    /**
+     * Directories are walked in parallel, paths may also be files. Known files under them that are gone are reported as removed,
+     * unless they were under a directory that could not be listed
+     */
+    Changes scan(const juce::StringArray& paths);
+
+    bool load(const juce::File& file);
+
+    /**
+     * Written to a temporary file first, the previous state is never left half written
+     */
+    bool save(const juce::File& file) const;
+
+    void clear();
+
+    size_t size() const;
+
+private:
+    bool isAudioFile(const juce::File& file) const;
+
+    /**
+     * Called from the walking threads
+     */
+    void visitFile(const juce::File& file, const FileState& state, Changes& changes);
+
+    /**
+     * Whether what is known under a scanned path can be trusted to be gone when it was not seen.
+     *
+     * An unmounted drive must not empty the catalog: not if the path and its parent are both gone,
+     * nor if the path is a directory that is empty, could not be listed or is no longer on the device it was on
+     */
+    bool canRemoveUnder(const juce::File& root, const std::set<juce::String>& unlisted);
+
+    /**
+     * Directories that could not be listed are in unlisted, nothing under them is removed
+     */
+    void removeMissing(const juce::String& path, const std::set<juce::String>& seen, const std::set<juce::String>& unlisted, Changes& changes);
+
+    static juce::uint64 getDeviceId(const juce::File& file);
+
+    static constexpr const char* header = "medley-library 1";
+
+    juce::AudioFormatManager& formatMgr;
+    juce::StringArray extensions;
+    juce::ThreadPool pool;
+
+    // Held for a whole scan, the watcher and an explicit scan never report the same change twice
+    juce::CriticalSection scanLock;
+
+    juce::CriticalSection lock;
+    std::map<juce::String, FileState> files;
+
+    // Device of each scanned directory, when it was last listed
+    std::map<juce::String, juce::uint64> devices;
+};
+
+}
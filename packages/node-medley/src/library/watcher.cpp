@@ -0,0 +1,207 @@
+#include "watcher.h"
+
+#ifdef __linux__
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
+
+namespace library {
+
+Watcher::Watcher(Callback callback, int debounceMs, int pollIntervalMs)
+    :
+    juce::Thread("Library Watcher"),
+    callback(callback),
+    debounceMs(debounceMs),
+    pollIntervalMs(pollIntervalMs)
+{
+#ifdef __linux__
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+
+    startThread();
+}
+
+Watcher::~Watcher()
+{
+    // Never killed, the callback may be in the middle of a scan
+    stopThread(-1);
+
+#ifdef __linux__
+    if (fd >= 0) {
+        close(fd);
+    }
+#endif
+}
+
+void Watcher::stop()
+{
+    signalThreadShouldExit();
+    notify();
+}
+
+bool Watcher::isNative()
+{
+#ifdef __linux__
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Watcher::watch(const juce::StringArray& newDirectories)
+{
+    const juce::ScopedLock sl(lock);
+
+    for (auto& dir : newDirectories) {
+        if (directories.contains(dir)) {
+            continue;
+        }
+
+        directories.add(dir);
+
+#ifdef __linux__
+        addWatches(juce::File(dir));
+#endif
+    }
+}
+
+void Watcher::flush()
+{
+    juce::StringArray paths;
+
+    {
+        const juce::ScopedLock sl(lock);
+
+        if (pending.isEmpty() || juce::Time::getMillisecondCounter() - lastEventTime < (juce::uint32)debounceMs) {
+            return;
+        }
+
+        paths.swapWith(pending);
+    }
+
+    callback(paths);
+}
+
+#ifdef __linux__
+
+namespace {
+    constexpr uint32_t changeMask = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+}
+
+void Watcher::addWatches(const juce::File& dir)
+{
+    if (fd < 0) {
+        return;
+    }
+
+    auto wd = inotify_add_watch(fd, dir.getFullPathName().toRawUTF8(), changeMask | IN_ONLYDIR);
+
+    if (wd < 0) {
+        return;
+    }
+
+    // Already watched, through a symbolic link for example
+    if (!watches.emplace(wd, dir.getFullPathName()).second) {
+        return;
+    }
+
+    for (const auto& entry : juce::RangedDirectoryIterator(dir, false, "*", juce::File::findDirectories | juce::File::ignoreHiddenFiles)) {
+        addWatches(entry.getFile());
+    }
+}
+
+void Watcher::readEvents()
+{
+    alignas(inotify_event) char buffer[64 * 1024];
+
+    for (;;) {
+        auto len = read(fd, buffer, sizeof(buffer));
+
+        if (len <= 0) {
+            return;
+        }
+
+        const juce::ScopedLock sl(lock);
+
+        for (char* p = buffer; p < buffer + len;) {
+            auto event = reinterpret_cast<inotify_event*>(p);
+            p += sizeof(inotify_event) + event->len;
+
+            // Events were dropped, everything must be looked at again
+            if (event->mask & IN_Q_OVERFLOW) {
+                pending.addArray(directories);
+                continue;
+            }
+
+            auto it = watches.find(event->wd);
+
+            if (it == watches.end()) {
+                continue;
+            }
+
+            if (event->mask & IN_IGNORED) {
+                watches.erase(it);
+                continue;
+            }
+
+            // The files of an unmounted drive are not gone, nothing else than a change of the files is looked at
+            if ((event->mask & IN_UNMOUNT) || !(event->mask & changeMask)) {
+                continue;
+            }
+
+            auto path = event->len > 0 ? juce::File(it->second).getChildFile(juce::String::fromUTF8(event->name)).getFullPathName() : it->second;
+
+            // Hidden files are not scanned either
+            if (event->len > 0 && event->name[0] == '.') {
+                continue;
+            }
+
+            if ((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO))) {
+                addWatches(juce::File(path));
+            }
+
+            pending.addIfNotAlreadyThere(path);
+        }
+
+        lastEventTime = juce::Time::getMillisecondCounter();
+    }
+}
+
+#endif
+
+void Watcher::run()
+{
+    while (!threadShouldExit()) {
+#ifdef __linux__
+        if (fd >= 0) {
+            pollfd pfd{ fd, POLLIN, 0 };
+
+            if (poll(&pfd, 1, juce::jmin(250, debounceMs)) > 0 && (pfd.revents & POLLIN)) {
+                readEvents();
+                continue;
+            }
+
+            flush();
+            continue;
+        }
+#endif
+
+        // Without inotify, the directories are reported as a whole
+        wait(pollIntervalMs);
+
+        if (threadShouldExit()) {
+            break;
+        }
+
+        {
+            const juce::ScopedLock sl(lock);
+            pending.addArray(directories);
+            lastEventTime = 0;
+        }
+
+        flush();
+    }
+}
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <map>
+
+namespace library {
+
+/**
+ * Tells which paths under the watched directories have changed, after they have settled for a while
+ *
+ * inotify is used on Linux, directories created later are watched as well.
+ * Elsewhere the watched directories are reported as a whole every poll interval, to be scanned incrementally.
+ */
+class Watcher : private juce::Thread {
+public:
+    /**
+     * Called on the watcher thread, paths are files or directories that may have been added, changed or removed
+     */
+    using Callback = std::function<void(const juce::StringArray& paths)>;
+
+    Watcher(Callback callback, int debounceMs, int pollIntervalMs);
+
+    /**
+     * Blocks until the watcher thread has stopped, which may take a whole scan
+     */
+    ~Watcher() override;
+
+    void watch(const juce::StringArray& directories);
+
+    /**
+     * Ask the watcher thread to stop without waiting for it
+     */
+    void stop();
+
+    static bool isNative();
+
+private:
+    void run() override;
+
+    void flush();
+
+    Callback callback;
+    int debounceMs;
+    int pollIntervalMs;
+
+    juce::CriticalSection lock;
+    juce::StringArray directories;
+    juce::StringArray pending;
+    juce::uint32 lastEventTime = 0;
+
+#ifdef __linux__
+    void addWatches(const juce::File& dir);
+
+    void readEvents();
+
+    int fd = -1;
+
+    // Guarded by lock
+    std::map<int, juce::String> watches;
+#endif
+};
+
+}
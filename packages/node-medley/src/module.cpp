@@ -1,11 +1,16 @@
 #include <napi.h>
 #include "core.h"
+#include "scanner.h"
+#include "addon.h"
 
 using namespace Napi;
 
 Object Init(Env env, Object exports) {
+    env.SetInstanceData(new AddonData(env));
+
     Medley::Initialize(exports);
     Queue::Initialize(exports);
+    LibraryScanner::Initialize(exports);
     return exports;
 }
 
@@ -2,24 +2,37 @@
 
 FunctionReference Queue::ctor;
 
+namespace {
+    std::vector<Track::Ptr> tracksFromJS(const Napi::Value p) {
+        std::vector<Track::Ptr> tracks;
+
+        if (p.IsArray()) {
+            auto arr = p.As<Napi::Array>();
+            tracks.reserve(arr.Length());
+
+            for (uint32_t index = 0; index < arr.Length(); index++) {
+                tracks.push_back(Track::fromJS(arr.Get(index)));
+            }
+        } else if (!p.IsUndefined() && !p.IsNull()) {
+            tracks.push_back(Track::fromJS(p));
+        }
+
+        return tracks;
+    }
+}
+
 Queue::Queue(const CallbackInfo& info)
     : ObjectWrap<Queue>(info)
 {
-    auto p = info[0];
-
-    if (p.IsArray()) {
-        auto arr = p.As<Napi::Array>();
-        for (uint32_t index = 0; index < arr.Length(); index++) {
-            Arr::add(Track::fromJS(arr.Get(index)));
-        }
-    } else if (!p.IsUndefined() && !p.IsNull()) {
-        Arr::add(Track::fromJS(p));
-    }
+    auto initial = tracksFromJS(info[0]);
+    tracks.assign(initial.begin(), initial.end());
+    numTracks = tracks.size();
 }
 
 void Queue::Initialize(Object& exports) {
     auto proto = {
         InstanceAccessor<&Queue::length>("length"),
+        InstanceAccessor<&Queue::version>("version"),
 
         InstanceMethod<&Queue::add>("add"),
         InstanceMethod<&Queue::clear>("clear"),
@@ -43,11 +56,42 @@ void Queue::Initialize(Object& exports) {
 }
 
 medley::ITrack::Ptr Queue::fetchNextTrack() {
-    if (!Arr::isEmpty()) {
-        return removeAndReturn(0);
+    juce::ScopedLock sl(lock);
+
+    if (tracks.empty()) {
+        return nullptr;
+    }
+
+    medley::ITrack::Ptr track = tracks.front();
+    tracks.pop_front();
+    changed();
+
+    return track;
+}
+
+medley::ITrack::Ptr Queue::peek(size_t index) const {
+    juce::ScopedLock sl(lock);
+    return index < tracks.size() ? tracks[index] : nullptr;
+}
+
+std::shared_ptr<const Queue::Snapshot> Queue::getSnapshot() const {
+    juce::ScopedLock sl(lock);
+
+    auto v = currentVersion.load(std::memory_order_relaxed);
+
+    if (snapshot == nullptr || snapshot->version != v) {
+        auto s = std::make_shared<Snapshot>();
+        s->version = v;
+        s->tracks.assign(tracks.begin(), tracks.end());
+        snapshot = std::move(s);
     }
 
-    return nullptr;
+    return snapshot;
+}
+
+void Queue::changed() {
+    numTracks.store(tracks.size(), std::memory_order_release);
+    currentVersion.fetch_add(1, std::memory_order_release);
 }
 
 void Queue::add(const CallbackInfo& info) {
@@ -58,29 +102,32 @@ void Queue::add(const CallbackInfo& info) {
         return;
     }
 
-    auto p = info[0];
+    // Tracks are created from JS objects before taking the lock
+    auto added = tracksFromJS(info[0]);
 
-    if (!p.IsArray()) {
-        Arr::add(Track::fromJS(p));
-        return;
+    {
+        juce::ScopedLock sl(lock);
+        tracks.insert(tracks.end(), added.begin(), added.end());
+        changed();
     }
 
-    auto arr = p.As<Napi::Array>();
-    auto tracks = std::make_unique<Track::Ptr[]>(arr.Length());
-
-    for (uint32_t index = 0; index < arr.Length(); index++) {
-        tracks[index] = Track::fromJS(arr.Get(index));
-    }
-
-    Arr::addArray(tracks.get(), arr.Length());
+    notifyChanged();
 }
 
 void Queue::clear(const CallbackInfo& info) {
-    Arr::clear();
+    std::deque<Track::Ptr> removed;
+
+    {
+        juce::ScopedLock sl(lock);
+        removed.swap(tracks);
+        changed();
+    }
+
+    notifyChanged();
 }
 
 Napi::Value Queue::isEmpty(const CallbackInfo& info) {
-    return Napi::Boolean::New(info.Env(), Arr::isEmpty());
+    return Napi::Boolean::New(info.Env(), count() == 0);
 }
 
 void Queue::insert(const CallbackInfo& info) {
@@ -91,53 +138,114 @@ void Queue::insert(const CallbackInfo& info) {
         return;
     }
 
-    auto at = info[0].ToNumber().Uint32Value();
-    auto p = info[1];
+    auto at = info[0].ToNumber().Int32Value();
+    auto inserted = tracksFromJS(info[1]);
 
-    if (p.IsArray()) {
-        auto arr = p.As<Napi::Array>();
+    {
+        juce::ScopedLock sl(lock);
 
-        auto tracks = std::make_unique<Track::Ptr[]>(arr.Length());
+        // Out of range, append
+        auto pos = (at >= 0 && (size_t)at <= tracks.size()) ? tracks.begin() + at : tracks.end();
 
-        for (uint32_t index = 0; index < arr.Length(); index++) {
-            tracks[index] = Track::fromJS(arr.Get(index));
-        }
-
-        Arr::insertArray(at, tracks.get(), arr.Length());
-    } else if (!p.IsUndefined() && !p.IsNull()) {
-        Arr::insert(at, Track::fromJS(p));
+        tracks.insert(pos, inserted.begin(), inserted.end());
+        changed();
     }
+
+    notifyChanged();
 }
 
-void Queue::del(const CallbackInfo& info) {{
+void Queue::del(const CallbackInfo& info) {
     if (info.Length() >= 2) {
-        auto from = info[0].ToNumber();
-        auto count = info[1].ToNumber();
+        auto from = info[0].ToNumber().Int32Value();
+        auto count = info[1].ToNumber().Int32Value();
 
-        Arr::removeRange(from, count);
+        {
+            juce::ScopedLock sl(lock);
+
+            auto size = (int64_t)tracks.size();
+            auto end = juce::jlimit<int64_t>(0, size, (int64_t)from + count);
+            auto start = juce::jlimit<int64_t>(0, size, from);
+
+            if (end > start) {
+                tracks.erase(tracks.begin() + start, tracks.begin() + end);
+            }
+
+            changed();
+        }
+
+        notifyChanged();
         return;
     }
 
-
     if (info.Length() > 0) {
-        auto p = info[0];
-        auto index = p.ToNumber().Int32Value();
+        auto index = info[0].ToNumber().Int32Value();
+
+        {
+            juce::ScopedLock sl(lock);
+
+            if (index < 0 || (size_t)index >= tracks.size()) {
+                return;
+            }
 
-        if (index >= 0 && index < size()) {
-            Arr::remove(index);
+            tracks.erase(tracks.begin() + index);
+            changed();
         }
+
+        notifyChanged();
     }
-}}
+}
 
 void Queue::swap(const CallbackInfo& info) {
     if (info.Length() >= 2) {
-        Arr::swap(info[0].ToNumber(), info[1].ToNumber());
+        auto index1 = info[0].ToNumber().Int32Value();
+        auto index2 = info[1].ToNumber().Int32Value();
+
+        {
+            juce::ScopedLock sl(lock);
+
+            auto size = (int32_t)tracks.size();
+
+            if (index1 >= 0 && index1 < size && index2 >= 0 && index2 < size) {
+                std::swap(tracks[index1], tracks[index2]);
+            }
+
+            changed();
+        }
+
+        notifyChanged();
     }
 }
 
 void Queue::move(const CallbackInfo& info) {
     if (info.Length() >= 2) {
-        Arr::move(info[0].ToNumber(), info[1].ToNumber());
+        auto currentIndex = info[0].ToNumber().Int32Value();
+        auto newIndex = info[1].ToNumber().Int32Value();
+
+        {
+            juce::ScopedLock sl(lock);
+
+            auto size = (int32_t)tracks.size();
+
+            if (currentIndex >= 0 && currentIndex < size) {
+                // Out of range, move to the end
+                if (newIndex < 0 || newIndex >= size) {
+                    newIndex = size - 1;
+                }
+
+                auto first = tracks.begin() + currentIndex;
+                auto last = tracks.begin() + newIndex;
+
+                if (currentIndex < newIndex) {
+                    std::rotate(first, first + 1, last + 1);
+                } else if (currentIndex > newIndex) {
+                    std::rotate(last, first, first + 1);
+                }
+            }
+
+            changed();
+        }
+
+        notifyChanged();
     }
 }
 
@@ -145,9 +253,12 @@ Napi::Value Queue::get(const CallbackInfo& info) {
     auto env = info.Env();
 
     if (info.Length() >= 1) {
-        int32_t index = info[0].ToNumber();
-        if (index >= 0 && index < size()) {
-            return Arr::getUnchecked(index)->toObject(env);
+        auto index = info[0].ToNumber().Int32Value();
+
+        if (index >= 0) {
+            if (auto track = peek((size_t)index)) {
+                return static_cast<Track*>(track.get())->toObject(env);
+            }
         }
     }
 
@@ -156,22 +267,34 @@ Napi::Value Queue::get(const CallbackInfo& info) {
 
 void Queue::set(const CallbackInfo& info) {
     if (info.Length() >= 2) {
-        int32_t index = info[0].ToNumber();
-        if (index >= 0 && index < size()) {
-            auto p = info[1];
-            Arr::setUnchecked(index, Track::fromJS(p));
+        auto index = info[0].ToNumber().Int32Value();
+        auto track = Track::fromJS(info[1]);
+
+        {
+            juce::ScopedLock sl(lock);
+
+            if (index < 0 || (size_t)index >= tracks.size()) {
+                return;
+            }
+
+            tracks[index] = track;
+            changed();
         }
+
+        notifyChanged();
     }
 }
 
 Napi::Value Queue::toArray(const CallbackInfo& info) {
     auto env = info.Env();
 
-    auto result = Napi::Array::New(env, size());
+    // The lock is only held while taking the snapshot, JS objects are created from it
+    auto s = getSnapshot();
+    auto result = Napi::Array::New(env, s->tracks.size());
 
-    for (auto index = 0; index < size(); index++) {
-        result[index] = Arr::getUnchecked(index)->toObject(env);
+    for (uint32_t index = 0; index < s->tracks.size(); index++) {
+        result[index] = s->tracks[index]->toObject(env);
     }
 
     return result;
-}
\ No newline at end of file
+}
@@ -1,24 +1,58 @@
 #pragma once
 
 #include <napi.h>
+#include <deque>
 #include "track.h"
 
 using namespace Napi;
 
-class Queue : public ObjectWrap<Queue>, public juce::Array<Track::Ptr>, public medley::IQueue {
+/**
+ * Modified from JS on the main thread, consumed by the engine from its own threads
+ *
+ * Every access to the tracks goes through a lock, count() is lock-free.
+ * Tracks fetched by the engine are released wherever the engine drops them, their JS objects are released later on the JS thread, see Track.
+ */
+class Queue : public ObjectWrap<Queue>, public medley::IQueue {
 public:
-    using Arr = juce::Array<Track::Ptr>;
+    class Listener {
+    public:
+        virtual ~Listener() = default;
+
+        /**
+         * Called on the JS thread after the queue was modified from JS
+         */
+        virtual void queueChanged() = 0;
+    };
+
+    /**
+     * The tracks as they were at a version of the queue, immutable
+     */
+    struct Snapshot {
+        uint32_t version = 0;
+        std::vector<Track::Ptr> tracks;
+    };
 
     static void Initialize(Object& exports);
     static FunctionReference ctor;
 
     Queue(const CallbackInfo& info);
 
-    size_t count() const {
-        return size();
+    size_t count() const override {
+        return numTracks.load(std::memory_order_acquire);
     }
 
-    medley::ITrack::Ptr fetchNextTrack();
+    medley::ITrack::Ptr fetchNextTrack() override;
+
+    medley::ITrack::Ptr peek(size_t index) const override;
+
+    /**
+     * Shared until the queue changes, the version is incremented on every change, including tracks fetched by the engine
+     */
+    std::shared_ptr<const Snapshot> getSnapshot() const;
+
+    void addListener(Listener* listener) { listeners.add(listener); }
+
+    void removeListener(Listener* listener) { listeners.remove(listener); }
 
     void add(const CallbackInfo& info);
 
@@ -43,4 +77,28 @@ public:
     Napi::Value length(const CallbackInfo& info) {
         return Number::New(info.Env(), count());
     }
+
+    Napi::Value version(const CallbackInfo& info) {
+        return Number::New(info.Env(), currentVersion.load(std::memory_order_acquire));
+    }
+
+private:
+    /**
+     * Must be called with the lock held
+     */
+    void changed();
+
+    void notifyChanged() {
+        listeners.call([](Listener& l) { l.queueChanged(); });
+    }
+
+    juce::CriticalSection lock;
+    std::deque<Track::Ptr> tracks;
+
+    std::atomic<size_t> numTracks{ 0 };
+    std::atomic<uint32_t> currentVersion{ 0 };
+
+    mutable std::shared_ptr<const Snapshot> snapshot;
+
+    juce::ListenerList<Listener> listeners;
 };
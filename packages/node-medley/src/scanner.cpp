@@ -0,0 +1,235 @@
+#include "scanner.h"
+#include "core.h"
+
+void LibraryScanner::Initialize(Object& exports) {
+    auto proto = {
+        InstanceAccessor<&LibraryScanner::size>("size"),
+
+        InstanceMethod<&LibraryScanner::scan>("$scan"),
+        InstanceMethod<&LibraryScanner::watch>("watch"),
+        InstanceMethod<&LibraryScanner::unwatch>("unwatch"),
+        InstanceMethod<&LibraryScanner::save>("save"),
+        InstanceMethod<&LibraryScanner::reset>("reset")
+    };
+
+    auto env = exports.Env();
+    exports.Set("LibraryScanner", DefineClass(env, "LibraryScanner", proto));
+}
+
+LibraryScanner::LibraryScanner(const CallbackInfo& info)
+    : ObjectWrap<LibraryScanner>(info)
+{
+    auto options = info[0].IsObject() ? info[0].ToObject() : Object::New(info.Env());
+
+    auto extensions = Medley::getSupportedExtensions();
+
+    if (options.Get("extensions").IsArray()) {
+        auto arr = options.Get("extensions").As<Napi::Array>();
+        extensions.clear();
+
+        for (uint32_t i = 0; i < arr.Length(); i++) {
+            auto ext = juce::String(arr.Get(i).ToString().Utf8Value());
+            extensions.add(ext.startsWithChar('.') ? ext : "." + ext);
+        }
+    }
+
+    auto numThreads = options.Get("threads").IsNumber()
+        ? options.Get("threads").ToNumber().Int32Value()
+        : juce::jlimit(2, 8, juce::SystemStats::getNumCpus());
+
+    if (options.Get("debounce").IsNumber()) {
+        debounceMs = juce::jmax(0, options.Get("debounce").ToNumber().Int32Value());
+    }
+
+    if (options.Get("pollInterval").IsNumber()) {
+        pollIntervalMs = juce::jmax(1000, options.Get("pollInterval").ToNumber().Int32Value());
+    }
+
+    catalog = std::make_shared<library::Catalog>(Medley::getSupportedFormats(), extensions, numThreads);
+
+    if (options.Get("stateFile").IsString()) {
+        stateFile = juce::File(juce::String(options.Get("stateFile").ToString().Utf8Value()));
+
+        // A missing or unreadable state means a full scan, not an error
+        catalog->load(stateFile);
+    }
+}
+
+LibraryScanner::~LibraryScanner() {
+    stopWatching();
+}
+
+Napi::Value LibraryScanner::scan(const CallbackInfo& info) {
+    auto env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsArray()) {
+        TypeError::New(env, "Insufficient parameter").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    auto arr = info[0].As<Napi::Array>();
+    juce::StringArray paths;
+
+    for (uint32_t i = 0; i < arr.Length(); i++) {
+        auto path = juce::File(juce::String(arr.Get(i).ToString().Utf8Value())).getFullPathName();
+
+        paths.add(path);
+        directories.addIfNotAlreadyThere(path);
+    }
+
+    if (watcher) {
+        watcher->watch(paths);
+    }
+
+    auto catalog = this->catalog;
+    auto stateFile = this->stateFile;
+    auto changes = std::make_shared<library::Changes>();
+
+    return track_req::TaskPool::submit(
+        env,
+        [catalog, stateFile, paths, changes] {
+            *changes = catalog->scan(paths);
+
+            if (stateFile != juce::File() && !changes->isEmpty()) {
+                catalog->save(stateFile);
+            }
+        },
+        [changes](Napi::Env env) -> Napi::Value {
+            return createJSChanges(env, *changes);
+        }
+    );
+}
+
+void LibraryScanner::watch(const CallbackInfo& info) {
+    auto env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsFunction()) {
+        TypeError::New(env, "Insufficient parameter").ThrowAsJavaScriptException();
+        return;
+    }
+
+    stopWatching();
+
+    listener = std::make_shared<Listener>();
+    listener->tsfn = ThreadSafeFunction::New(env, info[0].As<Function>(), "Medley::LibraryScanner", 0, 1);
+
+    auto catalog = this->catalog;
+    auto stateFile = this->stateFile;
+    auto listener = this->listener;
+
+    watcher = std::make_unique<library::Watcher>(
+        [catalog, stateFile, listener](const juce::StringArray& paths) {
+            auto changes = std::make_shared<library::Changes>(catalog->scan(paths));
+
+            if (changes->isEmpty()) {
+                return;
+            }
+
+            if (stateFile != juce::File()) {
+                catalog->save(stateFile);
+            }
+
+            const juce::ScopedLock sl(listener->lock);
+
+            if (!listener->active) {
+                return;
+            }
+
+            listener->tsfn.NonBlockingCall([changes, listener](Napi::Env env, Function fn) {
+                // Unwatched while the call was queued
+                if (listener->active) {
+                    fn.Call({ createJSChanges(env, *changes) });
+                }
+            });
+        },
+        debounceMs,
+        pollIntervalMs
+    );
+
+    watcher->watch(directories);
+
+    self = Persistent(Value());
+}
+
+void LibraryScanner::unwatch(const CallbackInfo& info) {
+    stopWatching();
+}
+
+void LibraryScanner::stopWatching() {
+    if (listener) {
+        // Nothing is called through the function once released, a scan still in flight drops its changes
+        {
+            const juce::ScopedLock sl(listener->lock);
+            listener->active = false;
+        }
+
+        listener->tsfn.Release();
+        listener = nullptr;
+    }
+
+    if (watcher) {
+        watcher->stop();
+
+        // Stopping waits for the scan in flight, if any, the JS thread is not held for it
+        juce::Thread::launch([w = watcher.release()] {
+            delete w;
+        });
+    }
+
+    self.Reset();
+}
+
+Napi::Value LibraryScanner::save(const CallbackInfo& info) {
+    auto env = info.Env();
+
+    if (stateFile == juce::File()) {
+        return Boolean::New(env, false);
+    }
+
+    return Boolean::New(env, catalog->save(stateFile));
+}
+
+void LibraryScanner::reset(const CallbackInfo& info) {
+    catalog->clear();
+
+    if (stateFile != juce::File()) {
+        stateFile.deleteFile();
+    }
+}
+
+Napi::Value LibraryScanner::size(const CallbackInfo& info) {
+    return Number::New(info.Env(), (double)catalog->size());
+}
+
+Napi::Object LibraryScanner::createJSChanges(Napi::Env env, const library::Changes& changes) {
+    auto toJS = [env](const std::vector<library::ScannedFile>& files) {
+        auto arr = Napi::Array::New(env, files.size());
+
+        for (size_t i = 0; i < files.size(); i++) {
+            auto& file = files[i];
+            auto obj = Object::New(env);
+
+            obj.Set("path", Napi::String::New(env, file.path.toStdString()));
+            obj.Set("modified", Napi::Number::New(env, (double)file.state.modified));
+            obj.Set("size", Napi::Number::New(env, (double)file.state.size));
+            obj.Set("tags", file.hasMetadata ? Medley::toJSMetadata(env, file.metadata) : env.Undefined());
+
+            arr.Set((uint32_t)i, obj);
+        }
+
+        return arr;
+    };
+
+    auto removed = Napi::Array::New(env, changes.removed.size());
+
+    for (int i = 0; i < changes.removed.size(); i++) {
+        removed.Set((uint32_t)i, Napi::String::New(env, changes.removed[i].toStdString()));
+    }
+
+    auto result = Object::New(env);
+    result.Set("added", toJS(changes.added));
+    result.Set("changed", toJS(changes.changed));
+    result.Set("removed", removed);
+
+    return result;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <napi.h>
+#include "library/catalog.h"
+#include "library/watcher.h"
+
+using namespace Napi;
+
+class LibraryScanner : public ObjectWrap<LibraryScanner> {
+public:
+    static void Initialize(Object& exports);
+
+    LibraryScanner(const CallbackInfo& info);
+
+    ~LibraryScanner();
+
+    /**
+     * Returns { id, promise } of a task on the track_req pool
+     */
+    Napi::Value scan(const CallbackInfo& info);
+
+    void watch(const CallbackInfo& info);
+
+    void unwatch(const CallbackInfo& info);
+
+    Napi::Value save(const CallbackInfo& info);
+
+    void reset(const CallbackInfo& info);
+
+    Napi::Value size(const CallbackInfo& info);
+
+private:
+    void stopWatching();
+
+    static Napi::Object createJSChanges(Napi::Env env, const library::Changes& changes);
+
+    // Shared with the scan tasks and the watcher, they may outlive this object
+    std::shared_ptr<library::Catalog> catalog;
+
+    juce::File stateFile;
+    int debounceMs = 1000;
+    int pollIntervalMs = 60000;
+
+    // Scanned so far, watched by watch()
+    juce::StringArray directories;
+
+    /**
+     * Shared with the watcher callback, the function is never called once unwatched
+     */
+    struct Listener {
+        juce::CriticalSection lock;
+        ThreadSafeFunction tsfn;
+        bool active = true;
+    };
+
+    std::unique_ptr<library::Watcher> watcher;
+    std::shared_ptr<Listener> listener;
+
+    // Not garbage collected while watching
+    ObjectReference self;
+};
@@ -0,0 +1,71 @@
+#include "track.h"
+#include "addon.h"
+
+std::shared_ptr<Track::Releaser> Track::Releaser::create(Napi::Env env) {
+    std::shared_ptr<Releaser> releaser(new Releaser());
+    releaser->threadId = std::this_thread::get_id();
+
+    // Called on the JS thread as the environment goes away, the finalizer keeps the releaser alive until then
+    releaser->tsfn = Napi::ThreadSafeFunction::New(
+        env,
+        Napi::Function::New(env, [](const Napi::CallbackInfo&) {}),
+        "Medley::Track",
+        0, 1,
+        [releaser](Napi::Env) {
+            std::vector<Napi::ObjectReference> refs;
+
+            juce::ScopedLock sl(releaser->lock);
+            releaser->closed = true;
+            refs.swap(releaser->pending);
+        }
+    );
+
+    // Must not keep the event loop alive
+    releaser->tsfn.Unref(env);
+
+    return releaser;
+}
+
+void Track::Releaser::release(Napi::ObjectReference&& ref) {
+    juce::ScopedLock sl(lock);
+
+    if (closed) {
+        ref.SuppressDestruct();
+        return;
+    }
+
+    auto scheduled = !pending.empty();
+    pending.push_back(std::move(ref));
+
+    // One call releases everything handed over until it runs
+    if (!scheduled) {
+        tsfn.NonBlockingCall([self = shared_from_this()](Napi::Env env, Napi::Function) {
+            // Without an environment the call is being dropped, the finalizer takes care of what is pending
+            if (env != nullptr) {
+                self->releasePending();
+            }
+        });
+    }
+}
+
+void Track::Releaser::releasePending() {
+    std::vector<Napi::ObjectReference> refs;
+
+    juce::ScopedLock sl(lock);
+    refs.swap(pending);
+}
+
+Track::Track(const Napi::Object& obj)
+    : ref(Napi::Persistent(obj)),
+    releaser(AddonData::get(obj.Env()).trackReleaser)
+{
+    initFromJS();
+}
+
+Track::~Track() {
+    if (ref.IsEmpty() || releaser == nullptr || releaser->isJSThread()) {
+        return;
+    }
+
+    releaser->release(std::move(ref));
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <napi.h>
+#include <thread>
 #include "Medley.h"
 
 class Track : public medley::ITrack {
@@ -13,15 +14,43 @@ public:
 
     }
 
-    ~Track() {
+    /**
+     * Releases the JS objects of tracks dropped off the JS thread, there is one for each Node environment (main thread and workers)
+     */
+    class Releaser : public std::enable_shared_from_this<Releaser> {
+    public:
+        /**
+         * JS thread
+         */
+        static std::shared_ptr<Releaser> create(Napi::Env env);
 
-    }
+        bool isJSThread() const { return std::this_thread::get_id() == threadId; }
 
-    Track(const Napi::Object& obj)
-        : ref(Napi::Persistent(obj))
-    {
-        initFromJS();
-    }
+        /**
+         * Any thread, the reference is released later on the JS thread.
+         * Once the environment is gone the reference went along with it, it is left alone
+         */
+        void release(Napi::ObjectReference&& ref);
+
+    private:
+        Releaser() = default;
+
+        void releasePending();
+
+        std::thread::id threadId;
+        Napi::ThreadSafeFunction tsfn;
+
+        juce::CriticalSection lock;
+        std::vector<Napi::ObjectReference> pending;
+        bool closed = false;
+    };
+
+    /**
+     * The JS object can only be released on the JS thread of its environment, when dropped from another thread it is handed over to that thread
+     */
+    ~Track() override;
+
+    Track(const Napi::Object& obj);
 
     bool operator== (const Track& other) const {
         return ref == other.ref;
@@ -89,6 +118,7 @@ private:
     }
 
     Napi::ObjectReference ref;
+    std::shared_ptr<Releaser> releaser;
     File file;
     double cueIn = -1.0;
     double cueOut = -1.0;
@@ -0,0 +1,133 @@
+#include "pool.h"
+#include "../addon.h"
+
+namespace track_req {
+
+TaskPool::TaskPool()
+    : pool(numThreads)
+{
+
+}
+
+TaskPool::~TaskPool()
+{
+    pool.removeAllJobs(true, -1);
+}
+
+TaskPool& TaskPool::get(Napi::Env env)
+{
+    return AddonData::get(env).taskPool;
+}
+
+Napi::Object TaskPool::submit(Napi::Env env, Work work, Result result)
+{
+    auto& self = get(env);
+    auto& entries = self.entries;
+
+    auto id = ++self.nextId;
+    auto deferred = Napi::Promise::Deferred::New(env);
+
+    auto task = std::make_shared<Task>();
+    task->work = std::move(work);
+
+    entries.emplace(id, Entry{ task, std::move(result), deferred });
+
+    // Keeps the event loop alive until the task has been handed back
+    auto tsfn = Napi::ThreadSafeFunction::New(
+        env,
+        Napi::Function::New(env, [](const Napi::CallbackInfo&) {}),
+        "Medley::TaskPool",
+        0,
+        1
+    );
+
+    self.pool.addJob([id, task, tsfn]() mutable {
+        auto expected = State::Pending;
+
+        if (task->state.compare_exchange_strong(expected, State::Running)) {
+            run(*task);
+        }
+
+        tsfn.BlockingCall([id](Napi::Env env, Napi::Function) {
+            // The environment is being torn down
+            if (env == nullptr) {
+                return;
+            }
+
+            get(env).settle(env, id);
+        });
+
+        tsfn.Release();
+    });
+
+    auto handle = Napi::Object::New(env);
+    handle.Set("id", Napi::Number::New(env, id));
+    handle.Set("promise", deferred.Promise());
+    return handle;
+}
+
+bool TaskPool::cancel(Napi::Env env, uint32_t id)
+{
+    auto& entries = get(env).entries;
+    auto it = entries.find(id);
+
+    if (it == entries.end() || it->second.settled) {
+        return false;
+    }
+
+    auto& entry = it->second;
+
+    entry.task->state = State::Cancelled;
+    entry.settled = true;
+    entry.deferred.Reject(Napi::Error::New(env, "Cancelled").Value());
+
+    // The entry stays until the pool hands the task back
+    return true;
+}
+
+void TaskPool::run(Task& task)
+{
+    try {
+        task.work();
+    }
+    catch (std::exception const& e) {
+        task.failed = true;
+        task.error = e.what();
+    }
+    catch (...) {
+        task.failed = true;
+        task.error = "Error reading file";
+    }
+}
+
+void TaskPool::settle(Napi::Env env, uint32_t id)
+{
+    auto it = entries.find(id);
+
+    if (it == entries.end()) {
+        return;
+    }
+
+    auto entry = std::move(it->second);
+    entries.erase(it);
+
+    if (entry.settled) {
+        return;
+    }
+
+    auto& task = *entry.task;
+
+    if (task.failed) {
+        entry.deferred.Reject(Napi::Error::New(env, task.error.toStdString()).Value());
+        return;
+    }
+
+    try {
+        entry.deferred.Resolve(entry.result(env));
+    }
+    catch (const Napi::Error& e) {
+        entry.deferred.Reject(e.Value());
+    }
+}
+
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <napi.h>
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+#include <map>
+
+namespace track_req {
+
+/**
+ * Runs blocking track reads (TagLib, decoders) on a dedicated thread pool and settles a Promise on the JS thread,
+ * so a slow file never blocks the event loop nor the libuv pool shared with fs.
+ *
+ * A task can be cancelled until it settles, a cancelled task that has not started is never run,
+ * a running one cannot be interrupted but its result is discarded.
+ *
+ * There is one pool for each Node environment (main thread and workers), it is owned by AddonData.
+ */
+class TaskPool {
+public:
+    TaskPool();
+
+    /**
+     * Waits for the running tasks, the pending ones are dropped
+     */
+    ~TaskPool();
+
+    /**
+     * Worker thread, may throw
+     */
+    using Work = std::function<void()>;
+
+    /**
+     * JS thread, called once the work has completed without throwing
+     */
+    using Result = std::function<Napi::Value(Napi::Env)>;
+
+    /**
+     * JS thread, returns { id, promise }
+     */
+    static Napi::Object submit(Napi::Env env, Work work, Result result);
+
+    /**
+     * JS thread, rejects the promise of the task. Returns false if the task has already settled
+     */
+    static bool cancel(Napi::Env env, uint32_t id);
+
+    static int getNumThreads() { return numThreads; }
+
+private:
+    enum class State : uint8_t {
+        Pending, Running, Cancelled
+    };
+
+    struct Task {
+        Work work;
+        std::atomic<State> state{ State::Pending };
+        juce::String error;
+        bool failed = false;
+    };
+
+    struct Entry {
+        std::shared_ptr<Task> task;
+        Result result;
+        Napi::Promise::Deferred deferred;
+        bool settled = false;
+    };
+
+    static void run(Task& task);
+
+    static TaskPool& get(Napi::Env env);
+
+    void settle(Napi::Env env, uint32_t id);
+
+    static constexpr int numThreads = 4;
+
+    juce::ThreadPool pool;
+
+    // JS thread only
+    uint32_t nextId = 0;
+    std::map<uint32_t, Entry> entries;
+};
+
+}
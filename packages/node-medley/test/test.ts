@@ -1,5 +1,10 @@
-import { createMedley, Medley } from '..';
-import { extname } from 'node:path';
+import { createMedley, LibraryScanner, Medley, Queue } from '..';
+import type { LibraryChanges } from '..';
+import { copyFileSync, mkdtempSync, rmSync, unlinkSync } from 'node:fs';
+import { tmpdir } from 'node:os';
+import { extname, join } from 'node:path';
+import type { Readable } from 'node:stream';
+import { Worker } from 'node:worker_threads';
 import test, { ExecutionContext } from 'ava';
 
 test.serial('Native module loading', t => {
@@ -19,6 +24,64 @@ const middlec = [
   { ext: 'aiff', sampleRate: 44100 }
 ]
 
+const waitUntil = async (condition: () => boolean, timeout = 5000) => {
+  const deadline = Date.now() + timeout;
+
+  while (!condition()) {
+    if (Date.now() > deadline) {
+      throw new Error(`Condition not met after ${timeout}ms`);
+    }
+
+    await new Promise(resolve => setTimeout(resolve, 10));
+  }
+}
+
+const readBytes = (stream: Readable, numBytes: number) => new Promise<Buffer>(resolve => {
+  const chunks: Buffer[] = [];
+  let size = 0;
+
+  const onData = (chunk: Buffer) => {
+    chunks.push(chunk);
+    size += chunk.length;
+
+    if (size >= numBytes) {
+      stream.off('data', onData);
+      stream.pause();
+
+      resolve(Buffer.concat(chunks).subarray(0, numBytes));
+    }
+  }
+
+  stream.on('data', onData);
+});
+
+const readSamples = async (stream: Readable, numSamples: number) => {
+  const bytes = await readBytes(stream, numSamples * 4);
+  return new Float32Array(bytes.buffer.slice(bytes.byteOffset, bytes.byteOffset + bytes.length));
+}
+
+const rms = (samples: Float32Array) => Math.sqrt(samples.reduce((sum, v) => sum + v * v, 0) / samples.length);
+
+const createNullMedley = (t: ExecutionContext) => {
+  const result = createMedley({ skipDeviceScanning: true });
+
+  t.true(
+    result.medley.setAudioDevice({ type: 'Null', device: 'Null Device' }),
+    'Null audio device'
+  );
+
+  return result;
+}
+
+// Resolves once the first track is actually playing
+const startPlaying = async (t: ExecutionContext, medley: Medley, queue: Queue, paths = [tracks[0]]) => {
+  queue.add(paths);
+
+  const started = new Promise(resolve => medley.once('started', resolve));
+  t.true(medley.play());
+  await started;
+}
+
 for (const track of tracks) {
   test.serial(`${extname(track).toUpperCase().substring(1)} Track loading`, t => {
     t.true(Medley.isTrackLoadable(track));
@@ -37,6 +100,29 @@ test.serial('Exotic MP3 tracks loading', async t => {
 
    for (const [track, result] of testTracks) {
     t.is(Medley.isTrackLoadable(__dirname + '/' + track), result, track);
+    t.is(Medley.isTrackLoadable(__dirname + '/' + track, { deep: true }), result, track);
+  }
+});
+
+test.serial('Mislabeled tracks loading', t => {
+  const dir = mkdtempSync(join(tmpdir(), 'medley-mislabeled-'));
+
+  try {
+    // Valid FLAC content, the MP3 decoder would be picked by the extension
+    const mislabeled = join(dir, 'middlec.mp3');
+    copyFileSync(`${__dirname}/middlec.flac`, mislabeled);
+
+    t.false(Medley.isTrackLoadable(mislabeled));
+    t.true(Medley.isTrackLoadable(`${__dirname}/middlec.flac`));
+
+    // Vorbis in an Opus file
+    const opus = join(dir, 'middlec.opus');
+    copyFileSync(`${__dirname}/middlec.ogg`, opus);
+
+    t.false(Medley.isTrackLoadable(opus));
+  }
+  finally {
+    rmSync(dir, { recursive: true, force: true });
   }
 });
 
@@ -69,16 +155,154 @@ for (const { ext } of middlec) {
   test.serial(`Reading Cover and Lyrics: middlec.${ext}`, testCoverAndLyrics(ext));
 }
 
+test.serial('Cover hash and thumbnail', t => {
+  const full = Medley.getCoverAndLyrics(`${__dirname}/middlec.mp3`);
+  const thumbnailed = Medley.getCoverAndLyrics(`${__dirname}/middlec.flac`, { fullCover: false, thumbnailSize: 16 });
+
+  t.is(thumbnailed.coverHash, full.coverHash);
+  t.is(thumbnailed.cover.byteLength, 0);
+  t.is(thumbnailed.thumbnailMimeType, 'image/jpeg');
+  t.true((thumbnailed.thumbnail?.byteLength ?? 0) > 0);
+});
+
+test('Track probing', async t => {
+  const path = `${__dirname}/middlec.flac`;
+
+  const probed = Medley.probe(path);
+  t.deepEqual(probed.tags, Medley.getMetadata(path));
+  t.deepEqual(probed.properties, Medley.getAudioProperties(path));
+  t.is(probed.coverMimeType, 'image/jpeg');
+  t.is(probed.lyrics, 'middle c');
+  t.true(probed.loadable);
+  t.is(probed.error, undefined);
+
+  const partial = Medley.probe(path, { fields: ['properties'] });
+  t.deepEqual(Object.keys(partial).filter(key => partial[key as keyof typeof partial] !== undefined), ['properties']);
+
+  const batch = await Medley.probeAllAsync([path, `${__dirname}/excessive_alloc.mp3`], { fields: ['loadable'] });
+  t.deepEqual(batch.map(result => result.loadable), [true, false]);
+});
+
+test('Asynchronous reads', async t => {
+  const path = `${__dirname}/middlec.flac`;
+
+  t.deepEqual(await Medley.getMetadataAsync(path), Medley.getMetadata(path));
+  t.deepEqual(await Medley.getAudioPropertiesAsync(path), Medley.getAudioProperties(path));
+  t.deepEqual(await Medley.getCoverAndLyricsAsync(path), Medley.getCoverAndLyrics(path));
+  t.true(await Medley.isTrackLoadableAsync(tracks[0]));
+  t.false(await Medley.isTrackLoadableAsync(`${__dirname}/excessive_alloc.mp3`));
+  t.false(await Medley.isTrackLoadableAsync(42 as any));
+
+  const controller = new AbortController();
+  const aborted = Medley.getMetadataAsync(tracks[0], { signal: controller.signal });
+  controller.abort(new Error('Aborted by test'));
+
+  await t.throwsAsync(aborted, { message: 'Aborted by test' });
+});
+
+test('Asynchronous read timeout', async t => {
+  const paths = Array.from({ length: 50 }, (_, i) => tracks[i % tracks.length]);
+
+  // Keeps the 4 threads of the pool busy, the next read is left pending until it times out
+  const batches = Array.from({ length: 4 }, () => Medley.probeAllAsync(paths, { fields: ['loadable'], deep: true }));
+
+  await t.throwsAsync(Medley.getMetadataAsync(`${__dirname}/middlec.flac`, { timeout: 1 }), { message: 'Timed out after 1ms' });
+
+  for (const results of await Promise.all(batches)) {
+    t.true(results.every(result => result.loadable));
+  }
+
+  t.deepEqual(await Medley.getMetadataAsync(`${__dirname}/middlec.flac`, { timeout: 5000 }), Medley.getMetadata(`${__dirname}/middlec.flac`));
+});
+
+test.serial('Incremental library scanning', async t => {
+  const dir = mkdtempSync(join(tmpdir(), 'medley-library-'));
+  const stateFile = join(dir, 'library.state');
+
+  try {
+    for (const { ext } of middlec) {
+      copyFileSync(`${__dirname}/middlec.${ext}`, join(dir, `middlec.${ext}`));
+    }
+
+    const scanner = new LibraryScanner({ stateFile });
+
+    const first = await scanner.scan([dir]);
+    t.is(first.added.length, middlec.length);
+    t.is(first.added.find(file => file.path.endsWith('.flac'))?.tags?.title, Medley.getMetadata(`${__dirname}/middlec.flac`)?.title);
+
+    const second = await scanner.scan([dir]);
+    t.deepEqual(second, { added: [], changed: [], removed: [] });
+
+    unlinkSync(join(dir, 'middlec.wav'));
+
+    // Picks up from the persisted state
+    const restarted = new LibraryScanner({ stateFile });
+    t.is(restarted.size, middlec.length);
+
+    const third = await restarted.scan([dir]);
+    t.deepEqual(third.removed, [join(dir, 'middlec.wav')]);
+    t.is(third.added.length + third.changed.length, 0);
+  }
+  finally {
+    rmSync(dir, { recursive: true, force: true });
+  }
+});
+
+test.serial('Library watching', async t => {
+  const dir = mkdtempSync(join(tmpdir(), 'medley-library-'));
+
+  t.timeout(20_000);
+
+  try {
+    copyFileSync(`${__dirname}/middlec.mp3`, join(dir, 'middlec.mp3'));
+
+    const scanner = new LibraryScanner({ debounce: 100, pollInterval: 500 });
+    t.is((await scanner.scan([dir])).added.length, 1);
+
+    const changes: LibraryChanges[] = [];
+    let notify: (() => void) | undefined;
+
+    const nextChange = () => new Promise<LibraryChanges>(resolve => {
+      const take = () => resolve(changes.shift()!);
+      changes.length ? take() : (notify = take);
+    });
+
+    scanner.watch(result => {
+      changes.push(result);
+      notify?.();
+      notify = undefined;
+    });
+
+    try {
+      const flac = join(dir, 'middlec.flac');
+      copyFileSync(`${__dirname}/middlec.flac`, flac);
+
+      const added = await nextChange();
+      t.deepEqual(added.added.map(file => file.path), [flac]);
+      t.truthy(added.added[0].tags);
+
+      unlinkSync(flac);
+      t.deepEqual((await nextChange()).removed, [flac]);
+    }
+    finally {
+      scanner.unwatch();
+    }
+
+    // An emptied root looks like a drive that is not mounted
+    unlinkSync(join(dir, 'middlec.mp3'));
+    t.deepEqual((await scanner.scan([dir])).removed, []);
+    t.is(scanner.size, 1);
+  }
+  finally {
+    rmSync(dir, { recursive: true, force: true });
+  }
+});
+
 test('Null Audio Device playback', t => {
-  const { medley, queue } = createMedley({ skipDeviceScanning: true });
+  const { medley, queue } = createNullMedley(t);
 
   t.is(medley.constructor, Medley, `${Medley.name} instance expected`);
 
-  t.true(
-    medley.setAudioDevice({ type: 'Null', device: 'Null Device' }),
-    'Null audio device'
-  );
-
   queue.add(tracks[0]);
   t.true(medley.play());
 
@@ -106,3 +330,368 @@ test('Null Audio Device playback', t => {
   });
 })
 
+test('Audio stream conversion', async t => {
+  const { medley } = createNullMedley(t);
+
+  // Nothing is playing, the output is digital silence
+  const numSamples = 48_000;
+
+  const [plain, dithered, shaped, float] = await Promise.all([
+    medley.requestAudioStream({ format: 'Int16LE' }),
+    medley.requestAudioStream({ format: 'Int16BE', dither: true }),
+    medley.requestAudioStream({ format: 'Int16LE', dither: true, noiseShaping: true }),
+    medley.requestAudioStream({ format: 'FloatLE' })
+  ]);
+
+  t.true(medley.updateAudioStream(float.id, { dither: true }));
+
+  const readInt16 = async (stream: Readable, bigEndian: boolean) => {
+    const bytes = await readBytes(stream, numSamples * 2);
+    return Array.from({ length: numSamples }, (_, i) => bigEndian ? bytes.readInt16BE(i * 2) : bytes.readInt16LE(i * 2));
+  }
+
+  const [plainSamples, ditheredSamples, shapedSamples, floatSamples] = await Promise.all([
+    readInt16(plain.stream, false),
+    readInt16(dithered.stream, true),
+    readInt16(shaped.stream, false),
+    readSamples(float.stream, numSamples)
+  ]);
+
+  t.true(plainSamples.every(v => v === 0));
+
+  // Dither has no effect on float
+  t.true(floatSamples.every(v => v === 0));
+
+  // Triangular dither peaks at 1 LSB and averages to nothing
+  t.true(ditheredSamples.some(v => v !== 0));
+  t.true(ditheredSamples.every(v => Math.abs(v) <= 1));
+  t.true(Math.abs(ditheredSamples.reduce((sum, v) => sum + v, 0) / numSamples) < 0.05);
+
+  // Error feedback pushes the noise up, within the error limit plus the dither peak
+  t.true(shapedSamples.some(v => v !== 0));
+  t.true(shapedSamples.every(v => Math.abs(v) <= 3));
+
+  for (const { id } of [plain, dithered, shaped, float]) {
+    medley.deleteAudioStream(id);
+  }
+});
+
+test('Performance stats', async t => {
+  const { medley, queue } = createNullMedley(t);
+
+  await startPlaying(t, medley, queue);
+
+  const main = medley.getState().mainDeck!;
+  await waitUntil(() => medley.getStats().decks[main].load.count > 0);
+
+  const stats = medley.getStats();
+  const { callback, postProcessor } = stats.mixer;
+
+  t.true(callback.min <= callback.p50 && callback.p50 <= callback.p99 && callback.p99 <= callback.max);
+  t.is(callback.negative, 0);
+
+  // The post processor runs inside the audio callback, which may be halfway through
+  t.true(Math.abs(postProcessor.count - callback.count) <= 1);
+  t.true(postProcessor.mean <= callback.mean);
+  t.true(stats.mixer.cpu >= 0 && stats.mixer.cpu <= 1);
+
+  t.is(stats.decks.length, 3);
+  t.is(stats.decks[main].load.count, 1);
+  t.true(stats.decks.every((deck, index) => index === main || deck.load.count === 0));
+
+  // A single track, nothing to transit to
+  t.is(stats.transition.lateness.count, 0);
+
+  // Keeps counting while playing
+  await waitUntil(() => medley.getStats().mixer.callback.count > callback.count);
+
+  medley.stop(false);
+});
+
+test('Trace recording', async t => {
+  const { medley, queue } = createNullMedley(t);
+
+  medley.tracing = true;
+  t.true(medley.tracing);
+
+  await startPlaying(t, medley, queue);
+
+  medley.stop(false);
+  medley.tracing = false;
+
+  const { traceEvents } = JSON.parse(medley.getTrace(true));
+
+  const callbacks = traceEvents.filter((e: any) => e.name === 'audioCallback' && e.ph === 'X');
+  const loads = traceEvents.filter((e: any) => e.name === 'loadTrack' && e.ph === 'X');
+
+  t.true(callbacks.length > 0);
+  t.is(loads.length, 1);
+
+  t.true(traceEvents.filter((e: any) => e.ph === 'X').every((e: any) => e.ts >= 0 && e.dur >= 0));
+
+  // Tracks are loaded off the audio thread, every thread is named
+  t.not(loads[0].tid, callbacks[0].tid);
+
+  for (const tid of new Set(traceEvents.map((e: any) => e.tid))) {
+    t.true(traceEvents.some((e: any) => e.tid === tid && e.ph === 'M' && e.name === 'thread_name'));
+  }
+
+  // Audio callbacks never overlap, allowing for rounding
+  t.true(callbacks.every((e: any, i: number) => i === 0 || e.ts + 1 >= callbacks[i - 1].ts + callbacks[i - 1].dur));
+
+  // Cleared by the previous call
+  t.false(JSON.parse(medley.getTrace()).traceEvents.some((e: any) => e.ph === 'X'));
+});
+
+test('State snapshot', async t => {
+  const { medley, queue } = createNullMedley(t);
+
+  await startPlaying(t, medley, queue);
+
+  const state = medley.getState();
+
+  t.true(state.playing);
+  t.is(state.decks.length, 3);
+  t.is(state.decks.filter(deck => deck.loaded).length, 1);
+
+  const main = state.decks.find(deck => deck.main);
+
+  t.truthy(main);
+  t.true(main!.loaded);
+  t.is(state.decks.indexOf(main!), state.mainDeck);
+  t.is(main!.duration, medley.getDeckPositions(state.mainDeck!).duration);
+
+  // Published continuously, not only on events
+  await waitUntil(() => medley.getState().decks[state.mainDeck!].current > main!.current);
+
+  // The engine keeps publishing into its own memory, a buffer taken away from JS is replaced
+  const buffer: ArrayBuffer = (medley as any)['*$getStateBuffer']();
+
+  try {
+    structuredClone(buffer, { transfer: [buffer] });
+  }
+  catch {
+    // External buffers may not be transferable
+  }
+
+  t.true(medley.getState().playing);
+
+  medley.stop(false);
+
+  await waitUntil(() => !medley.getState().playing);
+  await waitUntil(() => medley.getState().decks.every(deck => !deck.loaded));
+});
+
+test('Prefetching', async t => {
+  const { medley, queue } = createNullMedley(t);
+  const prefetched = () => (medley as any)['*$getPrefetched']() as string[];
+
+  t.is(medley.prefetch, 2);
+
+  queue.add([tracks[0], tracks[2], tracks[3]]);
+
+  await waitUntil(() => prefetched().length === 2);
+  t.deepEqual(prefetched(), [tracks[0], tracks[2]]);
+
+  // No longer upcoming, dropped right away
+  queue.delete(0);
+  t.false(prefetched().includes(tracks[0]));
+
+  await waitUntil(() => prefetched().length === 2);
+  t.deepEqual(prefetched(), [tracks[2], tracks[3]]);
+
+  const loaded = new Promise(resolve => medley.once('loaded', resolve));
+  t.true(medley.play());
+  await loaded;
+
+  // Taken by the deck
+  await waitUntil(() => !prefetched().includes(tracks[2]));
+  t.deepEqual(prefetched(), [tracks[3]]);
+
+  medley.prefetch = 0;
+  t.is(medley.prefetch, 0);
+  t.deepEqual(prefetched(), []);
+
+  medley.stop(false);
+});
+
+test('Queue', async t => {
+  const queue = new Queue(['a', 'b', 'c']);
+  const paths = () => queue.toArray().map(track => track.path);
+
+  t.is(queue.length, 3);
+
+  const version = queue.version;
+  t.deepEqual(paths(), ['a', 'b', 'c']);
+  t.is(queue.version, version);
+
+  queue.insert(1, ['d', 'e']);
+  queue.move(0, 10);
+  queue.swap(0, 1);
+  queue.delete(1, 2);
+  queue.set(0, 'f');
+
+  t.deepEqual(paths(), ['f', 'c', 'a']);
+  t.is(queue.get(1).path, 'c');
+  t.is(queue.get(5), undefined);
+  t.is(queue.version, version + 5);
+
+  // Tracks taken by the engine are released on the JS thread
+  const { medley, queue: engineQueue } = createNullMedley(t);
+
+  await startPlaying(t, medley, engineQueue, [tracks[0], tracks[2]]);
+
+  t.is(engineQueue.length, 1);
+  t.is(engineQueue.get(0).path, tracks[2]);
+  t.deepEqual(engineQueue.toArray().map(track => track.path), [tracks[2]]);
+  t.true(engineQueue.version > 1);
+
+  medley.stop(false);
+});
+
+test('Worker threads', async t => {
+  // Each worker has its own environment, tracks dropped by its engine must be released there
+  const source = `
+    const { parentPort, workerData } = require('node:worker_threads');
+    const { EventEmitter } = require('node:events');
+    const { Medley, Queue } = require('node-gyp-build')(workerData.moduleDir);
+
+    Object.setPrototypeOf(Medley.prototype, EventEmitter.prototype);
+
+    const queue = new Queue(workerData.tracks);
+    const medley = new Medley(queue, { skipDeviceScanning: true });
+
+    medley.setAudioDevice({ type: 'Null', device: 'Null Device' });
+    medley.play();
+
+    medley.once('started', () => parentPort.postMessage(queue.length));
+  `;
+
+  const run = () => new Promise<number>((resolve, reject) => {
+    const worker = new Worker(source, { eval: true, workerData: { moduleDir: join(__dirname, '..'), tracks: [tracks[0], tracks[2]] } });
+
+    worker.once('error', reject);
+    worker.once('message', async (length: number) => {
+      // Torn down while its engine still holds tracks
+      await worker.terminate();
+      resolve(length);
+    });
+  });
+
+  const lengths = await Promise.all([run(), run()]);
+  t.true(lengths.every(length => length < 2));
+
+  // The main environment is unaffected
+  const queue = new Queue(['a']);
+  t.is(queue.toArray()[0].path, 'a');
+});
+
+test('Loudness metering', async t => {
+  const { medley, queue } = createNullMedley(t);
+
+  await startPlaying(t, medley, queue);
+
+  // The first gating block is 400ms long
+  await waitUntil(() => Number.isFinite(medley.loudness.integrated));
+
+  const { loudness } = medley;
+
+  // A mastered track, nowhere near silence nor full scale
+  t.true(loudness.momentary > -40 && loudness.momentary < 0, `Momentary ${loudness.momentary}`);
+  t.true(loudness.integrated > -40 && loudness.integrated < 0, `Integrated ${loudness.integrated}`);
+  t.true(loudness.correlation > 0 && loudness.correlation <= 1, `Correlation ${loudness.correlation}`);
+
+  for (const channel of ['left', 'right'] as const) {
+    t.true(loudness.truePeak[channel] > 0);
+    t.true(loudness.maxTruePeak[channel] >= loudness.truePeak[channel]);
+  }
+
+  t.true(medley.level.left.rms > 0);
+
+  // Stopped, below the absolute gate
+  medley.stop(false);
+  await waitUntil(() => medley.loudness.momentary < -70);
+
+  // Silence is gated out, the track is still integrated
+  t.true(Number.isFinite(medley.loudness.integrated));
+  t.true(medley.loudness.maxTruePeak.left > 0);
+
+  // Nothing but silence since the reset
+  medley.resetLoudness();
+  await waitUntil(() => medley.loudness.integrated === -Infinity);
+
+  t.true(medley.loudness.maxTruePeak.left < 0.001);
+  t.true(medley.loudness.maxTruePeak.right < 0.001);
+});
+
+test('Processing graph', async t => {
+  const { medley, queue } = createNullMedley(t);
+
+  t.true(medley.setGraph([
+    { type: 'eq', id: 'eq', params: { lowGain: 3 } },
+    { type: 'width' }
+  ]));
+
+  const graph = medley.getGraph();
+
+  t.is(graph.length, 2);
+  t.is(graph[0].id, 'eq');
+  t.is(graph[0].params.lowGain, 3);
+  t.is(graph[1].id, 'width-1');
+
+  t.true(medley.setGraphParams('eq', { lowGain: 100 }));
+  t.is(medley.getGraph()[0].params.lowGain, 24);
+  t.false(medley.setGraphParams('nothing', { gain: 0 }));
+
+  t.throws(() => medley.setGraph([{ type: 'unknown' as never }]));
+  t.is(medley.getGraph().length, 2);
+
+  // Audio streams running their own graph, off the main output
+  t.true(medley.setGraph([]));
+
+  await startPlaying(t, medley, queue);
+
+  const numSamples = 48_000 * 2;
+
+  const requests = await Promise.all([
+    medley.requestAudioStream({ format: 'FloatLE' }),
+    medley.requestAudioStream({ format: 'FloatLE', graph: [{ type: 'width', params: { width: 0 } }] }),
+    medley.requestAudioStream({ format: 'FloatLE', graph: [{ type: 'gain', params: { gain: -24 } }] })
+  ]);
+
+  const [plain, mono, quiet] = await Promise.all(requests.map(({ stream }) => readSamples(stream, numSamples)));
+
+  for (const { id } of requests) {
+    medley.deleteAudioStream(id);
+  }
+
+  medley.stop(false);
+
+  const sides = (samples: Float32Array) => samples.filter((v, i) => i % 2 === 0 && v !== samples[i + 1]).length;
+
+  t.true(rms(plain) > 0.01);
+  t.true(sides(plain) > 0, 'The track is stereo');
+  t.is(sides(mono), 0, 'Width 0 is mono');
+  t.true(rms(mono) > 0.01);
+
+  // -24dB is about 0.063 of the level
+  const ratio = rms(quiet) / rms(plain);
+  t.true(ratio > 0.03 && ratio < 0.12, `Gain ratio ${ratio}`);
+});
+
+test('Multiband processor', t => {
+  const { medley } = createNullMedley(t);
+
+  t.false(medley.getFx('multiband').enabled);
+
+  t.true(medley.setFx('multiband', { enabled: true, preset: 'speech' }));
+
+  const params = medley.getFx('multiband');
+
+  t.true(params.enabled);
+  t.is(params.preset, 'speech');
+  t.is(params.gains.length, 4);
+
+  t.throws(() => medley.setFx('multiband', { preset: 'unknown' as never }));
+  t.is(medley.getFx('multiband').preset, 'speech');
+});